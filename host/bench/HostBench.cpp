@@ -0,0 +1,269 @@
+#include <Arduino.h>
+#include "json/FirebaseJson.h"
+#include "mbfs/MB_Alloc.h"
+#include "HostBench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// The size is kept before each block so that free knows the live bytes
+static const size_t host_bench_header = 16;
+
+static std::atomic<uint64_t> bench_allocs{0};
+static std::atomic<size_t> bench_live{0};
+static std::atomic<size_t> bench_peak{0};
+
+static void host_bench_add(size_t len)
+{
+    bench_allocs.fetch_add(1, std::memory_order_relaxed);
+    size_t live = bench_live.fetch_add(len, std::memory_order_relaxed) + len;
+    size_t peak = bench_peak.load(std::memory_order_relaxed);
+    while (live > peak && !bench_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        ;
+}
+
+static void *host_bench_malloc(size_t len)
+{
+    uint8_t *p = static_cast<uint8_t *>(malloc(len + host_bench_header));
+    if (!p)
+        return nullptr;
+    memcpy(p, &len, sizeof(len));
+    host_bench_add(len);
+    return p + host_bench_header;
+}
+
+static void host_bench_free(void *ptr)
+{
+    if (!ptr)
+        return;
+    uint8_t *p = static_cast<uint8_t *>(ptr) - host_bench_header;
+    size_t len;
+    memcpy(&len, p, sizeof(len));
+    bench_live.fetch_sub(len, std::memory_order_relaxed);
+    free(p);
+}
+
+static void *host_bench_realloc(void *ptr, size_t len)
+{
+    if (!ptr)
+        return host_bench_malloc(len);
+    uint8_t *p = static_cast<uint8_t *>(ptr) - host_bench_header;
+    size_t old;
+    memcpy(&old, p, sizeof(old));
+    uint8_t *q = static_cast<uint8_t *>(realloc(p, len + host_bench_header));
+    if (!q)
+        return nullptr;
+    memcpy(q, &len, sizeof(len));
+    bench_live.fetch_sub(old, std::memory_order_relaxed);
+    host_bench_add(len);
+    return q + host_bench_header;
+}
+
+static MB_JSON_Hooks bench_json_hooks = {host_bench_malloc, host_bench_free, host_bench_realloc};
+static MB_String_Hooks bench_string_hooks = {host_bench_malloc, host_bench_realloc, host_bench_free};
+
+// The hooks are set before the static objects of the library and of the benchmarks allocate
+struct HostBenchHooks
+{
+    HostBenchHooks()
+    {
+        if (!FirebaseJsonBase::setHooks(&bench_json_hooks) || !MB_String::setHooks(&bench_string_hooks))
+        {
+            fprintf(stderr, "host_bench: the allocator hooks could not be set, blocks are alive\n");
+            exit(2);
+        }
+    }
+};
+
+static HostBenchHooks bench_hooks __attribute__((init_priority(101)));
+
+static uint64_t host_bench_mb_alloc_count()
+{
+    uint64_t n = 0;
+    for (uint8_t tag = 0; tag < mb_alloc_tag_max; tag++)
+        n += MB_Alloc::getStats(tag).allocs;
+    return n;
+}
+
+uint64_t host_bench_allocs() { return bench_allocs.load(std::memory_order_relaxed) + host_bench_mb_alloc_count(); }
+
+size_t host_bench_live_bytes() { return bench_live.load(std::memory_order_relaxed); }
+
+size_t host_bench_peak_bytes() { return bench_peak.load(std::memory_order_relaxed); }
+
+void host_bench_reset_peak() { bench_peak.store(bench_live.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+
+static uint64_t host_bench_now_ns()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool HostBenchState::run()
+{
+    if (!_started)
+    {
+        _started = true;
+        host_bench_reset_peak();
+        _liveStart = host_bench_live_bytes();
+        _allocsStart = host_bench_allocs();
+        _startNs = host_bench_now_ns();
+    }
+
+    if (_done < _iterations)
+    {
+        _done++;
+        return true;
+    }
+
+    if (!_finished)
+    {
+        _finished = true;
+        _elapsedNs = host_bench_now_ns() - _startNs - _pausedNs;
+        _allocs = host_bench_allocs() - _allocsStart - _pausedAllocs;
+    }
+    return false;
+}
+
+void HostBenchState::pause()
+{
+    _pauseStartNs = host_bench_now_ns();
+    _pauseAllocsStart = host_bench_allocs();
+}
+
+void HostBenchState::resume()
+{
+    _pausedNs += host_bench_now_ns() - _pauseStartNs;
+    _pausedAllocs += host_bench_allocs() - _pauseAllocsStart;
+}
+
+static std::vector<HostBenchCase> &host_benches()
+{
+    static std::vector<HostBenchCase> benches;
+    return benches;
+}
+
+HostBenchRegistrar::HostBenchRegistrar(const char *name, void (*run)(HostBenchState &state))
+{
+    host_benches().push_back({name, run});
+}
+
+struct HostBenchResult
+{
+    std::string name;
+    std::string label;
+    uint64_t iterations;
+    double nsPerOp;
+    double allocsPerOp;
+    size_t peakBytes;
+    double mbPerSec;
+};
+
+class HostBenchRunner
+{
+public:
+    static HostBenchResult measure(const HostBenchCase &bench, uint64_t minTimeNs)
+    {
+        uint64_t n = 1;
+        for (;;)
+        {
+            HostBenchState state(n);
+            bench.run(state);
+            // the loop that was left early (or never entered) still finishes its measurement
+            while (state.run())
+                ;
+
+            if (state._elapsedNs >= minTimeNs || n >= 1000000000ULL)
+            {
+                HostBenchResult result;
+                result.name = bench.name;
+                result.label = state._label;
+                result.iterations = n;
+                result.nsPerOp = (double)state._elapsedNs / n;
+                result.allocsPerOp = (double)state._allocs / n;
+                size_t peak = host_bench_peak_bytes();
+                result.peakBytes = peak > state._liveStart ? peak - state._liveStart : 0;
+                result.mbPerSec = state._bytesPerOp && state._elapsedNs ? (double)state._bytesPerOp * n * 1000.0 / state._elapsedNs : 0;
+                return result;
+            }
+
+            // aim 20% over the minimum time from the time per operation so far
+            double perOp = state._elapsedNs > 0 ? (double)state._elapsedNs / n : 1;
+            uint64_t next = (uint64_t)(minTimeNs * 1.2 / perOp);
+            n = std::max(n * 2, std::min(next, n * 100));
+        }
+    }
+};
+
+static std::string host_bench_json_str(const std::string &s)
+{
+    std::string out = "\"";
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if ((unsigned char)c < 0x20)
+            continue;
+        out += c;
+    }
+    return out + "\"";
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = nullptr;
+    const char *jsonPath = "bench_results.json";
+    uint64_t minTimeMs = 200;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--filter=", 9) == 0)
+            filter = argv[i] + 9;
+        else if (strncmp(argv[i], "--json=", 7) == 0)
+            jsonPath = argv[i] + 7;
+        else if (strncmp(argv[i], "--min-time-ms=", 14) == 0)
+            minTimeMs = strtoull(argv[i] + 14, nullptr, 10);
+        else
+        {
+            fprintf(stderr, "usage: %s [--filter=<substring>] [--json=<file>] [--min-time-ms=<ms>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<HostBenchResult> results;
+    printf("%-40s %12s %12s %12s %12s %10s  %s\n", "benchmark", "iterations", "ns/op", "allocs/op", "peak bytes", "MB/s", "");
+    for (auto &bench : host_benches())
+    {
+        if (filter && !strstr(bench.name, filter))
+            continue;
+        HostBenchResult r = HostBenchRunner::measure(bench, minTimeMs * 1000000ULL);
+        printf("%-40s %12llu %12.1f %12.2f %12zu %10.1f  %s\n", r.name.c_str(), (unsigned long long)r.iterations, r.nsPerOp,
+               r.allocsPerOp, r.peakBytes, r.mbPerSec, r.label.c_str());
+        fflush(stdout);
+        results.push_back(r);
+    }
+
+    FILE *f = fopen(jsonPath, "w");
+    if (!f)
+    {
+        fprintf(stderr, "host_bench: can't write %s\n", jsonPath);
+        return 1;
+    }
+    fprintf(f, "{\n  \"suite\": \"firebase_host\",\n  \"compiler\": %s,\n  \"min_time_ms\": %llu,\n  \"results\": [",
+            host_bench_json_str(__VERSION__).c_str(), (unsigned long long)minTimeMs);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const HostBenchResult &r = results[i];
+        fprintf(f, "%s\n    {\"name\": %s, \"label\": %s, \"iterations\": %llu, \"ns_per_op\": %.2f, \"allocs_per_op\": %.3f, \"peak_bytes\": %zu, \"mb_per_s\": %.2f}",
+                i ? "," : "", host_bench_json_str(r.name).c_str(), host_bench_json_str(r.label).c_str(),
+                (unsigned long long)r.iterations, r.nsPerOp, r.allocsPerOp, r.peakBytes, r.mbPerSec);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+    printf("%zu results written to %s\n", results.size(), jsonPath);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * The benchmarks of the host build, all bench_*.cpp files make one executable (host_bench).
+ *
+ * HOST_BENCH(name) { ... } defines a benchmark, the code before the first state.run() is the setup,
+ * the loop body is measured:
+ *
+ *   HOST_BENCH(json_set)
+ *   {
+ *       FirebaseJson json;
+ *       while (state.run())
+ *           json.set("a/b", 1);
+ *   }
+ *
+ * The loop runs until the minimum time was reached, the result is the time, the allocations and the
+ * peak of the live heap above the start of the loop, per operation. The allocations are those of
+ * FirebaseJson (MB_JSON hooks) and MB_String (MB_String hooks) which are installed before any other
+ * static object is made, plus the count of the MB_Alloc allocations (the MB_FS buffers).
+ *
+ *   host_bench [--filter=<substring>] [--json=<file>] [--min-time-ms=<ms>]
+ *
+ * The results are printed and written to the JSON file (bench_results.json by default).
+ */
+
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class HostBenchState
+{
+public:
+    explicit HostBenchState(uint64_t iterations) : _iterations(iterations) {}
+
+    // true while the loop should go on, the first call starts the measurement
+    bool run();
+
+    // Exclude the code between pause() and resume() from the time and the allocations
+    void pause();
+    void resume();
+
+    // The bytes processed by one operation, for the MB/s column
+    void setBytesPerOp(size_t bytes) { _bytesPerOp = bytes; }
+
+    // A note for the result e.g. the input size
+    void setLabel(const std::string &label) { _label = label; }
+
+    uint64_t iterations() const { return _iterations; }
+
+private:
+    friend class HostBenchRunner;
+
+    uint64_t _iterations;
+    uint64_t _done = 0;
+    bool _started = false;
+    bool _finished = false;
+    uint64_t _startNs = 0;
+    uint64_t _pausedNs = 0;
+    uint64_t _pauseStartNs = 0;
+    uint64_t _elapsedNs = 0;
+    uint64_t _allocsStart = 0;
+    uint64_t _allocs = 0;
+    uint64_t _pausedAllocs = 0;
+    uint64_t _pauseAllocsStart = 0;
+    size_t _liveStart = 0;
+    size_t _bytesPerOp = 0;
+    std::string _label;
+};
+
+struct HostBenchCase
+{
+    const char *name;
+    void (*run)(HostBenchState &state);
+};
+
+struct HostBenchRegistrar
+{
+    HostBenchRegistrar(const char *name, void (*run)(HostBenchState &state));
+};
+
+// The allocations so far and the live and peak bytes of the hooked allocators
+uint64_t host_bench_allocs();
+size_t host_bench_live_bytes();
+size_t host_bench_peak_bytes();
+void host_bench_reset_peak();
+
+// Keep the value from being optimized away
+template <typename T>
+inline void host_bench_keep(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#define HOST_BENCH(name)                                            \
+    static void name(HostBenchState &state);                        \
+    static HostBenchRegistrar name##_registrar(#name, name);        \
+    static void name(HostBenchState &state)
+
+#endif
@@ -0,0 +1,126 @@
+// The string, URL, base64 and HTTP helpers of FB_Utils.h that run on every request
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include "FB_Utils.h"
+#include "../server/LoopbackServer.h"
+#include "HostBench.h"
+
+static const char *const respHeader =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: application/json; charset=UTF-8\r\n"
+    "Vary: Origin\r\n"
+    "Vary: X-Origin\r\n"
+    "Vary: Referer\r\n"
+    "Date: Thu, 16 Oct 2025 20:00:00 GMT\r\n"
+    "Server: ESF\r\n"
+    "Cache-Control: private\r\n"
+    "X-XSS-Protection: 0\r\n"
+    "X-Frame-Options: SAMEORIGIN\r\n"
+    "X-Content-Type-Options: nosniff\r\n"
+    "Content-Length: 3661\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+
+HOST_BENCH(mb_string_append)
+{
+    state.setLabel("64 appends");
+    while (state.run())
+    {
+        MB_String s;
+        for (int i = 0; i < 16; i++)
+        {
+            s += "fields/AcX/bytesValue";
+            s += '/';
+            s += i;
+            s += "\r\n";
+        }
+        host_bench_keep(s.length());
+    }
+}
+
+HOST_BENCH(base64_encode)
+{
+    MB_FS mbfs;
+    Base64Helper b64;
+    uint8_t data[1024];
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t)(i * 31 + 7);
+    state.setBytesPerOp(sizeof(data));
+    state.setLabel("1024 bytes");
+    while (state.run())
+        host_bench_keep(b64.encodeToString(&mbfs, data, sizeof(data)).length());
+}
+
+HOST_BENCH(base64_decode)
+{
+    MB_FS mbfs;
+    Base64Helper b64;
+    uint8_t data[1024];
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t)(i * 31 + 7);
+    MB_String encoded = b64.encodeToString(&mbfs, data, sizeof(data));
+    MB_VECTOR<uint8_t> out;
+    state.setBytesPerOp(encoded.length());
+    state.setLabel("1024 bytes");
+    while (state.run())
+    {
+        out.clear();
+        b64.decodeToArray(&mbfs, encoded, out);
+        host_bench_keep(out.size());
+    }
+}
+
+HOST_BENCH(url_encode)
+{
+    URLHelper uh;
+    MB_String path = "projects/ece198-d2f99/databases/(default)/documents/SensorData?mask.fieldPaths=AcX&pageToken=Ab+c/d==";
+    state.setBytesPerOp(path.length());
+    while (state.run())
+        host_bench_keep(uh.encode(path).length());
+}
+
+HOST_BENCH(http_parse_resp_header)
+{
+    StringHelper sh;
+    HttpHelper hh;
+    MB_String header = respHeader;
+    state.setBytesPerOp(header.length());
+    while (state.run())
+    {
+        server_response_data_t response;
+        response.httpCode = 200;
+        hh.parseRespHeader(&sh, header, response);
+        host_bench_keep(response.contentLen);
+    }
+}
+
+HOST_BENCH(http_parse_resp_payload)
+{
+    StringHelper sh;
+    HttpHelper hh;
+    MB_String payload = LoopbackServer::fixture("rtdb/get.json").c_str();
+    state.setBytesPerOp(payload.length());
+    state.setLabel("rtdb/get.json");
+    while (state.run())
+    {
+        server_response_data_t response;
+        hh.parseRespPayload(&sh, payload, response, true);
+        host_bench_keep(response.dataType);
+    }
+}
+
+HOST_BENCH(http_parse_resp_payload_event)
+{
+    StringHelper sh;
+    HttpHelper hh;
+    MB_String payload = "event: put\ndata: {\"path\":\"/vitals\",\"data\":{\"bpm\":72,\"spo2\":97,\"temp\":36.7}}\n\n";
+    state.setBytesPerOp(payload.length());
+    state.setLabel("SSE put");
+    while (state.run())
+    {
+        server_response_data_t response;
+        hh.parseRespPayload(&sh, payload, response, true);
+        host_bench_keep(response.payloadLen);
+    }
+}
@@ -0,0 +1,104 @@
+// The FirebaseJson iterator on a listDocuments page of about 200 KB, made of the documents of
+// firestore/list_documents.json, and on a page of a tenth of the size to show the cost per byte.
+
+#include <Arduino.h>
+#include "json/FirebaseJson.h"
+#include "json/MB_JSON/MB_JSON.h"
+#include "../server/LoopbackServer.h"
+#include "HostBench.h"
+
+static std::string listDocumentsPage(size_t minBytes)
+{
+    std::string fixture = LoopbackServer::fixture("firestore/list_documents.json");
+    MB_JSON *root = MB_JSON_Parse(fixture.c_str());
+    MB_JSON *docs = MB_JSON_GetObjectItem(root, "documents");
+    std::vector<std::string> items;
+    MB_JSON *doc;
+    MB_JSON_ArrayForEach(doc, docs)
+    {
+        char *s = MB_JSON_PrintUnformatted(doc);
+        items.push_back(s);
+        MB_JSON_free(s);
+    }
+    MB_JSON_Delete(root);
+
+    std::string page = "{\"documents\":[";
+    for (size_t i = 0; page.size() < minBytes; i++)
+    {
+        // each document has its own name as in a real page
+        std::string item = items[i % items.size()];
+        size_t pos = item.find("SensorData/");
+        if (pos != std::string::npos)
+            item.insert(pos + 11, std::to_string(i) + "-");
+        page += i ? "," : "";
+        page += item;
+    }
+    page += "],\"nextPageToken\":\"AFTOeJwJ3tJcRkJ0eF9nS2dsZU5oc0pyZ3ZtcFdv\"}";
+    return page;
+}
+
+static void benchView(HostBenchState &state, size_t bytes)
+{
+    FirebaseJson json;
+    json.setJsonData(listDocumentsPage(bytes).c_str());
+    state.setBytesPerOp(strlen(json.raw()));
+    state.setLabel(std::to_string(strlen(json.raw()) / 1024) + " KB listDocuments");
+    while (state.run())
+    {
+        size_t n = json.iteratorBegin();
+        for (size_t i = 0; i < n; i++)
+        {
+            FirebaseJson::IteratorView view = json.viewAt(i);
+            host_bench_keep(view.valueLen);
+        }
+        json.iteratorEnd();
+    }
+}
+
+HOST_BENCH(json_iterator_20k_view)
+{
+    benchView(state, 20 * 1024);
+}
+
+HOST_BENCH(json_iterator_200k_view)
+{
+    benchView(state, 200 * 1024);
+}
+
+HOST_BENCH(json_iterator_200k_value)
+{
+    FirebaseJson json;
+    json.setJsonData(listDocumentsPage(200 * 1024).c_str());
+    state.setBytesPerOp(strlen(json.raw()));
+    state.setLabel("valueAt, copies the key and value");
+    while (state.run())
+    {
+        size_t n = json.iteratorBegin();
+        for (size_t i = 0; i < n; i++)
+        {
+            FirebaseJson::IteratorValue value = json.valueAt(i);
+            host_bench_keep(value.value.length());
+        }
+        json.iteratorEnd();
+    }
+}
+
+HOST_BENCH(json_iterator_200k_get)
+{
+    FirebaseJson json;
+    json.setJsonData(listDocumentsPage(200 * 1024).c_str());
+    state.setBytesPerOp(strlen(json.raw()));
+    state.setLabel("iteratorGet");
+    int type = 0;
+    String key, value;
+    while (state.run())
+    {
+        size_t n = json.iteratorBegin();
+        for (size_t i = 0; i < n; i++)
+        {
+            json.iteratorGet(i, type, key, value);
+            host_bench_keep(value.length());
+        }
+        json.iteratorEnd();
+    }
+}
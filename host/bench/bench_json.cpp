@@ -0,0 +1,121 @@
+// FirebaseJson and MB_JSON on the recorded Firestore responses and on the documents the sketch uploads
+
+#include <Arduino.h>
+#include "json/FirebaseJson.h"
+#include "json/MB_JSON/MB_JSON.h"
+#include "../server/LoopbackServer.h"
+#include "HostBench.h"
+
+static const char *const sensorPaths[] = {
+    "fields/AcX/bytesValue",
+    "fields/AcY/bytesValue",
+    "fields/AcZ/bytesValue",
+    "fields/Temp/bytesValue",
+    "fields/IR/bytesValue",
+    "fields/BPM/bytesValue",
+    "fields/ABPM/bytesValue",
+    "fields/T0/integerValue",
+};
+
+static const char *const sensorValue = "AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygpKissLS4vMDEyMzQ1Njc4OTo7PD0+Pw==";
+
+// The document of one upload of the sketch
+HOST_BENCH(json_set)
+{
+    FirebaseJson json;
+    state.setLabel("8 paths");
+    while (state.run())
+    {
+        json.clear();
+        for (const char *path : sensorPaths)
+            json.set(path, sensorValue);
+    }
+}
+
+HOST_BENCH(json_get)
+{
+    FirebaseJson json;
+    json.setJsonData(LoopbackServer::fixture("firestore/get_document.json").c_str());
+    FirebaseJsonData result;
+    state.setLabel("firestore/get_document.json");
+    while (state.run())
+    {
+        json.get(result, "fields/thresholds/mapValue/fields/bpmHigh/integerValue");
+        host_bench_keep(result.intValue);
+    }
+}
+
+HOST_BENCH(json_add)
+{
+    FirebaseJson json;
+    state.setLabel("8 keys");
+    while (state.run())
+    {
+        json.clear();
+        json.add("AcX", sensorValue).add("AcY", sensorValue).add("AcZ", sensorValue).add("Temp", sensorValue);
+        json.add("IR", sensorValue).add("BPM", sensorValue).add("ABPM", sensorValue).add("T0", 1700000000);
+    }
+}
+
+HOST_BENCH(json_remove)
+{
+    std::string doc = LoopbackServer::fixture("firestore/get_document.json");
+    FirebaseJson json;
+    state.setLabel("firestore/get_document.json");
+    while (state.run())
+    {
+        state.pause();
+        json.setJsonData(doc.c_str());
+        state.resume();
+        json.remove("fields/thresholds/mapValue/fields/bpmHigh");
+    }
+}
+
+HOST_BENCH(json_raw)
+{
+    FirebaseJson json;
+    json.setJsonData(LoopbackServer::fixture("firestore/get_document.json").c_str());
+    state.setBytesPerOp(strlen(json.raw()));
+    state.setLabel("firestore/get_document.json");
+    while (state.run())
+        host_bench_keep(json.raw());
+}
+
+HOST_BENCH(json_iterator)
+{
+    std::string doc = LoopbackServer::fixture("firestore/list_documents.json");
+    FirebaseJson json;
+    json.setJsonData(doc.c_str());
+    state.setBytesPerOp(doc.size());
+    state.setLabel("firestore/list_documents.json");
+    while (state.run())
+    {
+        size_t n = json.iteratorBegin();
+        for (size_t i = 0; i < n; i++)
+        {
+            FirebaseJson::IteratorView view = json.viewAt(i);
+            host_bench_keep(view.valueLen);
+        }
+        json.iteratorEnd();
+    }
+}
+
+HOST_BENCH(mb_json_parse)
+{
+    std::string doc = LoopbackServer::fixture("firestore/list_documents.json");
+    state.setBytesPerOp(doc.size());
+    state.setLabel("firestore/list_documents.json");
+    while (state.run())
+        MB_JSON_Delete(MB_JSON_ParseWithLength(doc.c_str(), doc.size()));
+}
+
+HOST_BENCH(mb_json_print)
+{
+    std::string doc = LoopbackServer::fixture("firestore/list_documents.json");
+    MB_JSON *root = MB_JSON_ParseWithLength(doc.c_str(), doc.size());
+    state.setBytesPerOp(doc.size());
+    state.setLabel("firestore/list_documents.json");
+    while (state.run())
+        MB_JSON_free(MB_JSON_PrintUnformatted(root));
+    MB_JSON_Delete(root);
+}
@@ -0,0 +1,99 @@
+// The RTDB stream parser on the recorded stream and on a burst of patch events, in reads of the
+// TCP segment size, against splitting the whole payload and parsing each event again (the way
+// FB_RTDB did before FirebaseSSEParser).
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include "FB_Utils.h"
+#include "rtdb/stream/FB_SSE_Parser.h"
+#include "../server/LoopbackServer.h"
+#include "HostBench.h"
+
+static const size_t tcpSegment = 1460;
+
+static std::string burstStream(size_t events)
+{
+    std::string s;
+    char buf[160];
+    for (size_t i = 0; i < events; i++)
+    {
+        snprintf(buf, sizeof(buf), "event: patch\ndata: {\"path\":\"/vitals\",\"data\":{\"bpm\":%u,\"spo2\":%u,\"ts\":%u}}\n\n",
+                 (unsigned)(60 + i % 40), (unsigned)(90 + i % 10), (unsigned)(1760644790 + i));
+        s += buf;
+    }
+    return s;
+}
+
+static size_t feedAll(FirebaseSSEParser &parser, const std::string &stream, size_t chunk)
+{
+    size_t events = 0;
+    for (size_t ofs = 0; ofs < stream.size(); ofs += chunk)
+    {
+        const char *p = stream.data() + ofs;
+        size_t n = std::min(chunk, stream.size() - ofs);
+        while (n > 0)
+        {
+            size_t used = parser.feed(p, n);
+            p += used;
+            n -= used;
+            if (parser.available())
+            {
+                host_bench_keep(parser.event().valueLen);
+                events++;
+            }
+        }
+    }
+    return events;
+}
+
+static void benchParser(HostBenchState &state, const std::string &stream, size_t chunk, const char *label)
+{
+    FirebaseSSEParser parser;
+    state.setBytesPerOp(stream.size());
+    state.setLabel(label);
+    while (state.run())
+        host_bench_keep(feedAll(parser, stream, chunk));
+}
+
+HOST_BENCH(sse_recorded_1_byte_reads)
+{
+    benchParser(state, LoopbackServer::fixture("rtdb/stream.sse"), 1, "rtdb/stream.sse");
+}
+
+HOST_BENCH(sse_recorded_segment_reads)
+{
+    benchParser(state, LoopbackServer::fixture("rtdb/stream.sse"), tcpSegment, "rtdb/stream.sse");
+}
+
+HOST_BENCH(sse_burst_segment_reads)
+{
+    benchParser(state, burstStream(1000), tcpSegment, "1000 patch events");
+}
+
+// The payload accumulated over the reads, split on the blank lines and each event parsed again
+HOST_BENCH(sse_burst_split_reparse)
+{
+    std::string stream = burstStream(1000);
+    StringHelper sh;
+    HttpHelper hh;
+    state.setBytesPerOp(stream.size());
+    state.setLabel("1000 patch events");
+    while (state.run())
+    {
+        MB_String payload = stream.c_str();
+        size_t pos = 0;
+        for (;;)
+        {
+            size_t end = payload.find("\n\n", pos);
+            if (end == MB_String::npos)
+                break;
+            MB_String ev = payload.substr(pos, end + 2 - pos);
+            server_response_data_t response;
+            hh.parseRespPayload(&sh, ev, response, true);
+            FirebaseJson json;
+            json.setJsonData(response.eventData);
+            host_bench_keep(response.payloadLen);
+            pos = end + 2;
+        }
+    }
+}
@@ -0,0 +1,138 @@
+// MB_String growth when the library builds a request: the Firestore createDocument request of the
+// sketch with the HttpHelper and URLHelper appends, the short keys and paths, the operator+ chains.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include "FB_Utils.h"
+#include "HostBench.h"
+
+// The ID token of the email sign-in is about 900 characters
+static MB_String idToken()
+{
+    MB_String token = "eyJhbGciOiJSUzI1NiIsImtpZCI6IjFlOWdkazcifQ.";
+    while (token.length() < 900)
+        token += "eyJpc3MiOiJodHRwczovL3NlY3VyZXRva2VuLmdvb2dsZS5jb20vZWNlMTk4In0";
+    return token;
+}
+
+// exactFit releases the spare capacity after each append, every append then reallocates as
+// MB_String did before the geometric growth
+static size_t buildRequest(const MB_String &token, size_t bodyLen, bool reserve, bool exactFit)
+{
+    HttpHelper hh;
+    URLHelper uh;
+    MB_String header;
+    auto fit = [&]()
+    {
+        if (exactFit)
+            header.shrink_to_fit();
+    };
+
+    if (reserve)
+        header.reserve(token.length() + 512);
+
+    hh.addRequestHeaderFirst(header, http_post);
+    fit();
+    header += "/v1/projects/";
+    fit();
+    header += "ece198-d2f99";
+    fit();
+    header += "/databases/(default)/documents/";
+    fit();
+    header += "SensorData";
+    fit();
+    bool hasParam = false;
+    uh.addParam(header, "documentId=", "18446744073709551615", hasParam);
+    fit();
+    hh.addRequestHeaderLast(header);
+    fit();
+    hh.addGAPIsHostHeader(header, "firestore.");
+    fit();
+    hh.addUAHeader(header);
+    fit();
+    hh.addAuthHeaderFirst(header, token_type_id_token);
+    fit();
+    header += token;
+    fit();
+    hh.addNewLine(header);
+    fit();
+    hh.addContentTypeHeader(header, "application/json");
+    fit();
+    hh.addContentLengthHeader(header, bodyLen);
+    fit();
+    hh.addConnectionHeader(header, true);
+    fit();
+    hh.addNewLine(header);
+    return header.length();
+}
+
+HOST_BENCH(mb_string_request_header)
+{
+    MB_String token = idToken();
+    state.setBytesPerOp(buildRequest(token, 1420, false, false));
+    state.setLabel("Firestore createDocument");
+    while (state.run())
+        host_bench_keep(buildRequest(token, 1420, false, false));
+}
+
+HOST_BENCH(mb_string_request_header_reserved)
+{
+    MB_String token = idToken();
+    state.setBytesPerOp(buildRequest(token, 1420, true, false));
+    state.setLabel("Firestore createDocument, reserved");
+    while (state.run())
+        host_bench_keep(buildRequest(token, 1420, true, false));
+}
+
+HOST_BENCH(mb_string_request_header_exact_fit)
+{
+    MB_String token = idToken();
+    state.setBytesPerOp(buildRequest(token, 1420, false, true));
+    state.setLabel("Firestore createDocument, no spare capacity");
+    while (state.run())
+        host_bench_keep(buildRequest(token, 1420, false, true));
+}
+
+// The field paths of the sketch fit in the inline buffer
+HOST_BENCH(mb_string_short_paths)
+{
+    static const char *const keys[] = {"AcX", "AcY", "AcZ", "Temp", "IR", "BPM", "ABPM", "T0"};
+    state.setLabel("8 paths");
+    while (state.run())
+    {
+        for (const char *key : keys)
+        {
+            MB_String path = "fields/";
+            path += key;
+            host_bench_keep(path.length());
+        }
+    }
+}
+
+HOST_BENCH(mb_string_concat_chain)
+{
+    MB_String host = "ece198-d2f99-default-rtdb.firebaseio.com";
+    MB_String path = "/SensorData/device-01/vitals";
+    state.setLabel("6 operands");
+    while (state.run())
+    {
+        MB_String url = MB_String("https://") + host + path + ".json" + "?auth=" + "key";
+        host_bench_keep(url.length());
+    }
+}
+
+// The response payload read in TCP segments
+HOST_BENCH(mb_string_read_payload)
+{
+    char segment[1460];
+    memset(segment, 'x', sizeof(segment));
+    state.setBytesPerOp(sizeof(segment) * 44);
+    state.setLabel("64 KB in 1460 byte reads");
+    while (state.run())
+    {
+        MB_String payload;
+        for (int i = 0; i < 44; i++)
+            payload.append(segment, sizeof(segment));
+        host_bench_keep(payload.length());
+    }
+}
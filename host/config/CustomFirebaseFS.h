@@ -0,0 +1,24 @@
+/**
+ * The build options of the host build, see FirebaseFS.h.
+ *
+ * Every connection goes to the loopback server (host/server) on the port it listens, a TLS port
+ * of the SSL client makes it do the handshake with the test certificate, any other port is plain.
+ */
+
+#ifndef HOST_CUSTOM_FIREBASE_FS_H
+#define HOST_CUSTOM_FIREBASE_FS_H
+
+#include <stdint.h>
+
+// The port of the running loopback server, 443 when none was started
+uint16_t host_server_port();
+
+#define FIREBASE_HOST_OVERRIDE "127.0.0.1"
+#define FIREBASE_PORT_OVERRIDE host_server_port()
+
+#include <FS.h>
+#define DEFAULT_FLASH_FS HostFS
+
+#define FIREBASE_DEFAULT_DEBUG_PORT Serial
+
+#endif
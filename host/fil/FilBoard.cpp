@@ -0,0 +1,40 @@
+#include <Arduino.h>
+#include "Esp.h"
+#include "FilHeap.h"
+#include "WiFi.h"
+#include "esp32-hal.h"
+#include "esp_timer.h"
+
+EspClass ESP;
+WiFiClass WiFi;
+
+uint32_t EspClass::getHeapSize()
+{
+    return _heapSize;
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    size_t used = FilHeap::used();
+    return used < _heapSize ? (uint32_t)(_heapSize - used) : 0;
+}
+
+uint32_t EspClass::getMinFreeHeap()
+{
+    size_t peak = FilHeap::peak();
+    return peak < _heapSize ? (uint32_t)(_heapSize - peak) : 0;
+}
+
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char *server1, const char *server2, const char *server3)
+{
+    (void)gmtOffset_sec;
+    (void)daylightOffset_sec;
+    (void)server1;
+    (void)server2;
+    (void)server3;
+}
+
+int64_t esp_timer_get_time()
+{
+    return (int64_t)micros();
+}
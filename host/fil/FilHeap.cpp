@@ -0,0 +1,149 @@
+#include "FilHeap.h"
+#include <stdint.h>
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#include <errno.h>
+#include <malloc.h>
+
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void __libc_free(void *ptr);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void *__libc_valloc(size_t size);
+    void *__libc_pvalloc(size_t size);
+}
+
+// only the firmware thread counts, the figures are read on it too
+static __thread bool fil_counted = false;
+static int64_t fil_used = 0;
+static int64_t fil_peak = 0;
+static int64_t fil_base = 0;
+
+__attribute__((constructor(101))) static void fil_heap_start()
+{
+    fil_counted = true;
+}
+
+static void *fil_add(void *ptr)
+{
+    if (ptr && fil_counted)
+    {
+        fil_used += (int64_t)malloc_usable_size(ptr);
+        if (fil_used > fil_peak)
+            fil_peak = fil_used;
+    }
+    return ptr;
+}
+
+static void fil_remove(void *ptr)
+{
+    if (ptr && fil_counted)
+        fil_used -= (int64_t)malloc_usable_size(ptr);
+}
+
+extern "C"
+{
+    void *malloc(size_t size)
+    {
+        return fil_add(__libc_malloc(size));
+    }
+
+    void free(void *ptr)
+    {
+        fil_remove(ptr);
+        __libc_free(ptr);
+    }
+
+    void *calloc(size_t count, size_t size)
+    {
+        return fil_add(__libc_calloc(count, size));
+    }
+
+    void *realloc(void *ptr, size_t size)
+    {
+        size_t old = ptr ? malloc_usable_size(ptr) : 0;
+        void *p = __libc_realloc(ptr, size);
+        // on failure the block is kept, realloc(ptr, 0) freed it
+        if (!p && size)
+            return p;
+        if (fil_counted)
+            fil_used -= (int64_t)old;
+        return fil_add(p);
+    }
+
+    void *memalign(size_t alignment, size_t size)
+    {
+        return fil_add(__libc_memalign(alignment, size));
+    }
+
+    void *aligned_alloc(size_t alignment, size_t size)
+    {
+        return fil_add(__libc_memalign(alignment, size));
+    }
+
+    int posix_memalign(void **ptr, size_t alignment, size_t size)
+    {
+        if (alignment % sizeof(void *) || (alignment & (alignment - 1)))
+            return EINVAL;
+        void *p = fil_add(__libc_memalign(alignment, size));
+        if (!p)
+            return ENOMEM;
+        *ptr = p;
+        return 0;
+    }
+
+    void *valloc(size_t size)
+    {
+        return fil_add(__libc_valloc(size));
+    }
+
+    void *pvalloc(size_t size)
+    {
+        return fil_add(__libc_pvalloc(size));
+    }
+}
+
+bool FilHeap::counting()
+{
+    return true;
+}
+
+void FilHeap::mark()
+{
+    fil_base = fil_used;
+    fil_peak = fil_used;
+}
+
+size_t FilHeap::used()
+{
+    return fil_used > fil_base ? (size_t)(fil_used - fil_base) : 0;
+}
+
+size_t FilHeap::peak()
+{
+    return fil_peak > fil_base ? (size_t)(fil_peak - fil_base) : 0;
+}
+
+#else
+
+bool FilHeap::counting()
+{
+    return false;
+}
+
+void FilHeap::mark() {}
+
+size_t FilHeap::used()
+{
+    return 0;
+}
+
+size_t FilHeap::peak()
+{
+    return 0;
+}
+
+#endif
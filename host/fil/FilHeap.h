@@ -0,0 +1,27 @@
+/**
+ * The heap the firmware holds in the firmware-in-the-loop build.
+ *
+ * malloc and its family are counted on the thread that started the process, the firmware thread,
+ * not on the threads of the loopback server. The bytes are the usable sizes of glibc; the pointers
+ * and size_t of the host are 8 bytes where the ESP32 has 4, so the figures are an upper bound of the
+ * board ones. The counting needs glibc and is off under AddressSanitizer, which has its own malloc,
+ * counting() then returns false and the figures are 0.
+ */
+
+#ifndef FIL_HEAP_H
+#define FIL_HEAP_H
+
+#include <stddef.h>
+
+class FilHeap
+{
+public:
+    static bool counting();
+
+    // The used and the peak bytes are counted from here
+    static void mark();
+    static size_t used();
+    static size_t peak();
+};
+
+#endif
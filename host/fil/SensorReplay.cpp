@@ -0,0 +1,288 @@
+#include "SensorReplay.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+bool SensorTrace::load(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+    _times.clear();
+    _rows.clear();
+    std::string line;
+    std::getline(file, line);
+    while (std::getline(file, line))
+    {
+        if (line.empty())
+            continue;
+        std::stringstream fields(line);
+        std::string field;
+        std::vector<int32_t> row;
+        while (std::getline(fields, field, ','))
+            row.push_back((int32_t)strtol(field.c_str(), nullptr, 10));
+        if (row.size() < 2)
+            continue;
+        _times.push_back((uint32_t)row[0]);
+        _rows.emplace_back(row.begin() + 1, row.end());
+    }
+    if (_rows.empty())
+        return false;
+    // the trace repeats after its last row, one row interval later
+    uint32_t step = _times.size() > 1 ? _times[1] - _times[0] : 1;
+    _period = _times.back() + (step ? step : 1);
+    return true;
+}
+
+const std::vector<int32_t> &SensorTrace::at(uint32_t ms) const
+{
+    uint32_t t = ms % _period;
+    // the last row at or before t
+    size_t i = std::upper_bound(_times.begin(), _times.end(), t) - _times.begin();
+    return _rows[i ? i - 1 : 0];
+}
+
+void RegisterDevice::receive(const uint8_t *data, size_t len)
+{
+    if (len == 0)
+        return;
+    _pointer = data[0];
+    for (size_t i = 1; i < len; i++)
+        writeRegister(_pointer++, data[i]);
+}
+
+void RegisterDevice::request(uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+        data[i] = readRegister(_pointer++);
+}
+
+Mpu6050Replay::Mpu6050Replay(const SensorTrace &trace, uint32_t startMs) : _trace(trace), _startMs(startMs)
+{
+    _regs[0x6B] = 0x40; // PWR_MGMT_1, asleep after power on
+    _regs[0x75] = 0x68; // WHO_AM_I
+}
+
+void Mpu6050Replay::request(uint8_t *data, size_t len)
+{
+    // the output registers are latched at the start of the burst read
+    if (!(_regs[0x6B] & 0x40))
+    {
+        const std::vector<int32_t> &row = _trace.at(millis() - _startMs);
+        for (size_t i = 0; i < 7 && i < row.size(); i++)
+        {
+            _regs[0x3B + 2 * i] = (uint8_t)(row[i] >> 8);
+            _regs[0x3B + 2 * i + 1] = (uint8_t)row[i];
+        }
+    }
+    RegisterDevice::request(data, len);
+}
+
+Max30205Replay::Max30205Replay(const SensorTrace &trace, uint32_t startMs) : _trace(trace), _startMs(startMs)
+{
+    _regs[0x02] = 0x4B; // THYST 75 °C
+    _regs[0x03] = 0x50; // TOS 80 °C
+}
+
+void Max30205Replay::request(uint8_t *data, size_t len)
+{
+    // the temperature register is 16 bits, the pointer does not move on
+    if (_pointer != 0x00)
+    {
+        RegisterDevice::request(data, len);
+        return;
+    }
+    uint16_t temp = (uint16_t)_trace.at(millis() - _startMs)[0];
+    for (size_t i = 0; i < len; i++)
+        data[i] = i % 2 ? (uint8_t)temp : (uint8_t)(temp >> 8);
+}
+
+// The registers of the MAX30102 datasheet
+enum
+{
+    MAX30102_FIFOWRITEPTR = 0x04,
+    MAX30102_FIFOOVERFLOW = 0x05,
+    MAX30102_FIFOREADPTR = 0x06,
+    MAX30102_FIFODATA = 0x07,
+    MAX30102_FIFOCONFIG = 0x08,
+    MAX30102_MODECONFIG = 0x09,
+    MAX30102_PARTICLECONFIG = 0x0A,
+    MAX30102_REVISIONID = 0xFE,
+    MAX30102_PARTID = 0xFF,
+};
+
+Max30102Replay::Max30102Replay(const SensorTrace &trace, uint32_t startMs) : _trace(trace), _startMs(startMs)
+{
+    _regs[MAX30102_REVISIONID] = 0x03;
+    _regs[MAX30102_PARTID] = 0x15;
+}
+
+void Max30102Replay::request(uint8_t *data, size_t len)
+{
+    // the burst read of FIFO_DATA stays on it
+    if (_pointer != MAX30102_FIFODATA)
+    {
+        RegisterDevice::request(data, len);
+        return;
+    }
+    for (size_t i = 0; i < len; i++)
+        data[i] = readRegister(MAX30102_FIFODATA);
+}
+
+uint32_t Max30102Replay::sampleRate() const
+{
+    static const uint32_t rates[] = {50, 100, 200, 400, 800, 1000, 1600, 3200};
+    uint32_t average = 1u << std::min(_regs[MAX30102_FIFOCONFIG] >> 5, 5);
+    return rates[(_regs[MAX30102_PARTICLECONFIG] >> 2) & 0x07] / average;
+}
+
+uint8_t Max30102Replay::activeLeds() const
+{
+    switch (_regs[MAX30102_MODECONFIG] & 0x07)
+    {
+    case 0x02:
+        return 1;
+    case 0x03:
+        return 2;
+    case 0x07:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+// A new configuration starts the conversions again from now
+void Max30102Replay::restart()
+{
+    fill();
+    _t0 = millis();
+    _produced = 0;
+}
+
+void Max30102Replay::fill()
+{
+    if (!activeLeds() || (_regs[MAX30102_MODECONFIG] & 0x80))
+        return;
+    uint32_t rate = sampleRate();
+    uint64_t due = (uint64_t)(millis() - _t0) * rate / 1000;
+    if (due <= _produced)
+        return;
+    // only the last 32 of a long gap can be in the FIFO, the others overflowed
+    if (due - _produced > 32)
+    {
+        uint64_t skipped = due - _produced - 32;
+        _overflowed += (uint32_t)skipped;
+        _producedTotal += (uint32_t)skipped;
+        _regs[MAX30102_FIFOOVERFLOW] = (uint8_t)std::min<uint64_t>(_regs[MAX30102_FIFOOVERFLOW] + skipped, 31);
+        _produced = due - 32;
+    }
+    bool rollover = _regs[MAX30102_FIFOCONFIG] & 0x10;
+    for (; _produced < due; _produced++)
+    {
+        _producedTotal++;
+        if (_count == 32)
+        {
+            _overflowed++;
+            if (_regs[MAX30102_FIFOOVERFLOW] < 31)
+                _regs[MAX30102_FIFOOVERFLOW]++;
+            if (!rollover)
+                continue;
+            // the oldest sample is overwritten
+            _rd = (_rd + 1) & 31;
+            _count--;
+        }
+        const std::vector<int32_t> &row = _trace.at(_t0 + (uint32_t)(_produced * 1000 / rate) - _startMs);
+        _fifo[_wr] = {(uint32_t)row[0], row.size() > 1 ? (uint32_t)row[1] : 0};
+        _wr = (_wr + 1) & 31;
+        _count++;
+    }
+}
+
+uint8_t Max30102Replay::readRegister(uint8_t reg)
+{
+    switch (reg)
+    {
+    case MAX30102_FIFOWRITEPTR:
+        fill();
+        return _wr;
+    case MAX30102_FIFOREADPTR:
+        return _rd;
+    case MAX30102_FIFOOVERFLOW:
+        return _regs[reg];
+    case MAX30102_FIFODATA:
+    {
+        // the read pointer moves on once all the bytes of a sample are read
+        if (_bytes.empty() && _count)
+        {
+            const Sample &sample = _fifo[_rd];
+            uint32_t leds[] = {sample.red, sample.ir, 0};
+            for (uint8_t i = 0; i < activeLeds(); i++)
+            {
+                uint32_t value = leds[i] & 0x3FFFF;
+                _bytes.push_back((uint8_t)(value >> 16));
+                _bytes.push_back((uint8_t)(value >> 8));
+                _bytes.push_back((uint8_t)value);
+            }
+            _rd = (_rd + 1) & 31;
+            _count--;
+        }
+        if (_bytes.empty())
+            return 0;
+        uint8_t value = _bytes.front();
+        _bytes.pop_front();
+        return value;
+    }
+    default:
+        return _regs[reg];
+    }
+}
+
+void Max30102Replay::writeRegister(uint8_t reg, uint8_t value)
+{
+    switch (reg)
+    {
+    case MAX30102_FIFOWRITEPTR:
+        _wr = value & 31;
+        _count = (_wr - _rd) & 31;
+        _bytes.clear();
+        break;
+    case MAX30102_FIFOREADPTR:
+        _rd = value & 31;
+        _count = (_wr - _rd) & 31;
+        _bytes.clear();
+        break;
+    case MAX30102_FIFOOVERFLOW:
+        _regs[reg] = value & 31;
+        break;
+    case MAX30102_MODECONFIG:
+        if (value & 0x40)
+        {
+            // the reset completes at once, all the registers are back to their power on values
+            uint8_t rev = _regs[MAX30102_REVISIONID];
+            uint8_t part = _regs[MAX30102_PARTID];
+            memset(_regs, 0, sizeof(_regs));
+            _regs[MAX30102_REVISIONID] = rev;
+            _regs[MAX30102_PARTID] = part;
+            _wr = _rd = _count = 0;
+            _bytes.clear();
+            restart();
+            break;
+        }
+        _regs[reg] = value;
+        restart();
+        break;
+    case MAX30102_FIFOCONFIG:
+    case MAX30102_PARTICLECONFIG:
+        _regs[reg] = value;
+        restart();
+        break;
+    case MAX30102_FIFODATA:
+    case MAX30102_REVISIONID:
+    case MAX30102_PARTID:
+        break;
+    default:
+        _regs[reg] = value;
+        break;
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * The sensors of the wearable on the I2C bus of the host build (shim/Wire.h), each replays a trace
+ * of host/fixtures/i2c through its register map, so the unmodified drivers of src/main and the
+ * SparkFun MAX3010x library read them as they read the board.
+ *
+ * The trace row at the time millis() - start is returned and the trace repeats. The MAX30102 fills
+ * its 32 sample FIFO at the rate of its configuration, the samples that the firmware does not read
+ * in time overflow as on the chip.
+ */
+
+#ifndef FIL_SENSOR_REPLAY_H
+#define FIL_SENSOR_REPLAY_H
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include <Wire.h>
+
+class SensorTrace
+{
+public:
+    // The CSV file with a header line, the first column is the time in ms
+    bool load(const std::string &path);
+
+    // The values of the row at the time (the time column excluded)
+    const std::vector<int32_t> &at(uint32_t ms) const;
+
+    size_t rows() const { return _rows.size(); }
+
+private:
+    std::vector<uint32_t> _times;
+    std::vector<std::vector<int32_t>> _rows;
+    uint32_t _period = 1;
+};
+
+// Register pointer and map of 256 registers, the pointer increments on each byte
+class RegisterDevice : public I2CDevice
+{
+public:
+    void receive(const uint8_t *data, size_t len) override;
+    void request(uint8_t *data, size_t len) override;
+
+protected:
+    virtual uint8_t readRegister(uint8_t reg) { return _regs[reg]; }
+    virtual void writeRegister(uint8_t reg, uint8_t value) { _regs[reg] = value; }
+
+    uint8_t _regs[256] = {};
+    uint8_t _pointer = 0;
+};
+
+// MPU6050 at 0x68, the accelerometer, temperature and gyro registers (0x3B-0x48) follow the trace
+// once PWR_MGMT_1 took it out of sleep
+class Mpu6050Replay : public RegisterDevice
+{
+public:
+    Mpu6050Replay(const SensorTrace &trace, uint32_t startMs);
+    void request(uint8_t *data, size_t len) override;
+
+private:
+    const SensorTrace &_trace;
+    uint32_t _startMs;
+};
+
+// MAX30205 at 0x48, the 16-bit temperature register 0x00 follows the trace
+class Max30205Replay : public RegisterDevice
+{
+public:
+    Max30205Replay(const SensorTrace &trace, uint32_t startMs);
+    void request(uint8_t *data, size_t len) override;
+
+private:
+    const SensorTrace &_trace;
+    uint32_t _startMs;
+};
+
+// MAX30102 at 0x57, part ID 0x15, the FIFO of red/IR samples at the configured rate and averaging
+class Max30102Replay : public RegisterDevice
+{
+public:
+    Max30102Replay(const SensorTrace &trace, uint32_t startMs);
+    void request(uint8_t *data, size_t len) override;
+
+    // The samples that overflowed the FIFO since start
+    uint32_t overflowed() const { return _overflowed; }
+    uint32_t produced() const { return _producedTotal; }
+
+protected:
+    uint8_t readRegister(uint8_t reg) override;
+    void writeRegister(uint8_t reg, uint8_t value) override;
+
+private:
+    struct Sample
+    {
+        uint32_t red;
+        uint32_t ir;
+    };
+
+    void restart();
+    void fill();
+    uint32_t sampleRate() const;
+    uint8_t activeLeds() const;
+
+    const SensorTrace &_trace;
+    uint32_t _startMs;
+    uint32_t _t0 = 0;
+    uint64_t _produced = 0;
+    uint32_t _producedTotal = 0;
+    uint32_t _overflowed = 0;
+    Sample _fifo[32] = {};
+    uint8_t _wr = 0;
+    uint8_t _rd = 0;
+    uint8_t _count = 0;
+    std::deque<uint8_t> _bytes;
+};
+
+#endif
@@ -0,0 +1,281 @@
+// The firmware-in-the-loop harness: the sketch of src/main (setup/loop, Logger, the three sensors)
+// runs on the host, its sensors replay the traces of host/fixtures/i2c on the simulated I2C bus and
+// it uploads to a fake Firestore, the loopback server with the latency and the loss of the link.
+//
+//   firmware_fil [--duration-s=<s>] [--latency-ms=<min>[:<max>]] [--loss=<rate>] [--seed=<n>] [--tls]
+//                [--heap-kb=<kb>] [--traces=<dir>] [--serial-log=<file>] [--json=<file>] [--check]
+//
+// The report is the achieved sampling rate, the loop time histogram, the upload latency
+// percentiles, the heap high-water mark and the samples lost, printed and written to the JSON file
+// (fil_results.json by default). The periods are those the firmware was built with, one executable
+// per RECORDING_PERIOD_MS/LOGGING_PERIOD_MS pair (FIL_SWEEP in host/CMakeLists.txt, fil/sweep.py).
+
+#include <Arduino.h>
+#include <HostClient.h>
+#include "main.ino"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "../server/LoopbackServer.h"
+#include "FilHeap.h"
+#include "SensorReplay.h"
+
+static HostClient fil_client;
+
+static void fil_network_connection() {}
+
+static void fil_network_status()
+{
+    fbdo.setNetworkStatus(true);
+}
+
+struct FilOptions
+{
+    uint32_t durationS = 30;
+    uint32_t latencyMin = 80;
+    uint32_t latencyMax = 250;
+    double loss = 0;
+    uint32_t seed = 1;
+    bool tls = false;
+    uint32_t heapKb = 320;
+    std::string traces = HOST_FIXTURES_DIR "/i2c";
+    std::string serialLog = "fil_serial.log";
+    std::string jsonPath = "fil_results.json";
+    bool check = false;
+};
+
+static bool fil_parse(int argc, char **argv, FilOptions &opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        if (strncmp(arg, "--duration-s=", 13) == 0)
+            opt.durationS = (uint32_t)strtoul(arg + 13, nullptr, 10);
+        else if (strncmp(arg, "--latency-ms=", 13) == 0)
+        {
+            char *end = nullptr;
+            opt.latencyMin = (uint32_t)strtoul(arg + 13, &end, 10);
+            opt.latencyMax = *end == ':' ? (uint32_t)strtoul(end + 1, nullptr, 10) : opt.latencyMin;
+        }
+        else if (strncmp(arg, "--loss=", 7) == 0)
+            opt.loss = strtod(arg + 7, nullptr);
+        else if (strncmp(arg, "--seed=", 7) == 0)
+            opt.seed = (uint32_t)strtoul(arg + 7, nullptr, 10);
+        else if (strcmp(arg, "--tls") == 0)
+            opt.tls = true;
+        else if (strncmp(arg, "--heap-kb=", 10) == 0)
+            opt.heapKb = (uint32_t)strtoul(arg + 10, nullptr, 10);
+        else if (strncmp(arg, "--traces=", 9) == 0)
+            opt.traces = arg + 9;
+        else if (strncmp(arg, "--serial-log=", 13) == 0)
+            opt.serialLog = arg + 13;
+        else if (strncmp(arg, "--json=", 7) == 0)
+            opt.jsonPath = arg + 7;
+        else if (strcmp(arg, "--check") == 0)
+            opt.check = true;
+        else
+            return false;
+    }
+    return true;
+}
+
+// The value at the percentile of the sorted values, nearest rank
+static uint32_t fil_percentile(const std::vector<uint32_t> &sorted, uint32_t p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t rank = ((uint64_t)sorted.size() * p + 99) / 100;
+    return sorted[rank ? rank - 1 : 0];
+}
+
+struct FilDistribution
+{
+    std::vector<uint32_t> values;
+
+    void sort() { std::sort(values.begin(), values.end()); }
+    uint32_t p(uint32_t percentile) const { return fil_percentile(values, percentile); }
+    uint32_t max() const { return values.empty() ? 0 : values.back(); }
+    double mean() const
+    {
+        double sum = 0;
+        for (uint32_t v : values)
+            sum += v;
+        return values.empty() ? 0 : sum / values.size();
+    }
+    std::string json() const
+    {
+        char buf[160];
+        snprintf(buf, sizeof(buf), "{\"count\": %zu, \"mean\": %.1f, \"p50\": %u, \"p90\": %u, \"p99\": %u, \"max\": %u}",
+                 values.size(), mean(), p(50), p(90), p(99), max());
+        return buf;
+    }
+};
+
+// The power of two buckets of the firmware Histogram (Profiler.h), bucket i counts [2^(i-1), 2^i)
+static std::vector<uint32_t> fil_buckets(const std::vector<uint32_t> &values)
+{
+    std::vector<uint32_t> counts;
+    for (uint32_t v : values)
+    {
+        size_t i = v ? (size_t)(32 - __builtin_clz(v)) : 0;
+        if (counts.size() <= i)
+            counts.resize(i + 1);
+        counts[i]++;
+    }
+    return counts;
+}
+
+int main(int argc, char **argv)
+{
+    FilOptions opt;
+    if (!fil_parse(argc, argv, opt))
+    {
+        fprintf(stderr,
+                "usage: %s [--duration-s=<s>] [--latency-ms=<min>[:<max>]] [--loss=<rate>] [--seed=<n>] [--tls]\n"
+                "       [--heap-kb=<kb>] [--traces=<dir>] [--serial-log=<file>] [--json=<file>] [--check]\n",
+                argv[0]);
+        return 2;
+    }
+
+    SensorTrace mpuTrace, tempTrace, pulseTrace;
+    if (!mpuTrace.load(opt.traces + "/mpu6050.csv") || !tempTrace.load(opt.traces + "/max30205.csv") ||
+        !pulseTrace.load(opt.traces + "/max30102.csv"))
+    {
+        fprintf(stderr, "firmware_fil: can't read the traces of %s\n", opt.traces.c_str());
+        return 1;
+    }
+
+    // the fake Firestore of the project of Logger.h
+    LoopbackServer server(opt.tls);
+    server.onFixture("POST", "/identitytoolkit/v3/relyingparty/verifyPassword", "token/verify_password.json");
+    server.onFixture("POST", "/v1/token", "token/refresh.json");
+    server.onFixture("POST", "/v1/projects/" PROJECT_ID "/databases/(default)/documents/" PATH, "firestore/create_document.json");
+    server.setLatency(opt.latencyMin, opt.latencyMax);
+    server.setLoss(opt.loss, opt.seed);
+    if (!server.start())
+    {
+        fprintf(stderr, "firmware_fil: the loopback server did not start\n");
+        return 1;
+    }
+
+    uint32_t startMs = millis();
+    Mpu6050Replay mpu(mpuTrace, startMs);
+    Max30205Replay temp(tempTrace, startMs);
+    Max30102Replay pulse(pulseTrace, startMs);
+    Wire.attach(Constants::Accelerometer::ADDRESS, &mpu);
+    Wire.attach(Constants::TemperatureSensor::ADDRESS, &temp);
+    Wire.attach(MAX30105_ADDRESS, &pulse);
+    Wire.setBusTiming(true);
+
+    FILE *serialLog = fopen(opt.serialLog.c_str(), "w");
+    if (!serialLog)
+    {
+        fprintf(stderr, "firmware_fil: can't write %s\n", opt.serialLog.c_str());
+        return 1;
+    }
+    // line buffered, the log is up to date when a run is stopped
+    setvbuf(serialLog, nullptr, _IOLBF, 0);
+    Serial.setOutput(serialLog);
+    fbdo.setGenericClient(&fil_client, fil_network_connection, fil_network_status);
+    ESP.setHeapSize(opt.heapKb * 1024);
+
+    printf("firmware_fil: RECORDING_PERIOD=%u ms LOGGING_PERIOD=%u ms, %u s, latency %u-%u ms, loss %.2f, %s\n",
+           Constants::RECORDING_PERIOD, Constants::LOGGING_PERIOD, opt.durationS, opt.latencyMin, opt.latencyMax,
+           opt.loss, opt.tls ? "TLS" : "plain");
+    fflush(stdout);
+
+    FilHeap::mark();
+    unsigned long setupUs = micros();
+    setup();
+    setupUs = micros() - setupUs;
+
+    FilDistribution loops, uploads;
+    uint32_t uploadsSeen = 0;
+    unsigned long runStart = micros();
+    unsigned long runEnd = runStart + (unsigned long)opt.durationS * 1000000UL;
+    while (micros() < runEnd)
+    {
+        unsigned long t = micros();
+        loop();
+        uint32_t us = (uint32_t)(micros() - t);
+        loops.values.push_back(us);
+        // the loop that uploaded, its time is the time of the createDocument call and the sampling it held up
+        if (Profiler::totals().uploads != uploadsSeen)
+        {
+            uploadsSeen = Profiler::totals().uploads;
+            uploads.values.push_back((us + 500) / 1000);
+        }
+    }
+    double elapsedMs = (micros() - runStart) / 1000.0;
+    fflush(serialLog);
+    Serial.setOutput(nullptr);
+    fclose(serialLog);
+    server.stop();
+    loops.sort();
+    uploads.sort();
+
+    const Profiler::Totals &totals = Profiler::totals();
+    // a row is stamped once more than RECORDING_PERIOD has passed
+    uint32_t expected = (uint32_t)(elapsedMs / Constants::RECORDING_PERIOD);
+    uint32_t shortfall = expected > totals.samples ? expected - totals.samples : 0;
+    double rate = elapsedMs > 0 ? totals.samples * 1000.0 / elapsedMs : 0;
+    size_t hwm = FilHeap::peak();
+
+    printf("\n%-28s %u ms\n", "setup", (uint32_t)(setupUs / 1000));
+    printf("%-28s %u in %.1f s, %.2f Hz of %.2f Hz\n", "sample rows", totals.samples, elapsedMs / 1000, rate,
+           1000.0 / Constants::RECORDING_PERIOD);
+    printf("%-28s %u (firmware), %u short of %u expected\n", "rows lost", totals.lost, shortfall, expected);
+    printf("%-28s %u of %u\n", "MAX30102 FIFO overflow", pulse.overflowed(), pulse.produced());
+    printf("%-28s n=%zu mean=%.0f p50=%u p90=%u p99=%u max=%u\n", "loop us", loops.values.size(), loops.mean(),
+           loops.p(50), loops.p(90), loops.p(99), loops.max());
+    std::vector<uint32_t> buckets = fil_buckets(loops.values);
+    for (size_t i = 0; i < buckets.size(); i++)
+    {
+        if (!buckets[i])
+            continue;
+        uint32_t bar = (uint32_t)((uint64_t)buckets[i] * 50 / loops.values.size());
+        printf("  < %-10u %8u %s\n", i ? (uint32_t)(1u << i) : 1, buckets[i], std::string(bar, '#').c_str());
+    }
+    printf("%-28s n=%zu failed=%u p50=%u p90=%u p99=%u max=%u\n", "upload ms", uploads.values.size(), totals.failed,
+           uploads.p(50), uploads.p(90), uploads.p(99), uploads.max());
+    if (FilHeap::counting())
+        printf("%-28s %zu bytes, min free %u of %u\n", "heap high-water mark", hwm, ESP.getMinFreeHeap(), ESP.getHeapSize());
+    else
+        printf("%-28s not counted in this build\n", "heap high-water mark");
+    printf("%-28s %zu requests, %u dropped, %u connections\n", "server", server.requestCount(), server.dropped(),
+           server.connections());
+
+    FILE *f = fopen(opt.jsonPath.c_str(), "w");
+    if (!f)
+    {
+        fprintf(stderr, "firmware_fil: can't write %s\n", opt.jsonPath.c_str());
+        return 1;
+    }
+    fprintf(f, "{\n  \"recording_period_ms\": %u,\n  \"logging_period_ms\": %u,\n", Constants::RECORDING_PERIOD,
+            Constants::LOGGING_PERIOD);
+    fprintf(f, "  \"latency_ms\": [%u, %u],\n  \"loss\": %.3f,\n  \"tls\": %s,\n  \"duration_ms\": %.0f,\n  \"setup_ms\": %u,\n",
+            opt.latencyMin, opt.latencyMax, opt.loss, opt.tls ? "true" : "false", elapsedMs, (uint32_t)(setupUs / 1000));
+    fprintf(f, "  \"samples\": %u,\n  \"rate_hz\": %.3f,\n  \"expected_rows\": %u,\n  \"rows_lost\": %u,\n  \"rows_short\": %u,\n",
+            totals.samples, rate, expected, totals.lost, shortfall);
+    fprintf(f, "  \"fifo_overflow\": %u,\n  \"fifo_samples\": %u,\n", pulse.overflowed(), pulse.produced());
+    fprintf(f, "  \"loop_us\": %s,\n  \"loop_us_buckets\": [", loops.json().c_str());
+    for (size_t i = 0; i < buckets.size(); i++)
+        fprintf(f, "%s%u", i ? ", " : "", buckets[i]);
+    fprintf(f, "],\n  \"upload_ms\": %s,\n  \"uploads_failed\": %u,\n", uploads.json().c_str(), totals.failed);
+    if (FilHeap::counting())
+        fprintf(f, "  \"heap_hwm_bytes\": %zu,\n  \"heap_min_free_bytes\": %u,\n", hwm, ESP.getMinFreeHeap());
+    else
+        fprintf(f, "  \"heap_hwm_bytes\": null,\n  \"heap_min_free_bytes\": null,\n");
+    fprintf(f, "  \"server\": {\"requests\": %zu, \"dropped\": %u, \"connections\": %u}\n}\n", server.requestCount(),
+            server.dropped(), server.connections());
+    fclose(f);
+    printf("results written to %s\n", opt.jsonPath.c_str());
+
+    // the smoke run of ctest: the firmware sampled and got a batch through
+    if (opt.check && (totals.samples == 0 || uploads.values.size() <= totals.failed))
+    {
+        fprintf(stderr, "firmware_fil: no sample row or no upload went through\n");
+        return 1;
+    }
+    return 0;
+}
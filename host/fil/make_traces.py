@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""Write the I2C sensor traces of host/fixtures/i2c that the firmware-in-the-loop harness replays.
+
+The traces are in the register units of each device, one row per conversion:
+
+  mpu6050.csv   t_ms,ax,ay,az,temp,gx,gy,gz   100 Hz, +-2 g (16384/g), +-250 dps (131/dps)
+  max30205.csv  t_ms,temp                     10 Hz, 1/256 degC
+  max30102.csv  t_ms,red,ir                   100 Hz (400 sps, 4 averaged), 18-bit counts
+
+They are synthetic: a wrist at rest with arm swings, skin temperature settling, and a finger on
+the oximeter with a pulse between 66 and 80 bpm. Replace them with recordings of the board in the
+same format to replay the real signals; the output is the same for the same seed.
+
+  python3 host/fil/make_traces.py [--seconds 20] [--seed 198] [--out host/fixtures/i2c]
+"""
+
+import argparse
+import math
+import os
+import random
+
+
+def clamp(value, low, high):
+    return max(low, min(high, int(round(value))))
+
+
+def mpu6050(seconds, rng):
+    rows = []
+    for i in range(seconds * 100):
+        t = i / 100.0
+        # arm swing of 1.2 s every 6 s, else at rest with the watch face up
+        swing = math.sin(2 * math.pi * t / 1.2) if (t % 6.0) < 2.4 else 0.0
+        ax = 0.05 * math.sin(2 * math.pi * 0.1 * t) + 0.6 * swing + rng.gauss(0, 0.01)
+        ay = 0.02 + 0.3 * swing * math.cos(2 * math.pi * t / 1.2) + rng.gauss(0, 0.01)
+        az = 0.98 - 0.25 * abs(swing) + rng.gauss(0, 0.01)
+        gx = 40 * swing + rng.gauss(0, 0.5)
+        gy = 15 * swing * math.sin(2 * math.pi * t / 0.6) + rng.gauss(0, 0.5)
+        gz = rng.gauss(0, 0.5)
+        die = 30.0 + 2.0 * (1 - math.exp(-t / 30.0))
+        rows.append((i * 10,
+                     clamp(ax * 16384, -32768, 32767), clamp(ay * 16384, -32768, 32767), clamp(az * 16384, -32768, 32767),
+                     clamp((die - 36.53) * 340, -32768, 32767),
+                     clamp(gx * 131, -32768, 32767), clamp(gy * 131, -32768, 32767), clamp(gz * 131, -32768, 32767)))
+    return "t_ms,ax,ay,az,temp,gx,gy,gz", rows
+
+
+def max30205(seconds, rng):
+    rows = []
+    for i in range(seconds * 10):
+        t = i / 10.0
+        temp = 36.2 + 0.4 * (1 - math.exp(-t / 15.0)) + rng.gauss(0, 0.01)
+        rows.append((i * 100, clamp(temp * 256, 0, 0xffff)))
+    return "t_ms,temp", rows
+
+
+def max30102(seconds, rng):
+    rows = []
+    phase = 0.0
+    for i in range(seconds * 100):
+        t = i / 100.0
+        bpm = 73 + 7 * math.sin(2 * math.pi * t / 17.0)
+        phase += bpm / 60.0 / 100.0
+        p = phase % 1.0
+        # systolic peak and the dicrotic wave, the absorption rises with the blood volume
+        pulse = math.exp(-((p - 0.2) / 0.08) ** 2) + 0.35 * math.exp(-((p - 0.55) / 0.1) ** 2)
+        wander = math.sin(2 * math.pi * 0.2 * t)
+        ir = 50000 - 300 * pulse + 150 * wander + rng.gauss(0, 6)
+        red = 42000 - 180 * pulse + 110 * wander + rng.gauss(0, 6)
+        rows.append((i * 10, clamp(red, 0, 0x3ffff), clamp(ir, 0, 0x3ffff)))
+    return "t_ms,red,ir", rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--seconds", type=int, default=20)
+    parser.add_argument("--seed", type=int, default=198)
+    parser.add_argument("--out", default=os.path.join(os.path.dirname(__file__), "..", "fixtures", "i2c"))
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    for name, make in (("mpu6050", mpu6050), ("max30205", max30205), ("max30102", max30102)):
+        header, rows = make(args.seconds, random.Random("%s-%d" % (name, args.seed)))
+        with open(os.path.join(args.out, name + ".csv"), "w") as f:
+            f.write(header + "\n")
+            for row in rows:
+                f.write(",".join(str(v) for v in row) + "\n")
+
+
+if __name__ == "__main__":
+    main()
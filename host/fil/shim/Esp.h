@@ -0,0 +1,28 @@
+/**
+ * The ESP of the firmware-in-the-loop build, the heap is the one of the board (FIL_HEAP_SIZE, set by
+ * the harness) less the bytes the firmware holds on the host heap, see FilHeap.h.
+ */
+
+#ifndef FIL_ESP_H
+#define FIL_ESP_H
+
+#include <stdint.h>
+
+class EspClass
+{
+public:
+    uint32_t getHeapSize();
+    uint32_t getFreeHeap();
+    // The lowest free heap since the harness started the firmware
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+    void setHeapSize(uint32_t bytes) { _heapSize = bytes; }
+    void restart() {}
+
+private:
+    uint32_t _heapSize = 320 * 1024;
+};
+
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,2 @@
+// The Arduino header before 1.0, the SparkFun MAX3010x library includes it when ARDUINO is not set
+#include <Arduino.h>
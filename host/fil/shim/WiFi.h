@@ -0,0 +1,47 @@
+/**
+ * The WiFi of the firmware-in-the-loop build, the station is connected once begin() was called.
+ * The library reaches the loopback server through the HostClient that the harness sets with
+ * fbdo.setGenericClient().
+ */
+
+#ifndef FIL_WIFI_H
+#define FIL_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass
+{
+public:
+    wl_status_t begin(const char *ssid, const char *passphrase = nullptr)
+    {
+        (void)ssid;
+        (void)passphrase;
+        _status = WL_CONNECTED;
+        return _status;
+    }
+    wl_status_t status() { return _status; }
+    bool isConnected() { return _status == WL_CONNECTED; }
+    bool reconnect() { return isConnected(); }
+    bool disconnect()
+    {
+        _status = WL_DISCONNECTED;
+        return true;
+    }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+
+private:
+    wl_status_t _status = WL_IDLE_STATUS;
+};
+
+extern WiFiClass WiFi;
+
+#endif
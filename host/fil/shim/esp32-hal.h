@@ -0,0 +1,14 @@
+/**
+ * The Arduino core of the ESP32 in the firmware-in-the-loop build, the host Arduino API and the SNTP
+ * start. The system clock of the host is already set, configTime() does nothing.
+ */
+
+#ifndef FIL_ESP32_HAL_H
+#define FIL_ESP32_HAL_H
+
+#include <Arduino.h>
+
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char *server1, const char *server2 = nullptr,
+                const char *server3 = nullptr);
+
+#endif
@@ -0,0 +1,12 @@
+/**
+ * The esp_timer of the firmware-in-the-loop build, the microseconds since the start of the process.
+ */
+
+#ifndef FIL_ESP_TIMER_H
+#define FIL_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time();
+
+#endif
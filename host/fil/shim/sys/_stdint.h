@@ -0,0 +1,2 @@
+// The newlib header of the ESP32 toolchain
+#include <stdint.h>
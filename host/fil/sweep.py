@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Sweep RECORDING_PERIOD/LOGGING_PERIOD of the firmware in the firmware-in-the-loop harness.
+
+The periods are build flags of the firmware (src/main/Constants.h), the sweep configures the host
+build with one firmware_fil_<rec>_<log> executable for each pair (FIL_SWEEP), builds them, runs each
+against the same link and writes one row per pair:
+
+  python3 host/fil/sweep.py --recording 50,100,200 --logging 1000,2000,5000 \\
+      --duration-s 60 --latency-ms 80:250 --loss 0.05 --out fil_sweep.csv
+
+The JSON result of each run is kept next to the CSV (fil_<rec>_<log>.json), with its serial log.
+"""
+
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+
+COLUMNS = [
+    ("rec_ms", lambda r: r["recording_period_ms"]),
+    ("log_ms", lambda r: r["logging_period_ms"]),
+    ("rate_hz", lambda r: "%.2f" % r["rate_hz"]),
+    ("target_hz", lambda r: "%.2f" % (1000.0 / r["recording_period_ms"])),
+    ("rows_lost", lambda r: r["rows_lost"]),
+    ("rows_short", lambda r: r["rows_short"]),
+    ("fifo_overflow", lambda r: r["fifo_overflow"]),
+    ("loop_p50_us", lambda r: r["loop_us"]["p50"]),
+    ("loop_p99_us", lambda r: r["loop_us"]["p99"]),
+    ("loop_max_us", lambda r: r["loop_us"]["max"]),
+    ("uploads", lambda r: r["upload_ms"]["count"]),
+    ("failed", lambda r: r["uploads_failed"]),
+    ("upload_p50_ms", lambda r: r["upload_ms"]["p50"]),
+    ("upload_p90_ms", lambda r: r["upload_ms"]["p90"]),
+    ("upload_p99_ms", lambda r: r["upload_ms"]["p99"]),
+    ("heap_hwm", lambda r: "" if r["heap_hwm_bytes"] is None else r["heap_hwm_bytes"]),
+]
+
+
+def periods(text):
+    return [int(v) for v in text.split(",") if v]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--recording", type=periods, default=[50, 100, 200], help="RECORDING_PERIOD_MS values")
+    parser.add_argument("--logging", type=periods, default=[1000, 2000, 5000], help="LOGGING_PERIOD_MS values")
+    parser.add_argument("--duration-s", type=int, default=30)
+    parser.add_argument("--latency-ms", default="80:250", help="<min>[:<max>] of the fake Firestore")
+    parser.add_argument("--loss", type=float, default=0.0, help="rate of the dropped requests")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--tls", action="store_true")
+    parser.add_argument("--build", default="_fil_build", help="the build directory of the sweep")
+    parser.add_argument("--build-type", default="Release")
+    parser.add_argument("--out", default="fil_sweep.csv")
+    args = parser.parse_args()
+
+    root = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", ".."))
+    pairs = [(rec, log) for rec in args.recording for log in args.logging]
+    sweep = ";".join("%d:%d" % pair for pair in pairs)
+    targets = ["firmware_fil_%d_%d" % pair for pair in pairs]
+
+    subprocess.run(["cmake", "-S", root, "-B", args.build, "-DCMAKE_BUILD_TYPE=" + args.build_type,
+                    "-DFIL_SWEEP=" + sweep], check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(["cmake", "--build", args.build, "-j%d" % (os.cpu_count() or 1), "--target"] + targets, check=True)
+
+    outdir = os.path.dirname(os.path.abspath(args.out))
+    os.makedirs(outdir, exist_ok=True)
+    rows = []
+    for (rec, log), target in zip(pairs, targets):
+        name = os.path.join(outdir, "fil_%d_%d" % (rec, log))
+        cmd = [os.path.join(args.build, "host", target), "--duration-s=%d" % args.duration_s,
+               "--latency-ms=" + args.latency_ms, "--loss=%g" % args.loss, "--seed=%d" % args.seed,
+               "--serial-log=" + name + ".log", "--json=" + name + ".json"]
+        if args.tls:
+            cmd.append("--tls")
+        print("== %s" % " ".join(cmd), flush=True)
+        if subprocess.run(cmd, stdout=subprocess.DEVNULL).returncode != 0:
+            print("sweep: %s failed" % target, file=sys.stderr)
+            continue
+        with open(name + ".json") as f:
+            result = json.load(f)
+        rows.append([get(result) for _, get in COLUMNS])
+
+    with open(args.out, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow([name for name, _ in COLUMNS])
+        writer.writerows(rows)
+
+    widths = [max(len(str(v)) for v in [name] + [row[i] for row in rows]) for i, (name, _) in enumerate(COLUMNS)]
+    print()
+    print("  ".join(name.rjust(w) for (name, _), w in zip(COLUMNS, widths)))
+    for row in rows:
+        print("  ".join(str(v).rjust(w) for v, w in zip(row, widths)))
+    print("\n%d runs written to %s" % (len(rows), args.out))
+    return 0 if len(rows) == len(pairs) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
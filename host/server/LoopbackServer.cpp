@@ -0,0 +1,648 @@
+#include <Arduino.h>
+#include <HostClient.h>
+#include "LoopbackServer.h"
+#include "client/SSLClient/client/BSSL_Helper.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fstream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// The unprivileged ports of _secure_ports (ESP_SSLClient_Const.h), the SSL client does the handshake on them
+static const uint16_t loopback_tls_ports[] = {4116, 4843, 5061, 5085, 5349, 5671, 5986, 6513, 6514, 6515, 6619, 8243, 8403, 8883};
+
+static const char *loopback_reason(int status)
+{
+    switch (status)
+    {
+    case 200:
+        return "OK";
+    case 204:
+        return "No Content";
+    case 400:
+        return "Bad Request";
+    case 401:
+        return "Unauthorized";
+    case 403:
+        return "Forbidden";
+    case 404:
+        return "Not Found";
+    case 409:
+        return "Conflict";
+    case 429:
+        return "Too Many Requests";
+    case 500:
+        return "Internal Server Error";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "Status";
+    }
+}
+
+std::string LoopbackRequest::header(const std::string &name) const
+{
+    auto it = headers.find(name);
+    return it == headers.end() ? std::string() : it->second;
+}
+
+struct LoopbackServer::TlsIdentity
+{
+    bssl::X509List chain;
+    bssl::PrivateKey key;
+};
+
+class LoopbackServer::Connection
+{
+public:
+    Connection(int fd, uint32_t id) : fd(fd), id(id) {}
+
+    ~Connection()
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+
+    bool beginTls(const TlsIdentity &identity)
+    {
+        sc.reset(new br_ssl_server_context());
+        iobuf.resize(BR_SSL_BUFSIZE_BIDI);
+        br_ssl_server_init_full_ec(sc.get(), identity.chain.getX509Certs(), identity.chain.getCount(), BR_KEYTYPE_EC,
+                                   identity.key.getEC());
+        br_ssl_engine_set_buffer(&sc->eng, iobuf.data(), iobuf.size(), 1);
+        if (!suites.empty())
+            br_ssl_engine_set_suites(&sc->eng, suites.data(), suites.size());
+
+        // the engine has no system seeder on every host
+        unsigned char seed[32];
+        std::random_device rd;
+        for (size_t i = 0; i < sizeof(seed); i++)
+            seed[i] = (unsigned char)rd();
+        br_ssl_engine_inject_entropy(&sc->eng, seed, sizeof(seed));
+
+        if (!br_ssl_server_reset(sc.get()))
+            return false;
+        br_sslio_init(&ioc, &sc->eng, sockRead, this, sockWrite, this);
+        return true;
+    }
+
+    // The bytes read, 0 or less when the connection was closed
+    int read(char *buf, size_t len)
+    {
+        int n = readSome(buf, len);
+        if (n > 0 && bytesRead)
+            *bytesRead += n;
+        return n;
+    }
+
+    bool write(const std::string &data)
+    {
+        // counted before the client can see them
+        if (bytesWritten)
+            *bytesWritten += data.size();
+        if (sc)
+            return br_sslio_write_all(&ioc, data.data(), data.size()) == 0 && br_sslio_flush(&ioc) == 0;
+        return sockWrite(this, reinterpret_cast<const unsigned char *>(data.data()), data.size()) == (int)data.size();
+    }
+
+    // Wait for data, false when the peer closed the connection
+    bool idle(int timeoutMs, bool &readable)
+    {
+        readable = false;
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int r = poll(&pfd, 1, timeoutMs);
+        if (r <= 0)
+            return r == 0 || errno == EINTR;
+        char c;
+        ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+            return false;
+        readable = n > 0;
+        return true;
+    }
+
+    void shutdownSocket() { ::shutdown(fd, SHUT_RDWR); }
+
+    // Close as the HTTP servers do after a response with connection close: end the sending and
+    // discard the requests that the client pipelined until it closes too (or timeoutMs). Closing
+    // with unread data would reset the connection and the client could lose the response.
+    void lingeringClose(int timeoutMs)
+    {
+        if (sc)
+        {
+            // close_notify, then the engine discards the application data until the client's one
+            struct timeval tv = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+            br_sslio_close(&ioc);
+        }
+        ::shutdown(fd, SHUT_WR);
+        char buf[4096];
+        unsigned long start = millis();
+        while (millis() - start < (unsigned long)timeoutMs)
+        {
+            struct pollfd pfd = {fd, POLLIN, 0};
+            if (poll(&pfd, 1, 10) < 0 && errno != EINTR)
+                break;
+            ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                break;
+        }
+    }
+
+    int fd;
+    uint32_t id;
+    // The cipher suite of the handshake, 0 in plain mode or before the handshake
+    uint16_t cipherSuite() const { return sc ? sc->eng.session.cipher_suite : 0; }
+
+    // see LoopbackServer::setSegments
+    size_t segment = 0;
+    uint32_t segmentPauseMs = 0;
+    // see LoopbackServer::setCipherSuites
+    std::vector<uint16_t> suites;
+    // see LoopbackServer::bytesRead and bytesWritten
+    std::atomic<uint64_t> *bytesRead = nullptr;
+    std::atomic<uint64_t> *bytesWritten = nullptr;
+
+private:
+    int readSome(char *buf, size_t len)
+    {
+        if (sc)
+            return br_sslio_read(&ioc, buf, len);
+        for (;;)
+        {
+            ssize_t n = recv(fd, buf, len, 0);
+            if (n < 0 && errno == EINTR)
+                continue;
+            return (int)n;
+        }
+    }
+
+    static int sockRead(void *ctx, unsigned char *buf, size_t len)
+    {
+        int fd = static_cast<Connection *>(ctx)->fd;
+        for (;;)
+        {
+            ssize_t n = recv(fd, buf, len, 0);
+            if (n < 0 && errno == EINTR)
+                continue;
+            return n > 0 ? (int)n : -1;
+        }
+    }
+
+    static int sockWrite(void *ctx, const unsigned char *buf, size_t len)
+    {
+        Connection *conn = static_cast<Connection *>(ctx);
+        size_t sent = 0;
+        while (sent < len)
+        {
+            size_t part = len - sent;
+            if (conn->segment > 0 && part > conn->segment)
+                part = conn->segment;
+            if (conn->segment > 0 && sent > 0 && conn->segmentPauseMs > 0)
+                delay(conn->segmentPauseMs);
+            ssize_t n = send(conn->fd, buf + sent, part, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return -1;
+            sent += n;
+        }
+        return (int)sent;
+    }
+
+    std::unique_ptr<br_ssl_server_context> sc;
+    std::vector<unsigned char> iobuf;
+    br_sslio_context ioc;
+};
+
+LoopbackServer::LoopbackServer(bool tls) : _tls(tls), _rng(1)
+{
+}
+
+LoopbackServer::~LoopbackServer()
+{
+    stop();
+}
+
+std::string LoopbackServer::fixturePath(const std::string &name)
+{
+    return std::string(HOST_FIXTURES_DIR) + "/" + name;
+}
+
+std::string LoopbackServer::fixture(const std::string &name)
+{
+    std::ifstream in(fixturePath(name), std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+bool LoopbackServer::start(uint16_t port, bool setDefault)
+{
+    if (_running)
+        return true;
+
+    if (_tls && !_identity)
+    {
+        std::string cert = fixture("tls/server.crt"), key = fixture("tls/server.key");
+        _identity = std::make_shared<TlsIdentity>();
+        if (!_identity->chain.append(cert.c_str()) || !_identity->key.parse(key.c_str()) || !_identity->key.isEC())
+        {
+            _identity.reset();
+            return false;
+        }
+    }
+
+    std::vector<uint16_t> candidates;
+    if (port)
+        candidates.push_back(port);
+    else if (_tls)
+        candidates.assign(std::begin(loopback_tls_ports), std::end(loopback_tls_ports));
+    else
+        candidates.push_back(0);
+
+    for (uint16_t candidate : candidates)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0)
+            return false;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(candidate);
+        if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0 && listen(fd, 16) == 0)
+        {
+            socklen_t len = sizeof(addr);
+            getsockname(fd, reinterpret_cast<struct sockaddr *>(&addr), &len);
+            _listenFd = fd;
+            _port = ntohs(addr.sin_port);
+            break;
+        }
+        close(fd);
+    }
+
+    if (_listenFd < 0)
+        return false;
+
+    if (setDefault)
+        host_set_server_port(_port);
+
+    _running = true;
+    _acceptThread = std::thread(&LoopbackServer::acceptLoop, this);
+    return true;
+}
+
+void LoopbackServer::stop()
+{
+    if (!_running.exchange(false))
+        return;
+
+    ::shutdown(_listenFd, SHUT_RDWR);
+    if (_acceptThread.joinable())
+        _acceptThread.join();
+    close(_listenFd);
+    _listenFd = -1;
+
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto &conn : _conns)
+            conn->shutdownSocket();
+        threads.swap(_threads);
+    }
+    for (auto &t : threads)
+        t.join();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _conns.clear();
+}
+
+void LoopbackServer::on(const std::string &method, const std::string &pathPrefix, LoopbackHandler handler)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _routes.push_back({method, pathPrefix, handler});
+}
+
+void LoopbackServer::onFixture(const std::string &method, const std::string &pathPrefix, const std::string &fixtureName,
+                               int status)
+{
+    std::string content = fixture(fixtureName);
+    bool events = fixtureName.size() > 4 && fixtureName.compare(fixtureName.size() - 4, 4, ".sse") == 0;
+
+    on(method, pathPrefix, [content, events, status, fixtureName](const LoopbackRequest &, LoopbackResponse &response)
+       {
+        response.status = status;
+        if (content.empty())
+        {
+            response.status = 500;
+            response.body = "{\"error\":\"missing fixture " + fixtureName + "\"}";
+        }
+        else if (events)
+        {
+            // the events of a recorded stream are separated by a blank line
+            response.stream = true;
+            response.contentType = "text/event-stream; charset=utf-8";
+            size_t pos = 0;
+            while (pos < content.size())
+            {
+                size_t end = content.find("\n\n", pos);
+                end = end == std::string::npos ? content.size() : end + 2;
+                response.events.push_back(content.substr(pos, end - pos));
+                pos = end;
+            }
+        }
+        else
+            response.body = content; });
+}
+
+void LoopbackServer::setLatency(uint32_t minMs, uint32_t maxMs)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _latencyMin = minMs;
+    _latencyMax = maxMs < minMs ? minMs : maxMs;
+}
+
+void LoopbackServer::setSegments(size_t size, uint32_t pauseMs)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _segment = size;
+    _segmentPauseMs = pauseMs;
+}
+
+void LoopbackServer::setCipherSuites(const std::vector<uint16_t> &suites)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _suites = suites;
+}
+
+void LoopbackServer::setLoss(double rate, uint32_t seed)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _loss = rate;
+    _rng.seed(seed);
+}
+
+std::vector<LoopbackRequest> LoopbackServer::requests() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requests;
+}
+
+size_t LoopbackServer::requestCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requests.size();
+}
+
+void LoopbackServer::clearRequests()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _requests.clear();
+}
+
+uint32_t LoopbackServer::nextDelay()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_latencyMax == _latencyMin)
+        return _latencyMin;
+    return std::uniform_int_distribution<uint32_t>(_latencyMin, _latencyMax)(_rng);
+}
+
+bool LoopbackServer::nextLost()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _loss > 0 && std::uniform_real_distribution<double>(0, 1)(_rng) < _loss;
+}
+
+void LoopbackServer::acceptLoop()
+{
+    while (_running)
+    {
+        int fd = accept(_listenFd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        std::shared_ptr<Connection> conn = std::make_shared<Connection>(fd, ++_connections);
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running)
+            break;
+        conn->segment = _segment;
+        conn->segmentPauseMs = _segmentPauseMs;
+        conn->suites = _suites;
+        conn->bytesRead = &_bytesRead;
+        conn->bytesWritten = &_bytesWritten;
+        _conns.push_back(conn);
+        _threads.emplace_back(&LoopbackServer::serve, this, conn);
+    }
+}
+
+void LoopbackServer::serve(std::shared_ptr<Connection> conn)
+{
+    if (!_tls || conn->beginTls(*_identity))
+    {
+        std::string buf;
+        LoopbackRequest request;
+        while (_running && readRequest(*conn, buf, request))
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _requests.push_back(request);
+            }
+
+            if (nextLost())
+            {
+                _dropped++;
+                break;
+            }
+
+            uint32_t latency = nextDelay();
+            if (latency)
+                delay(latency);
+
+            LoopbackResponse response;
+            dispatch(request, response);
+            if (!sendResponse(*conn, request, response))
+                break;
+            if (response.stream)
+            {
+                holdStream(*conn, response);
+                break;
+            }
+            if (response.close)
+            {
+                conn->lingeringClose(1000);
+                break;
+            }
+        }
+    }
+
+    conn->shutdownSocket();
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _conns.begin(); it != _conns.end(); ++it)
+    {
+        if (it->get() == conn.get())
+        {
+            _conns.erase(it);
+            break;
+        }
+    }
+}
+
+bool LoopbackServer::readRequest(Connection &conn, std::string &buf, LoopbackRequest &request)
+{
+    char chunk[4096];
+    size_t headerEnd;
+    while ((headerEnd = buf.find("\r\n\r\n")) == std::string::npos)
+    {
+        int n = conn.read(chunk, sizeof(chunk));
+        if (n <= 0)
+            return false;
+        buf.append(chunk, n);
+    }
+
+    request = LoopbackRequest();
+    request.receivedMs = millis();
+    request.connection = conn.id;
+    request.cipherSuite = conn.cipherSuite();
+
+    std::istringstream head(buf.substr(0, headerEnd));
+    std::string line, version;
+    std::getline(head, line);
+    std::istringstream requestLine(line);
+    requestLine >> request.method >> request.target >> version;
+
+    size_t q = request.target.find('?');
+    request.path = request.target.substr(0, q);
+    request.query = q == std::string::npos ? std::string() : request.target.substr(q + 1);
+
+    while (std::getline(head, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        std::string name = line.substr(0, colon), value = line.substr(colon + 1);
+        for (auto &c : name)
+            c = (char)tolower((unsigned char)c);
+        size_t start = value.find_first_not_of(' ');
+        request.headers[name] = start == std::string::npos ? std::string() : value.substr(start);
+    }
+
+    size_t length = strtoul(request.header("content-length").c_str(), nullptr, 10);
+    size_t bodyStart = headerEnd + 4;
+    while (buf.size() < bodyStart + length)
+    {
+        int n = conn.read(chunk, sizeof(chunk));
+        if (n <= 0)
+            return false;
+        buf.append(chunk, n);
+    }
+
+    request.body = buf.substr(bodyStart, length);
+    buf.erase(0, bodyStart + length);
+    return true;
+}
+
+void LoopbackServer::dispatch(const LoopbackRequest &request, LoopbackResponse &response)
+{
+    LoopbackHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto it = _routes.rbegin(); it != _routes.rend(); ++it)
+        {
+            if ((it->method == "*" || it->method == request.method) && request.path.compare(0, it->prefix.size(), it->prefix) == 0)
+            {
+                handler = it->handler;
+                break;
+            }
+        }
+    }
+
+    if (handler)
+        handler(request, response);
+    else
+    {
+        response.status = 404;
+        response.body = "{\"error\":{\"code\":404,\"message\":\"No route for " + request.method + " " + request.path + "\",\"status\":\"NOT_FOUND\"}}";
+    }
+}
+
+bool LoopbackServer::sendResponse(Connection &conn, const LoopbackRequest &request, LoopbackResponse &response)
+{
+    if (request.header("connection") == "close")
+        response.close = true;
+
+    std::string out = "HTTP/1.1 " + std::to_string(response.status) + " " + loopback_reason(response.status) + "\r\n";
+    if (!response.contentType.empty())
+        out += "Content-Type: " + response.contentType + "\r\n";
+    for (auto &h : response.headers)
+        out += h.first + ": " + h.second + "\r\n";
+
+    if (response.stream)
+    {
+        out += "Cache-Control: no-cache\r\n\r\n";
+        if (!conn.write(out))
+            return false;
+        for (size_t i = 0; i < response.events.size(); i++)
+        {
+            if (i > 0 && response.eventIntervalMs)
+                delay(response.eventIntervalMs);
+            if (!_running || !conn.write(response.events[i]))
+                return false;
+        }
+        return true;
+    }
+
+    out += response.close ? "Connection: close\r\n" : "Connection: keep-alive\r\n";
+
+    if (response.chunkSize > 0)
+    {
+        out += "Transfer-Encoding: chunked\r\n\r\n";
+        char size[16];
+        for (size_t pos = 0; pos < response.body.size(); pos += response.chunkSize)
+        {
+            std::string part = response.body.substr(pos, response.chunkSize);
+            snprintf(size, sizeof(size), "%zx\r\n", part.size());
+            out += size + part + "\r\n";
+        }
+        out += "0\r\n\r\n";
+    }
+    else
+        out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n\r\n" + response.body;
+
+    return conn.write(out);
+}
+
+void LoopbackServer::holdStream(Connection &conn, const LoopbackResponse &response)
+{
+    unsigned long lastEvent = millis();
+    bool readable = false;
+    while (_running && conn.idle(20, readable) && !readable)
+    {
+        if (response.keepAliveMs && millis() - lastEvent >= response.keepAliveMs)
+        {
+            if (!conn.write("event: keep-alive\ndata: null\n\n"))
+                break;
+            lastEvent = millis();
+        }
+    }
+}
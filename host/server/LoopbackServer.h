@@ -0,0 +1,188 @@
+/**
+ * The loopback HTTP/1.1 server of the host build, in plain or TLS mode.
+ *
+ * The library connects it through FIREBASE_HOST_OVERRIDE/FIREBASE_PORT_OVERRIDE (see
+ * host/config/CustomFirebaseFS.h), start() sets the port that host_server_port() returns.
+ *
+ * The requests are routed by method and path prefix to a handler or to a recorded response of
+ * host/fixtures. A handler can answer with a body or with an event stream (RTDB SSE).
+ * The latency, loss and segment size of the link can be set to test the timeouts, the retries and
+ * the records that arrive in pieces.
+ *
+ * The TLS mode uses the BearSSL server of the library with the test certificate of
+ * host/fixtures/tls, it listens the first free port that the SSL client treats as secure. Its
+ * cipher suites can be restricted to test the suites that the client accepts.
+ */
+
+#ifndef HOST_LOOPBACK_SERVER_H
+#define HOST_LOOPBACK_SERVER_H
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct LoopbackRequest
+{
+    std::string method;
+    std::string target;
+    std::string path;
+    std::string query;
+    // the names are in lower case
+    std::map<std::string, std::string> headers;
+    std::string body;
+    // the time the request was read, in millis()
+    unsigned long receivedMs = 0;
+    // the connection it came on, 1 for the first one of the server
+    uint32_t connection = 0;
+    // the TLS cipher suite of the connection, 0 in plain mode
+    uint16_t cipherSuite = 0;
+
+    std::string header(const std::string &name) const;
+};
+
+struct LoopbackResponse
+{
+    int status = 200;
+    std::string contentType = "application/json; charset=UTF-8";
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+
+    // The event stream, the events are sent one by one after the headers, each after eventIntervalMs,
+    // then the connection is held open with a keep-alive event every keepAliveMs (0 for none) until
+    // the client closes it or the server stops.
+    bool stream = false;
+    std::vector<std::string> events;
+    uint32_t eventIntervalMs = 0;
+    uint32_t keepAliveMs = 0;
+
+    // Send the body in chunks of this size (Transfer-Encoding: chunked), 0 for Content-Length
+    size_t chunkSize = 0;
+
+    // Close the connection after this response, the requests pipelined after it are not read
+    bool close = false;
+};
+
+typedef std::function<void(const LoopbackRequest &request, LoopbackResponse &response)> LoopbackHandler;
+
+class LoopbackServer
+{
+public:
+    explicit LoopbackServer(bool tls = false);
+    ~LoopbackServer();
+
+    /**
+     * Listen on 127.0.0.1 and serve in the background.
+     * @param port The port, 0 for the first free secure port in TLS mode or any free port in plain mode.
+     * @param setDefault Make the library connect this server (host_set_server_port).
+     * @return true when listening.
+     */
+    bool start(uint16_t port = 0, bool setDefault = true);
+
+    // Close the listener and all connections, the event streams included
+    void stop();
+
+    uint16_t port() const { return _port; }
+    bool tls() const { return _tls; }
+
+    /**
+     * Route the requests of a method ("*" for any) whose path starts with the prefix, the latest
+     * route that matches wins.
+     */
+    void on(const std::string &method, const std::string &pathPrefix, LoopbackHandler handler);
+
+    // Route to a recorded response of host/fixtures
+    void onFixture(const std::string &method, const std::string &pathPrefix, const std::string &fixtureName,
+                   int status = 200);
+
+    /**
+     * The delay before each response, uniformly in [minMs, maxMs].
+     */
+    void setLatency(uint32_t minMs, uint32_t maxMs = 0);
+
+    /**
+     * Send the bytes in segments of this size with a pause between them, a TLS record then takes
+     * several reads of the client. 0 to send the data as it is written. It applies to the next
+     * connections.
+     */
+    void setSegments(size_t size, uint32_t pauseMs = 1);
+
+    /**
+     * The TLS cipher suites that the server accepts, in the order of the BearSSL server, empty for
+     * all those of the full EC server. It applies to the next connections.
+     */
+    void setCipherSuites(const std::vector<uint16_t> &suites);
+
+    /**
+     * The rate [0, 1] of the requests that are dropped, the connection is closed without a response.
+     */
+    void setLoss(double rate, uint32_t seed = 1);
+
+    std::vector<LoopbackRequest> requests() const;
+    size_t requestCount() const;
+    void clearRequests();
+    uint32_t connections() const { return _connections; }
+    uint32_t dropped() const { return _dropped; }
+
+    // The HTTP bytes read and written on all connections, the TLS records excluded
+    uint64_t bytesRead() const { return _bytesRead; }
+    uint64_t bytesWritten() const { return _bytesWritten; }
+
+    // The content and path of a file in host/fixtures
+    static std::string fixture(const std::string &name);
+    static std::string fixturePath(const std::string &name);
+
+private:
+    struct Route
+    {
+        std::string method;
+        std::string prefix;
+        LoopbackHandler handler;
+    };
+
+    class Connection;
+
+    void acceptLoop();
+    void serve(std::shared_ptr<Connection> conn);
+    bool readRequest(Connection &conn, std::string &buf, LoopbackRequest &request);
+    bool sendResponse(Connection &conn, const LoopbackRequest &request, LoopbackResponse &response);
+    void holdStream(Connection &conn, const LoopbackResponse &response);
+    void dispatch(const LoopbackRequest &request, LoopbackResponse &response);
+    uint32_t nextDelay();
+    bool nextLost();
+
+    bool _tls;
+    int _listenFd = -1;
+    uint16_t _port = 0;
+    std::atomic<bool> _running{false};
+    std::thread _acceptThread;
+
+    mutable std::mutex _mutex;
+    std::vector<Route> _routes;
+    std::vector<LoopbackRequest> _requests;
+    std::vector<std::shared_ptr<Connection>> _conns;
+    std::vector<std::thread> _threads;
+    std::mt19937 _rng;
+    uint32_t _latencyMin = 0;
+    uint32_t _latencyMax = 0;
+    double _loss = 0;
+    size_t _segment = 0;
+    uint32_t _segmentPauseMs = 0;
+    std::vector<uint16_t> _suites;
+    std::atomic<uint32_t> _connections{0};
+    std::atomic<uint32_t> _dropped{0};
+    std::atomic<uint64_t> _bytesRead{0};
+    std::atomic<uint64_t> _bytesWritten{0};
+
+    struct TlsIdentity;
+    std::shared_ptr<TlsIdentity> _identity;
+};
+
+#endif
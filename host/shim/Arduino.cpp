@@ -0,0 +1,226 @@
+#include "Arduino.h"
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+
+static const std::chrono::steady_clock::time_point host_boot = std::chrono::steady_clock::now();
+
+unsigned long millis()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - host_boot).count();
+}
+
+unsigned long micros()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - host_boot).count();
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield()
+{
+    std::this_thread::yield();
+}
+
+static std::mt19937 &host_random()
+{
+    static std::mt19937 rng(1);
+    return rng;
+}
+
+long random(long max)
+{
+    return max > 0 ? random(0, max) : 0;
+}
+
+long random(long min, long max)
+{
+    if (min >= max)
+        return min;
+    return std::uniform_int_distribution<long>(min, max - 1)(host_random());
+}
+
+void randomSeed(unsigned long seed)
+{
+    if (seed)
+        host_random().seed(seed);
+}
+
+static std::atomic<size_t> host_largest_block{0};
+static std::atomic<size_t> host_heap{0};
+
+size_t host_largest_free_block() { return host_largest_block; }
+
+size_t host_free_heap() { return host_heap; }
+
+void host_set_heap(size_t largestBlock, size_t freeHeap)
+{
+    host_largest_block = largestBlock;
+    host_heap = freeHeap;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t, uint8_t) {}
+
+int digitalRead(uint8_t) { return LOW; }
+
+static char *host_itoa(unsigned long long value, bool negative, char *str, int base)
+{
+    std::string s = String(value, (unsigned char)base).c_str();
+    if (negative)
+        s.insert(0, 1, '-');
+    memcpy(str, s.c_str(), s.length() + 1);
+    return str;
+}
+
+char *itoa(int value, char *str, int base) { return ltoa(value, str, base); }
+
+char *ltoa(long value, char *str, int base)
+{
+    if (base == 10 && value < 0)
+        return host_itoa(0ULL - (unsigned long long)value, true, str, base);
+    return host_itoa((unsigned long)value, false, str, base);
+}
+
+char *utoa(unsigned int value, char *str, int base) { return host_itoa(value, false, str, base); }
+
+char *ultoa(unsigned long value, char *str, int base) { return host_itoa(value, false, str, base); }
+
+char *dtostrf(double value, signed char width, unsigned char prec, char *str)
+{
+    sprintf(str, "%*.*f", width, prec, value);
+    return str;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        if (!write(*buffer++))
+            break;
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    if (len < 0)
+        return 0;
+    if ((size_t)len < sizeof(buf))
+        return write(reinterpret_cast<const uint8_t *>(buf), len);
+
+    std::string out(len, 0);
+    va_start(args, format);
+    vsnprintf(&out[0], len + 1, format, args);
+    va_end(args);
+    return write(reinterpret_cast<const uint8_t *>(out.data()), len);
+}
+
+int Stream::timedRead()
+{
+    unsigned long start = millis();
+    do
+    {
+        int c = read();
+        if (c >= 0)
+            return c;
+        yield();
+    } while (millis() - start < _timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+    size_t count = 0;
+    while (count < length)
+    {
+        int c = timedRead();
+        if (c < 0)
+            break;
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length)
+{
+    size_t count = 0;
+    while (count < length)
+    {
+        int c = timedRead();
+        if (c < 0 || c == terminator)
+            break;
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+String Stream::readString()
+{
+    String out;
+    int c;
+    while ((c = timedRead()) >= 0)
+        out += (char)c;
+    return out;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    String out;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator)
+        out += (char)c;
+    return out;
+}
+
+bool IPAddress::fromString(const char *address)
+{
+    unsigned a, b, c, d;
+    char end;
+    if (!address || sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &end) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+        return false;
+    *this = IPAddress(a, b, c, d);
+    return true;
+}
+
+String IPAddress::toString() const
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+    return String(buf);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return fwrite(&c, 1, 1, _out ? _out : stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, _out ? _out : stdout);
+}
+
+void HardwareSerial::flush()
+{
+    fflush(_out ? _out : stdout);
+}
@@ -0,0 +1,218 @@
+#include "Arduino.h"
+#include "FS.h"
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+fs::FS HostFS;
+
+namespace fs
+{
+    class FileImpl
+    {
+    public:
+        ~FileImpl()
+        {
+            if (fp)
+                fclose(fp);
+            if (dir)
+                closedir(dir);
+        }
+
+        FILE *fp = nullptr;
+        DIR *dir = nullptr;
+        std::string path;
+        std::string realPath;
+    };
+}
+
+using namespace fs;
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+    return _impl && _impl->fp ? fwrite(buf, 1, size, _impl->fp) : 0;
+}
+
+int File::available()
+{
+    if (!_impl || !_impl->fp)
+        return 0;
+    long pos = ftell(_impl->fp);
+    return pos < 0 ? 0 : (int)(size() - pos);
+}
+
+int File::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek()
+{
+    if (!_impl || !_impl->fp)
+        return -1;
+    int c = fgetc(_impl->fp);
+    if (c != EOF)
+        ungetc(c, _impl->fp);
+    return c == EOF ? -1 : c;
+}
+
+void File::flush()
+{
+    if (_impl && _impl->fp)
+        fflush(_impl->fp);
+}
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+    return _impl && _impl->fp ? fread(buf, 1, size, _impl->fp) : 0;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    static const int whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return _impl && _impl->fp && fseek(_impl->fp, pos, whence[mode]) == 0;
+}
+
+size_t File::position() const
+{
+    return _impl && _impl->fp ? (size_t)ftell(_impl->fp) : 0;
+}
+
+size_t File::size() const
+{
+    if (!_impl || !_impl->fp)
+        return 0;
+    fflush(_impl->fp);
+    struct stat st;
+    return fstat(fileno(_impl->fp), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() { _impl.reset(); }
+
+File::operator bool() const { return _impl && (_impl->fp || _impl->dir); }
+
+const char *File::name() const
+{
+    if (!_impl)
+        return "";
+    size_t slash = _impl->path.rfind('/');
+    return _impl->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+const char *File::path() const { return _impl ? _impl->path.c_str() : ""; }
+
+bool File::isDirectory() const { return _impl && _impl->dir; }
+
+File File::openNextFile(const char *mode)
+{
+    if (!_impl || !_impl->dir)
+        return File();
+
+    struct dirent *entry;
+    while ((entry = readdir(_impl->dir)) != nullptr)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        std::string path = _impl->path + (_impl->path.empty() || _impl->path.back() != '/' ? "/" : "") + entry->d_name;
+        std::shared_ptr<FileImpl> impl = std::make_shared<FileImpl>();
+        impl->path = path;
+        impl->realPath = _impl->realPath + "/" + entry->d_name;
+        if (entry->d_type == DT_DIR)
+            impl->dir = opendir(impl->realPath.c_str());
+        else
+            impl->fp = fopen(impl->realPath.c_str(), mode[0] == 'r' ? "rb" : mode[0] == 'a' ? "ab" : "wb");
+        return File(impl);
+    }
+    return File();
+}
+
+void File::rewindDirectory()
+{
+    if (_impl && _impl->dir)
+        rewinddir(_impl->dir);
+}
+
+FS::FS(const char *root)
+{
+    const char *env = getenv("HOST_FS_ROOT");
+    _root = root ? root : env ? env : "host_fs";
+}
+
+std::string FS::realPath(const char *path) const
+{
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/')
+        p.insert(0, 1, '/');
+    return _root + p;
+}
+
+static bool host_mkdirs(const std::string &path)
+{
+    for (size_t pos = 1; pos <= path.length(); pos++)
+    {
+        if (pos == path.length() || path[pos] == '/')
+        {
+            std::string dir = path.substr(0, pos);
+            if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool FS::begin(bool formatOnFail)
+{
+    (void)formatOnFail;
+    return host_mkdirs(_root);
+}
+
+bool FS::format()
+{
+    std::string cmd = "rm -rf '" + _root + "'";
+    return system(cmd.c_str()) == 0 && begin();
+}
+
+File FS::open(const char *path, const char *mode, bool create)
+{
+    std::shared_ptr<FileImpl> impl = std::make_shared<FileImpl>();
+    impl->path = path ? path : "";
+    impl->realPath = realPath(path);
+
+    struct stat st;
+    if (stat(impl->realPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+    {
+        impl->dir = opendir(impl->realPath.c_str());
+        return impl->dir ? File(impl) : File();
+    }
+
+    // the parent directories are created as LittleFS does
+    if (mode[0] != 'r' || create)
+    {
+        size_t slash = impl->realPath.rfind('/');
+        if (slash != std::string::npos)
+            host_mkdirs(impl->realPath.substr(0, slash));
+    }
+
+    const char *m = mode[0] == 'r' ? (strchr(mode, '+') ? "rb+" : "rb") : mode[0] == 'a' ? (strchr(mode, '+') ? "ab+" : "ab") : (strchr(mode, '+') ? "wb+" : "wb");
+    impl->fp = fopen(impl->realPath.c_str(), m);
+    return impl->fp ? File(impl) : File();
+}
+
+bool FS::exists(const char *path)
+{
+    struct stat st;
+    return stat(realPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path) { return ::remove(realPath(path).c_str()) == 0; }
+
+bool FS::rename(const char *pathFrom, const char *pathTo) { return ::rename(realPath(pathFrom).c_str(), realPath(pathTo).c_str()) == 0; }
+
+bool FS::mkdir(const char *path) { return host_mkdirs(realPath(path)); }
+
+bool FS::rmdir(const char *path) { return ::rmdir(realPath(path).c_str()) == 0; }
@@ -0,0 +1,104 @@
+/**
+ * The flash file system of the host build, the files are kept in a directory.
+ *
+ * HostFS is the file system of the library (DEFAULT_FLASH_FS in CustomFirebaseFS.h), its root is
+ * the HOST_FS_ROOT environment variable or ./host_fs, and can be set with HostFS.setRoot().
+ */
+
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include "Stream.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs
+{
+    enum SeekMode
+    {
+        SeekSet = 0,
+        SeekCur = 1,
+        SeekEnd = 2
+    };
+
+    class FileImpl;
+
+    class File : public Stream
+    {
+    public:
+        File() {}
+        File(std::shared_ptr<FileImpl> impl) : _impl(impl) {}
+
+        size_t write(uint8_t c) override;
+        size_t write(const uint8_t *buf, size_t size) override;
+        int available() override;
+        int read() override;
+        int peek() override;
+        void flush() override;
+        size_t read(uint8_t *buf, size_t size);
+        size_t readBytes(char *buffer, size_t length) override { return read(reinterpret_cast<uint8_t *>(buffer), length); }
+
+        bool seek(uint32_t pos, SeekMode mode = SeekSet);
+        size_t position() const;
+        size_t size() const;
+        void close();
+        operator bool() const;
+        const char *name() const;
+        const char *path() const;
+        bool isDirectory() const;
+        File openNextFile(const char *mode = FILE_READ);
+        void rewindDirectory();
+
+        using Print::write;
+
+    private:
+        std::shared_ptr<FileImpl> _impl;
+    };
+
+    class FS
+    {
+    public:
+        FS(const char *root = nullptr);
+
+        bool begin(bool formatOnFail = false);
+        void end() {}
+        bool format();
+
+        File open(const char *path, const char *mode = FILE_READ, bool create = false);
+        File open(const String &path, const char *mode = FILE_READ, bool create = false) { return open(path.c_str(), mode, create); }
+        bool exists(const char *path);
+        bool exists(const String &path) { return exists(path.c_str()); }
+        bool remove(const char *path);
+        bool remove(const String &path) { return remove(path.c_str()); }
+        bool rename(const char *pathFrom, const char *pathTo);
+        bool mkdir(const char *path);
+        bool mkdir(const String &path) { return mkdir(path.c_str()); }
+        bool rmdir(const char *path);
+
+        // The directory that holds the files, created by begin()
+        void setRoot(const char *root) { _root = root ? root : ""; }
+        const char *root() const { return _root.c_str(); }
+
+    private:
+        std::string realPath(const char *path) const;
+
+        std::string _root;
+    };
+}
+
+// as the ESP32 core, the names are global whatever FS_NO_GLOBALS is
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekMode;
+using fs::SeekSet;
+
+extern fs::FS HostFS;
+
+#endif
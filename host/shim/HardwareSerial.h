@@ -0,0 +1,38 @@
+/**
+ * The Serial of the host build, the output goes to stdout (or the file of setOutput()) and there
+ * is no input.
+ */
+
+#ifndef HOST_HARDWARESERIAL_H
+#define HOST_HARDWARESERIAL_H
+
+#include <stdio.h>
+#include "Stream.h"
+
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override;
+
+    operator bool() const { return true; }
+
+    // Write to this file instead of stdout, nullptr for stdout
+    void setOutput(FILE *out) { _out = out; }
+
+    using Print::write;
+
+private:
+    FILE *_out = nullptr;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,146 @@
+#include "Arduino.h"
+#include "HostClient.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+int HostClient::connect(IPAddress ip, uint16_t port)
+{
+    return connect(ip.toString().c_str(), port);
+}
+
+int HostClient::connect(const char *host, uint16_t port)
+{
+    stop();
+
+    struct addrinfo hints = {}, *res = nullptr;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    if (getaddrinfo(host, service, &hints, &res) != 0)
+        return 0;
+
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next)
+    {
+        int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0)
+            continue;
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+        {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#if defined(SO_NOSIGPIPE)
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+            _fd = fd;
+            break;
+        }
+        close(fd);
+    }
+    freeaddrinfo(res);
+
+    if (_fd < 0)
+        return 0;
+    _connections++;
+    return 1;
+}
+
+size_t HostClient::write(const uint8_t *buf, size_t size)
+{
+    size_t sent = 0;
+    while (_fd >= 0 && sent < size)
+    {
+        ssize_t n = send(_fd, buf + sent, size - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            stop();
+            break;
+        }
+        sent += n;
+    }
+    return sent;
+}
+
+int HostClient::available()
+{
+    int n = 0;
+    if (_fd < 0 || ioctl(_fd, FIONREAD, &n) != 0)
+        return 0;
+    return n;
+}
+
+int HostClient::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int HostClient::read(uint8_t *buf, size_t size)
+{
+    // the Arduino clients do not block, only what is available is read
+    int n = available();
+    if (n <= 0)
+        return -1;
+    if ((size_t)n > size)
+        n = size;
+    ssize_t r = recv(_fd, buf, n, 0);
+    return r > 0 ? (int)r : -1;
+}
+
+int HostClient::peek()
+{
+    uint8_t c;
+    if (available() <= 0)
+        return -1;
+    return recv(_fd, &c, 1, MSG_PEEK) == 1 ? c : -1;
+}
+
+void HostClient::stop()
+{
+    if (_fd >= 0)
+    {
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+uint8_t HostClient::connected()
+{
+    if (_fd < 0)
+        return 0;
+    if (available() > 0)
+        return 1;
+
+    // a readable socket with nothing to read was closed by the peer
+    struct pollfd pfd = {_fd, POLLIN, 0};
+    if (poll(&pfd, 1, 0) > 0)
+    {
+        uint8_t c;
+        ssize_t n = recv(_fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+        {
+            stop();
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint16_t host_port = 443;
+
+uint16_t host_server_port() { return host_port; }
+
+void host_set_server_port(uint16_t port) { host_port = port; }
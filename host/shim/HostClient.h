@@ -0,0 +1,47 @@
+/**
+ * The TCP client of the host build over POSIX sockets.
+ *
+ * It is the network client of the library on host, pass it with fbdo.setGenericClient() or
+ * Firebase.Stream/Firestore via the generic client config, TLS is done by the library BearSSL
+ * client on top of it.
+ */
+
+#ifndef HOST_CLIENT_SOCKET_H
+#define HOST_CLIENT_SOCKET_H
+
+#include "Client.h"
+
+class HostClient : public Client
+{
+public:
+    HostClient() {}
+    ~HostClient() { stop(); }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return _fd >= 0; }
+
+    using Print::write;
+
+    // The connections made since the client was created
+    uint32_t connections() const { return _connections; }
+
+private:
+    int _fd = -1;
+    uint32_t _connections = 0;
+};
+
+// The port the library connects, see FIREBASE_PORT_OVERRIDE in host/config/CustomFirebaseFS.h
+uint16_t host_server_port();
+void host_set_server_port(uint16_t port);
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * The Arduino Print of the host build.
+ */
+
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "Printable.h"
+#include "WString.h"
+
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    int getWriteError() { return write_error; }
+    void clearWriteError() { setWriteError(0); }
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return str ? write(reinterpret_cast<const uint8_t *>(str), strlen(str)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write(reinterpret_cast<const uint8_t *>(buffer), size); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const __FlashStringHelper *str) { return write(reinterpret_cast<const char *>(str)); }
+    size_t print(const String &str) { return write(str.c_str(), str.length()); }
+    size_t print(const char *str) { return write(str); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = 10) { return print((unsigned long long)value, base); }
+    size_t print(int value, int base = 10) { return print((long long)value, base); }
+    size_t print(unsigned int value, int base = 10) { return print((unsigned long long)value, base); }
+    size_t print(long value, int base = 10) { return print((long long)value, base); }
+    size_t print(unsigned long value, int base = 10) { return print((unsigned long long)value, base); }
+    size_t print(long long value, int base = 10) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long long value, int base = 10) { return print(String(value, (unsigned char)base)); }
+    size_t print(double value, int digits = 2) { return print(String(value, (unsigned char)digits)); }
+    size_t print(const Printable &value) { return value.printTo(*this); }
+
+    template <typename T>
+    size_t println(const T &value)
+    {
+        size_t n = print(value);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T &value, int format)
+    {
+        size_t n = print(value, format);
+        return n + println();
+    }
+    size_t println() { return write("\r\n"); }
+
+protected:
+    void setWriteError(int err = 1) { write_error = err; }
+
+private:
+    int write_error = 0;
+};
+
+#endif
@@ -0,0 +1,19 @@
+/**
+ * The Arduino Printable of the host build, print() and println() write it with printTo().
+ */
+
+#ifndef HOST_PRINTABLE_H
+#define HOST_PRINTABLE_H
+
+#include <stddef.h>
+
+class Print;
+
+class Printable
+{
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print &p) const = 0;
+};
+
+#endif
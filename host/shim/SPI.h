@@ -0,0 +1,17 @@
+/**
+ * The SPI of the host build, there is no SPI device.
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include <stdint.h>
+
+class SPIClass
+{
+public:
+    void begin() {}
+    void end() {}
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "Update.h"
+
+UpdateClass Update;
+
+bool UpdateClass::begin(size_t size)
+{
+    // as the core, an update is not started over a running one
+    if (_running || size == 0 || size > _freeSpace)
+        return false;
+    _image.clear();
+    _size = size;
+    _writes = 0;
+    _running = true;
+    _error = false;
+    return true;
+}
+
+size_t UpdateClass::write(uint8_t *data, size_t len)
+{
+    if (!_running || _error)
+        return 0;
+    _writes++;
+    if (len > remaining())
+    {
+        _error = true;
+        abort();
+        return 0;
+    }
+    _image.insert(_image.end(), data, data + len);
+    return len;
+}
+
+bool UpdateClass::end(bool evenIfRemaining)
+{
+    if (!_running || _error)
+        return false;
+    if (!isFinished() && !evenIfRemaining)
+    {
+        abort();
+        return false;
+    }
+    _ended = _image;
+    _ends++;
+    _image.clear();
+    _size = 0;
+    _running = false;
+    return true;
+}
+
+void UpdateClass::abort()
+{
+    _image.clear();
+    _size = 0;
+    _running = false;
+}
@@ -0,0 +1,53 @@
+/**
+ * The firmware update of the host build, the Update of the ESP32 core over a memory image.
+ *
+ * begin() starts an update of the given size, write() appends to the image and fails past the
+ * size, end() takes the image when it was all written (or with evenIfRemaining, the part that was
+ * written) and abort() drops it. The image of the last successful end() is kept for the tests.
+ */
+
+#ifndef HOST_UPDATE_H
+#define HOST_UPDATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+class UpdateClass
+{
+public:
+    bool begin(size_t size);
+    size_t write(uint8_t *data, size_t len);
+    bool end(bool evenIfRemaining = false);
+    void abort();
+
+    size_t size() const { return _size; }
+    size_t progress() const { return _image.size(); }
+    size_t remaining() const { return _size - _image.size(); }
+    bool isRunning() const { return _running; }
+    bool isFinished() const { return _running && remaining() == 0; }
+    bool hasError() const { return _error; }
+
+    // The image of the last successful end(), the updates that ended and the write() calls of the
+    // running one
+    const std::vector<uint8_t> &image() const { return _ended; }
+    uint32_t ends() const { return _ends; }
+    uint32_t writes() const { return _writes; }
+
+    // The space for the image, begin() of a larger size fails
+    void setFreeSpace(size_t size) { _freeSpace = size; }
+
+private:
+    std::vector<uint8_t> _image;
+    std::vector<uint8_t> _ended;
+    size_t _size = 0;
+    size_t _freeSpace = 4 * 1024 * 1024;
+    uint32_t _ends = 0;
+    uint32_t _writes = 0;
+    bool _running = false;
+    bool _error = false;
+};
+
+extern UpdateClass Update;
+
+#endif
@@ -0,0 +1,123 @@
+#include "Arduino.h"
+
+static std::string host_to_base(unsigned long long value, unsigned char base, bool negative)
+{
+    if (base < 2 || base > 36)
+        base = 10;
+    char buf[72];
+    char *p = buf + sizeof(buf) - 1;
+    *p = 0;
+    do
+    {
+        int d = value % base;
+        *--p = d < 10 ? '0' + d : 'a' + d - 10;
+        value /= base;
+    } while (value);
+    if (negative)
+        *--p = '-';
+    return p;
+}
+
+String::String(long value, unsigned char base) : String((long long)value, base) {}
+
+String::String(unsigned long value, unsigned char base) : s(host_to_base(value, base, false)) {}
+
+String::String(long long value, unsigned char base)
+{
+    // only the decimal numbers are signed
+    if (base == 10 && value < 0)
+        s = host_to_base(0ULL - (unsigned long long)value, base, true);
+    else
+        s = host_to_base((unsigned long long)value, base, false);
+}
+
+String::String(unsigned long long value, unsigned char base) : s(host_to_base(value, base, false)) {}
+
+String::String(double value, unsigned char decimalPlaces)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    s = buf;
+}
+
+bool String::equalsIgnoreCase(const String &str) const
+{
+    if (s.length() != str.s.length())
+        return false;
+    for (size_t i = 0; i < s.length(); i++)
+    {
+        if (tolower((unsigned char)s[i]) != tolower((unsigned char)str.s[i]))
+            return false;
+    }
+    return true;
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+    if (!bufsize || !buf)
+        return;
+    if (index >= s.length())
+    {
+        buf[0] = 0;
+        return;
+    }
+    size_t n = std::min((size_t)bufsize - 1, s.length() - index);
+    memcpy(buf, s.data() + index, n);
+    buf[n] = 0;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const
+{
+    if (beginIndex > endIndex)
+        std::swap(beginIndex, endIndex);
+    if (beginIndex >= s.length())
+        return String();
+    if (endIndex > s.length())
+        endIndex = s.length();
+    return String(s.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(char find, char replace)
+{
+    for (char &c : s)
+    {
+        if (c == find)
+            c = replace;
+    }
+}
+
+void String::replace(const String &find, const String &replace)
+{
+    if (find.s.empty())
+        return;
+    size_t pos = 0;
+    while ((pos = s.find(find.s, pos)) != std::string::npos)
+    {
+        s.replace(pos, find.s.length(), replace.s);
+        pos += replace.s.length();
+    }
+}
+
+void String::toLowerCase()
+{
+    for (char &c : s)
+        c = tolower((unsigned char)c);
+}
+
+void String::toUpperCase()
+{
+    for (char &c : s)
+        c = toupper((unsigned char)c);
+}
+
+void String::trim()
+{
+    size_t b = s.find_first_not_of(" \t\r\n\f\v");
+    if (b == std::string::npos)
+    {
+        s.clear();
+        return;
+    }
+    size_t e = s.find_last_not_of(" \t\r\n\f\v");
+    s = s.substr(b, e - b + 1);
+}
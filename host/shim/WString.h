@@ -0,0 +1,194 @@
+/**
+ * The Arduino String of the host build, backed by std::string.
+ */
+
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <stdint.h>
+#include <string>
+
+class __FlashStringHelper;
+class StringSumHelper;
+
+class String
+{
+public:
+    String() {}
+    String(const char *cstr) { if (cstr) s = cstr; }
+    String(const char *cstr, unsigned int length) { if (cstr) s.assign(cstr, length); }
+    String(const __FlashStringHelper *str) : String(reinterpret_cast<const char *>(str)) {}
+    String(const std::string &str) : s(str) {}
+    String(const String &str) = default;
+    String(String &&str) = default;
+    explicit String(char c) : s(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10) : String((unsigned long)value, base) {}
+    explicit String(int value, unsigned char base = 10) : String((long)value, base) {}
+    explicit String(unsigned int value, unsigned char base = 10) : String((unsigned long)value, base) {}
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimalPlaces = 2) : String((double)value, decimalPlaces) {}
+    explicit String(double value, unsigned char decimalPlaces = 2);
+
+    String &operator=(const String &rhs) = default;
+    String &operator=(String &&rhs) = default;
+    String &operator=(const char *cstr)
+    {
+        s = cstr ? cstr : "";
+        return *this;
+    }
+    String &operator=(const __FlashStringHelper *str) { return *this = reinterpret_cast<const char *>(str); }
+
+    bool reserve(unsigned int size)
+    {
+        s.reserve(size);
+        return true;
+    }
+    unsigned int length() const { return s.length(); }
+    bool isEmpty() const { return s.empty(); }
+    const char *c_str() const { return s.c_str(); }
+    char *begin() { return &s[0]; }
+    char *end() { return &s[0] + s.length(); }
+
+    bool concat(const String &str)
+    {
+        s += str.s;
+        return true;
+    }
+    bool concat(const char *cstr)
+    {
+        if (cstr)
+            s += cstr;
+        return true;
+    }
+    bool concat(const char *cstr, unsigned int length)
+    {
+        if (cstr)
+            s.append(cstr, length);
+        return true;
+    }
+    bool concat(char c)
+    {
+        s += c;
+        return true;
+    }
+    bool concat(const __FlashStringHelper *str) { return concat(reinterpret_cast<const char *>(str)); }
+    template <typename T>
+    bool concat(T value) { return concat(String(value)); }
+
+    template <typename T>
+    String &operator+=(const T &rhs)
+    {
+        concat(rhs);
+        return *this;
+    }
+
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, const String &rhs);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, const char *cstr);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, char c);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, int num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned int num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, long num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned long num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, double num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, const __FlashStringHelper *rhs);
+
+    int compareTo(const String &str) const { return s.compare(str.s); }
+    bool equals(const String &str) const { return s == str.s; }
+    bool equals(const char *cstr) const { return s == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String &str) const;
+    bool operator==(const String &rhs) const { return equals(rhs); }
+    bool operator==(const char *cstr) const { return equals(cstr); }
+    bool operator!=(const String &rhs) const { return !equals(rhs); }
+    bool operator!=(const char *cstr) const { return !equals(cstr); }
+    bool operator<(const String &rhs) const { return s < rhs.s; }
+    bool startsWith(const String &prefix) const { return s.compare(0, prefix.s.length(), prefix.s) == 0; }
+    bool startsWith(const String &prefix, unsigned int offset) const { return offset <= s.length() && s.compare(offset, prefix.s.length(), prefix.s) == 0; }
+    bool endsWith(const String &suffix) const { return s.length() >= suffix.s.length() && s.compare(s.length() - suffix.s.length(), suffix.s.length(), suffix.s) == 0; }
+
+    char charAt(unsigned int index) const { return index < s.length() ? s[index] : 0; }
+    void setCharAt(unsigned int index, char c)
+    {
+        if (index < s.length())
+            s[index] = c;
+    }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index) { return s[index]; }
+    void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index = 0) const;
+    void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const { getBytes(reinterpret_cast<unsigned char *>(buf), bufsize, index); }
+
+    int indexOf(char ch, unsigned int fromIndex = 0) const { return find(s.find(ch, fromIndex)); }
+    int indexOf(const String &str, unsigned int fromIndex = 0) const { return find(s.find(str.s, fromIndex)); }
+    int lastIndexOf(char ch) const { return find(s.rfind(ch)); }
+    int lastIndexOf(char ch, unsigned int fromIndex) const { return find(s.rfind(ch, fromIndex)); }
+    int lastIndexOf(const String &str) const { return find(s.rfind(str.s)); }
+    int lastIndexOf(const String &str, unsigned int fromIndex) const { return find(s.rfind(str.s, fromIndex)); }
+    String substring(unsigned int beginIndex) const { return beginIndex < s.length() ? String(s.substr(beginIndex)) : String(); }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    void replace(char find, char replace);
+    void replace(const String &find, const String &replace);
+    void remove(unsigned int index) { remove(index, (unsigned int)-1); }
+    void remove(unsigned int index, unsigned int count)
+    {
+        if (index < s.length())
+            s.erase(index, count);
+    }
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const { return strtol(s.c_str(), nullptr, 10); }
+    float toFloat() const { return (float)toDouble(); }
+    double toDouble() const { return strtod(s.c_str(), nullptr); }
+
+    operator std::string() const { return s; }
+
+protected:
+    std::string s;
+
+private:
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+};
+
+class StringSumHelper : public String
+{
+public:
+    StringSumHelper(const String &s) : String(s) {}
+    StringSumHelper(const char *p) : String(p) {}
+    StringSumHelper(char c) : String(c) {}
+    StringSumHelper(int num) : String(num) {}
+    StringSumHelper(unsigned int num) : String(num) {}
+    StringSumHelper(long num) : String(num) {}
+    StringSumHelper(unsigned long num) : String(num) {}
+    StringSumHelper(double num) : String(num) {}
+};
+
+inline StringSumHelper &operator+(const StringSumHelper &lhs, const String &rhs)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(rhs);
+    return a;
+}
+inline StringSumHelper &operator+(const StringSumHelper &lhs, const char *cstr)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(cstr);
+    return a;
+}
+inline StringSumHelper &operator+(const StringSumHelper &lhs, char c)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(c);
+    return a;
+}
+inline StringSumHelper &operator+(const StringSumHelper &lhs, int num) { return lhs + String(num); }
+inline StringSumHelper &operator+(const StringSumHelper &lhs, unsigned int num) { return lhs + String(num); }
+inline StringSumHelper &operator+(const StringSumHelper &lhs, long num) { return lhs + String(num); }
+inline StringSumHelper &operator+(const StringSumHelper &lhs, unsigned long num) { return lhs + String(num); }
+inline StringSumHelper &operator+(const StringSumHelper &lhs, double num) { return lhs + String(num); }
+inline StringSumHelper &operator+(const StringSumHelper &lhs, const __FlashStringHelper *rhs) { return lhs + reinterpret_cast<const char *>(rhs); }
+
+#endif
@@ -0,0 +1,71 @@
+#include "Wire.h"
+#include <chrono>
+
+TwoWire Wire;
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency)
+{
+    (void)sda;
+    (void)scl;
+    if (frequency)
+        _clock = frequency;
+    _transactions = 0;
+    return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _address = address;
+    _tx.clear();
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    (void)sendStop;
+    _transactions++;
+    auto it = _devices.find(_address);
+    if (it == _devices.end())
+        return 2;
+    it->second->receive(_tx.data(), _tx.size());
+    busWait(_tx.size());
+    _tx.clear();
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop)
+{
+    (void)sendStop;
+    _transactions++;
+    _rx.clear();
+    _rxPos = 0;
+    auto it = _devices.find(address);
+    if (it == _devices.end())
+        return 0;
+    _rx.resize(quantity);
+    it->second->request(_rx.data(), quantity);
+    busWait(quantity);
+    return quantity;
+}
+
+void TwoWire::busWait(size_t bytes)
+{
+    if (!_busTiming || _clock == 0)
+        return;
+    // start, address and data bytes of 9 clocks each (ACK included), stop
+    auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds((uint64_t)(bytes + 1) * 9 * 1000000000ULL / _clock);
+    // too short for sleep_for to be on time
+    while (std::chrono::steady_clock::now() < end)
+        ;
+}
+
+size_t TwoWire::write(uint8_t c)
+{
+    _tx.push_back(c);
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len)
+{
+    _tx.insert(_tx.end(), data, data + len);
+    return len;
+}
@@ -0,0 +1,88 @@
+/**
+ * The I2C bus of the host build, the devices are simulated.
+ *
+ * A device is attached to an address with Wire.attach(), it receives the bytes of each
+ * beginTransmission()/endTransmission() and fills each requestFrom(). A transmission to an
+ * address without a device is not acknowledged (endTransmission() returns 2).
+ *
+ * With setBusTiming(true) each transaction takes the time of its bytes at the bus clock, as the
+ * blocking Wire of the board does.
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <vector>
+#include "Stream.h"
+
+class I2CDevice
+{
+public:
+    virtual ~I2CDevice() {}
+
+    // The bytes written by one transmission, the first one is usually the register
+    virtual void receive(const uint8_t *data, size_t len) = 0;
+
+    // The bytes read by one requestFrom
+    virtual void request(uint8_t *data, size_t len) = 0;
+};
+
+class TwoWire : public Stream
+{
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end() { return true; }
+    bool setClock(uint32_t frequency)
+    {
+        _clock = frequency;
+        return true;
+    }
+    uint32_t getClock() { return _clock; }
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+    uint8_t requestFrom(int address, int quantity, int sendStop = 1) { return requestFrom((uint8_t)address, (uint8_t)quantity, sendStop != 0); }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *data, size_t len) override;
+    // the integer overloads of the Wire of the cores, write(0) is not a null string
+    size_t write(unsigned long n) { return write((uint8_t)n); }
+    size_t write(long n) { return write((uint8_t)n); }
+    size_t write(unsigned int n) { return write((uint8_t)n); }
+    size_t write(int n) { return write((uint8_t)n); }
+    int available() override { return (int)(_rx.size() - _rxPos); }
+    int read() override { return _rxPos < _rx.size() ? _rx[_rxPos++] : -1; }
+    int peek() override { return _rxPos < _rx.size() ? _rx[_rxPos] : -1; }
+    void flush() override {}
+
+    using Print::write;
+
+    void attach(uint8_t address, I2CDevice *device) { _devices[address] = device; }
+    void detach(uint8_t address) { _devices.erase(address); }
+
+    // The transactions since begin(), one for each endTransmission() and requestFrom()
+    uint32_t transactions() const { return _transactions; }
+
+    void setBusTiming(bool enable) { _busTiming = enable; }
+
+private:
+    std::map<uint8_t, I2CDevice *> _devices;
+    std::vector<uint8_t> _tx;
+    std::vector<uint8_t> _rx;
+    size_t _rxPos = 0;
+    uint8_t _address = 0;
+    uint32_t _clock = 100000;
+    uint32_t _transactions = 0;
+    bool _busTiming = false;
+
+    void busWait(size_t bytes);
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * The checks of the host tests, each test file is one executable of ctest.
+ *
+ * HOST_TEST(name) { ... } defines a test, CHECK()/CHECK_EQ()/CHECK_NEAR() report the failure and
+ * go on with the test, HOST_TEST_MAIN() runs them all and returns the failed count.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct HostTestCase
+{
+    const char *name;
+    void (*run)();
+};
+
+inline std::vector<HostTestCase> &host_tests()
+{
+    static std::vector<HostTestCase> tests;
+    return tests;
+}
+
+inline int &host_test_failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+struct HostTestRegistrar
+{
+    HostTestRegistrar(const char *name, void (*run)()) { host_tests().push_back({name, run}); }
+};
+
+template <typename T>
+std::string host_test_str(const T &value)
+{
+    std::ostringstream ss;
+    ss << value;
+    return ss.str();
+}
+
+inline std::string host_test_str(const char *value) { return value ? "\"" + std::string(value) + "\"" : "null"; }
+inline std::string host_test_str(const std::string &value) { return "\"" + value + "\""; }
+inline std::string host_test_str(unsigned char value) { return std::to_string(value); }
+inline std::string host_test_str(signed char value) { return std::to_string(value); }
+
+inline void host_test_fail(const char *file, int line, const std::string &message)
+{
+    host_test_failures()++;
+    fprintf(stderr, "%s:%d: FAILED %s\n", file, line, message.c_str());
+}
+
+#define HOST_TEST(name)                                             \
+    static void name();                                             \
+    static HostTestRegistrar name##_registrar(#name, name);         \
+    static void name()
+
+#define CHECK(cond)                                                 \
+    do                                                              \
+    {                                                               \
+        if (!(cond))                                                \
+            host_test_fail(__FILE__, __LINE__, #cond);              \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                                    \
+    do                                                                                                    \
+    {                                                                                                     \
+        auto _a = (a);                                                                                    \
+        auto _b = (b);                                                                                    \
+        if (!(_a == _b))                                                                                  \
+            host_test_fail(__FILE__, __LINE__, #a " == " #b " (" + host_test_str(_a) + " vs " + host_test_str(_b) + ")"); \
+    } while (0)
+
+#define CHECK_STR(a, b)                                                                                   \
+    do                                                                                                    \
+    {                                                                                                     \
+        std::string _a = (a);                                                                             \
+        std::string _b = (b);                                                                             \
+        if (_a != _b)                                                                                     \
+            host_test_fail(__FILE__, __LINE__, #a " == " #b " (" + host_test_str(_a) + " vs " + host_test_str(_b) + ")"); \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                                             \
+    do                                                                                                    \
+    {                                                                                                     \
+        double _a = (a);                                                                                  \
+        double _b = (b);                                                                                  \
+        if (!(fabs(_a - _b) <= (tol)))                                                                    \
+            host_test_fail(__FILE__, __LINE__, #a " ~ " #b " (" + host_test_str(_a) + " vs " + host_test_str(_b) + ")"); \
+    } while (0)
+
+#define HOST_TEST_MAIN()                                                      \
+    int main(int argc, char **argv)                                           \
+    {                                                                         \
+        int run = 0;                                                          \
+        for (auto &test : host_tests())                                       \
+        {                                                                     \
+            if (argc > 1 && strstr(test.name, argv[1]) == nullptr)            \
+                continue;                                                     \
+            int before = host_test_failures();                                \
+            test.run();                                                       \
+            run++;                                                            \
+            printf("%s %s\n", host_test_failures() == before ? "ok  " : "FAIL", test.name); \
+        }                                                                     \
+        printf("%d tests, %d failed checks\n", run, host_test_failures());    \
+        return host_test_failures() ? 1 : 0;                                  \
+    }
+
+#endif
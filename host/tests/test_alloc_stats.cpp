@@ -0,0 +1,302 @@
+// The tagged allocation with ENABLE_ALLOC_STATS: the live, peak and block counts of each tag over
+// alloc/realloc/free, the tag of the scope, the allocator hooks of MB_String and FirebaseJson that
+// can't change while their blocks are alive and the largest free block watchdog.
+
+#include <Arduino.h>
+#include "json/FirebaseJson.h"
+#include "mbfs/MB_Alloc.h"
+#include "HostTest.h"
+
+#if !defined(ENABLE_ALLOC_STATS)
+#error "the test is built with ENABLE_ALLOC_STATS"
+#endif
+
+// The string longer than the inline buffer, it has a heap buffer
+static const char *longText = "The quick brown fox jumps over the lazy dog";
+
+HOST_TEST(tag_live_peak_blocks)
+{
+    // the firesense tag is not used by the string and JSON allocations of the test
+    const uint8_t tag = mb_alloc_tag_firesense;
+    MB_Alloc::resetStats();
+    MB_AllocStats base = MB_Alloc::getStats(tag);
+    CHECK_EQ(base.live, 0u);
+    CHECK_EQ(base.blocks, 0u);
+
+    void *a = MB_Alloc::alloc(tag, 100, false);
+    CHECK(a != nullptr);
+    MB_AllocStats stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.live, 100u);
+    CHECK_EQ(stats.peak, 100u);
+    CHECK_EQ(stats.blocks, 1u);
+    CHECK_EQ(stats.allocs, 1u);
+
+    a = MB_Alloc::realloc(tag, a, 300, false);
+    CHECK(a != nullptr);
+    void *b = MB_Alloc::alloc(tag, 50, false, true);
+    CHECK(b != nullptr && ((uint8_t *)b)[49] == 0);
+    stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.live, 350u);
+    CHECK_EQ(stats.peak, 350u);
+    CHECK_EQ(stats.blocks, 2u);
+
+    a = MB_Alloc::realloc(tag, a, 20, false);
+    stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.live, 70u);
+    CHECK_EQ(stats.peak, 350u);
+    CHECK_EQ(stats.blocks, 2u);
+
+    MB_Alloc::free(a);
+    stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.live, 50u);
+    CHECK_EQ(stats.blocks, 1u);
+
+    MB_Alloc::free(b);
+    stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.live, 0u);
+    CHECK_EQ(stats.peak, 350u);
+    CHECK_EQ(stats.blocks, 0u);
+    CHECK_EQ(stats.fails, 0u);
+
+    MB_Alloc::resetStats();
+    stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.peak, 0u);
+    CHECK_EQ(stats.allocs, 0u);
+
+    // the block that was not allocated here is freed as is
+    MB_Alloc::free(::malloc(16));
+    CHECK_EQ(MB_Alloc::getStats(tag).blocks, 0u);
+}
+
+HOST_TEST(many_blocks)
+{
+    // past the first table of 64 blocks and back, the blocks are removed in the other order
+    const uint8_t tag = mb_alloc_tag_firesense;
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < 1000; i++)
+        blocks.push_back(MB_Alloc::alloc(tag, i + 1, false));
+    MB_AllocStats stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.blocks, 1000u);
+    CHECK_EQ(stats.live, 1000u * 1001u / 2);
+
+    for (size_t i = 0; i < blocks.size(); i += 2)
+        MB_Alloc::free(blocks[i]);
+    for (size_t i = blocks.size() - 1; i < blocks.size(); i -= 2)
+        blocks[i] = MB_Alloc::realloc(tag, blocks[i], 1, false);
+    stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.blocks, 500u);
+    CHECK_EQ(stats.live, 500u);
+
+    for (size_t i = 1; i < blocks.size(); i += 2)
+        MB_Alloc::free(blocks[i]);
+    stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.blocks, 0u);
+    CHECK_EQ(stats.live, 0u);
+}
+
+HOST_TEST(realloc_keeps_tag)
+{
+    MB_AllocStats tls = MB_Alloc::getStats(mb_alloc_tag_tls);
+    MB_AllocStats http = MB_Alloc::getStats(mb_alloc_tag_http);
+
+    void *p = MB_Alloc::alloc(mb_alloc_tag_tls, 64, false);
+    p = MB_Alloc::realloc(mb_alloc_tag_http, p, 512, false);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_tls).live, tls.live + 512);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_tls).blocks, tls.blocks + 1);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_http).live, http.live);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_http).blocks, http.blocks);
+
+    MB_Alloc::free(p);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_tls).live, tls.live);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_tls).blocks, tls.blocks);
+}
+
+HOST_TEST(scope_tag)
+{
+    const uint8_t tag = mb_alloc_tag_rtdb_queue;
+    MB_AllocStats string = MB_Alloc::getStats(mb_alloc_tag_string);
+    MB_AllocStats json = MB_Alloc::getStats(mb_alloc_tag_json);
+    CHECK_EQ(MB_Alloc::tag(mb_alloc_tag_string), (uint8_t)mb_alloc_tag_string);
+
+    MB_String *s = nullptr;
+    FirebaseJson *doc = nullptr;
+    {
+        MB_AllocTagScope scope(tag);
+        CHECK_EQ(MB_Alloc::tag(mb_alloc_tag_string), tag);
+        {
+            // the inner scope tags its own allocations and restores the outer tag
+            MB_AllocTagScope inner(mb_alloc_tag_firesense);
+            CHECK_EQ(MB_Alloc::tag(mb_alloc_tag_string), (uint8_t)mb_alloc_tag_firesense);
+        }
+        CHECK_EQ(MB_Alloc::tag(mb_alloc_tag_string), tag);
+
+        s = new MB_String(longText);
+        doc = new FirebaseJson();
+        doc->set("vitals/bpm", 72);
+        doc->set("vitals/note", longText);
+    }
+    CHECK_EQ(MB_Alloc::tag(mb_alloc_tag_string), (uint8_t)mb_alloc_tag_string);
+
+    MB_AllocStats stats = MB_Alloc::getStats(tag);
+    CHECK(stats.blocks >= 2);
+    CHECK(stats.live >= strlen(longText) * 2);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_string).blocks, string.blocks);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_json).blocks, json.blocks);
+
+    // the string grows out of the scope, the block keeps the tag
+    *s += longText;
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_string).blocks, string.blocks);
+
+    // out of the scope the default tags are used
+    MB_String t(longText);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_string).blocks, string.blocks + 1);
+
+    delete s;
+    delete doc;
+    stats = MB_Alloc::getStats(tag);
+    CHECK_EQ(stats.blocks, 0u);
+    CHECK_EQ(stats.live, 0u);
+}
+
+static size_t hookAllocs = 0;
+
+static void *countingMalloc(size_t len)
+{
+    hookAllocs++;
+    return ::malloc(len);
+}
+
+static void *countingRealloc(void *ptr, size_t len)
+{
+    if (!ptr)
+        hookAllocs++;
+    return ::realloc(ptr, len);
+}
+
+static void countingFree(void *ptr)
+{
+    ::free(ptr);
+}
+
+HOST_TEST(string_hooks)
+{
+    MB_String_Hooks hooks = {countingMalloc, countingRealloc, countingFree};
+
+    MB_String *s = new MB_String(longText);
+    CHECK(!MB_String::setHooks(&hooks));
+    delete s;
+    CHECK(MB_String::setHooks(&hooks));
+
+    uint32_t allocs = MB_Alloc::getStats(mb_alloc_tag_string).allocs;
+    hookAllocs = 0;
+    s = new MB_String(longText);
+    *s += longText;
+    CHECK(hookAllocs >= 1);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_string).allocs, allocs);
+
+    // the buffer of the hooks is alive
+    CHECK(!MB_String::setHooks(nullptr));
+    delete s;
+    CHECK(MB_String::setHooks(nullptr));
+
+    s = new MB_String(longText);
+    CHECK(MB_Alloc::getStats(mb_alloc_tag_string).allocs > allocs);
+    delete s;
+}
+
+static void *MB_JSON_CDECL countingJsonMalloc(size_t len)
+{
+    return countingMalloc(len);
+}
+
+static void *MB_JSON_CDECL countingJsonRealloc(void *ptr, size_t len)
+{
+    return countingRealloc(ptr, len);
+}
+
+static void MB_JSON_CDECL countingJsonFree(void *ptr)
+{
+    countingFree(ptr);
+}
+
+HOST_TEST(json_hooks)
+{
+    MB_JSON_Hooks hooks = {countingJsonMalloc, countingJsonFree, countingJsonRealloc};
+
+    FirebaseJson *doc = new FirebaseJson();
+    doc->set("vitals/bpm", 72);
+    CHECK(!FirebaseJsonBase::setHooks(&hooks));
+    CHECK(!MB_JSON_InitHooks(&hooks));
+    delete doc;
+    CHECK(FirebaseJsonBase::setHooks(&hooks));
+
+    // the nodes are of the hooks, the temporary buffers of the path are not
+    hookAllocs = 0;
+    doc = new FirebaseJson();
+    doc->set("vitals/bpm", 72);
+    CHECK(hookAllocs >= 1);
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_json).blocks, 0u);
+
+    // the nodes of the hooks are alive
+    CHECK(!FirebaseJsonBase::setHooks(nullptr));
+    delete doc;
+    CHECK(FirebaseJsonBase::setHooks(nullptr));
+
+    hookAllocs = 0;
+    doc = new FirebaseJson();
+    doc->set("vitals/bpm", 72);
+    CHECK_EQ(hookAllocs, (size_t)0);
+    CHECK(MB_Alloc::getStats(mb_alloc_tag_json).blocks > 0);
+    delete doc;
+    CHECK_EQ(MB_Alloc::getStats(mb_alloc_tag_json).blocks, 0u);
+}
+
+static size_t watchdogCalls = 0;
+static size_t watchdogBlock = 0;
+static size_t watchdogHeap = 0;
+
+static void watchdog(size_t largestBlock, size_t freeHeap)
+{
+    watchdogCalls++;
+    watchdogBlock = largestBlock;
+    watchdogHeap = freeHeap;
+}
+
+HOST_TEST(watchdog_once_below)
+{
+    // not checked while the largest free block is unknown
+    host_set_heap(0, 0);
+    MB_Alloc::setWatchdog(4096, watchdog);
+    CHECK(MB_Alloc::checkWatchdog());
+    CHECK_EQ(watchdogCalls, (size_t)0);
+
+    host_set_heap(16384, 40000);
+    MB_Alloc::resetStats();
+    CHECK(MB_Alloc::checkWatchdog());
+    CHECK_EQ(watchdogCalls, (size_t)0);
+    CHECK_EQ(MB_Alloc::lowestFreeBlock(), (size_t)16384);
+
+    // once until it recovers
+    host_set_heap(3000, 20000);
+    CHECK(!MB_Alloc::checkWatchdog());
+    host_set_heap(2000, 18000);
+    CHECK(!MB_Alloc::checkWatchdog());
+    CHECK_EQ(watchdogCalls, (size_t)1);
+    CHECK_EQ(watchdogBlock, (size_t)3000);
+    CHECK_EQ(watchdogHeap, (size_t)20000);
+    CHECK_EQ(MB_Alloc::lowestFreeBlock(), (size_t)2000);
+
+    host_set_heap(4096, 20000);
+    CHECK(MB_Alloc::checkWatchdog());
+    host_set_heap(1000, 10000);
+    CHECK(!MB_Alloc::checkWatchdog());
+    CHECK_EQ(watchdogCalls, (size_t)2);
+    CHECK_EQ(watchdogBlock, (size_t)1000);
+
+    MB_Alloc::setWatchdog(0, nullptr);
+    CHECK(MB_Alloc::checkWatchdog());
+    CHECK_EQ(watchdogCalls, (size_t)2);
+    host_set_heap(0, 0);
+}
+
+HOST_TEST_MAIN()
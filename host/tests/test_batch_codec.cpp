@@ -0,0 +1,228 @@
+// The channel batches of the sketch (src/main/BatchCodec.h): the INTEGER and FLOAT round trips and
+// the blobs batch_decode must reject without throwing.
+
+#include <math.h>
+#include <limits>
+#include <random>
+#include "BatchCodec.h"
+#include "HostTest.h"
+
+static std::string encodeInts(const std::vector<int64_t> &in)
+{
+    BatchCodec codec(BatchCodec::INTEGER);
+    for (int64_t v : in)
+        codec.add(v);
+    return codec.base64();
+}
+
+static std::string encodeFloats(const std::vector<float> &in)
+{
+    BatchCodec codec(BatchCodec::FLOAT);
+    for (float v : in)
+        codec.add(v);
+    return codec.base64();
+}
+
+static uint32_t floatBits(float v)
+{
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+static void checkInts(const std::vector<int64_t> &in)
+{
+    std::vector<double> out;
+    CHECK(BatchCodec::decode(encodeInts(in), out));
+    CHECK_EQ(out.size(), in.size());
+    for (size_t i = 0; i < in.size() && i < out.size(); i++)
+        CHECK_EQ(out[i], (double)in[i]);
+}
+
+// The decoded value is the float bit for bit, NaN only as NaN since double keeps no signaling bit
+static void checkFloats(const std::vector<float> &in)
+{
+    std::vector<double> out;
+    CHECK(BatchCodec::decode(encodeFloats(in), out));
+    CHECK_EQ(out.size(), in.size());
+    for (size_t i = 0; i < in.size() && i < out.size(); i++)
+    {
+        if (isnan(in[i]))
+            CHECK(isnan(out[i]));
+        else
+            CHECK_EQ(floatBits((float)out[i]), floatBits(in[i]));
+    }
+}
+
+HOST_TEST(integer_round_trip)
+{
+    checkInts({});
+    checkInts({0});
+    checkInts({1, 2, 3, 3, 3, 2, 1, 0, -1, -1000, 1000000});
+
+    std::mt19937 rng(38);
+    std::vector<int64_t> walk;
+    int64_t v = 0;
+    for (int i = 0; i < 5000; i++)
+    {
+        v += (int64_t)(rng() % 201) - 100;
+        walk.push_back(v);
+    }
+    checkInts(walk);
+}
+
+HOST_TEST(integer_extremes)
+{
+    const int64_t lo = std::numeric_limits<int64_t>::min();
+    const int64_t hi = std::numeric_limits<int64_t>::max();
+    // the deltas between the extremes wrap in 64 bits both ways
+    std::vector<int64_t> in = {lo, hi, lo, 0, hi, -1, lo + 1, hi - 1, 1, lo};
+    BatchCodec codec(BatchCodec::INTEGER);
+    for (int64_t x : in)
+        codec.add(x);
+
+    // the doubles of the decoder only hold 53 bits, compare the values they round to
+    std::vector<double> out;
+    CHECK(BatchCodec::decode(codec.base64(), out));
+    CHECK_EQ(out.size(), in.size());
+    for (size_t i = 0; i < in.size() && i < out.size(); i++)
+        CHECK_EQ(out[i], (double)in[i]);
+
+    // the zigzag values of the 32-bit fixed point channels are exact
+    checkInts({INT32_MIN, INT32_MAX, INT32_MIN, 0, -1, 1});
+}
+
+HOST_TEST(integer_is_compact)
+{
+    // a slow signal takes a byte a sample
+    BatchCodec codec(BatchCodec::INTEGER);
+    for (int i = 0; i < 300; i++)
+        codec.add((int64_t)(20000 + (i % 7) - 3));
+    std::string text = codec.base64();
+    CHECK(text.size() <= (300 + 6 + 2) / 3 * 4 + 4);
+    CHECK_EQ(codec.count(), (uint32_t)300);
+
+    codec.clear();
+    CHECK_EQ(codec.count(), (uint32_t)0);
+    std::vector<double> out = {1, 2};
+    CHECK(BatchCodec::decode(codec.base64(), out));
+    CHECK(out.empty());
+}
+
+HOST_TEST(float_round_trip)
+{
+    checkFloats({});
+    checkFloats({36.6f});
+    // same value, same window and new window
+    checkFloats({36.6f, 36.6f, 36.6f, 36.7f, 36.7f, 36.8f, 36.6f, -12.5f, 1e-30f, 3.4e38f});
+
+    std::mt19937 rng(39);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::vector<float> wave;
+    for (int i = 0; i < 5000; i++)
+        wave.push_back(9.81f + sinf(i * 0.05f) + noise(rng));
+    checkFloats(wave);
+}
+
+HOST_TEST(float_special_values)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float denorm = std::numeric_limits<float>::denorm_min();
+    // +0/-0 differ in the sign bit only, the XOR of a full 32-bit window follows -0 to a denormal
+    checkFloats({0.0f, -0.0f, 0.0f, -0.0f, denorm, -denorm, inf, -inf, nan, nan, 1.0f, nan, -0.0f});
+    checkFloats({-0.0f});
+    checkFloats({nan});
+    checkFloats({-3.0f, 3.0f});
+
+    // the XOR of every single bit, the windows of length 1 to 32
+    std::vector<float> bits = {0.0f};
+    for (int b = 0; b < 32; b++)
+    {
+        uint32_t x = 1u << b;
+        float f;
+        memcpy(&f, &x, sizeof(f));
+        bits.push_back(f);
+        bits.push_back(0.0f);
+    }
+    uint32_t all = 0xFFFFFFFFu;
+    float f;
+    memcpy(&f, &all, sizeof(f));
+    bits.push_back(f);
+    checkFloats(bits);
+}
+
+HOST_TEST(kinds_convert)
+{
+    // the INTEGER batch truncates a float, the FLOAT batch takes an integer as a float
+    BatchCodec ints(BatchCodec::INTEGER);
+    ints.add(2.9f);
+    ints.add(-2.9f);
+    std::vector<double> out;
+    CHECK(BatchCodec::decode(ints.base64(), out));
+    CHECK(out.size() == 2 && out[0] == 2 && out[1] == -2);
+
+    BatchCodec floats(BatchCodec::FLOAT);
+    floats.add((int64_t)7);
+    floats.add((int64_t)-7);
+    CHECK(BatchCodec::decode(floats.base64(), out));
+    CHECK(out.size() == 2 && out[0] == 7 && out[1] == -7);
+}
+
+HOST_TEST(truncated_blobs)
+{
+    std::vector<int64_t> ints;
+    for (int i = 0; i < 50; i++)
+        ints.push_back(i * 1000 - 25000);
+    std::vector<float> floats;
+    for (int i = 0; i < 50; i++)
+        floats.push_back(sinf(i * 0.3f) * 100);
+
+    for (const std::string &text : {encodeInts(ints), encodeFloats(floats)})
+    {
+        std::vector<double> out;
+        CHECK(BatchCodec::decode(text, out));
+        // every 4 character cut is a whole number of base64 groups, the body ends early
+        for (size_t len = 0; len + 4 < text.size(); len += 4)
+        {
+            CHECK(!BatchCodec::decode(text.substr(0, len), out));
+            CHECK(out.size() < 50);
+        }
+    }
+}
+
+HOST_TEST(over_long_count)
+{
+    std::vector<double> out;
+    // INTEGER, count 2^40 and one byte of body
+    CHECK(!BatchCodec::decode("AYCAgICAIA==", out));
+    CHECK(out.empty());
+    // the count of a 10-byte varint that never ends
+    CHECK(!BatchCodec::decode("AYCAgICAgICAgICA", out));
+    // FLOAT, count 1000 with 4 bytes of body
+    CHECK(!BatchCodec::decode("AugHAACAPw==", out));
+    // count 9 with a single byte of body, more than its 8 bits
+    CHECK(!BatchCodec::decode("AQkC", out));
+}
+
+HOST_TEST(bad_blobs)
+{
+    std::vector<double> out;
+    CHECK(!BatchCodec::decode("", out));
+    CHECK(!BatchCodec::decode("AQI*AgI=", out));
+    CHECK(!BatchCodec::decode("AQI AgI=", out));
+    CHECK(!BatchCodec::decode("AQIC\x80gI=", out));
+    // unknown kind
+    CHECK(!BatchCodec::decode(std::string("AwEC"), out));
+    // FLOAT window of 31 leading zeros and 32 bits: lead + len > 32
+    CHECK(!BatchCodec::decode("AgIAAIA///AAAAAA", out));
+    // the URL-safe alphabet and line breaks are accepted
+    std::string text = encodeInts({-1, 62, 63, 4000000, -4000000});
+    std::string url = text;
+    for (char &c : url)
+        c = c == '+' ? '-' : c == '/' ? '_' : c;
+    CHECK(BatchCodec::decode(url.substr(0, 4) + "\r\n" + url.substr(4), out));
+    CHECK_EQ(out.size(), (size_t)5);
+}
+
+HOST_TEST_MAIN()
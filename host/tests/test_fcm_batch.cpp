@@ -0,0 +1,125 @@
+// The FCM batch of the library against the loopback server, the messages are pipelined over one
+// connection that the server closes in the middle of the pipeline. Run as "test_fcm_batch _plain"
+// and "test_fcm_batch _tls" as the token and the sessions of the library are global.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include <HostClient.h>
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+// the client outlives fbdo that stops it when destroyed
+static HostClient client;
+static FirebaseData fbdo;
+static FirebaseConfig config;
+static FirebaseAuth auth;
+
+static std::vector<FCM_BatchResult> results;
+
+static void networkConnection() {}
+
+static void networkStatusRequest()
+{
+    fbdo.setNetworkStatus(true);
+}
+
+static void batchResult(FCM_BatchResult result)
+{
+    results.push_back(result);
+}
+
+static bool waitReady(unsigned long timeoutMs)
+{
+    unsigned long start = millis();
+    while (millis() - start < timeoutMs)
+    {
+        if (Firebase.ready())
+            return true;
+        delay(5);
+    }
+    return false;
+}
+
+static size_t resultsOf(size_t index)
+{
+    size_t n = 0;
+    for (auto &result : results)
+        n += result.index == index;
+    return n;
+}
+
+static void closeMidPipeline(bool tls)
+{
+    const char *tokens[] = {"device-0", "device-1", "device-2", "device\"3", "device-4", "", "device-6", "device-7"};
+    const size_t numToken = sizeof(tokens) / sizeof(tokens[0]);
+
+    LoopbackServer server(tls);
+    // the server reads all requests ahead before it answers, the one of device-1 is answered
+    // with connection close and the requests pipelined after it are not read
+    server.setLatency(20);
+    bool closed = false;
+    server.on("POST", "/v1/projects/host-test/messages:send", [&](const LoopbackRequest &request, LoopbackResponse &response) {
+        response.body = "{\"name\":\"projects/host-test/messages/" + std::to_string(request.receivedMs) + "\"}";
+        if (!closed && request.body.find("\"device-1\"") != std::string::npos)
+        {
+            closed = true;
+            response.close = true;
+        }
+    });
+    CHECK(server.start());
+
+    config.service_account.data.project_id = "host-test";
+    fbdo.setGenericClient(&client, networkConnection, networkStatusRequest);
+    fbdo.setResponseSize(4096);
+    Firebase.reconnectNetwork(true);
+    Firebase.setAccessToken(&config, "ya29.host-test-access-token", 3600);
+    Firebase.begin(&config, &auth);
+    CHECK(waitReady(5000));
+
+    FCM_HTTPv1_JSON_Message msg;
+    msg.notification.title = "Vitals";
+    msg.notification.body = "bpm 72";
+
+    Firebase.FCM.resetBatchStats();
+    CHECK(!Firebase.FCM.sendBatch(&fbdo, &msg, tokens, numToken, batchResult));
+
+    // each token but the empty one has one result, the invalid token is not sent
+    CHECK_EQ(results.size(), (size_t)7);
+    for (size_t i = 0; i < numToken; i++)
+        CHECK_EQ(resultsOf(i), (size_t)(i == 5 ? 0 : 1));
+    for (auto &result : results)
+        CHECK_EQ(result.httpCode, result.index == 3 ? FIREBASE_ERROR_FCM_INVALID_TOKEN : 200);
+
+    std::vector<LoopbackRequest> requests = server.requests();
+    for (size_t i = 0; i < numToken; i++)
+    {
+        size_t n = 0;
+        std::string quoted = "\"" + std::string(tokens[i]) + "\"";
+        for (auto &request : requests)
+            n += request.body.find(quoted) != std::string::npos;
+        // the server answers each valid token once, the resent requests were not read
+        CHECK_EQ(n, (size_t)(i == 3 || i == 5 ? 0 : 1));
+    }
+    CHECK_EQ(server.connections(), 2u);
+
+    FCM_BatchStats stats = Firebase.FCM.getBatchStats();
+    CHECK_EQ(stats.sent, 6u);
+    CHECK_EQ(stats.succeeded, 6u);
+    CHECK_EQ(stats.failed, 1u);
+    CHECK(stats.resent > 0);
+    CHECK_EQ(stats.connections, 2u);
+
+    server.stop();
+}
+
+HOST_TEST(batch_plain)
+{
+    closeMidPipeline(false);
+}
+
+HOST_TEST(batch_tls)
+{
+    closeMidPipeline(true);
+}
+
+HOST_TEST_MAIN()
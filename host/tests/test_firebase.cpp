@@ -0,0 +1,133 @@
+// The library against the loopback server, run as "test_firebase _plain" and "test_firebase _tls"
+// as the token and the sessions of the library are global.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include <HostClient.h>
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+static FirebaseData fbdo;
+static FirebaseConfig config;
+static FirebaseAuth auth;
+static HostClient client;
+
+static void networkConnection() {}
+
+static void networkStatusRequest()
+{
+    fbdo.setNetworkStatus(true);
+}
+
+static void routeFixtures(LoopbackServer &server)
+{
+    server.onFixture("POST", "/identitytoolkit/v3/relyingparty/verifyPassword", "token/verify_password.json");
+    server.onFixture("POST", "/v1/token", "token/refresh.json");
+    server.onFixture("GET", "/patients/p-0001.json", "rtdb/get.json");
+    server.onFixture("GET", "/v1/projects/host-test/databases/(default)/documents/patients/p-0001", "firestore/get_document.json");
+    server.onFixture("GET", "/v1/projects/host-test/databases/(default)/documents/SensorData", "firestore/list_documents.json");
+    server.onFixture("POST", "/v1/projects/host-test/databases/(default)/documents/SensorData", "firestore/create_document.json");
+    server.onFixture("GET", "/v1/projects/host-test/databases/(default)/documents/patients/p-9999", "firestore/not_found.json", 404);
+}
+
+static bool waitReady(unsigned long timeoutMs)
+{
+    unsigned long start = millis();
+    while (millis() - start < timeoutMs)
+    {
+        if (Firebase.ready())
+            return true;
+        delay(5);
+    }
+    return false;
+}
+
+static void signInAndRequest(bool tls)
+{
+    LoopbackServer server(tls);
+    routeFixtures(server);
+    CHECK(server.start());
+
+    config.api_key = "host-test-api-key";
+    config.database_url = "host-test-default-rtdb.firebaseio.com";
+    auth.user.email = "device-01@example.com";
+    auth.user.password = "host-test-password";
+    fbdo.setGenericClient(&client, networkConnection, networkStatusRequest);
+    fbdo.setResponseSize(4096);
+    Firebase.reconnectNetwork(true);
+    Firebase.begin(&config, &auth);
+
+    CHECK(waitReady(5000));
+    CHECK_STR(auth.token.uid.c_str(), "Xq3hQ0c8bTf1r2mJ7sVv9LkWp4A2");
+    CHECK(strncmp(Firebase.getToken(), "eyJhbGciOiJSUzI1NiIs", 20) == 0);
+
+    std::vector<LoopbackRequest> requests = server.requests();
+    CHECK(requests.size() >= 1);
+    if (requests.size() >= 1)
+    {
+        CHECK(requests[0].query == "key=host-test-api-key");
+        CHECK(requests[0].body.find("\"email\":\"device-01@example.com\"") != std::string::npos);
+        CHECK(requests[0].body.find("\"returnSecureToken\":true") != std::string::npos);
+    }
+
+    CHECK(Firebase.RTDB.getJSON(&fbdo, "/patients/p-0001"));
+    FirebaseJson &json = fbdo.to<FirebaseJson>();
+    FirebaseJsonData result;
+    CHECK(json.get(result, "vitals/bpm"));
+    CHECK_EQ(result.to<int>(), 72);
+    CHECK(server.requests().back().query.find("auth=eyJ") == 0);
+
+    CHECK(Firebase.Firestore.getDocument(&fbdo, "host-test", "", "patients/p-0001", ""));
+    FirebaseJson doc;
+    doc.setJsonData(fbdo.payload());
+    CHECK(doc.get(result, "fields/thresholds/mapValue/fields/bpmHigh/integerValue"));
+    CHECK_STR(result.to<const char *>(), "120");
+    CHECK_STR(server.requests().back().header("authorization"), "Firebase " + std::string(Firebase.getToken()));
+
+    FirebaseJson content;
+    content.set("fields/Synced/booleanValue", true);
+    CHECK(Firebase.Firestore.createDocument(&fbdo, "host-test", "", "SensorData", "4294965295", content.raw(), ""));
+    CHECK(server.requests().back().query.find("documentId=4294965295") != std::string::npos);
+    CHECK_STR(server.requests().back().body, "{\"fields\":{\"Synced\":{\"booleanValue\":true}}}");
+
+    CHECK(Firebase.Firestore.listDocuments(&fbdo, "host-test", "", "SensorData", 3, "", "", "", false));
+    CHECK(fbdo.payload().indexOf("nextPageToken") > 0);
+
+    CHECK(!Firebase.Firestore.getDocument(&fbdo, "host-test", "", "patients/p-9999", ""));
+    CHECK_EQ(fbdo.httpCode(), 404);
+    CHECK(fbdo.errorReason().indexOf("No document to update") >= 0);
+
+    // the Firestore requests share one connection
+    requests = server.requests();
+    CHECK(requests.size() >= 4);
+    for (size_t i = requests.size() - 4; i < requests.size(); i++)
+        CHECK_EQ(requests[i].connection, requests.back().connection);
+
+    // the server closes the connection without a response, the request fails at once instead of
+    // waiting for the response time out
+    server.setLoss(1.0);
+    unsigned long start = millis();
+    CHECK(!Firebase.Firestore.createDocument(&fbdo, "host-test", "", "SensorData", "4294965296", content.raw(), ""));
+    CHECK(millis() - start < 2000);
+    CHECK_EQ(fbdo.httpCode(), FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST);
+    CHECK(server.dropped() >= 1);
+    server.setLoss(0);
+
+    Firebase.refreshToken(&config);
+    CHECK(waitReady(5000));
+    CHECK(server.requests().back().path == "/v1/token");
+
+    server.stop();
+}
+
+HOST_TEST(library_plain)
+{
+    signInAndRequest(false);
+}
+
+HOST_TEST(library_tls)
+{
+    signInAndRequest(true);
+}
+
+HOST_TEST_MAIN()
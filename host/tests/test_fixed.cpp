@@ -0,0 +1,234 @@
+// The fixed point math of the sketch (src/main/Fixed.h) against a double precision reference, over
+// the whole input range and beyond it, where the results saturate.
+
+#include <math.h>
+#include <random>
+#include "Fixed.h"
+#include "HostTest.h"
+
+// The reference raw value of x in Q(frac), saturated, rounded toward zero as the integer division
+static double refRaw(double x, int frac)
+{
+    double raw = trunc(x * ldexp(1.0, frac));
+    if (raw > INT32_MAX)
+        return INT32_MAX;
+    if (raw < INT32_MIN)
+        return INT32_MIN;
+    return raw;
+}
+
+static std::vector<int32_t> samples(uint32_t seed, size_t count)
+{
+    std::vector<int32_t> v = {0, 1, -1, 2, -2, 255, 256, -256, 32767, -32768, 65535, 262143, 8388607, -8388608,
+                              8388608, 16777216, INT32_MAX, INT32_MIN, INT32_MAX - 1, INT32_MIN + 1};
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < count; i++)
+    {
+        // uniform in the magnitude, the small values are as covered as the large ones
+        int bits = (int)(rng() % 32);
+        int32_t x = (int32_t)(rng() & ((bits == 31 ? 0x7fffffffu : (1u << bits) - 1)));
+        v.push_back(rng() & 1 ? x : -x);
+    }
+    return v;
+}
+
+template <uint8_t FRAC>
+static void checkFromIntToInt()
+{
+    using F = Fixed<FRAC>;
+    for (int32_t x : samples(FRAC, 20000))
+    {
+        F f = F::fromInt(x);
+        CHECK_EQ((double)f.raw(), refRaw(x, FRAC));
+        // the integers in range come back, the saturated ones come back as the limit
+        double back = floor(f.raw() / ldexp(1.0, FRAC) + 0.5);
+        CHECK_EQ((double)f.toInt(), back);
+    }
+}
+
+HOST_TEST(from_int_to_int)
+{
+    checkFromIntToInt<0>();
+    checkFromIntToInt<8>();
+    checkFromIntToInt<16>();
+    checkFromIntToInt<30>();
+}
+
+template <uint8_t FRAC>
+static void checkRatio()
+{
+    using F = Fixed<FRAC>;
+    std::vector<int32_t> nums = samples(100 + FRAC, 3000);
+    std::vector<int32_t> dens = samples(200 + FRAC, 3000);
+    for (size_t i = 0; i < nums.size(); i++)
+    {
+        int32_t num = nums[i];
+        int32_t den = dens[i];
+        F f = F::ratio(num, den);
+        if (den == 0)
+        {
+            CHECK_EQ(f.raw(), 0);
+            continue;
+        }
+        // num * 2^FRAC is exact in double up to 2^53, the quotient is within one unit of the last place
+        double ref = refRaw((double)num / den, FRAC);
+        CHECK_NEAR((double)f.raw(), ref, 1.0);
+    }
+}
+
+HOST_TEST(ratio)
+{
+    checkRatio<0>();
+    checkRatio<8>();
+    checkRatio<16>();
+    checkRatio<30>();
+
+    // the heart rate of the beat interval in ms
+    using F = Fixed<8>;
+    for (int32_t delta = 1; delta <= 5000; delta++)
+        CHECK_NEAR(F::ratio(60000, delta).raw() / 256.0, 60000.0 / delta, 1.0 / 256);
+    CHECK_EQ(F::ratio(INT32_MAX, 1).raw(), INT32_MAX);
+    CHECK_EQ(F::ratio(INT32_MIN, 1).raw(), INT32_MIN);
+    CHECK_EQ(F::ratio(INT32_MIN, -1).raw(), INT32_MAX);
+}
+
+template <uint8_t FRAC, int32_t NUM, int32_t DEN>
+static void checkConvert(uint32_t seed)
+{
+    for (int32_t raw : samples(seed, 20000))
+    {
+        Fixed<FRAC> f = convert<FRAC, NUM, DEN>(raw);
+        double ref = refRaw((double)raw * NUM / DEN, FRAC);
+        // the product of the reference is rounded to 53 bits, it may be a unit off in the last place
+        CHECK_NEAR((double)f.raw(), ref, fmax(1.0, fabs(ref) * 1e-15));
+        if (fabs((double)raw * NUM / DEN * ldexp(1.0, FRAC)) > 4.0 * INT32_MAX)
+            CHECK_EQ((double)f.raw(), ref);
+    }
+}
+
+HOST_TEST(convert)
+{
+    // the MAX30205 count is 1/256 °C, every count is kept
+    for (int32_t raw = 0; raw <= 0xffff; raw++)
+        CHECK_EQ((convert<8, 1, 256>(raw).raw()), raw);
+
+    checkConvert<8, 1, 256>(1);
+    checkConvert<0, 1, 256>(2);
+    checkConvert<16, 1000, 3>(3);
+    checkConvert<8, -5, 3>(4);
+    checkConvert<4, 123456789, 7>(5);
+    checkConvert<30, INT32_MAX, 1>(6);
+    checkConvert<12, 1, INT32_MAX>(7);
+}
+
+template <uint8_t FRAC>
+static void checkArithmetic()
+{
+    using F = Fixed<FRAC>;
+    std::vector<int32_t> a = samples(300 + FRAC, 5000);
+    std::vector<int32_t> b = samples(400 + FRAC, 5000);
+    double one = ldexp(1.0, FRAC);
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        F x = F::fromRaw(a[i]);
+        F y = F::fromRaw(b[i]);
+        CHECK_EQ((double)(x + y).raw(), refRaw(((double)a[i] + b[i]) / one, FRAC));
+        CHECK_EQ((double)(x - y).raw(), refRaw(((double)a[i] - b[i]) / one, FRAC));
+        // the product is rounded toward minus infinity by the shift
+        double p = floor((double)a[i] * b[i] / one);
+        p = p > INT32_MAX ? INT32_MAX : p < INT32_MIN ? INT32_MIN : p;
+        CHECK_NEAR((double)(x * y).raw(), p, fmax(1.0, fabs(p) * 1e-15));
+        CHECK_EQ(x < y, a[i] < b[i]);
+    }
+}
+
+HOST_TEST(arithmetic)
+{
+    checkArithmetic<0>();
+    checkArithmetic<8>();
+    checkArithmetic<16>();
+    checkArithmetic<30>();
+}
+
+// The fixed point average follows the double one within the rounding of each step (half a unit,
+// accumulated over 1/alpha steps) and the Q16 rounding of alpha
+template <uint8_t FRAC, uint32_t NUM, uint32_t DEN>
+static void checkEma(const std::vector<int32_t> &input)
+{
+    using F = Fixed<FRAC>;
+    Ema<FRAC, NUM, DEN> ema;
+    double alpha = (double)NUM / DEN;
+    double ref = 0;
+    double maxStep = 0;
+    for (int32_t x : input)
+    {
+        double prev = ref;
+        ref += alpha * ((double)x - ref);
+        maxStep = fmax(maxStep, fabs((double)x - prev));
+        F y = ema.add(F::fromRaw(x));
+        double tol = (1.0 + maxStep * ldexp(1.0, -16)) / alpha + 1;
+        CHECK_NEAR((double)y.raw(), ref, tol);
+        CHECK_EQ(y.raw(), ema.value().raw());
+    }
+}
+
+HOST_TEST(ema)
+{
+    std::mt19937 rng(7);
+    std::vector<int32_t> step(200, 0);
+    step.resize(1000, 256 * 72);
+    std::vector<int32_t> noise;
+    for (int i = 0; i < 5000; i++)
+        noise.push_back(256 * 100000 + (int32_t)(rng() % 51200) - 25600);
+    std::vector<int32_t> ramp;
+    for (int i = 0; i < 5000; i++)
+        ramp.push_back(i * 400000 - 1000000000);
+    std::vector<int32_t> extremes;
+    for (int i = 0; i < 200; i++)
+        extremes.push_back(i % 50 < 25 ? INT32_MAX : INT32_MIN);
+
+    checkEma<8, 1, 10>(step);
+    checkEma<8, 1, 10>(noise);
+    checkEma<8, 1, 10>(ramp);
+    checkEma<8, 1, 10>(extremes);
+    checkEma<16, 1, 1>(noise);
+    checkEma<16, 3, 100>(ramp);
+    checkEma<0, 1, 2>(extremes);
+    checkEma<30, 1, 64>(extremes);
+
+    // the swing between the limits does not wrap
+    Ema<8, 1, 1> full;
+    CHECK_EQ(full.add(Fixed<8>::fromRaw(INT32_MAX)).raw(), INT32_MAX);
+    CHECK_EQ(full.add(Fixed<8>::fromRaw(INT32_MIN)).raw(), INT32_MIN);
+    CHECK_EQ(full.add(Fixed<8>::fromRaw(INT32_MAX)).raw(), INT32_MAX);
+
+    // the constant input is reached within the dead band of the rounded step, 0.5 / alpha units
+    Ema<8, 1, 10> bpm;
+    for (int i = 0; i < 500; i++)
+        bpm.add(Fixed<8>::fromInt(72));
+    CHECK_EQ(bpm.value().toInt(), 72);
+    CHECK_NEAR(bpm.value().raw(), 72 * 256, 5.0);
+    bpm.reset();
+    CHECK_EQ(bpm.value().raw(), 0);
+}
+
+HOST_TEST(moving_average)
+{
+    MovingAverage<uint8_t, 4> avg;
+    std::vector<int> window;
+    std::mt19937 rng(11);
+    for (int i = 0; i < 1000; i++)
+    {
+        uint8_t v = (uint8_t)(rng() % 256);
+        avg.add(v);
+        window.push_back(v);
+        if (window.size() > 4)
+            window.erase(window.begin());
+        double sum = 0;
+        for (int w : window)
+            sum += w;
+        CHECK_EQ((int)avg.average(), (int)(sum / 4));
+    }
+}
+
+HOST_TEST_MAIN()
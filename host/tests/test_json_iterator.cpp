@@ -0,0 +1,196 @@
+// The FirebaseJson iterator against the element sequence of the iterator it replaced: the order and
+// skip rules of the old mIterate walk, the keys and values as they are serialized, and the depth as
+// the nesting level of the element.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+struct Element
+{
+    int type;
+    int depth;
+    std::string key;
+    std::string value;
+};
+
+static std::string printed(MB_JSON *e)
+{
+    char *p = MB_JSON_PrintUnformatted(e);
+    std::string s = p ? p : "";
+    MB_JSON_free(p);
+    return s;
+}
+
+static void collect(MB_JSON *e, int depth, std::vector<Element> &out)
+{
+    Element el;
+    el.type = e->string ? FirebaseJson::JSON_OBJECT : FirebaseJson::JSON_ARRAY;
+    el.depth = depth;
+    if (e->string)
+    {
+        // the key as it is in the serialized text, without the quotes
+        MB_JSON *k = MB_JSON_CreateString(e->string);
+        el.key = printed(k);
+        el.key = el.key.substr(1, el.key.size() - 2);
+        MB_JSON_Delete(k);
+    }
+    el.value = printed(e);
+    out.push_back(el);
+}
+
+// The walk of the old FirebaseJsonBase::mIterate: a child object or array is collected and then its
+// children, the object/array items of an array are not collected but their children are
+static void iterate(MB_JSON *parent, int depth, std::vector<Element> &out)
+{
+    for (MB_JSON *e = parent->child; e; e = e->next)
+    {
+        if (MB_JSON_IsArray(e) || MB_JSON_IsObject(e))
+            collect(e, depth, out);
+
+        if (MB_JSON_IsArray(e))
+        {
+            for (MB_JSON *item = e->child; item; item = item->next)
+            {
+                if (MB_JSON_IsArray(item) || MB_JSON_IsObject(item))
+                    iterate(item, depth + 2, out);
+                else
+                    collect(item, depth + 1, out);
+            }
+        }
+        else if (MB_JSON_IsObject(e))
+            iterate(e, depth + 1, out);
+        else
+            collect(e, depth, out);
+    }
+}
+
+static std::vector<Element> baseline(const std::string &text)
+{
+    std::vector<Element> out;
+    MB_JSON *root = MB_JSON_Parse(text.c_str());
+    if (root)
+    {
+        iterate(root, 0, out);
+        MB_JSON_Delete(root);
+    }
+    return out;
+}
+
+// iteratorGet, valueAt and viewAt of every element give the baseline element
+template <typename T>
+static void checkIterator(const std::string &name, T &json, const std::string &text)
+{
+    std::vector<Element> expected = baseline(text);
+    size_t count = json.iteratorBegin();
+    CHECK_EQ(count, expected.size());
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count && i < expected.size(); i++)
+    {
+        const Element &x = expected[i];
+
+        int type = -1;
+        String key, value;
+        int depth = json.iteratorGet(i, type, key, value);
+        typename T::IteratorValue v = json.valueAt(i);
+        typename T::IteratorView view = json.viewAt(i);
+
+        bool same = depth == x.depth && type == x.type && x.key == key.c_str() && x.value == value.c_str();
+        same &= v.depth == x.depth && v.type == x.type && x.key == v.key.c_str() && x.value == v.value.c_str();
+        same &= view.depth == x.depth && view.type == x.type && x.key == std::string(view.key, view.keyLen) &&
+                x.value == std::string(view.value, view.valueLen);
+        if (!same && mismatches++ < 5)
+            host_test_fail(__FILE__, __LINE__, name + " element " + std::to_string(i) + ": expected " +
+                                                   std::to_string(x.depth) + " " + std::to_string(x.type) + " [" + x.key +
+                                                   "] [" + x.value + "], got " + std::to_string(view.depth) + " " +
+                                                   std::to_string(view.type) + " [" + std::string(view.key, view.keyLen) +
+                                                   "] [" + std::string(view.value, view.valueLen) + "]");
+    }
+    CHECK_EQ(mismatches, (size_t)0);
+
+    // past the end and after iteratorEnd
+    CHECK_EQ(json.viewAt(count).depth, -1);
+    CHECK_EQ(json.valueAt(count).depth, -1);
+    int type;
+    String key, value;
+    CHECK_EQ(json.iteratorGet(count + 5, type, key, value), -1);
+    json.iteratorEnd();
+    CHECK_EQ(json.viewAt(0).depth, -1);
+    CHECK_EQ(json.valueAt(0).depth, -1);
+    CHECK_EQ(json.iteratorGet(0, type, key, value), -1);
+    CHECK(key.length() == 0 && value.length() == 0);
+}
+
+static void checkObject(const std::string &name, const std::string &text)
+{
+    FirebaseJson json;
+    CHECK(json.setJsonData(text.c_str()));
+    checkIterator(name, json, text);
+    // a second pass over the same object
+    checkIterator(name + " again", json, text);
+}
+
+static void checkArray(const std::string &name, const std::string &text)
+{
+    FirebaseJsonArray arr;
+    CHECK(arr.setJsonArrayData(text.c_str()));
+    checkIterator(name, arr, text);
+}
+
+HOST_TEST(nested_objects_and_arrays)
+{
+    checkObject("nested", "{\"a\":{\"b\":{\"c\":1},\"d\":2},\"e\":3,\"f\":[1,[2,[3,{\"g\":4}]],{\"h\":[5]}],\"i\":{}}");
+    // the siblings after a nested object are back at the depth of the object
+    checkObject("siblings", "{\"x\":{\"y\":{\"z\":{}}},\"after\":1,\"arr\":[{\"k\":{\"l\":2}},3],\"last\":true}");
+    checkArray("array root", "[1,{\"a\":2,\"b\":{\"c\":3}},[4,[5,6]],\"s\",null]");
+}
+
+HOST_TEST(empty_containers)
+{
+    checkObject("empty object", "{}");
+    checkArray("empty array", "[]");
+    checkObject("empty children", "{\"o\":{},\"a\":[],\"ao\":[{}],\"aa\":[[]],\"oa\":{\"x\":[]}}");
+    checkArray("empty items", "[{},[],[{}],[[]]]");
+}
+
+HOST_TEST(strings_and_numbers)
+{
+    // the keys and values are the escaped text of the buffer
+    checkObject("escaped", "{\"q\\\"k\":\"v\\\"al\",\"b\\\\s\":\"\\\\\",\"\":\"\",\"u\":\"caf\\u00e9\\n\",\"{\":\"}\","
+                           "\"c,\\\"d\":{\"e\":\"f\\\"\"},\"ctl\":\"\\t\\b\"}");
+    checkObject("numbers", "{\"i\":0,\"neg\":-12,\"big\":1760644790123,\"f\":1.5,\"e\":1e-7,\"max\":1.7976931348623157e308,"
+                           "\"arr\":[0,-1,2.25,1e21],\"t\":true,\"n\":null}");
+    checkArray("strings", "[\"\",\"a\",\"\\\"\",\"[1,2]\",\"{\\\"k\\\":1}\"]");
+}
+
+HOST_TEST(fixtures)
+{
+    for (const char *name : {"firestore/list_documents.json", "firestore/get_document.json", "token/invalid_password.json",
+                             "rtdb/get.json"})
+    {
+        std::string text = LoopbackServer::fixture(name);
+        CHECK(!text.empty());
+        checkObject(name, text);
+    }
+}
+
+HOST_TEST(large_page)
+{
+    // a page past the 64 KB the old offsets held
+    std::string text = "{\"documents\":[";
+    for (int i = 0; i < 800; i++)
+    {
+        if (i)
+            text += ",";
+        text += "{\"name\":\"projects/p/databases/(default)/documents/patients/p-" + std::to_string(i) +
+                "\",\"fields\":{\"bpm\":{\"integerValue\":\"" + std::to_string(60 + i % 40) +
+                "\"},\"note\":{\"stringValue\":\"line \\\"" + std::to_string(i) + "\\\"\"},\"tags\":{\"arrayValue\":{\"values\":[{\"stringValue\":\"a\"},{\"stringValue\":\"b\"}]}}}}";
+    }
+    text += "],\"nextPageToken\":\"tok\"}";
+    CHECK(text.size() > 100000);
+    checkObject("large", text);
+}
+
+HOST_TEST_MAIN()
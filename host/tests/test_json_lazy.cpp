@@ -0,0 +1,179 @@
+// FirebaseJson::setJsonDataLazy against setJsonData: the same get, isMember and toString calls give
+// the same results on the recorded responses, on every path of them and on the paths that are not
+// there, and on the malformed and truncated JSON.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+// Every path of the element tree, "[i]" for the array items as the paths of FirebaseJson
+static void collectPaths(MB_JSON *item, const std::string &path, std::vector<std::string> &paths)
+{
+    int index = 0;
+    for (MB_JSON *child = item->child; child; child = child->next, index++)
+    {
+        std::string key = MB_JSON_IsArray(item) ? "[" + std::to_string(index) + "]" : std::string(child->string);
+        std::string childPath = path.empty() ? key : path + "/" + key;
+        paths.push_back(childPath);
+        if (MB_JSON_IsObject(child) || MB_JSON_IsArray(child))
+            collectPaths(child, childPath, paths);
+    }
+}
+
+static std::vector<std::string> pathsOf(const std::string &text)
+{
+    std::vector<std::string> paths;
+    MB_JSON *root = MB_JSON_Parse(text.c_str());
+    if (root)
+    {
+        collectPaths(root, "", paths);
+        MB_JSON_Delete(root);
+    }
+    return paths;
+}
+
+static std::string describe(FirebaseJson &json, const std::string &path, bool prettify = false)
+{
+    FirebaseJsonData result;
+    bool found = json.get(result, path.c_str(), prettify);
+    std::string s = found ? "found" : "missing";
+    s += result.success ? " success " : " failure ";
+    s += std::to_string(result.typeNum) + " " + result.type.c_str() + " [" + result.to<String>().c_str() + "]";
+    s += " int " + std::to_string(result.to<int>()) + " bool " + std::to_string(result.to<bool>());
+    return s;
+}
+
+static std::string toText(FirebaseJson &json, bool prettify = false)
+{
+    String s;
+    json.toString(s, prettify);
+    return s.c_str();
+}
+
+// Run the calls on an eager and a lazy object of the text, each call of the lazy one must give the
+// result of the eager one
+static void compare(const std::string &name, const std::string &text, std::vector<std::string> paths)
+{
+    // the paths of the document, the missing ones, and each of them twice
+    std::vector<std::string> extra = {"", "/", "missing", "missing/child", "[0]", "[99]", "error/missing",
+                                      "error/message/child", "fields/[0]", "documents/[99]/name", "a//b"};
+    paths.insert(paths.end(), extra.begin(), extra.end());
+    std::vector<std::string> found = pathsOf(text);
+    for (const std::string &p : found)
+    {
+        paths.push_back(p);
+        paths.push_back(p + "/missing");
+        paths.push_back("/" + p);
+    }
+    size_t count = paths.size();
+    for (size_t i = 0; i < count; i++)
+        paths.push_back(paths[i]);
+
+    FirebaseJson eager;
+    FirebaseJson lazy;
+    bool eagerSet = eager.setJsonData(text.c_str());
+    bool lazySet = lazy.setJsonDataLazy(text.c_str());
+    CHECK_EQ(lazySet, eagerSet);
+
+    size_t mismatches = 0;
+    for (const std::string &p : paths)
+    {
+        std::string e = describe(eager, p);
+        std::string l = describe(lazy, p);
+        bool eIs = eager.isMember(p.c_str());
+        bool lIs = lazy.isMember(p.c_str());
+        if (e != l || eIs != lIs)
+        {
+            if (mismatches++ < 5)
+                host_test_fail(__FILE__, __LINE__, name + " path \"" + p + "\": " + e + " (isMember " +
+                                                       std::to_string(eIs) + ") vs lazy " + l + " (isMember " +
+                                                       std::to_string(lIs) + ")");
+        }
+    }
+    CHECK_EQ(mismatches, (size_t)0);
+
+    // the prettified value of the first object member
+    if (!found.empty())
+        CHECK_STR(describe(lazy, found[0], true), describe(eager, found[0], true));
+
+    // the whole object parses on toString, the gets after it use the tree
+    CHECK_STR(toText(lazy), toText(eager));
+    CHECK_EQ(lazy.errorPosition(), eager.errorPosition());
+    for (const std::string &p : found)
+        CHECK_STR(describe(lazy, p), describe(eager, p));
+
+    // new objects that go to toString first, the gets above may have added the root to both
+    FirebaseJson eagerFirst;
+    FirebaseJson lazyFirst;
+    eagerFirst.setJsonData(text.c_str());
+    lazyFirst.setJsonDataLazy(text.c_str());
+    CHECK_STR(toText(lazyFirst, true), toText(eagerFirst, true));
+}
+
+static void compareFixture(const char *name, const std::vector<std::string> &paths = {})
+{
+    std::string text = LoopbackServer::fixture(name);
+    CHECK(!text.empty());
+    compare(name, text, paths);
+}
+
+HOST_TEST(token_fixtures)
+{
+    // the elements FirebaseCore::handleTokenResponse and getError read
+    compareFixture("token/verify_password.json", {"idToken", "refreshToken", "expiresIn", "localId", "error/message"});
+    compareFixture("token/refresh.json", {"id_token", "refresh_token", "expires_in", "user_id", "error/message"});
+    compareFixture("token/invalid_password.json", {"error/code", "error/message", "error/errors/[0]/reason"});
+}
+
+HOST_TEST(firestore_fixtures)
+{
+    compareFixture("firestore/get_document.json");
+    compareFixture("firestore/list_documents.json", {"nextPageToken", "documents/[2]/fields", "documents/[3]"});
+    compareFixture("firestore/create_document.json");
+    compareFixture("firestore/not_found.json", {"error/code", "error/status", "error/message"});
+    compareFixture("rtdb/get.json");
+}
+
+HOST_TEST(escaped_keys_and_values)
+{
+    compare("escaped", "{\"a\\\"b\":1,\"c\\\\d\":\"e\\\"f\",\"\\u0041\":\"\\u00e9\",\"g/h\":2,\"t\\tab\":[\"\\n\"],\"\":3}",
+            {"a\"b", "c\\d", "A", "\\u0041", "g/h", "t\tab", "t\tab/[0]", "a\\\"b"});
+    // the first of the repeated keys, as the element tree
+    compare("repeated", "{\"k\":1,\"k\":2,\"o\":{\"k\":{\"x\":1},\"k\":[2]}}", {"k", "o/k", "o/k/x", "o/k/[0]"});
+}
+
+HOST_TEST(arrays_and_types)
+{
+    compare("types", "{\"i\":-12,\"big\":1760644790123,\"f\":1.5,\"e\":1e-7,\"t\":true,\"n\":null,\"s\":\"\","
+                     "\"o\":{},\"a\":[],\"m\":[1,\"2\",[3,[4]],{\"five\":5},null,false]}",
+            {"m/[2]/[1]/[0]", "m/[3]/five", "m/[6]", "m/[-1]", "m/x", "o/[0]", "a/[0]", "i/x"});
+    // only the spaces before the object as setJsonData, the other white space makes it raw data
+    compare("spaces", "   {\"a\" :[ 1\t,\r\n{ \"b\" : \"c\" } ] , \"d\" : { } } \n", {"a/[1]/b", "d"});
+    compare("line break", " \r\n{ \"a\" : [ 1 , { \"b\" : \"c\" } ] , \"d\" : { } } \n", {"a/[1]/b", "d"});
+}
+
+HOST_TEST(malformed_and_truncated)
+{
+    std::string text = LoopbackServer::fixture("token/verify_password.json");
+    // every cut of the recorded response
+    for (size_t len = 0; len < text.size(); len += 7)
+        compare("cut " + std::to_string(len), text.substr(0, len), {"idToken", "expiresIn", "error/message"});
+
+    compare("not an object", "[1,2,3]", {"[0]", "[2]"});
+    compare("string", "\"text\"", {});
+    compare("number", "42", {});
+    compare("empty", "", {});
+    compare("trailing", "{\"a\":1} {\"b\":2}", {"a", "b"});
+    compare("unclosed string", "{\"a\":\"b}", {"a"});
+    compare("bad escape", "{\"a\":\"\\x\",\"b\":1}", {"a", "b"});
+    compare("missing colon", "{\"a\" 1,\"b\":2}", {"a", "b"});
+    compare("missing comma", "{\"a\":1 \"b\":2}", {"a", "b"});
+    compare("bad number", "{\"a\":1-2,\"b\":2}", {"a", "b"});
+    compare("bad numbers", "{\"a\":-,\"b\":1..2,\"c\":1e}", {"a", "b", "c"});
+    compare("bad unicode", "{\"a\":\"\\u12\",\"\\ud800\":1}", {"a", "\\ud800"});
+    compare("bad literal", "{\"a\":tru,\"b\":nul}", {"a", "b"});
+    compare("unbalanced", "{\"a\":[1,2},\"b\":{]}", {"a", "b"});
+}
+
+HOST_TEST_MAIN()
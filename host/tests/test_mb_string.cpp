@@ -0,0 +1,323 @@
+// MB_String around the inline buffer of the short strings (MB_STRING_SSO_SIZE): the 15/16/17 chars
+// boundary, the moves between the inline and the heap buffer both ways, self assignment and append,
+// the moves and operator+ with the null and empty operands. Every test checks that the heap buffers
+// it made were released.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include "HostTest.h"
+
+#if MB_STRING_SSO_SIZE != 16
+#error "the tests expect the 16 bytes inline buffer of the host build"
+#endif
+
+// The buffer is the inline one when it is inside the object
+static bool isInline(const MB_String &s)
+{
+    const char *p = s.c_str();
+    const char *obj = reinterpret_cast<const char *>(&s);
+    return p >= obj && p < obj + sizeof(MB_String);
+}
+
+static std::string chars(size_t n, char first = 'a')
+{
+    std::string s;
+    for (size_t i = 0; i < n; i++)
+        s += (char)(first + i % 26);
+    return s;
+}
+
+// The string and its length as the C string it holds
+#define CHECK_MB(s, expected)                                  \
+    do                                                         \
+    {                                                          \
+        std::string _e = (expected);                           \
+        CHECK_STR(std::string((s).c_str()), _e);               \
+        CHECK_EQ((s).length(), _e.size());                     \
+    } while (0)
+
+// The heap buffers of the test are released at the end of the scope
+struct BlockCheck
+{
+    size_t blocks = mb_string_blocks();
+    ~BlockCheck() { CHECK_EQ(mb_string_blocks(), blocks); }
+};
+
+HOST_TEST(sso_boundary)
+{
+    BlockCheck blocks;
+    for (size_t n : {0, 1, 14, 15, 16, 17, 18, 19, 20, 31, 32, 33})
+    {
+        std::string text = chars(n);
+        MB_String s = text.c_str();
+        CHECK_MB(s, text);
+        // 15 chars and the NUL fit in the 16 bytes
+        CHECK_EQ(isInline(s), n <= 15);
+        if (n <= 15)
+            CHECK_EQ(s.bufferLength(), (size_t)16);
+        else
+            CHECK(s.bufferLength() > n);
+
+        // the copy of an empty string has no buffer
+        MB_String copy(s);
+        CHECK_MB(copy, text);
+        CHECK_EQ(isInline(copy), n > 0 && n <= 15);
+
+        MB_String assigned = chars(40).c_str();
+        assigned = s;
+        CHECK_MB(assigned, text);
+    }
+
+    // one char at a time across the boundary
+    MB_String grow;
+    std::string expected;
+    for (int i = 0; i < 40; i++)
+    {
+        grow += (char)('A' + i % 26);
+        expected += (char)('A' + i % 26);
+        CHECK_MB(grow, expected);
+        CHECK_EQ(isInline(grow), expected.size() <= 15);
+    }
+}
+
+HOST_TEST(inline_to_heap_and_back)
+{
+    BlockCheck blocks;
+
+    // append
+    MB_String s = chars(15).c_str();
+    CHECK(isInline(s));
+    s += "p";
+    CHECK_MB(s, chars(15) + "p");
+    CHECK(!isInline(s));
+    s.append("qrstuvwxyz", 3);
+    CHECK_MB(s, chars(15) + "pqrs");
+    s.append(2, '!');
+    CHECK_MB(s, chars(15) + "pqrs!!");
+
+    // erase keeps the buffer, shrink_to_fit goes back to the inline one
+    s.erase(5);
+    CHECK_MB(s, chars(5));
+    CHECK(!isInline(s));
+    s.shrink_to_fit();
+    CHECK_MB(s, chars(5));
+    CHECK(isInline(s));
+    s.erase(1, 2);
+    CHECK_MB(s, "ade");
+    s.erase(0);
+    CHECK_MB(s, "");
+
+    // insert
+    MB_String ins = chars(14).c_str();
+    ins.insert(0, 'X');
+    CHECK_MB(ins, "X" + chars(14));
+    CHECK(isInline(ins));
+    ins.insert(1, 'Y');
+    CHECK_MB(ins, "XY" + chars(14));
+    CHECK(!isInline(ins));
+    ins.insert(3, "123456789012345678901234567890");
+    CHECK_MB(ins, "XYa123456789012345678901234567890" + chars(14).substr(1));
+    ins.insert(0, 3, '-');
+    CHECK_MB(ins, "---XYa123456789012345678901234567890" + chars(14).substr(1));
+
+    MB_String small = "ab";
+    small.insert(1, 20, '.');
+    CHECK_MB(small, "a" + std::string(20, '.') + "b");
+    CHECK(!isInline(small));
+
+    // substr of a heap string short enough for the inline buffer and long enough for the heap
+    MB_String heap = chars(40).c_str();
+    MB_String shortSub = heap.substr(3, 15);
+    CHECK_MB(shortSub, chars(40).substr(3, 15));
+    CHECK(isInline(shortSub));
+    MB_String longSub = heap.substr(3, 16);
+    CHECK_MB(longSub, chars(40).substr(3, 16));
+    CHECK(!isInline(longSub));
+    CHECK_MB(heap.substr(30), chars(40).substr(30));
+    CHECK_MB(heap.substr(40), "");
+    CHECK_MB(heap.substr(0, 0), "");
+    MB_String inl = "hello";
+    CHECK_MB(inl.substr(1, 100), "ello");
+
+    // shrink_to_fit of a heap string that stays on the heap, and of an empty one
+    MB_String big = chars(60).c_str();
+    big.erase(20);
+    big.shrink_to_fit();
+    CHECK_MB(big, chars(20));
+    CHECK(!isInline(big));
+    CHECK(big.bufferLength() < 60);
+    big.erase(0);
+    big.shrink_to_fit();
+    CHECK_MB(big, "");
+    CHECK_EQ(big.bufferLength(), (size_t)0);
+
+    // clear releases either buffer, the string is usable after it
+    MB_String c1 = chars(10).c_str();
+    MB_String c2 = chars(50).c_str();
+    c1.clear();
+    c2.clear();
+    CHECK_MB(c1, "");
+    CHECK_MB(c2, "");
+    CHECK_EQ(c1.bufferLength(), (size_t)0);
+    CHECK_EQ(c2.bufferLength(), (size_t)0);
+    c1 += chars(30).c_str();
+    c2 += "xy";
+    CHECK_MB(c1, chars(30));
+    CHECK_MB(c2, "xy");
+    CHECK(isInline(c2));
+
+    // reassigning a heap string with a short one keeps the heap buffer, the content is right
+    MB_String re = chars(30).c_str();
+    re = "short";
+    CHECK_MB(re, "short");
+    re = chars(25).c_str();
+    CHECK_MB(re, chars(25));
+}
+
+HOST_TEST(self_assignment_and_append)
+{
+    BlockCheck blocks;
+    for (size_t n : {0, 1, 7, 8, 15, 16, 30})
+    {
+        std::string text = chars(n);
+
+        MB_String s = text.c_str();
+        MB_String &ref = s;
+        s = ref;
+        CHECK_MB(s, text);
+        s = std::move(ref);
+        CHECK_MB(s, text);
+
+        // the string doubles, across the inline boundary for 8 and 15 chars
+        s += ref;
+        CHECK_MB(s, text + text);
+        s += s;
+        CHECK_MB(s, text + text + text + text);
+
+        // the C string of the string itself, the buffer may move while it is appended
+        MB_String c = text.c_str();
+        c += c.c_str();
+        CHECK_MB(c, text + text);
+        MB_String a = text.c_str();
+        a.append(a.c_str(), n);
+        CHECK_MB(a, text + text);
+        MB_String i = text.c_str();
+        i.insert(0, i);
+        CHECK_MB(i, n ? text + text : "");
+        MB_String r = text.c_str();
+        r = r.c_str();
+        CHECK_MB(r, text);
+        r = r.c_str() + (n / 2);
+        CHECK_MB(r, text.substr(n / 2));
+        MB_String p = text.c_str();
+        p = p + p;
+        CHECK_MB(p, text + text);
+    }
+}
+
+HOST_TEST(move_inline_and_heap)
+{
+    BlockCheck blocks;
+
+    // the inline buffer is copied, the source is left empty
+    MB_String small = "inline";
+    MB_String movedSmall(std::move(small));
+    CHECK_MB(movedSmall, "inline");
+    CHECK(isInline(movedSmall));
+    CHECK_MB(small, "");
+
+    // the heap buffer is taken
+    MB_String big = chars(40).c_str();
+    const char *bigBuf = big.c_str();
+    MB_String movedBig(std::move(big));
+    CHECK_MB(movedBig, chars(40));
+    CHECK(movedBig.c_str() == bigBuf);
+    CHECK_MB(big, "");
+
+    // move assignment over an inline and a heap target
+    MB_String target = chars(20).c_str();
+    target = std::move(movedSmall);
+    CHECK_MB(target, "inline");
+    CHECK_MB(movedSmall, "");
+    target = std::move(movedBig);
+    CHECK_MB(target, chars(40));
+    CHECK(target.c_str() == bigBuf);
+    CHECK_MB(movedBig, "");
+    MB_String shortTarget = "x";
+    shortTarget = std::move(target);
+    CHECK_MB(shortTarget, chars(40));
+    CHECK(!isInline(shortTarget));
+
+    // the moved-from strings are usable
+    small += chars(20).c_str();
+    big = "again";
+    CHECK_MB(small, chars(20));
+    CHECK_MB(big, "again");
+
+    // moving an empty string
+    MB_String empty;
+    MB_String fromEmpty(std::move(empty));
+    CHECK_MB(fromEmpty, "");
+    shortTarget = std::move(fromEmpty);
+    CHECK_MB(shortTarget, "");
+
+    // the strings in a growing vector are moved
+    std::vector<MB_String> list;
+    for (int i = 0; i < 50; i++)
+        list.push_back(MB_String(chars(i % 30, 'A').c_str()));
+    for (int i = 0; i < 50; i++)
+        CHECK_MB(list[i], chars(i % 30, 'A'));
+}
+
+HOST_TEST(operator_plus_null_and_empty)
+{
+    BlockCheck blocks;
+    const char *null = NULL;
+    MB_String empty;
+    MB_String small = "abc";
+    MB_String big = chars(20).c_str();
+
+    CHECK_MB(small + null, "abc");
+    CHECK_MB(null + small, "abc");
+    CHECK_MB(big + null, chars(20));
+    CHECK_MB(null + big, chars(20));
+    CHECK_MB(empty + null, "");
+    CHECK_MB(null + empty, "");
+    CHECK_MB(empty + "", "");
+    CHECK_MB("" + empty, "");
+    CHECK_MB(empty + empty, "");
+    CHECK_MB(small + "", "abc");
+    CHECK_MB("" + small, "abc");
+    CHECK_MB(small + empty, "abc");
+    CHECK_MB(empty + small, "abc");
+    CHECK_MB(empty + 'z', "z");
+    CHECK_MB('z' + empty, "z");
+
+    // the temporaries of a chain
+    CHECK_MB(MB_String() + null, "");
+    CHECK_MB(MB_String("x") + null + "y", "xy");
+    CHECK_MB(MB_String() + MB_String(), "");
+    CHECK_MB(small + MB_String(), "abc");
+    CHECK_MB(MB_String() + small, "abc");
+    CHECK_MB(small + MB_String("d"), "abcd");
+    CHECK_MB('z' + MB_String(), "z");
+    CHECK_MB('z' + MB_String("y"), "zy");
+    CHECK_MB(MB_String() + 'z', "z");
+    CHECK_MB(MB_String(small) + empty + big + null + "" + '!', "abc" + chars(20) + "!");
+
+    // the operands are not changed
+    CHECK_MB(small, "abc");
+    CHECK_MB(big, chars(20));
+    CHECK_MB(empty, "");
+
+    // += with the null and empty operands
+    MB_String s = "q";
+    s += empty;
+    s += "";
+    s += MB_String();
+    CHECK_MB(s, "q");
+    s.append(null, 5);
+    CHECK_MB(s, "q");
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,317 @@
+// The OTA firmware sink of FB_Utils.h (OtaHelper) on the Update of the host: the image written to
+// Update and the SHA-256 digest against a reference SHA-256, for the base64 (RTDB) and the raw
+// (Storage) downloads, over the sizes around the base64 quantum and the write buffer, with and
+// without the padding and the quotes, in chunks of any length. Then the digest mismatch and the
+// malformed data, which leave no image.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include <Update.h>
+#include "HostTest.h"
+
+#if !defined(OTA_UPDATE_ENABLED)
+#error "the tests need the OTA update (ENABLE_OTA_FIRMWARE_UPDATE)"
+#endif
+
+// The SHA-256 of FIPS 180-4, apart from the BearSSL one of the sink
+class ReferenceSha256
+{
+public:
+    static std::string hex(const std::vector<uint8_t> &data)
+    {
+        uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        std::vector<uint8_t> msg(data);
+        uint64_t bits = (uint64_t)data.size() * 8;
+        msg.push_back(0x80);
+        while (msg.size() % 64 != 56)
+            msg.push_back(0);
+        for (int i = 7; i >= 0; i--)
+            msg.push_back((uint8_t)(bits >> (i * 8)));
+        for (size_t ofs = 0; ofs < msg.size(); ofs += 64)
+            block(h, &msg[ofs]);
+
+        std::string s;
+        for (uint32_t v : h)
+        {
+            char b[9];
+            snprintf(b, sizeof(b), "%08x", v);
+            s += b;
+        }
+        return s;
+    }
+
+private:
+    static uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+    static void block(uint32_t *h, const uint8_t *p)
+    {
+        static const uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++)
+            w[i] = (uint32_t)p[i * 4] << 24 | (uint32_t)p[i * 4 + 1] << 16 | (uint32_t)p[i * 4 + 2] << 8 | p[i * 4 + 3];
+        for (int i = 16; i < 64; i++)
+        {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        for (int i = 0; i < 64; i++)
+        {
+            uint32_t t1 = hh + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            hh = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e, h[5] += f, h[6] += g, h[7] += hh;
+    }
+};
+
+// The firmware of n bytes, every byte value in it
+static std::vector<uint8_t> firmware(size_t n, uint32_t seed = 1)
+{
+    std::vector<uint8_t> data(n);
+    uint32_t x = seed * 2654435761UL + 1;
+    for (size_t i = 0; i < n; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        data[i] = (uint8_t)x;
+    }
+    return data;
+}
+
+static std::string base64(const std::vector<uint8_t> &data, bool pad)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string s;
+    for (size_t i = 0; i < data.size(); i += 3)
+    {
+        uint32_t v = (uint32_t)data[i] << 16;
+        size_t n = std::min((size_t)3, data.size() - i);
+        if (n > 1)
+            v |= (uint32_t)data[i + 1] << 8;
+        if (n > 2)
+            v |= data[i + 2];
+        for (size_t j = 0; j < 4; j++)
+        {
+            if (j <= n)
+                s += table[(v >> (18 - j * 6)) & 0x3f];
+            else if (pad)
+                s += '=';
+        }
+    }
+    return s;
+}
+
+static MB_FS mbfs;
+static OtaHelper oh;
+
+// Feed the text to the sink in chunks, the result of the first failed write or of end()
+static int download(const std::string &text, size_t size, bool base64, size_t chunk, const char *expected,
+                    std::string &digest)
+{
+    int code = oh.begin(&mbfs, size, base64);
+    if (code != 0)
+        return code;
+    for (size_t ofs = 0; ofs < text.size(); ofs += chunk)
+    {
+        size_t len = std::min(chunk, text.size() - ofs);
+        bool ret = base64 ? oh.writeBase64(text.data() + ofs, len)
+                          : oh.write(reinterpret_cast<const uint8_t *>(text.data() + ofs), len);
+        if (!ret)
+        {
+            // as FirebaseData::endDownloadOTA after the failed write
+            oh.abort(&mbfs);
+            return FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED;
+        }
+    }
+    MB_String out;
+    code = oh.end(&mbfs, MB_String(expected), out);
+    digest = out.c_str();
+    return code;
+}
+
+static std::string upper(std::string s)
+{
+    for (char &c : s)
+        c = (char)toupper((unsigned char)c);
+    return s;
+}
+
+HOST_TEST(reference_sha256)
+{
+    // the examples of FIPS 180-4
+    auto text = [](const std::string &s)
+    { return std::vector<uint8_t>(s.begin(), s.end()); };
+    CHECK_STR(ReferenceSha256::hex({}), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CHECK_STR(ReferenceSha256::hex(text("abc")), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK_STR(ReferenceSha256::hex(text("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")),
+              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    CHECK_STR(ReferenceSha256::hex(std::vector<uint8_t>(1000000, 'a')),
+              "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+HOST_TEST(base64_sizes_padding_and_chunks)
+{
+    size_t failures = 0;
+    for (size_t n : {1, 2, 3, 4, 5, 6, 7, 100, 1022, 1023, 1024, 1025, 1026, 3072, 4097, 70001})
+    {
+        std::vector<uint8_t> data = firmware(n, (uint32_t)n);
+        std::string sha = ReferenceSha256::hex(data);
+        for (bool pad : {true, false})
+        {
+            for (bool quoted : {false, true})
+            {
+                // the RTDB value is the JSON string of the base64 text
+                std::string text = base64(data, pad);
+                size_t quads = (text.size() + 3) / 4;
+                if (quoted)
+                    text = "\"" + text + "\"";
+
+                for (size_t chunk : {1, 2, 3, 5, 7, 64, 1000, 1024, 4096, 65536})
+                {
+                    if (chunk == 1 && n > 5000)
+                        continue;
+                    // the size of the decoded data, and the size from the base64 length with the pad bytes
+                    for (size_t size : {n, quads * 3})
+                    {
+                        uint32_t ends = Update.ends();
+                        std::string digest;
+                        int code = download(text, size, true, chunk, nullptr, digest);
+                        bool ok = code == 0 && digest == sha && Update.ends() == ends + 1 && Update.image() == data &&
+                                  !Update.isRunning() && Update.writes() == (n + OTA_WRITE_BUFFER_SIZE - 1) / OTA_WRITE_BUFFER_SIZE;
+                        if (!ok && failures++ < 5)
+                            host_test_fail(__FILE__, __LINE__, "size " + std::to_string(n) + " pad " + std::to_string(pad) +
+                                                                   " quoted " + std::to_string(quoted) + " chunk " + std::to_string(chunk) +
+                                                                   " update size " + std::to_string(size) + ": code " +
+                                                                   std::to_string(code) + " digest " + digest);
+                    }
+                }
+            }
+        }
+    }
+    CHECK_EQ(failures, (size_t)0);
+}
+
+HOST_TEST(raw_sizes_and_chunks)
+{
+    size_t failures = 0;
+    for (size_t n : {1, 63, 64, 65, 1024, 1025, 70001})
+    {
+        std::vector<uint8_t> data = firmware(n, (uint32_t)n + 7);
+        std::string text(data.begin(), data.end());
+        std::string sha = ReferenceSha256::hex(data);
+        for (size_t chunk : {1, 7, 64, 1024, 4096, 65536})
+        {
+            if (chunk == 1 && n > 5000)
+                continue;
+            std::string digest;
+            int code = download(text, n, false, chunk, nullptr, digest);
+            bool ok = code == 0 && digest == sha && Update.image() == data && !Update.isRunning();
+            if (!ok && failures++ < 5)
+                host_test_fail(__FILE__, __LINE__, "size " + std::to_string(n) + " chunk " + std::to_string(chunk) +
+                                                       ": code " + std::to_string(code) + " digest " + digest);
+        }
+    }
+    CHECK_EQ(failures, (size_t)0);
+}
+
+HOST_TEST(expected_digest)
+{
+    std::vector<uint8_t> data = firmware(5000, 3);
+    std::string sha = ReferenceSha256::hex(data);
+    std::string text = "\"" + base64(data, true) + "\"";
+    std::string digest;
+
+    // the expected digest matches in either case
+    CHECK_EQ(download(text, data.size(), true, 1000, sha.c_str(), digest), 0);
+    CHECK(Update.image() == data);
+    CHECK_EQ(download(text, data.size(), true, 1000, upper(sha).c_str(), digest), 0);
+    CHECK_EQ(download(std::string(data.begin(), data.end()), data.size(), false, 333, sha.c_str(), digest), 0);
+    CHECK_STR(digest, sha);
+}
+
+HOST_TEST(digest_mismatch)
+{
+    std::vector<uint8_t> good = firmware(3000, 4);
+    std::vector<uint8_t> data = firmware(4000, 5);
+    std::string sha = ReferenceSha256::hex(data);
+    std::string text = base64(data, true);
+    std::string digest;
+
+    // the image of the last update is there
+    CHECK_EQ(download(base64(good, true), good.size(), true, 512, nullptr, digest), 0);
+    uint32_t ends = Update.ends();
+
+    std::string wrong = sha;
+    wrong[63] = wrong[63] == '0' ? '1' : '0';
+    for (const std::string &expected : {wrong, sha.substr(0, 63), sha + "0", std::string(64, '0'), ReferenceSha256::hex(good)})
+    {
+        CHECK_EQ(download(text, data.size(), true, 700, expected.c_str(), digest), FIREBASE_ERROR_FW_UPDATE_DIGEST_MISMATCH);
+        // the digest of the data, the update was not ended and is not running
+        CHECK_STR(digest, sha);
+        CHECK_EQ(Update.ends(), ends);
+        CHECK(!Update.isRunning());
+        CHECK(Update.image() == good);
+    }
+    CHECK_EQ(download(std::string(data.begin(), data.end()), data.size(), false, 700, wrong.c_str(), digest),
+             FIREBASE_ERROR_FW_UPDATE_DIGEST_MISMATCH);
+    CHECK_EQ(Update.ends(), ends);
+    CHECK(!Update.isRunning());
+
+    // the next update starts
+    CHECK_EQ(download(text, data.size(), true, 700, sha.c_str(), digest), 0);
+    CHECK(Update.image() == data);
+}
+
+HOST_TEST(malformed_and_failed)
+{
+    std::vector<uint8_t> data = firmware(100, 6);
+    std::string digest;
+    uint32_t ends = Update.ends();
+
+    // the data after the padding
+    CHECK_EQ(download("QUJD" "QQ==" "QUJD", 9, true, 4, nullptr, digest), FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED);
+    CHECK_EQ(download("QQ=A", 3, true, 1, nullptr, digest), FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED);
+    // a single symbol of the last quantum, three pad symbols
+    CHECK_EQ(download("QUJDQ", 6, true, 2, nullptr, digest), FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED);
+    CHECK_EQ(download("QUJDQ===", 6, true, 3, nullptr, digest), FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED);
+    // more data than the size of the update
+    CHECK(download(base64(data, true), data.size() - 1, true, 64, nullptr, digest) != 0);
+    CHECK_EQ(download(std::string(data.begin(), data.end()), data.size() - 10, false, 64, nullptr, digest),
+             FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED);
+    // less data than the size of the update
+    CHECK_EQ(download(base64(data, true), data.size() + 10, true, 64, nullptr, digest), FIREBASE_ERROR_FW_UPDATE_END_FAILED);
+    CHECK_EQ(Update.ends(), ends);
+    CHECK(!Update.isRunning());
+
+    // no space for the image, end() without begin()
+    Update.setFreeSpace(1000);
+    CHECK_EQ(oh.begin(&mbfs, 1001, true), FIREBASE_ERROR_FW_UPDATE_TOO_LOW_FREE_SKETCH_SPACE);
+    Update.setFreeSpace(4 * 1024 * 1024);
+    MB_String out;
+    CHECK_EQ(oh.end(&mbfs, MB_String(), out), FIREBASE_ERROR_FW_UPDATE_END_FAILED);
+
+    // a new update after the failed ones
+    CHECK_EQ(download(base64(data, false), data.size(), true, 5, nullptr, digest), 0);
+    CHECK_STR(digest, ReferenceSha256::hex(data));
+    CHECK_EQ(Update.ends(), ends + 1);
+}
+
+HOST_TEST_MAIN()
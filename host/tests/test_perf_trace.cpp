@@ -0,0 +1,155 @@
+// The phase counters and the trace ring of the library built with ENABLE_PERF_TRACE against the TLS
+// loopback server: the connect, handshake, request, wait and response phases of a session, its bytes
+// against those of the server and the ring that keeps the last FB_PERF_TRACE_SIZE phases.
+// Run as "test_perf_trace trace_phases" and "test_perf_trace trace_wrap" as the token and the
+// sessions of the library are global.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include <HostClient.h>
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+// the client outlives fbdo that stops it when destroyed
+static HostClient client;
+static FirebaseData fbdo;
+static FirebaseConfig config;
+static FirebaseAuth auth;
+
+static void networkConnection() {}
+
+static void networkStatusRequest()
+{
+    fbdo.setNetworkStatus(true);
+}
+
+static bool waitReady(unsigned long timeoutMs)
+{
+    unsigned long start = millis();
+    while (millis() - start < timeoutMs)
+    {
+        if (Firebase.ready())
+            return true;
+        delay(5);
+    }
+    return false;
+}
+
+static void signIn(LoopbackServer &server)
+{
+    server.onFixture("POST", "/identitytoolkit/v3/relyingparty/verifyPassword", "token/verify_password.json");
+    server.onFixture("GET", "/v1/projects/host-test/databases/(default)/documents/patients/p-0001", "firestore/get_document.json");
+    server.onFixture("POST", "/v1/projects/host-test/databases/(default)/documents/SensorData", "firestore/create_document.json");
+    CHECK(server.start());
+
+    config.api_key = "host-test-api-key";
+    auth.user.email = "device-01@example.com";
+    auth.user.password = "host-test-password";
+    fbdo.setGenericClient(&client, networkConnection, networkStatusRequest);
+    fbdo.setResponseSize(4096);
+    Firebase.reconnectNetwork(true);
+    Firebase.begin(&config, &auth);
+    CHECK(waitReady(5000));
+}
+
+// The trace entries of the session from the oldest to the newest
+static std::vector<FB_PerfTraceEntry> sessionTrace(uint8_t session)
+{
+    FB_PerfTraceEntry entries[FB_PERF_TRACE_SIZE];
+    size_t n = Firebase.getPerfTrace(entries, FB_PERF_TRACE_SIZE);
+    std::vector<FB_PerfTraceEntry> out;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (entries[i].session == session)
+            out.push_back(entries[i]);
+    }
+    return out;
+}
+
+HOST_TEST(trace_phases)
+{
+    LoopbackServer server(true);
+    signIn(server);
+
+    fbdo.resetPerfStats();
+    Firebase.clearPerfTrace();
+    uint64_t serverRead = server.bytesRead(), serverWritten = server.bytesWritten();
+
+    // a new connection for the first request, the second one reuses it, stop ends its response
+    FirebaseJson content;
+    content.set("fields/Synced/booleanValue", true);
+    CHECK(Firebase.Firestore.createDocument(&fbdo, "host-test", "", "SensorData", "4294965295", content.raw(), ""));
+    CHECK(Firebase.Firestore.getDocument(&fbdo, "host-test", "", "patients/p-0001", ""));
+    fbdo.stopWiFiClient();
+
+    FB_PerfStats stats = fbdo.getPerfStats();
+    CHECK(stats.session != FB_PERF_SESSION_CORE);
+    CHECK_EQ(stats.phaseCount[fb_perf_phase_connect], 1u);
+    CHECK_EQ(stats.phaseCount[fb_perf_phase_handshake], 1u);
+    CHECK_EQ(stats.phaseCount[fb_perf_phase_request], 2u);
+    CHECK_EQ(stats.phaseCount[fb_perf_phase_wait], 2u);
+    CHECK_EQ(stats.phaseCount[fb_perf_phase_response], 2u);
+    CHECK_EQ(stats.fullHandshakes + stats.resumedHandshakes, 1u);
+
+    // the session wrote what the server read and read what it wrote, the token requests of the
+    // core session were done before
+    CHECK_EQ((uint64_t)stats.bytesOut, server.bytesRead() - serverRead);
+    CHECK_EQ((uint64_t)stats.bytesIn, server.bytesWritten() - serverWritten);
+
+    const fb_perf_phase order[] = {fb_perf_phase_connect, fb_perf_phase_handshake,
+                                   fb_perf_phase_request, fb_perf_phase_wait, fb_perf_phase_response,
+                                   fb_perf_phase_request, fb_perf_phase_wait, fb_perf_phase_response};
+    std::vector<FB_PerfTraceEntry> trace = sessionTrace(stats.session);
+    CHECK_EQ(trace.size(), sizeof(order) / sizeof(order[0]));
+    uint32_t requestBytes = 0, responseBytes = 0;
+    for (size_t i = 0; i < trace.size() && i < sizeof(order) / sizeof(order[0]); i++)
+    {
+        CHECK_STR(FB_PerfTrace::phaseName(trace[i].phase), FB_PerfTrace::phaseName(order[i]));
+        if (trace[i].phase == fb_perf_phase_request)
+            requestBytes += trace[i].value;
+        else if (trace[i].phase == fb_perf_phase_response)
+            responseBytes += trace[i].value;
+    }
+    CHECK_EQ(requestBytes, stats.bytesOut);
+    CHECK_EQ(responseBytes, stats.bytesIn);
+
+    server.stop();
+}
+
+HOST_TEST(trace_wrap)
+{
+    LoopbackServer server(true);
+    signIn(server);
+
+    fbdo.resetPerfStats();
+    Firebase.clearPerfTrace();
+
+    // three phases for each request on the kept connection, the ring wraps around
+    const uint32_t count = FB_PERF_TRACE_SIZE;
+    for (uint32_t i = 0; i < count; i++)
+        CHECK(Firebase.Firestore.getDocument(&fbdo, "host-test", "", "patients/p-0001", ""));
+    fbdo.stopWiFiClient();
+
+    FB_PerfStats stats = fbdo.getPerfStats();
+    CHECK_EQ(stats.phaseCount[fb_perf_phase_request], count);
+    CHECK_EQ(stats.phaseCount[fb_perf_phase_response], count);
+
+    // the copy has the last FB_PERF_TRACE_SIZE entries in order, however large the buffer
+    FB_PerfTraceEntry entries[FB_PERF_TRACE_SIZE * 2];
+    size_t n = Firebase.getPerfTrace(entries, FB_PERF_TRACE_SIZE * 2);
+    CHECK_EQ(n, (size_t)FB_PERF_TRACE_SIZE);
+    for (size_t i = 1; i < n; i++)
+        CHECK_EQ((uint16_t)(entries[i].seq - entries[i - 1].seq), (uint16_t)1);
+    CHECK_EQ(entries[n - 1].phase, (uint8_t)fb_perf_phase_response);
+    CHECK_EQ(entries[n - 1].session, stats.session);
+
+    // a smaller buffer takes the newest entries
+    FB_PerfTraceEntry last[4];
+    CHECK_EQ(Firebase.getPerfTrace(last, 4), (size_t)4);
+    CHECK_EQ(last[0].seq, entries[n - 4].seq);
+    CHECK_EQ(last[3].seq, entries[n - 1].seq);
+
+    server.stop();
+}
+
+HOST_TEST_MAIN()
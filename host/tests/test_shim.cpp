@@ -0,0 +1,178 @@
+#include <Arduino.h>
+#include <FS.h>
+#include <HostClient.h>
+#include <Wire.h>
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+HOST_TEST(string_basics)
+{
+    String s = "Fire";
+    s += "base";
+    s += 42;
+    CHECK_STR(s.c_str(), "Firebase42");
+    CHECK_EQ(s.length(), 10u);
+    CHECK_EQ(s.indexOf("base"), 4);
+    CHECK_STR(s.substring(4, 8).c_str(), "base");
+    s.replace("42", "");
+    CHECK(s == "Firebase");
+    CHECK_STR(String(255, HEX).c_str(), "ff");
+    CHECK_STR(String(1.5f, 3).c_str(), "1.500");
+    CHECK_EQ(String("  x ").length(), 4u);
+}
+
+HOST_TEST(fs_write_read_append)
+{
+    fs::FS disk("host_fs_test");
+    CHECK(disk.begin());
+    disk.remove("/dir/a.txt");
+
+    fs::File f = disk.open("/dir/a.txt", FILE_WRITE);
+    CHECK((bool)f);
+    f.print("hello");
+    f.close();
+
+    f = disk.open("/dir/a.txt", FILE_APPEND);
+    f.write(reinterpret_cast<const uint8_t *>(" world"), 6);
+    f.close();
+
+    CHECK(disk.exists("/dir/a.txt"));
+    f = disk.open("/dir/a.txt", FILE_READ);
+    CHECK_EQ(f.size(), 11u);
+    CHECK_EQ(f.available(), 11);
+    CHECK_EQ(f.read(), 'h');
+    CHECK(f.seek(6));
+    CHECK_STR(f.readString().c_str(), "world");
+    CHECK_EQ(f.available(), 0);
+    f.close();
+
+    fs::File dir = disk.open("/dir");
+    CHECK(dir.isDirectory());
+    fs::File entry = dir.openNextFile();
+    CHECK_STR(entry.name(), "a.txt");
+
+    CHECK(disk.remove("/dir/a.txt"));
+    CHECK(!disk.exists("/dir/a.txt"));
+    CHECK(!disk.open("/missing.txt", FILE_READ));
+}
+
+class CounterDevice : public I2CDevice
+{
+public:
+    void receive(const uint8_t *data, size_t len) override
+    {
+        if (len > 0)
+            reg = data[0];
+        if (len > 1)
+            value = data[1];
+    }
+    void request(uint8_t *data, size_t len) override
+    {
+        for (size_t i = 0; i < len; i++)
+            data[i] = (uint8_t)(reg + value + i);
+    }
+    uint8_t reg = 0;
+    uint8_t value = 0;
+};
+
+HOST_TEST(wire_devices)
+{
+    CounterDevice dev;
+    TwoWire bus;
+    bus.begin(21, 22);
+    bus.attach(0x48, &dev);
+
+    bus.beginTransmission(0x48);
+    bus.write(0x10);
+    bus.write(0x05);
+    CHECK_EQ(bus.endTransmission(), 0);
+
+    CHECK_EQ(bus.requestFrom(0x48, 3), 3);
+    CHECK_EQ(bus.available(), 3);
+    CHECK_EQ(bus.read(), 0x15);
+    CHECK_EQ(bus.read(), 0x16);
+    CHECK_EQ(bus.read(), 0x17);
+    CHECK_EQ(bus.read(), -1);
+
+    bus.beginTransmission(0x50);
+    CHECK_EQ(bus.endTransmission(), 2);
+    CHECK_EQ(bus.requestFrom(0x50, 2), 0);
+    CHECK_EQ(bus.transactions(), 4u);
+}
+
+static String host_test_http(HostClient &client, const char *request)
+{
+    client.print(request);
+    String response;
+    unsigned long start = millis();
+    while (millis() - start < 2000)
+    {
+        while (client.available())
+            response += (char)client.read();
+        if (!client.connected())
+            break;
+        if (response.indexOf("\r\n\r\n") > 0)
+        {
+            int len = response.indexOf("Content-Length: ");
+            int body = response.indexOf("\r\n\r\n") + 4;
+            if (len > 0 && (int)response.length() - body >= atoi(response.c_str() + len + 16))
+                break;
+        }
+        delay(1);
+    }
+    return response;
+}
+
+HOST_TEST(client_loopback_plain)
+{
+    LoopbackServer server;
+    server.onFixture("GET", "/patients", "rtdb/get.json");
+    server.on("POST", "/echo", [](const LoopbackRequest &request, LoopbackResponse &response)
+              { response.body = request.body; });
+    CHECK(server.start());
+    CHECK_EQ(host_server_port(), server.port());
+
+    HostClient client;
+    CHECK(client.connect("127.0.0.1", server.port()));
+    String res = host_test_http(client, "GET /patients/p-0001.json HTTP/1.1\r\nHost: x\r\n\r\n");
+    CHECK(res.startsWith("HTTP/1.1 200 OK"));
+    CHECK(res.indexOf("\"bpm\":72") > 0);
+
+    // the connection is kept for the next request
+    res = host_test_http(client, "POST /echo HTTP/1.1\r\nHost: x\r\nContent-Length: 4\r\n\r\nping");
+    CHECK(res.endsWith("\r\n\r\nping"));
+
+    res = host_test_http(client, "GET /nowhere HTTP/1.1\r\nHost: x\r\n\r\n");
+    CHECK(res.startsWith("HTTP/1.1 404"));
+    CHECK_EQ(client.connections(), 1u);
+    CHECK_EQ(server.requestCount(), 3u);
+    CHECK_STR(server.requests()[1].body, "ping");
+
+    server.stop();
+    delay(20);
+    CHECK(!client.connected());
+}
+
+HOST_TEST(server_loss_and_latency)
+{
+    LoopbackServer server;
+    server.onFixture("GET", "/", "rtdb/get.json");
+    server.setLatency(30);
+    CHECK(server.start());
+
+    HostClient client;
+    CHECK(client.connect("127.0.0.1", server.port()));
+    unsigned long start = millis();
+    String res = host_test_http(client, "GET / HTTP/1.1\r\n\r\n");
+    CHECK(res.startsWith("HTTP/1.1 200"));
+    CHECK(millis() - start >= 30);
+
+    server.setLatency(0);
+    server.setLoss(1.0);
+    res = host_test_http(client, "GET / HTTP/1.1\r\n\r\n");
+    CHECK(res.length() == 0);
+    CHECK_EQ(server.dropped(), 1u);
+    CHECK(!client.connected());
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,268 @@
+// FirebaseSSEParser on the recorded RTDB stream and on the edge cases of text/event-stream
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include "rtdb/stream/FB_SSE_Parser.h"
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+struct SSEEvent
+{
+    std::string event;
+    std::string data;
+    bool hasPath = false;
+    std::string path;
+    bool hasValue = false;
+    std::string value;
+};
+
+static SSEEvent takeEvent(FirebaseSSEParser &parser)
+{
+    const firebase_sse_event_view_t &view = parser.event();
+    SSEEvent ev;
+    ev.event.assign(view.event, view.eventLen);
+    ev.data.assign(view.data, view.dataLen);
+    ev.hasPath = view.path != nullptr;
+    if (ev.hasPath)
+        ev.path.assign(view.path, view.pathLen);
+    ev.hasValue = view.value != nullptr;
+    if (ev.hasValue)
+        ev.value.assign(view.value, view.valueLen);
+    return ev;
+}
+
+// Feed the stream in reads of chunk bytes as readPayload does, with flush after each read as
+// FB_RTDB::parseStreamPayload
+static std::vector<SSEEvent> parseChunks(FirebaseSSEParser &parser, const std::string &stream, size_t chunk,
+                                         bool flush = false)
+{
+    std::vector<SSEEvent> events;
+    for (size_t ofs = 0; ofs < stream.size(); ofs += chunk)
+    {
+        const char *p = stream.data() + ofs;
+        size_t n = std::min(chunk, stream.size() - ofs);
+        while (n > 0)
+        {
+            size_t used = parser.feed(p, n);
+            p += used;
+            n -= used;
+            if (parser.available())
+                events.push_back(takeEvent(parser));
+        }
+        if (flush && !parser.available() && parser.flush())
+            events.push_back(takeEvent(parser));
+    }
+    return events;
+}
+
+HOST_TEST(recorded_stream)
+{
+    FirebaseSSEParser parser;
+    std::vector<SSEEvent> events = parseChunks(parser, LoopbackServer::fixture("rtdb/stream.sse"), 4096);
+
+    CHECK_EQ(events.size(), (size_t)8);
+    if (events.size() != 8)
+        return;
+
+    CHECK_STR(events[0].event, "put");
+    CHECK_STR(events[0].path, "/");
+    CHECK(events[0].value.compare(0, 10, "{\"alarms\":") == 0);
+    CHECK_EQ(events[0].value.back(), '}');
+
+    CHECK_STR(events[1].event, "patch");
+    CHECK_STR(events[1].path, "/vitals");
+    CHECK_STR(events[1].value, "{\"bpm\":74,\"spo2\":96}");
+
+    CHECK_STR(events[2].event, "keep-alive");
+    CHECK_STR(events[2].data, "null");
+    CHECK(!events[2].hasPath);
+    CHECK(!events[2].hasValue);
+
+    CHECK_STR(events[4].path, "/vitals/temp");
+    CHECK_STR(events[4].value, "36.9");
+    CHECK_STR(events[6].value, "null");
+    CHECK_STR(events[7].value, "\"sensor \\\"B\\\" re-seated\"");
+    CHECK_EQ(parser.eventCount(), (size_t)8);
+    CHECK(!parser.pending());
+}
+
+HOST_TEST(any_read_size)
+{
+    std::string stream = LoopbackServer::fixture("rtdb/stream.sse");
+    FirebaseSSEParser whole;
+    std::vector<SSEEvent> expected = parseChunks(whole, stream, stream.size());
+
+    for (size_t chunk = 1; chunk <= 97; chunk++)
+    {
+        FirebaseSSEParser parser;
+        std::vector<SSEEvent> events = parseChunks(parser, stream, chunk);
+        CHECK_EQ(events.size(), expected.size());
+        for (size_t i = 0; i < events.size() && i < expected.size(); i++)
+        {
+            CHECK_STR(events[i].event, expected[i].event);
+            CHECK_STR(events[i].data, expected[i].data);
+            CHECK_STR(events[i].path, expected[i].path);
+            CHECK_STR(events[i].value, expected[i].value);
+        }
+    }
+}
+
+HOST_TEST(flush_after_any_read)
+{
+    std::string stream = LoopbackServer::fixture("rtdb/stream.sse");
+    FirebaseSSEParser whole;
+    std::vector<SSEEvent> expected = parseChunks(whole, stream, stream.size());
+
+    for (size_t chunk = 1; chunk <= 97; chunk++)
+    {
+        FirebaseSSEParser parser;
+        std::vector<SSEEvent> events = parseChunks(parser, stream, chunk, true);
+        CHECK_EQ(events.size(), expected.size());
+        for (size_t i = 0; i < events.size() && i < expected.size(); i++)
+        {
+            CHECK_STR(events[i].event, expected[i].event);
+            CHECK_STR(events[i].data, expected[i].data);
+            CHECK_STR(events[i].path, expected[i].path);
+            CHECK_STR(events[i].value, expected[i].value);
+        }
+        CHECK(!parser.pending());
+    }
+
+    // the read ends after the event line, its data line comes in the next read
+    FirebaseSSEParser parser;
+    CHECK(parseChunks(parser, "event: put\n", 64, true).empty());
+    CHECK(parser.pending());
+    std::vector<SSEEvent> events = parseChunks(parser, "data: {\"path\":\"/a\",\"data\":1}\n", 64, true);
+    CHECK_EQ(events.size(), (size_t)1);
+    if (events.size() == 1)
+    {
+        CHECK_STR(events[0].event, "put");
+        CHECK_STR(events[0].value, "1");
+    }
+    // the empty line of the flushed event dispatches nothing
+    CHECK(parseChunks(parser, "\n", 64, true).empty());
+    CHECK(!parser.pending());
+}
+
+HOST_TEST(crlf_and_comments)
+{
+    FirebaseSSEParser parser;
+    std::vector<SSEEvent> events = parseChunks(parser,
+                                               ": connected\r\n"
+                                               "retry: 1000\r\n"
+                                               "event: put\r\n"
+                                               "data: {\"path\":\"/a\",\"data\":1}\r\n"
+                                               "\r\n"
+                                               "event:patch\r"
+                                               "data:{\"path\":\"/b\",\"data\":{\"c\":2}}\r"
+                                               "\r",
+                                               7);
+    CHECK_EQ(events.size(), (size_t)2);
+    if (events.size() != 2)
+        return;
+    CHECK_STR(events[0].event, "put");
+    CHECK_STR(events[0].path, "/a");
+    CHECK_STR(events[0].value, "1");
+    CHECK_STR(events[1].event, "patch");
+    CHECK_STR(events[1].path, "/b");
+    CHECK_STR(events[1].value, "{\"c\":2}");
+}
+
+HOST_TEST(multi_line_data)
+{
+    FirebaseSSEParser parser;
+    std::vector<SSEEvent> events = parseChunks(parser,
+                                               "event: put\n"
+                                               "data: {\"path\":\"/a\",\n"
+                                               "data: \"data\":[1,\n"
+                                               "data: 2]}\n"
+                                               "\n",
+                                               5);
+    CHECK_EQ(events.size(), (size_t)1);
+    if (events.size() != 1)
+        return;
+    CHECK_STR(events[0].data, "{\"path\":\"/a\",\n\"data\":[1,\n2]}");
+    CHECK_STR(events[0].path, "/a");
+    CHECK_STR(events[0].value, "[1,\n2]");
+}
+
+HOST_TEST(escaped_strings)
+{
+    FirebaseSSEParser parser;
+    std::vector<SSEEvent> events = parseChunks(parser,
+                                               "event: put\n"
+                                               "data: {\"path\":\"/a\\\\\",\"data\":\"\\\\\"}\n"
+                                               "\n"
+                                               "event: put\n"
+                                               "data: {\"data\":\"}\\\",\\\"path\\\":\\\"/x\",\"path\":\"/b\"}\n"
+                                               "\n",
+                                               3);
+    CHECK_EQ(events.size(), (size_t)2);
+    if (events.size() != 2)
+        return;
+    // a backslash before the closing quote is itself escaped
+    CHECK_STR(events[0].path, "/a\\\\");
+    CHECK_STR(events[0].value, "\"\\\\\"");
+    // the quotes and braces in the string are not members
+    CHECK_STR(events[1].path, "/b");
+    CHECK_STR(events[1].value, "\"}\\\",\\\"path\\\":\\\"/x\"");
+}
+
+HOST_TEST(no_data_no_event)
+{
+    FirebaseSSEParser parser;
+    std::vector<SSEEvent> events = parseChunks(parser, "event: put\n\nevent: patch\ndata\n\n", 64);
+    // "data" without the colon is an empty data line, the event is dispatched with empty data
+    CHECK_EQ(events.size(), (size_t)1);
+    if (events.size() == 1)
+    {
+        CHECK_STR(events[0].event, "patch");
+        CHECK_STR(events[0].data, "");
+    }
+}
+
+HOST_TEST(flush_and_reset)
+{
+    FirebaseSSEParser parser;
+    std::string partial = "event: put\ndata: {\"path\":\"/a\",\"data\":1}\n";
+    CHECK(parseChunks(parser, partial, partial.size()).empty());
+    CHECK(parser.pending());
+    CHECK(parser.flush());
+    CHECK_STR(takeEvent(parser).value, "1");
+
+    // the JSON was not closed, its next line is coming
+    std::string open = "event: put\ndata: {\"path\":\"/a\",\n";
+    CHECK(parseChunks(parser, open, open.size()).empty());
+    CHECK(!parser.flush());
+
+    // the new connection starts clean
+    parser.reset();
+    CHECK(!parser.pending());
+    std::vector<SSEEvent> events = parseChunks(parser, "event: patch\ndata: {\"path\":\"/b\",\"data\":2}\n\n", 11);
+    CHECK_EQ(events.size(), (size_t)1);
+    if (events.size() == 1)
+    {
+        CHECK_STR(events[0].event, "patch");
+        CHECK_STR(events[0].path, "/b");
+    }
+    CHECK(!parser.failed());
+    CHECK_EQ(parser.dropCount(), (size_t)0);
+}
+
+HOST_TEST(buffers_are_reused)
+{
+    FirebaseSSEParser parser;
+    std::string stream = LoopbackServer::fixture("rtdb/stream.sse");
+    parseChunks(parser, stream, 512);
+    size_t size = parser.bufferSize();
+    CHECK(size > 0);
+    for (int i = 0; i < 20; i++)
+        parseChunks(parser, stream, 512);
+    CHECK_EQ(parser.bufferSize(), size);
+    CHECK_EQ(parser.eventCount(), (size_t)8 * 21);
+
+    parser.release();
+    CHECK_EQ(parser.bufferSize(), (size_t)0);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,295 @@
+// FirebaseStreamMux on an RTDB stream of the loopback server: the shadow tree after the put and
+// patch events and the route callbacks they reach.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include <HostClient.h>
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+static FirebaseData fbdo;
+static FirebaseConfig config;
+static FirebaseAuth auth;
+static HostClient client;
+
+struct RouteEvent
+{
+    std::string route;
+    std::string dataPath;
+    std::string eventType;
+    std::string value;
+    std::string type;
+};
+
+static std::vector<RouteEvent> routeEvents;
+
+static void onRoute(StreamMuxEvent &event)
+{
+    routeEvents.push_back({event.route.c_str(), event.dataPath.c_str(), event.eventType.c_str(),
+                           event.value.c_str(), event.type.c_str()});
+}
+
+static void networkConnection() {}
+
+static void networkStatusRequest()
+{
+    fbdo.setNetworkStatus(true);
+}
+
+static std::string put(const std::string &path, const std::string &data)
+{
+    return "event: put\ndata: {\"path\":\"" + path + "\",\"data\":" + data + "}\n\n";
+}
+
+static std::string patch(const std::string &path, const std::string &data)
+{
+    return "event: patch\ndata: {\"path\":\"" + path + "\",\"data\":" + data + "}\n\n";
+}
+
+// Stream the events to the mux and run the stream until they were all applied
+static void streamEvents(FirebaseStreamMux &mux, const std::vector<std::string> &events)
+{
+    LoopbackServer server;
+    server.on("GET", "/patients/p-0001.json", [events](const LoopbackRequest &, LoopbackResponse &response)
+              {
+        response.stream = true;
+        response.contentType = "text/event-stream; charset=utf-8";
+        response.events = events; });
+    CHECK(server.start());
+
+    static bool begun = false;
+    if (!begun)
+    {
+        config.database_url = "host-test-default-rtdb.firebaseio.com";
+        config.signer.tokens.legacy_token = "host-test-database-secret";
+        fbdo.setGenericClient(&client, networkConnection, networkStatusRequest);
+        Firebase.reconnectNetwork(true);
+        Firebase.begin(&config, &auth);
+        begun = true;
+    }
+
+    routeEvents.clear();
+    size_t applied = mux.eventCount() + events.size();
+    // the mux is set first, beginStream may already read the first event
+    Firebase.RTDB.setStreamMux(&fbdo, &mux);
+    CHECK(Firebase.RTDB.beginStream(&fbdo, "/patients/p-0001"));
+
+    unsigned long start = millis();
+    while (mux.eventCount() < applied && millis() - start < 5000)
+    {
+        Firebase.RTDB.runStream();
+        delay(1);
+    }
+    CHECK_EQ(mux.eventCount(), applied);
+
+    Firebase.RTDB.removeStreamMux(&fbdo);
+    Firebase.RTDB.endStream(&fbdo);
+    server.stop();
+}
+
+static std::string shadowOf(FirebaseStreamMux &mux)
+{
+    String s;
+    mux.shadow().toString(s);
+    return s.c_str();
+}
+
+static std::string valueAt(FirebaseStreamMux &mux, const char *path, std::string *type = nullptr)
+{
+    FirebaseJsonData result;
+    if (!mux.get(result, path))
+        return "<none>";
+    if (type)
+        *type = result.type.c_str();
+    return result.to<const char *>();
+}
+
+static const RouteEvent *lastOf(const std::string &route)
+{
+    for (size_t i = routeEvents.size(); i > 0; i--)
+        if (routeEvents[i - 1].route == route)
+            return &routeEvents[i - 1];
+    return nullptr;
+}
+
+static size_t countOf(const std::string &route)
+{
+    size_t n = 0;
+    for (const RouteEvent &e : routeEvents)
+        n += e.route == route;
+    return n;
+}
+
+HOST_TEST(root_put_then_nested_puts_and_patches)
+{
+    FirebaseStreamMux mux;
+    mux.addRoute("/", onRoute);
+    mux.addRoute("/vitals", onRoute);
+    streamEvents(mux, {put("/", "{\"vitals\":{\"bpm\":72,\"spo2\":97,\"temp\":36.7},\"config\":{\"logging\":2000}}"),
+                       put("/vitals/temp", "36.9"),
+                       patch("/vitals", "{\"bpm\":74,\"spo2\":96}"),
+                       put("/alarms/a1", "{\"level\":\"high\",\"ok\":false}"),
+                       patch("/", "{\"config/logging\":5000,\"config/recording\":100}")});
+
+    CHECK_STR(shadowOf(mux), "{\"vitals\":{\"bpm\":74,\"spo2\":96,\"temp\":36.9},\"config\":{\"logging\":5000,"
+                             "\"recording\":100},\"alarms\":{\"a1\":{\"level\":\"high\",\"ok\":false}}}");
+    std::string type;
+    CHECK_STR(valueAt(mux, "/vitals/temp", &type), "36.9");
+    CHECK_STR(type, "float");
+    CHECK_STR(valueAt(mux, "alarms/a1/ok", &type), "false");
+    CHECK_STR(type, "boolean");
+
+    // every event reaches the root, the /config patch and the /alarms put don't reach /vitals
+    CHECK_EQ(countOf("/"), (size_t)5);
+    CHECK_EQ(countOf("/vitals"), (size_t)3);
+    const RouteEvent *vitals = lastOf("/vitals");
+    CHECK(vitals != nullptr);
+    if (vitals)
+    {
+        CHECK_STR(vitals->eventType, "patch");
+        CHECK_STR(vitals->type, "json");
+        CHECK_STR(vitals->value, "{\"bpm\":74,\"spo2\":96,\"temp\":36.9}");
+    }
+    const RouteEvent *root = lastOf("/");
+    if (root)
+    {
+        CHECK_STR(root->type, "json");
+        CHECK_STR(root->value, shadowOf(mux));
+    }
+}
+
+HOST_TEST(null_deletes)
+{
+    FirebaseStreamMux mux;
+    mux.addRoute("/alarms/a0", onRoute);
+    streamEvents(mux, {put("/", "{\"alarms\":{\"a0\":{\"level\":\"low\"},\"a1\":{\"level\":\"high\"}}}"),
+                       put("/alarms/a0", "null"),
+                       patch("/alarms", "{\"a1\":null,\"a2\":1}")});
+
+    CHECK_STR(shadowOf(mux), "{\"alarms\":{\"a2\":1}}");
+    CHECK_STR(valueAt(mux, "/alarms/a0"), "<none>");
+    const RouteEvent *a0 = lastOf("/alarms/a0");
+    CHECK(a0 != nullptr);
+    if (a0)
+    {
+        CHECK_STR(a0->dataPath, "/alarms/a0");
+        CHECK_STR(a0->type, "null");
+        CHECK_STR(a0->value, "");
+    }
+    // the patch of the parent changed a1 and a2, not a0
+    CHECK_EQ(countOf("/alarms/a0"), (size_t)2);
+
+    // a null root put empties the tree
+    FirebaseStreamMux cleared;
+    cleared.addRoute("/", onRoute);
+    streamEvents(cleared, {put("/", "{\"a\":1}"), put("/", "null")});
+    CHECK_STR(shadowOf(cleared), "");
+    if (lastOf("/"))
+        CHECK_STR(lastOf("/")->type, "null");
+}
+
+HOST_TEST(route_matching)
+{
+    FirebaseStreamMux mux;
+    mux.addRoute("/a", onRoute);
+    mux.addRoute("ab/", onRoute);
+    mux.addRoute("/a/b", onRoute);
+    streamEvents(mux, {put("/ab/x", "1"), put("/a/c", "2"), put("/a", "{\"b\":3}"), put("/a/b/d", "4")});
+
+    // /a is not the parent of /ab, the route paths are normalized
+    CHECK_EQ(countOf("/a"), (size_t)3);
+    CHECK_EQ(countOf("/ab"), (size_t)1);
+    // /a/c is a sibling, the put of /a replaces the parent, /a/b/d is a child
+    CHECK_EQ(countOf("/a/b"), (size_t)2);
+    CHECK(routeEvents.size() >= 1 && routeEvents[0].route == "/ab" && routeEvents[0].dataPath == "/ab/x");
+    CHECK_STR(valueAt(mux, "/a/b/d"), "4");
+    CHECK_STR(valueAt(mux, "/a/c"), "<none>");
+
+    mux.removeRoute("/ab");
+    routeEvents.clear();
+    streamEvents(mux, {put("/ab", "5")});
+    CHECK_EQ(countOf("/ab"), (size_t)0);
+}
+
+HOST_TEST(escaped_strings)
+{
+    FirebaseStreamMux mux;
+    mux.addRoute("/note", onRoute);
+    streamEvents(mux, {put("/", "{\"n\":0}"),
+                       put("/note", "\"sensor \\\"B\\\" re-seated\""),
+                       patch("/", "{\"path\":\"C:\\\\temp\\\\a\\/b\",\"unicode\":\"caf\\u00e9 \\t\",\"empty\":\"\"}")});
+
+    // the route callback gets the string, get() escapes it once as FirebaseJson::get
+    const RouteEvent *note = lastOf("/note");
+    CHECK(note != nullptr);
+    if (note)
+    {
+        CHECK_STR(note->value, "sensor \"B\" re-seated");
+        CHECK_STR(note->type, "string");
+    }
+    std::string type;
+    CHECK_STR(valueAt(mux, "/note", &type), "sensor \\\"B\\\" re-seated");
+    CHECK_STR(type, "string");
+    CHECK_STR(valueAt(mux, "/path"), "C:\\\\temp\\\\a/b");
+    CHECK_STR(valueAt(mux, "/unicode"), "caf\xc3\xa9 \\t");
+    CHECK_STR(valueAt(mux, "/empty"), "");
+    CHECK_STR(shadowOf(mux), "{\"n\":0,\"note\":\"sensor \\\"B\\\" re-seated\",\"path\":\"C:\\\\temp\\\\a/b\","
+                             "\"unicode\":\"caf\xc3\xa9 \\t\",\"empty\":\"\"}");
+
+    // the value at the path as it was sent
+    FirebaseStreamMux paths;
+    paths.addRoute("/path", onRoute);
+    streamEvents(paths, {put("/path", "\"C:\\\\temp\\\\a\\/b\"")});
+    if (lastOf("/path"))
+        CHECK_STR(lastOf("/path")->value, "C:\\temp\\a/b");
+}
+
+HOST_TEST(int64_timestamps)
+{
+    FirebaseStreamMux mux;
+    mux.addRoute("/ts", onRoute);
+    streamEvents(mux, {put("/", "{\"ts\":1760644790}"),
+                       put("/ts", "1760644790123"),
+                       patch("/", "{\"big\":9007199254740993,\"neg\":-9223372036854775807}")});
+
+    std::string type;
+    CHECK_STR(valueAt(mux, "/ts", &type), "1760644790123");
+    CHECK_STR(type, "int");
+    CHECK_STR(valueAt(mux, "/big"), "9007199254740993");
+    CHECK_STR(valueAt(mux, "/neg"), "-9223372036854775807");
+    if (lastOf("/ts"))
+        CHECK_STR(lastOf("/ts")->value, "1760644790123");
+}
+
+HOST_TEST(root_primitives)
+{
+    FirebaseStreamMux mux;
+    mux.addRoute("/", onRoute);
+    streamEvents(mux, {put("/", "42")});
+    std::string type;
+    CHECK_STR(valueAt(mux, "/", &type), "42");
+    CHECK_STR(type, "int");
+    if (lastOf("/"))
+    {
+        CHECK_STR(lastOf("/")->value, "42");
+        CHECK_STR(lastOf("/")->type, "int");
+    }
+
+    streamEvents(mux, {put("/", "\"a \\\"b\\\"\"")});
+    CHECK_STR(valueAt(mux, "/", &type), "a \\\"b\\\"");
+    CHECK_STR(type, "string");
+    if (lastOf("/"))
+        CHECK_STR(lastOf("/")->value, "a \"b\"");
+
+    streamEvents(mux, {put("/", "[1,2]")});
+    CHECK_STR(valueAt(mux, "/", &type), "[1,2]");
+    CHECK_STR(type, "array");
+
+    // a child put turns the root into an object
+    streamEvents(mux, {put("/x", "true")});
+    CHECK_STR(shadowOf(mux), "{\"x\":true}");
+    if (lastOf("/"))
+        CHECK_STR(lastOf("/")->type, "json");
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,138 @@
+// The corked request writes of the library against the TLS loopback server: the Firestore request
+// goes out in one TLS record without the records of the handshake and takes no more records, socket
+// writes and bytes than the same request written uncorked, the header then the body in the chunks
+// of the TCP client, with the same buffer sizes.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include <HostClient.h>
+#include "client/SSLClient/ESP_SSLClient.h"
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+// the client outlives fbdo that stops it when destroyed
+static HostClient client;
+static FirebaseData fbdo;
+static FirebaseConfig config;
+static FirebaseAuth auth;
+
+static void networkConnection() {}
+
+static void networkStatusRequest()
+{
+    fbdo.setNetworkStatus(true);
+}
+
+static bool waitReady(unsigned long timeoutMs)
+{
+    unsigned long start = millis();
+    while (millis() - start < timeoutMs)
+    {
+        if (Firebase.ready())
+            return true;
+        delay(5);
+    }
+    return false;
+}
+
+// The request as the server read it, the header names are in lower case, the size is the same
+static void rawRequest(const LoopbackRequest &request, std::string &header, std::string &body)
+{
+    header = request.method + " " + request.target + " HTTP/1.1\r\n";
+    for (auto &h : request.headers)
+        header += h.first + ": " + h.second + "\r\n";
+    header += "\r\n";
+    body = request.body;
+}
+
+// Write the request uncorked as the TCP client does, the header then the body in chunks of
+// 1024 bytes, and read the response
+static bool writeUncorked(ESP_SSLClient &ssl, const std::string &header, const std::string &body)
+{
+    if (ssl.write(reinterpret_cast<const uint8_t *>(header.data()), header.size()) != header.size())
+        return false;
+    for (size_t pos = 0; pos < body.size(); pos += 1024)
+    {
+        size_t n = std::min((size_t)1024, body.size() - pos);
+        if (ssl.write(reinterpret_cast<const uint8_t *>(body.data() + pos), n) != n)
+            return false;
+    }
+
+    std::string response;
+    unsigned long start = millis();
+    while (response.find("\r\n\r\n") == std::string::npos && millis() - start < 5000)
+    {
+        uint8_t buf[256];
+        int avail = ssl.available();
+        int r = avail > 0 ? ssl.read(buf, std::min((size_t)avail, sizeof(buf))) : 0;
+        if (r > 0)
+            response.append(reinterpret_cast<char *>(buf), r);
+        delay(0);
+    }
+    return response.compare(0, 12, "HTTP/1.1 200") == 0;
+}
+
+HOST_TEST(corked_firestore_request)
+{
+    LoopbackServer server(true);
+    server.onFixture("POST", "/identitytoolkit/v3/relyingparty/verifyPassword", "token/verify_password.json");
+    server.onFixture("POST", "/v1/projects/host-test/databases/(default)/documents/SensorData", "firestore/create_document.json");
+    CHECK(server.start());
+
+    config.api_key = "host-test-api-key";
+    auth.user.email = "device-01@example.com";
+    auth.user.password = "host-test-password";
+    fbdo.setGenericClient(&client, networkConnection, networkStatusRequest);
+    fbdo.setResponseSize(4096);
+    // the record size follows the smaller of the buffers, one record takes the whole request
+    fbdo.setBSSLBufferSize(16384, 16384);
+    Firebase.reconnectNetwork(true);
+    Firebase.begin(&config, &auth);
+    CHECK(waitReady(5000));
+
+    // the body takes several chunks of the TCP client
+    FirebaseJson content;
+    for (int i = 0; i < 40; i++)
+        content.set(("fields/reading" + std::to_string(i) + "/stringValue").c_str(), "bpm=72;spo2=98;temperature=36.6;accel=0.01,0.02,0.98");
+    CHECK(content.raw() != nullptr && strlen(content.raw()) > 2048);
+
+    fbdo.resetTCPWriteStats();
+    CHECK(Firebase.Firestore.createDocument(&fbdo, "host-test", "", "SensorData", "4294965295", content.raw(), ""));
+    FB_TCPWriteStats corked = fbdo.getTCPWriteStats();
+    CHECK_EQ(corked.requests, 1u);
+    CHECK_EQ(corked.lastRecords, 1u);
+    CHECK(corked.lastSocketWrites >= 1);
+
+    std::string header, body;
+    rawRequest(server.requests().back(), header, body);
+    CHECK_STR(body, content.raw());
+    // the record carries the request and the header and tag of the record, the handshake of the
+    // new connection is not counted
+    CHECK(corked.lastBytes > header.size() + body.size());
+    CHECK(corked.lastBytes <= header.size() + body.size() + 85);
+    CHECK_EQ(corked.records, corked.lastRecords);
+    CHECK_EQ(corked.bytes, corked.lastBytes);
+
+    // the same request written uncorked over a new connection
+    HostClient tcp;
+    ESP_SSLClient ssl;
+    ssl.setClient(&tcp);
+    ssl.setInsecure();
+    ssl.setBufferSizes(16384, 16384);
+    CHECK(ssl.connect("127.0.0.1", server.port()));
+    uint32_t records = 0, writes = 0, bytes = 0;
+    ssl.getWriteStats(records, writes, bytes);
+    CHECK(writeUncorked(ssl, header, body));
+    uint32_t records2 = 0, writes2 = 0, bytes2 = 0;
+    ssl.getWriteStats(records2, writes2, bytes2);
+    CHECK_STR(server.requests().back().body, body);
+
+    CHECK(corked.lastRecords <= records2 - records);
+    CHECK(corked.lastSocketWrites <= writes2 - writes);
+    CHECK(corked.lastBytes <= bytes2 - bytes);
+
+    ssl.stop();
+    server.stop();
+}
+
+HOST_TEST_MAIN()
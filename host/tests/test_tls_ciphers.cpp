@@ -0,0 +1,148 @@
+// The AEAD only cipher suites (setCiphersAEADOnly) and the crypto provider (setCryptoProvider) of
+// the SSL client against the TLS loopback server: the handshake and a request with each AEAD suite
+// of the EC test certificate, the order of the provider and the server without AEAD suite refused.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include <HostClient.h>
+#include "client/SSLClient/ESP_SSLClient.h"
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+// The AEAD suites of setCiphersAEADOnly that the ECDSA certificate of the server can use
+static const uint16_t aeadSuites[] = {
+    BR_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384};
+
+// The CBC suites of the same certificate
+static const std::vector<uint16_t> cbcSuites = {
+    BR_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA384,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA};
+
+struct Session
+{
+    HostClient tcp;
+    ESP_SSLClient ssl;
+
+    explicit Session(bool aeadOnly)
+    {
+        ssl.setClient(&tcp);
+        ssl.setInsecure();
+        ssl.setBufferSizes(16384, 16384);
+        // the provider is set first, the AEAD suites are ordered by it
+        ssl.setCryptoProvider(bssl::portable_crypto_provider());
+        if (aeadOnly)
+            CHECK(ssl.setCiphersAEADOnly());
+    }
+};
+
+static void routes(LoopbackServer &server)
+{
+    server.on("GET", "/echo/", [](const LoopbackRequest &request, LoopbackResponse &response)
+              {
+        response.contentType = "text/plain";
+        response.body = request.path.substr(6); });
+}
+
+// GET /echo/<text> and the body of the response
+static std::string echo(Session &s, const std::string &text)
+{
+    std::string req = "GET /echo/" + text + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: keep-alive\r\n\r\n";
+    if (s.ssl.write(reinterpret_cast<const uint8_t *>(req.data()), req.size()) != req.size())
+        return std::string();
+
+    std::string response;
+    unsigned long start = millis();
+    while (millis() - start < 5000)
+    {
+        uint8_t buf[256];
+        int avail = s.ssl.available();
+        int r = avail > 0 ? s.ssl.read(buf, std::min((size_t)avail, sizeof(buf))) : 0;
+        if (r > 0)
+            response.append(reinterpret_cast<char *>(buf), r);
+
+        size_t end = response.find("\r\n\r\n");
+        size_t pos = response.find("Content-Length: ");
+        if (end != std::string::npos && pos != std::string::npos && pos < end)
+        {
+            size_t len = strtoul(response.c_str() + pos + 16, nullptr, 10);
+            if (response.size() >= end + 4 + len)
+                return response.substr(end + 4, len);
+        }
+        delay(0);
+    }
+    return std::string();
+}
+
+HOST_TEST(each_aead_suite)
+{
+    for (uint16_t suite : aeadSuites)
+    {
+        LoopbackServer server(true);
+        routes(server);
+        server.setCipherSuites({suite});
+        CHECK(server.start());
+
+        Session s(true);
+        CHECK(s.ssl.connect("127.0.0.1", server.port()));
+        CHECK_STR(echo(s, "vitals-" + std::to_string(suite)), "vitals-" + std::to_string(suite));
+        CHECK_EQ(server.requestCount(), (size_t)1);
+        if (server.requestCount() == 1)
+            CHECK_EQ(server.requests()[0].cipherSuite, suite);
+
+        s.ssl.stop();
+        server.stop();
+    }
+}
+
+HOST_TEST(provider_order)
+{
+    // the server takes the first suite of the client that it has, the portable provider puts
+    // ChaCha20-Poly1305 first
+    LoopbackServer server(true);
+    routes(server);
+    CHECK(server.start());
+
+    Session s(true);
+    CHECK(s.ssl.connect("127.0.0.1", server.port()));
+    CHECK_STR(echo(s, "order"), "order");
+    if (server.requestCount() == 1)
+        CHECK_EQ(server.requests()[0].cipherSuite, (uint16_t)BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256);
+
+    s.ssl.stop();
+    server.stop();
+}
+
+HOST_TEST(server_without_aead_refused)
+{
+    LoopbackServer server(true);
+    routes(server);
+    server.setCipherSuites(cbcSuites);
+    CHECK(server.start());
+
+    // the default suites of the client include the CBC ones of the server
+    {
+        Session s(false);
+        CHECK(s.ssl.connect("127.0.0.1", server.port()));
+        CHECK_STR(echo(s, "cbc"), "cbc");
+        if (server.requestCount() == 1)
+            CHECK_EQ(server.requests()[0].cipherSuite, cbcSuites[0]);
+        s.ssl.stop();
+    }
+
+    // the AEAD only client has no suite in common with the server, no request goes out
+    {
+        Session s(true);
+        CHECK(!s.ssl.connect("127.0.0.1", server.port()));
+        CHECK(!s.ssl.connected());
+        s.ssl.stop();
+    }
+    CHECK_EQ(server.requestCount(), (size_t)1);
+
+    server.stop();
+}
+
+HOST_TEST_MAIN()
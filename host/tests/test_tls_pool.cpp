@@ -0,0 +1,256 @@
+// The SSL clients of the library against the TLS loopback server with the receive buffers of
+// BSSL_BufferPool: the sessions share the pool buffers, an idle session holds none, the records
+// that arrive in pieces and the buffer of a negotiated maximum fragment length.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+#include <HostClient.h>
+#include "client/SSLClient/ESP_SSLClient.h"
+#include "client/SSLClient/client/BSSL_BufferPool.h"
+#include "../server/LoopbackServer.h"
+#include "HostTest.h"
+
+#if !defined(ESP_SSLCLIENT_USE_RX_BUFFER_POOL)
+#error "the tests need the receive buffer pool (ESP_SSLCLIENT_USE_RX_BUFFER_POOL)"
+#endif
+
+// The receive buffer for the full 16 KB records and the overhead of the engine
+static const size_t FULL_RX = 16384 + 325;
+// The receive buffer for the 1024 bytes fragments
+static const size_t MFL_RX = 1024 + 325;
+
+struct Session
+{
+    HostClient tcp;
+    ESP_SSLClient ssl;
+
+    // The engine asks for the fragment length that fits both buffers, the session without the
+    // maximum fragment length has the full transmit buffer
+    explicit Session(uint16_t mfl = 0)
+    {
+        ssl.setClient(&tcp);
+        ssl.setInsecure();
+        ssl.setBufferSizes(16384, mfl ? mfl : 16384);
+        if (mfl)
+            ssl.setMaxFragmentLength(mfl);
+    }
+};
+
+// The body of n bytes that tells the position of each byte
+static std::string pattern(size_t n)
+{
+    std::string s(n, ' ');
+    for (size_t i = 0; i < n; i++)
+        s[i] = (char)('!' + (i * 7 + i / 94) % 94);
+    return s;
+}
+
+static void routes(LoopbackServer &server)
+{
+    server.on("GET", "/bytes/", [](const LoopbackRequest &request, LoopbackResponse &response)
+              {
+        response.contentType = "application/octet-stream";
+        response.body = pattern(strtoul(request.path.c_str() + 7, nullptr, 10)); });
+}
+
+static bool sendGet(Session &s, size_t bytes)
+{
+    std::string req = "GET /bytes/" + std::to_string(bytes) + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: keep-alive\r\n\r\n";
+    return s.ssl.write(reinterpret_cast<const uint8_t *>(req.data()), req.size()) == req.size();
+}
+
+// Read what is available, at most max bytes, into the response
+static void readSome(Session &s, std::string &response, size_t max)
+{
+    uint8_t buf[512];
+    int avail = s.ssl.available();
+    if (avail <= 0)
+        return;
+    size_t n = std::min(std::min((size_t)avail, sizeof(buf)), max);
+    int r = s.ssl.read(buf, n);
+    if (r > 0)
+        response.append(reinterpret_cast<char *>(buf), r);
+}
+
+// The response is complete when the body has its Content-Length
+static bool complete(const std::string &response, std::string *body = nullptr)
+{
+    size_t end = response.find("\r\n\r\n");
+    size_t pos = response.find("Content-Length: ");
+    if (end == std::string::npos || pos == std::string::npos || pos > end)
+        return false;
+    size_t len = strtoul(response.c_str() + pos + 16, nullptr, 10);
+    if (response.size() < end + 4 + len)
+        return false;
+    if (body)
+        *body = response.substr(end + 4, len);
+    return true;
+}
+
+static std::string readBody(Session &s, size_t max = 512)
+{
+    std::string response, body;
+    unsigned long start = millis();
+    while (!complete(response, &body) && millis() - start < 10000)
+    {
+        readSome(s, response, max);
+        delay(0);
+    }
+    // the next poll finds no record data and returns the buffer
+    s.ssl.available();
+    return body;
+}
+
+static std::string get(Session &s, size_t bytes)
+{
+    CHECK(sendGet(s, bytes));
+    return readBody(s);
+}
+
+HOST_TEST(sessions_share_the_pool)
+{
+    LoopbackServer server(true);
+    routes(server);
+    CHECK(server.start());
+    BSSL_BufferPool::trim();
+    CHECK_EQ(BSSL_BufferPool::size(), (size_t)0);
+
+    Session a, b, c;
+    CHECK(a.ssl.connect("127.0.0.1", server.port()));
+    CHECK(b.ssl.connect("127.0.0.1", server.port()));
+    CHECK(c.ssl.connect("127.0.0.1", server.port()));
+    CHECK(a.ssl.connected() && b.ssl.connected() && c.ssl.connected());
+
+    // the handshakes are done, the idle sessions hold no buffer
+    a.ssl.available();
+    b.ssl.available();
+    c.ssl.available();
+    BSSL_BufferPool::trim();
+    CHECK_EQ(BSSL_BufferPool::size(), (size_t)0);
+
+    // one session at a time, all of them read with the one buffer
+    for (int round = 0; round < 3; round++)
+    {
+        for (Session *s : {&a, &b, &c})
+        {
+            size_t bytes = 1000 + round * 20000;
+            CHECK(get(*s, bytes) == pattern(bytes));
+            CHECK(s->ssl.connected());
+        }
+        CHECK_EQ(BSSL_BufferPool::size(), FULL_RX);
+    }
+
+    // the peak use of each session is in its receive buffer
+    for (Session *s : {&a, &b, &c})
+    {
+        size_t rxPeak = 0, txPeak = 0;
+        s->ssl.getBufferUsage(rxPeak, txPeak);
+        CHECK(rxPeak > 1000 && rxPeak <= FULL_RX);
+        CHECK(txPeak > 0);
+    }
+
+    // the buffer is not lent when the sessions are idle
+    BSSL_BufferPool::trim();
+    CHECK_EQ(BSSL_BufferPool::size(), (size_t)0);
+
+    a.ssl.stop();
+    b.ssl.stop();
+    c.ssl.stop();
+    server.stop();
+    BSSL_BufferPool::trim();
+}
+
+HOST_TEST(record_split_across_reads)
+{
+    LoopbackServer server(true);
+    routes(server);
+    // a 16 KB record comes in 300 bytes pieces
+    server.setSegments(300, 1);
+    CHECK(server.start());
+    BSSL_BufferPool::trim();
+
+    Session a, b;
+    CHECK(a.ssl.connect("127.0.0.1", server.port()));
+    CHECK(b.ssl.connect("127.0.0.1", server.port()));
+
+    // both sessions are in the middle of a record at the same time, each holds a buffer
+    const size_t bytes = 50000;
+    CHECK(sendGet(a, bytes));
+    CHECK(sendGet(b, bytes));
+    std::string ra, rb, bodyA, bodyB;
+    size_t lent = 0;
+    unsigned long start = millis();
+    while ((!complete(ra, &bodyA) || !complete(rb, &bodyB)) && millis() - start < 20000)
+    {
+        readSome(a, ra, 100);
+        readSome(b, rb, 100);
+        lent = std::max(lent, BSSL_BufferPool::size());
+    }
+    CHECK(bodyA == pattern(bytes));
+    CHECK(bodyB == pattern(bytes));
+    CHECK_EQ(lent, 2 * FULL_RX);
+    size_t rxPeak = 0, txPeak = 0;
+    a.ssl.getBufferUsage(rxPeak, txPeak);
+    CHECK(rxPeak > MFL_RX && rxPeak <= FULL_RX);
+    CHECK_EQ(a.ssl.getMFLNStatus(), 0);
+
+    // the partial records are kept across the polls, the buffers go back after the last one
+    a.ssl.available();
+    b.ssl.available();
+    BSSL_BufferPool::trim();
+    CHECK_EQ(BSSL_BufferPool::size(), (size_t)0);
+
+    // one byte at a time from the split records
+    CHECK(sendGet(a, 3000));
+    CHECK(readBody(a, 1) == pattern(3000));
+    CHECK(get(b, 20000) == pattern(20000));
+
+    a.ssl.stop();
+    b.ssl.stop();
+    server.stop();
+    BSSL_BufferPool::trim();
+}
+
+HOST_TEST(max_fragment_length)
+{
+    LoopbackServer server(true);
+    routes(server);
+    CHECK(server.start());
+    BSSL_BufferPool::trim();
+
+    // the server takes the 1024 bytes fragments, the session lends the smaller buffer
+    Session small(1024);
+    CHECK(small.ssl.connect("127.0.0.1", server.port()));
+    CHECK_EQ(small.ssl.getMFLNStatus(), 1);
+    CHECK(get(small, 40000) == pattern(40000));
+    size_t rxPeak = 0, txPeak = 0;
+    small.ssl.getBufferUsage(rxPeak, txPeak);
+    CHECK(rxPeak > 1000 && rxPeak <= MFL_RX);
+    CHECK_EQ(BSSL_BufferPool::size(), MFL_RX);
+
+    // the full size session next to it takes a larger buffer, the small one still fits the smaller
+    Session full;
+    CHECK(full.ssl.connect("127.0.0.1", server.port()));
+    CHECK_EQ(full.ssl.getMFLNStatus(), 0);
+    CHECK(get(full, 40000) == pattern(40000));
+    CHECK(get(small, 5000) == pattern(5000));
+    full.ssl.getBufferUsage(rxPeak, txPeak);
+    CHECK(rxPeak > MFL_RX && rxPeak <= FULL_RX);
+    CHECK_EQ(BSSL_BufferPool::size(), MFL_RX + FULL_RX);
+
+    // the probe result is cached, the next session doesn't probe the server again
+    uint32_t connections = server.connections();
+    Session again(1024);
+    CHECK(again.ssl.connect("127.0.0.1", server.port()));
+    CHECK_EQ(server.connections(), connections + 1);
+    CHECK_EQ(again.ssl.getMFLNStatus(), 1);
+    CHECK(get(again, 10000) == pattern(10000));
+
+    small.ssl.stop();
+    full.ssl.stop();
+    again.ssl.stop();
+    server.stop();
+    BSSL_BufferPool::trim();
+}
+
+HOST_TEST_MAIN()
@@ -114,6 +114,11 @@ void setup()
     // The memory from external SRAM/PSRAM will not use in the TCP client internal tx buffer.
     config.gcs.upload_buffer_size = 2048;
 
+    /* Assign the resumable upload chunk size in byte (multiple of 256 KiB) and the number of times to resume the interrupted upload */
+    // The default chunk size (0) is a quarter of file size. In ESP32, the next part of chunk is read from file while sending the current part.
+    config.gcs.upload_chunk_size = 256 * 1024;
+    config.gcs.upload_resume_retry = 3;
+
     // Comment or pass false value when WiFi reconnection will control by your code or third party library e.g. WiFiManager
     Firebase.reconnectNetwork(true);
 
@@ -53,12 +53,21 @@
 #if (defined(ENABLE_OTA_FIRMWARE_UPDATE) || defined(FIREBASE_ENABLE_OTA_FIRMWARE_UPDATE)) && (defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB) || (defined(ENABLE_FB_STORAGE) || defined(FIREBASE_ENABLE_FB_STORAGE)) || defined(ENABLE_GC_STORAGE))
 #if defined(ESP32)
 #include <Update.h>
+#include <mbedtls/sha256.h>
 #elif defined(ESP8266) || defined(MB_ARDUINO_PICO)
 #include <Updater.h>
+#include <bearssl/bearssl.h>
+#elif defined(MB_HOST)
+#include <Update.h>
+#include "./client/SSLClient/bssl/bearssl_hash.h"
 #endif
 #define OTA_UPDATE_ENABLED
 #endif
 
+#if defined(ENABLE_PERF_TRACE) || defined(FIREBASE_ENABLE_PERF_TRACE)
+#define PERF_TRACE_ENABLED
+#endif
+
 #if defined(MB_ARDUINO_PICO) && defined(INC_FREERTOS_H) && !defined(ENABLE_PICO_FREE_RTOS)
 #define ENABLE_PICO_FREE_RTOS
 #include <task.h>
@@ -109,6 +118,8 @@
 
 #define DEFAULT_AUTH_TOKEN_EXPIRED_SECONDS 3600
 
+#define MIN_TOKEN_REFRESH_TASK_RETRY_INTERVAL 10 * 1000
+
 #define DEFAULT_REQUEST_TIMEOUT 2000
 
 // The TCP session will be closed when time out reached
@@ -118,7 +129,12 @@
 
 #define STREAM_TASK_STACK_SIZE 8192
 #define QUEUE_TASK_STACK_SIZE 8192
+#define TOKEN_REFRESH_TASK_STACK_SIZE 8192
 #define MAX_BLOB_PAYLOAD_SIZE 1024
+// the decoded firmware buffer size, it divides the flash sector size
+#define OTA_WRITE_BUFFER_SIZE 1024
+// the FCM batch messages sent ahead before their responses are read
+#define FCM_BATCH_PIPELINE_DEPTH 4
 #define FIREBASE_DEFAULT_TS 1618971013
 #define FIREBASE_NON_TS -1000
 #define ESP_REPORT_PROGRESS_INTERVAL 2
@@ -155,7 +171,8 @@ typedef enum
     firebase_cert_type_undefined = -1,
     firebase_cert_type_none = 0,
     firebase_cert_type_data,
-    firebase_cert_type_file
+    firebase_cert_type_file,
+    firebase_cert_type_key
 
 } firebase_cert_type;
 
@@ -452,6 +469,7 @@ enum firebase_fcs_request_type
     firebase_fcs_request_type_undefined,
     firebase_fcs_request_type_upload,
     firebase_fcs_request_type_upload_pgm_data,
+    firebase_fcs_request_type_upload_segments,
     firebase_fcs_request_type_download,
     firebase_fcs_request_type_get_meta,
     firebase_fcs_request_type_delete,
@@ -743,6 +761,89 @@ struct firebase_auth_token_error_t
     int code = 0;
 };
 
+typedef struct firebase_tcp_write_stats_t
+{
+    // The requests sent with the corked writes
+    uint32_t requests = 0;
+    // The TLS records, TCP send calls and bytes of the requests
+    uint32_t records = 0;
+    uint32_t socketWrites = 0;
+    uint32_t bytes = 0;
+    // The same of the last request
+    uint32_t lastRecords = 0;
+    uint32_t lastSocketWrites = 0;
+    uint32_t lastBytes = 0;
+
+} FB_TCPWriteStats;
+
+#if defined(PERF_TRACE_ENABLED)
+
+// The number of entries of the trace ring
+#if !defined(FB_PERF_TRACE_SIZE)
+#define FB_PERF_TRACE_SIZE 32
+#endif
+
+// The session id of the phases that do not belong to a FirebaseData e.g. token request
+#define FB_PERF_SESSION_CORE 0
+
+typedef enum
+{
+    // DNS lookup and TCP connect
+    fb_perf_phase_connect,
+    // TLS handshake
+    fb_perf_phase_handshake,
+    // Token request or refresh
+    fb_perf_phase_token,
+    // Request header and payload writing
+    fb_perf_phase_request,
+    // Waiting for the first byte of the response
+    fb_perf_phase_wait,
+    // Response reading and parsing, from the first to the last byte read
+    fb_perf_phase_response,
+    fb_perf_phase_max
+} fb_perf_phase;
+
+typedef struct fb_perf_trace_entry_t
+{
+    // The cycle counter (micros where not available) at the phase start
+    uint32_t cycles = 0;
+    // The phase time in microseconds
+    uint32_t us = 0;
+    // The bytes of request and response, 1 for resumed and 0 for full handshake, the result of token request
+    int32_t value = 0;
+    // The fb_perf_phase
+    uint8_t phase = 0;
+    // The session id (FirebaseData::getPerfStats().session) or FB_PERF_SESSION_CORE
+    uint8_t session = 0;
+    // The entry sequence number, for the ring reader
+    uint16_t seq = 0;
+
+} FB_PerfTraceEntry;
+
+typedef struct fb_perf_stats_t
+{
+    // The session id in the trace entries
+    uint8_t session = 0;
+    // The number of phases, their total and last time in microseconds, indexed by fb_perf_phase
+    uint32_t phaseCount[fb_perf_phase_max] = {};
+    uint32_t phaseUs[fb_perf_phase_max] = {};
+    uint32_t lastUs[fb_perf_phase_max] = {};
+    // The bytes read and written
+    uint32_t bytesIn = 0;
+    uint32_t bytesOut = 0;
+    // The TLS records sent
+    uint32_t txRecords = 0;
+    // The new connections after the first one
+    uint32_t reconnects = 0;
+    uint32_t fullHandshakes = 0;
+    uint32_t resumedHandshakes = 0;
+    // The lowest free heap seen at the end of the phases, 0 if none
+    uint32_t heapMin = 0;
+
+} FB_PerfStats;
+
+#endif
+
 struct server_response_data_t
 {
     int httpCode = 0;
@@ -778,6 +879,8 @@ struct server_response_data_t
     MB_String pushName;
     MB_String fbError;
     MB_String transferEnc;
+    // The server time from Date header
+    time_t date = 0;
 };
 
 struct firebase_chunk_state_info
@@ -847,10 +950,10 @@ public:
 
 struct firebase_rtdb_address_t
 {
-    int dout = 0;
-    int din = 0;
-    int priority = 0;
-    int query = 0;
+    uintptr_t dout = 0;
+    uintptr_t din = 0;
+    uintptr_t priority = 0;
+    uintptr_t query = 0;
 };
 
 struct firebase_rtdb_request_data_info
@@ -886,6 +989,27 @@ typedef struct firebase_rtdb_download_status_info_t
 
 } RTDB_DownloadStatusInfo;
 
+typedef struct firebase_rtdb_stream_task_stats_t
+{
+    // The number of stream task wakeups
+    uint32_t wakeups = 0;
+    // The wakeups by incoming data
+    uint32_t dataWakeups = 0;
+    // The wakeups by keep-alive, reconnect or error notification deadline
+    uint32_t timerWakeups = 0;
+    // The stream events sent to callbacks
+    uint32_t events = 0;
+    uint32_t lastEventsPerWakeup = 0;
+    uint32_t maxEventsPerWakeup = 0;
+    // The time in microseconds the task woke up later than its deadline
+    uint32_t lastWakeLatencyUs = 0;
+    uint32_t maxWakeLatencyUs = 0;
+    // The time in microseconds from wakeup until all events of that wakeup were sent to callbacks
+    uint32_t lastDispatchUs = 0;
+    uint32_t maxDispatchUs = 0;
+
+} RTDB_StreamTaskStats;
+
 typedef void (*RTDB_UploadProgressCallback)(RTDB_UploadStatusInfo);
 typedef void (*RTDB_DownloadProgressCallback)(RTDB_DownloadStatusInfo);
 
@@ -973,6 +1097,8 @@ struct firebase_auth_signin_user_t
 struct firebase_auth_cert_t
 {
     const char *data = NULL;
+    // The server public key (PEM) to verify instead of the certificate chain
+    const char *pinned_key = NULL;
     MB_String file;
 #if defined(FIREBASE_ESP_CLIENT)
     firebase_mem_storage_type file_storage = mem_storage_type_flash;
@@ -1064,7 +1190,7 @@ struct firebase_stream_info_t
 
 struct firebase_session_info
 {
-    uint32_t ptr = 0;
+    uintptr_t ptr = 0;
     bool status = false;
 };
 
@@ -1092,6 +1218,7 @@ struct firebase_cfg_int_t
     unsigned long fb_last_time_sync_millis = 0;
     unsigned long fb_last_ntp_sync_timeout_millis = 0;
     bool fb_clock_rdy = false;
+    bool fb_ntp_started = false;
     base_time_type_t fb_base_time_type = base_time_type_undefined;
     float fb_gmt_offset = 0;
     float fb_daylight_offset = 0;
@@ -1111,6 +1238,9 @@ struct firebase_cfg_int_t
     uint16_t email_crc = 0, password_crc = 0, client_email_crc = 0, project_id_crc = 0, priv_key_crc = 0, uid_crc = 0;
 
     bool stream_loop_task_enable = true;
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+    RTDB_StreamTaskStats stream_task_stats;
+#endif
     bool deploy_loop_task_enable = true;
     bool resumable_upload_loop_task_enabnle = true;
 #if defined(ESP32) || defined(MB_ARDUINO_PICO)
@@ -1130,6 +1260,12 @@ struct firebase_cfg_int_t
     uint16_t stream_task_delay_ms = 10;
 #else
     uint16_t stream_task_delay_ms = 100;
+#endif
+#if defined(ESP32)
+    // The longest time the stream task waits for socket data or the nearest deadline
+    uint16_t stream_task_max_wait_ms = 1000;
+    unsigned long stream_task_wake_us = 0;
+    uint32_t stream_task_wake_events = 0;
 #endif
     size_t queue_task_stack_size = QUEUE_TASK_STACK_SIZE;
     uint8_t queue_task_priority = 1;
@@ -1190,6 +1326,17 @@ struct firebase_fcs_file_list_item_t
     unsigned long generation = 0;
 };
 
+// The segment of upload data, the byte array (data, len) or the part of file (localFileName, storageType, offset, len).
+// The zero len of file segment is the rest of file from offset.
+typedef struct firebase_upload_segment_t
+{
+    const uint8_t *data = nullptr;
+    const char *localFileName = nullptr;
+    firebase_mem_storage_type storageType = mem_storage_type_undefined;
+    size_t offset = 0;
+    size_t len = 0;
+} UploadSegment;
+
 #endif
 
 #if defined(ENABLE_GC_STORAGE) || defined(FIREBASE_ENABLE_GC_STORAGE)
@@ -1198,6 +1345,10 @@ struct firebase_gcs_config_t
 {
     size_t upload_buffer_size = 2048;
     size_t download_buffer_size = 2048;
+    // the resumable upload chunk size, rounded down to the multiple of 256 KiB, 0 for a quarter of file size
+    size_t upload_chunk_size = 0;
+    // the number of times to resume the interrupted resumable upload from the last committed byte
+    uint8_t upload_resume_retry = 3;
 };
 
 typedef struct firebase_gcs_upload_status_info_t
@@ -1626,6 +1777,10 @@ struct firebase_gcs_req_t
     int chunkRange = -1;
     int chunkPos = 0;
     int chunkLen = 0;
+    uint32_t chunkSize = 0;
+    uint8_t resumeRetry = 0;
+    bool queryStatus = false;
+    bool incomplete = false;
     size_t fileSize = 0;
     int progress = -1;
     ListOptions *listOptions = nullptr;
@@ -1820,6 +1975,41 @@ struct firebase_fcm_info_t
     MB_String payload;
 };
 
+typedef struct firebase_fcm_batch_result_t
+{
+    // The index of the token in the tokens array
+    size_t index = 0;
+    const char *token = nullptr;
+    // The HTTP status code or the negative TCP error code
+    int httpCode = 0;
+    // The server response, e.g. the message name or the error, valid during the callback only
+    const char *payload = nullptr;
+
+} FCM_BatchResult;
+
+typedef void (*FCM_BatchResultCallback)(FCM_BatchResult);
+
+typedef struct firebase_fcm_batch_stats_t
+{
+    // The messages sent, once for each token (see resent), and the responses of them
+    uint32_t sent = 0;
+    uint32_t succeeded = 0;
+    uint32_t failed = 0;
+    // The messages sent again because the server closed the connection before reading them
+    uint32_t resent = 0;
+    // The new connections, the other messages were sent over the kept-alive connection
+    uint32_t connections = 0;
+    // The time in ms of the last batch and its throughput
+    uint32_t lastBatchMs = 0;
+    uint32_t lastMessagesPerSec = 0;
+    // The time in ms from sending the message until its response was read
+    uint32_t lastLatencyMs = 0;
+    uint32_t maxLatencyMs = 0;
+    // The sum of latency of all responses, divide by (succeeded + failed) for the average
+    uint32_t totalLatencyMs = 0;
+
+} FCM_BatchStats;
+
 #endif
 
 #if defined(ENABLE_FB_STORAGE) || defined(FIREBASE_ENABLE_FB_STORAGE) || defined(ENABLE_GC_STORAGE) || defined(FIREBASE_ENABLE_GC_STORAGE)
@@ -1849,6 +2039,8 @@ struct firebase_fcs_req_t
     MB_String mime;
     const uint8_t *pgmArc = nullptr;
     size_t pgmArcLen = 0;
+    const UploadSegment *segments = nullptr;
+    size_t segmentCount = 0;
     size_t fileSize = 0;
     int progress = -1;
     firebase_mem_storage_type storageType = mem_storage_type_undefined;
@@ -1950,6 +2142,27 @@ struct firebase_firestore_document_write_t
 
 #endif
 
+enum firebase_header_template_type
+{
+    firebase_header_template_rtdb,
+    firebase_header_template_firestore,
+    firebase_header_template_fcm,
+    firebase_header_template_max
+};
+
+// The serialized invariant request header lines (Host, User-Agent, custom headers and Authorization)
+// which are rebuilt only when the host, custom headers or token were changed.
+struct firebase_header_template_t
+{
+    MB_String header;
+    MB_String host;
+    MB_String custom;
+    int8_t tokenType = -1;
+    bool space = false;
+    size_t tokenOfs = 0;
+    size_t tokenLen = 0;
+};
+
 struct firebase_session_info_t
 {
     int long_running_task = 0;
@@ -1965,7 +2178,7 @@ struct firebase_session_info_t
     bool classic_request = false;
     MB_String host;
     unsigned long last_conn_ms = 0;
-    int cert_ptr = 0;
+    uintptr_t cert_ptr = 0;
     bool cert_updated = false;
     uint32_t conn_timeout = DEFAULT_TCP_CONNECTION_TIMEOUT;
 
@@ -1996,9 +2209,17 @@ struct firebase_session_info_t
 #if defined(ENABLE_FB_FUNCTIONS) || defined(FIREBASE_ENABLE_FB_FUNCTIONS)
     struct firebase_functions_info_t cfn;
 #endif
+#if defined(OTA_UPDATE_ENABLED)
+    // the expected and the computed SHA-256 digest (hex) of the downloaded firmware
+    MB_String ota_sha256;
+    MB_String ota_digest;
+#endif
 
     uint16_t bssl_rx_size = 2048;
     uint16_t bssl_tx_size = 512;
+    uint16_t bssl_mfl_len = 0;
+
+    firebase_header_template_t header_tmpl[firebase_header_template_max];
 };
 
 #if defined(ENABLE_FCM) || defined(FIREBASE_ENABLE_FCM)
@@ -2095,6 +2316,8 @@ static const char firebase_pgm_str_67[] PROGMEM = "data";
 static const char firebase_pgm_str_68[] PROGMEM = "update";
 static const char firebase_pgm_str_69[] PROGMEM = "delete";
 static const char firebase_pgm_str_70[] PROGMEM = "updateMask";
+static const char firebase_pgm_str_71[] PROGMEM = "Date: ";
+static const char firebase_pgm_str_72[] PROGMEM = "JanFebMarAprMayJunJulAugSepOctNovDec";
 
 // Legacy FCM string
 #if defined(FIREBASE_ESP32_CLIENT) || defined(FIREBASE_ESP8266_CLIENT)
@@ -2180,6 +2403,7 @@ static const char firebase_auth_pgm_str_59[] PROGMEM = "requestType";
 static const char firebase_auth_pgm_str_60[] PROGMEM = "VERIFY_EMAIL";
 static const char firebase_auth_pgm_str_61[] PROGMEM = "getOobConfirmationCode?key=";
 static const char firebase_auth_pgm_str_62[] PROGMEM = "PASSWORD_RESET";
+static const char firebase_auth_pgm_str_63[] PROGMEM = "TokenRefresh";
 #endif
 
 // RTDB class string
@@ -2301,6 +2525,9 @@ static const char firebase_fcm_pgm_str_68[] PROGMEM = "message";
 static const char firebase_fcm_pgm_str_69[] PROGMEM = "android";
 static const char firebase_fcm_pgm_str_70[] PROGMEM = "webpush";
 static const char firebase_fcm_pgm_str_71[] PROGMEM = "apns";
+// The batch message token placeholder
+static const char firebase_fcm_pgm_str_72[] PROGMEM = "__fcm_batch_token__";
+static const char firebase_fcm_pgm_str_73[] PROGMEM = "close";
 #endif
 
 // Firestore class string
@@ -2417,6 +2644,8 @@ static const char firebase_gcs_pgm_str_45[] PROGMEM = "startOffset=";
 static const char firebase_gcs_pgm_str_46[] PROGMEM = "versions=";
 static const char firebase_gcs_pgm_str_47[] PROGMEM = "resumableUploadTask";
 static const char firebase_gcs_pgm_str_48[] PROGMEM = "Range: bytes=0-";
+static const char firebase_gcs_pgm_str_49[] PROGMEM = "*/";
+static const char firebase_gcs_pgm_str_50[] PROGMEM = "gcsChunkReader";
 #endif
 
 // Firebase Functions class string
@@ -2523,6 +2752,7 @@ static const char firebase_rtdb_ss_pgm_str_13[] PROGMEM = "push";
 static const char firebase_rtdb_ss_pgm_str_14[] PROGMEM = "task";
 static const char firebase_rtdb_ss_pgm_str_15[] PROGMEM = "_stream";
 static const char firebase_rtdb_ss_pgm_str_16[] PROGMEM = "_error_queue";
+static const char firebase_rtdb_ss_pgm_str_17[] PROGMEM = "value";
 #endif
 
 // Storage classes string
@@ -2615,6 +2845,7 @@ static const char firebase_ota_err_pgm_str_3[] PROGMEM = "Updater write() failed
 static const char firebase_ota_err_pgm_str_4[] PROGMEM = "Updater end() failed.";
 static const char firebase_ota_err_pgm_str_5[] PROGMEM = "invalid Firmware";
 static const char firebase_ota_err_pgm_str_6[] PROGMEM = "too low free sketch space";
+static const char firebase_ota_err_pgm_str_7[] PROGMEM = "firmware SHA-256 digest does not match";
 #endif
 
 // Storage error string
@@ -2651,6 +2882,7 @@ static const char firebase_fcm_err_pgm_str_1[] PROGMEM = "no ID token or registr
 static const char firebase_fcm_err_pgm_str_2[] PROGMEM = "mo server key provided";
 static const char firebase_fcm_err_pgm_str_3[] PROGMEM = "no topic provided";
 static const char firebase_fcm_err_pgm_str_4[] PROGMEM = "ID token or registration token was not not found at index";
+static const char firebase_fcm_err_pgm_str_5[] PROGMEM = "ID token or registration token contains invalid characters";
 
 #endif
 
@@ -2660,6 +2892,25 @@ static const char firebase_functions_err_pgm_str_1[] PROGMEM = "missing autozip
 #endif
 
 static const char firebase_boundary_table[] PROGMEM = "=_abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-static const unsigned char firebase_base64_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static constexpr unsigned char firebase_base64_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static constexpr unsigned char firebase_base64_url_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+// the index of firebase_base64_table character, 0x80 for the character that is not in the table and 0 for padding (=)
+static constexpr unsigned char firebase_base64_dec_table[256] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3e, 0x80, 0x80, 0x80, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x80, 0x80, 0x80, 0x00, 0x80, 0x80,
+    0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80};
 
 #endif
\ No newline at end of file
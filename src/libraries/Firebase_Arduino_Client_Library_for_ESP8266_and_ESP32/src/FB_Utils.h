@@ -583,12 +583,13 @@ public:
         return ret;
     }
 
-    bool setData(FirebaseJson *json, MB_String &val, bool clearAfterAdded)
+    // lazy, the elements are parsed when they are read, for the response which only a few elements are read
+    bool setData(FirebaseJson *json, MB_String &val, bool clearAfterAdded, bool lazy = false)
     {
         bool ret = false;
 
         if (json && val.length() > 0)
-            ret = json->setJsonData(val);
+            ret = lazy ? json->setJsonDataLazy(val) : json->setJsonData(val);
 
         if (clearAfterAdded)
             val.clear();
@@ -730,6 +731,55 @@ public:
             header += firebase_pgm_str_47; // "key="
     }
 
+    /** Get the Host, User-Agent, custom headers and Authorization lines from template.
+     *
+     * @param sh The StringHelper.
+     * @param tmpl The template to use.
+     * @param host The host name.
+     * @param custom The comma separated custom headers.
+     * @param token The auth token or NULL for no Authorization header.
+     * @param type The auth token type.
+     * @param space Add space between the auth type and token.
+     * @return The serialized header lines.
+     *
+     * @note The template is serialized again only when the host, custom headers or token were changed.
+     */
+    const MB_String &getHeaderTemplate(StringHelper *sh, struct firebase_header_template_t &tmpl, const char *host,
+                                       const MB_String &custom, const char *token, firebase_auth_token_type type, bool space = false)
+    {
+        int8_t tokenType = token ? (int8_t)type : -1;
+        size_t tokenLen = token ? strlen(token) : 0;
+
+        if (tmpl.header.length() > 0 && tmpl.tokenType == tokenType && tmpl.space == space && tmpl.tokenLen == tokenLen &&
+            strcmp(tmpl.host.c_str(), host) == 0 && strcmp(tmpl.custom.c_str(), custom.c_str()) == 0 &&
+            (tokenLen == 0 || memcmp(tmpl.header.c_str() + tmpl.tokenOfs, token, tokenLen) == 0))
+            return tmpl.header;
+
+        tmpl.header.clear();
+        tmpl.header.reserve(strlen(host) + custom.length() + tokenLen + 64);
+        addHostHeader(tmpl.header, host);
+        addUAHeader(tmpl.header);
+        getCustomHeaders(sh, tmpl.header, custom);
+
+        if (token)
+        {
+            addAuthHeaderFirst(tmpl.header, type);
+            if (space)
+                tmpl.header += firebase_pgm_str_9; // " "
+            tmpl.tokenOfs = tmpl.header.length();
+            tmpl.header += token;
+            addNewLine(tmpl.header);
+        }
+
+        tmpl.host = host;
+        tmpl.custom = custom;
+        tmpl.tokenType = tokenType;
+        tmpl.space = space;
+        tmpl.tokenLen = tokenLen;
+
+        return tmpl.header;
+    }
+
     void parseRespHeader(StringHelper *sh, const MB_String &src, struct server_response_data_t &response)
     {
         int beginPos = 0;
@@ -770,9 +820,46 @@ public:
 
             if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT)
                 response.noContent = true;
+
+            MB_String date;
+            if (sh->tokenSubString(src, date,
+                                   firebase_pgm_str_71 /* "Date: " */,
+                                   firebase_pgm_str_30 /* "\r\n" */, beginPos, 0, false))
+                response.date = parseDate(date.c_str());
         }
     }
 
+    /* parse the HTTP date e.g. "Sun, 06 Nov 1994 08:49:37 GMT" to UTC timestamp */
+    time_t parseDate(const char *date)
+    {
+        const char *p = strchr(date, ',');
+        if (!p)
+            return 0;
+
+        int day = 0, year = 0, hour = 0, mins = 0, sec = 0;
+        char mon[4];
+        if (sscanf(p + 1, " %d %3s %d %d:%d:%d", &day, mon, &year, &hour, &mins, &sec) != 6)
+            return 0;
+
+        MB_String months;
+        months.appendP(firebase_pgm_str_72); // "JanFebMarAprMayJunJulAugSepOctNovDec"
+        size_t pos = months.find(mon);
+        if (pos == MB_String::npos || pos % 3 != 0 || strlen(mon) != 3)
+            return 0;
+
+        int month = pos / 3 + 1;
+
+        // days from the civil date, independent of the local time zone (mktime)
+        year -= month <= 2;
+        int era = (year >= 0 ? year : year - 399) / 400;
+        unsigned yoe = (unsigned)(year - era * 400);
+        unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        long days = (long)era * 146097 + (long)doe - 719468;
+
+        return (time_t)days * 86400 + hour * 3600 + mins * 60 + sec;
+    }
+
     int getStatusCode(StringHelper *sh, const MB_String &header, int &pos)
     {
         int code = 0;
@@ -1309,36 +1396,26 @@ public:
         return (3 * (len / 4)) - pad;
     }
 
-    unsigned char *creatBase64EncBuffer(MB_FS *mbfs, bool isURL)
+    const unsigned char *base64EncTable(bool isURL)
     {
-        unsigned char *base64EncBuf = reinterpret_cast<unsigned char *>(mbfs->newP(65));
-        strcpy_P((char *)base64EncBuf, (char *)firebase_base64_table);
-        if (isURL)
-        {
-            base64EncBuf[62] = '-';
-            base64EncBuf[63] = '_';
-        }
-        return base64EncBuf;
+        return isURL ? firebase_base64_url_table : firebase_base64_table;
     }
 
     bool updateWrite(uint8_t *data, size_t len)
     {
+        (void)data;
+        (void)len;
 #if (defined(ENABLE_OTA_FIRMWARE_UPDATE) || defined(FIREBASE_ENABLE_OTA_FIRMWARE_UPDATE)) && (defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB) || defined(ENABLE_FB_STORAGE) || defined(ENABLE_GC_STORAGE) || defined(FIREBASE_ENABLE_GC_STORAGE))
-#if defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO)
+#if defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST)
         return Update.write(data, len) == len;
 #endif
 #endif
         return false;
     }
 
-    unsigned char *creatBase64DecBuffer(MB_FS *mbfs)
+    const unsigned char *base64DecTable()
     {
-        unsigned char *base64DecBuf = reinterpret_cast<unsigned char *>(mbfs->newP(256, false));
-        memset(base64DecBuf, 0x80, 256);
-        for (size_t i = 0; i < sizeof(firebase_base64_table) - 1; i++)
-            base64DecBuf[firebase_base64_table[i]] = (unsigned char)i;
-        base64DecBuf['='] = 0;
-        return base64DecBuf;
+        return firebase_base64_dec_table;
     }
 
     template <typename T = uint8_t>
@@ -1383,7 +1460,7 @@ public:
     }
 
     template <typename T>
-    bool decode(MB_FS *mbfs, unsigned char *base64DecBuf, const char *src, size_t len, firebase_base64_io_t<T> &out)
+    bool decode(MB_FS *mbfs, const unsigned char *base64DecBuf, const char *src, size_t len, firebase_base64_io_t<T> &out)
     {
         // the maximum chunk size that writes to output is limited by out.bufLen, the minimum is depending on the source length
         bool ret = false;
@@ -1463,7 +1540,7 @@ public:
     }
 
     template <typename T>
-    bool encodeLast(MB_FS *mbfs, unsigned char *base64EncBuf, const unsigned char *in, size_t len,
+    bool encodeLast(MB_FS *mbfs, const unsigned char *base64EncBuf, const unsigned char *in, size_t len,
                     firebase_base64_io_t<T> &out, T **pos)
     {
         if (len > 2)
@@ -1493,8 +1570,34 @@ public:
         return true;
     }
 
+    // Encode 12 bytes (three 32-bit words) to 16 characters.
     template <typename T>
-    bool encode(MB_FS *mbfs, unsigned char *base64EncBuf, uint8_t *src, size_t len,
+    void encodeBlock(const unsigned char *base64EncBuf, const unsigned char *in, T *dst)
+    {
+        uint32_t w0 = (uint32_t)in[0] << 24 | (uint32_t)in[1] << 16 | (uint32_t)in[2] << 8 | in[3];
+        uint32_t w1 = (uint32_t)in[4] << 24 | (uint32_t)in[5] << 16 | (uint32_t)in[6] << 8 | in[7];
+        uint32_t w2 = (uint32_t)in[8] << 24 | (uint32_t)in[9] << 16 | (uint32_t)in[10] << 8 | in[11];
+
+        dst[0] = (T)base64EncBuf[w0 >> 26];
+        dst[1] = (T)base64EncBuf[(w0 >> 20) & 0x3f];
+        dst[2] = (T)base64EncBuf[(w0 >> 14) & 0x3f];
+        dst[3] = (T)base64EncBuf[(w0 >> 8) & 0x3f];
+        dst[4] = (T)base64EncBuf[(w0 >> 2) & 0x3f];
+        dst[5] = (T)base64EncBuf[((w0 << 4) | (w1 >> 28)) & 0x3f];
+        dst[6] = (T)base64EncBuf[(w1 >> 22) & 0x3f];
+        dst[7] = (T)base64EncBuf[(w1 >> 16) & 0x3f];
+        dst[8] = (T)base64EncBuf[(w1 >> 10) & 0x3f];
+        dst[9] = (T)base64EncBuf[(w1 >> 4) & 0x3f];
+        dst[10] = (T)base64EncBuf[((w1 << 2) | (w2 >> 30)) & 0x3f];
+        dst[11] = (T)base64EncBuf[(w2 >> 24) & 0x3f];
+        dst[12] = (T)base64EncBuf[(w2 >> 18) & 0x3f];
+        dst[13] = (T)base64EncBuf[(w2 >> 12) & 0x3f];
+        dst[14] = (T)base64EncBuf[(w2 >> 6) & 0x3f];
+        dst[15] = (T)base64EncBuf[w2 & 0x3f];
+    }
+
+    template <typename T>
+    bool encode(MB_FS *mbfs, const unsigned char *base64EncBuf, const uint8_t *src, size_t len,
                 firebase_base64_io_t<T> &out, bool writeAllRemaining = true)
     {
         const unsigned char *end, *in;
@@ -1503,8 +1606,32 @@ public:
         in = src;
         end = src + len;
 
+        bool buffered = out.ota || out.outC || out.filetype != mb_fs_mem_storage_type_undefined;
+
         while (end - in >= 3)
         {
+            // The 12-byte block is encoded in place when the output has room for 16 characters,
+            // the output vector and the remaining bytes are encoded by 3-byte group.
+            if (end - in >= 12 && out.outT)
+            {
+                if (!buffered)
+                {
+                    encodeBlock(base64EncBuf, in, pos);
+                    pos += 16;
+                    in += 12;
+                    continue;
+                }
+                else if (out.bufLen - out.bufWrite >= 16)
+                {
+                    encodeBlock(base64EncBuf, in, out.outT + out.bufWrite);
+                    out.bufWrite += 16;
+                    in += 12;
+                    if (out.bufWrite == (int)out.bufLen && !writeOutput(mbfs, out))
+                        return false;
+                    continue;
+                }
+            }
+
             if (!setOutput(mbfs, base64EncBuf[in[0] >> 2], out, &pos))
                 return false;
             if (!setOutput(mbfs, base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, &pos))
@@ -1529,30 +1656,35 @@ public:
     {
         firebase_base64_io_t<T> out;
         out.outL = &val;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mbfs);
-        bool ret = decode<T>(mbfs, base64DecBuf, src.c_str(), src.length(), out);
-        mbfs->delP(&base64DecBuf);
-        return ret;
+        return decode<T>(mbfs, base64DecTable(), src.c_str(), src.length(), out);
+    }
+
+    template <typename T>
+    bool decodeToArray(MB_FS *mbfs, const char *src, size_t len, MB_VECTOR<T> &val)
+    {
+        firebase_base64_io_t<T> out;
+        out.outL = &val;
+        return decode<T>(mbfs, base64DecTable(), src, len, out);
     }
 
     bool decodeToFile(MB_FS *mbfs, const char *src, size_t len, mbfs_file_type type)
     {
+        (void)len;
         firebase_base64_io_t<uint8_t> out;
         out.filetype = type;
         uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs->newP(out.bufLen));
         out.outT = buf;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mbfs);
-        bool ret = decode<uint8_t>(mbfs, base64DecBuf, src, strlen(src), out);
+        bool ret = decode<uint8_t>(mbfs, base64DecTable(), src, strlen(src), out);
         mbfs->delP(&buf);
-        mbfs->delP(&base64DecBuf);
         return ret;
     }
 
     void encodeUrl(MB_FS *mbfs, char *encoded, unsigned char *string, size_t len)
     {
+        (void)mbfs;
         size_t i;
         char *p = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, true);
+        const unsigned char *base64EncBuf = base64EncTable(true);
 
         for (i = 0; i < len - 2; i += 3)
         {
@@ -1575,8 +1707,6 @@ public:
         }
 
         *p++ = '\0';
-
-        mbfs->delP(&base64EncBuf);
     }
 
     MB_String encodeToString(MB_FS *mbfs, uint8_t *src, size_t len)
@@ -1585,24 +1715,21 @@ public:
         char *encoded = reinterpret_cast<char *>(mbfs->newP(encodedLength(len) + 1));
         firebase_base64_io_t<char> out;
         out.outT = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, false);
-        if (encode<char>(mbfs, base64EncBuf, (uint8_t *)src, len, out))
+        if (encode<char>(mbfs, base64EncTable(false), (uint8_t *)src, len, out))
             str = encoded;
         mbfs->delP(&encoded);
-        mbfs->delP(&base64EncBuf);
         return str;
     }
 
     bool encodeToClient(Client *client, MB_FS *mbfs, size_t bufSize, uint8_t *data, size_t len)
     {
+        (void)bufSize;
         firebase_base64_io_t<uint8_t> out;
         out.outC = client;
         uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs->newP(out.bufLen));
         out.outT = buf;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, false);
-        bool ret = encode<uint8_t>(mbfs, base64EncBuf, (uint8_t *)data, len, out);
+        bool ret = encode<uint8_t>(mbfs, base64EncTable(false), (uint8_t *)data, len, out);
         mbfs->delP(&buf);
-        mbfs->delP(&base64EncBuf);
         return ret;
     }
 };
@@ -1635,23 +1762,212 @@ public:
         return padLen;
     }
 
-    bool decodeBase64OTA(Base64Helper *bh, MB_FS *mbfs, const char *src, size_t len, int &code)
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST))
+
+    // The firmware sink of RTDB, Firebase Storage and Cloud Storage downloads.
+    // The data is hashed and written in one pass, the base64 data (RTDB) is decoded incrementally
+    // with the incomplete quantum kept to the next chunk, to the fixed buffer which is written
+    // to Updater when it is full, the Updater flash sector buffer is then filled at the same boundary.
+    int begin(MB_FS *mbfs, size_t size, bool base64)
     {
-        bool ret = true;
-        firebase_base64_io_t<uint8_t> out;
-        uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs->newP(out.bufLen));
-        out.ota = true;
-        out.outT = buf;
-        unsigned char *base64DecBuf = bh->creatBase64DecBuffer(mbfs);
-        if (!bh->decode<uint8_t>(mbfs, base64DecBuf, src, strlen(src), out))
+        abort(mbfs);
+
+        if (!Update.begin(size))
+            return FIREBASE_ERROR_FW_UPDATE_TOO_LOW_FREE_SKETCH_SPACE;
+
+        this->base64 = base64;
+        if (base64)
+            buf = reinterpret_cast<uint8_t *>(mbfs->newP(OTA_WRITE_BUFFER_SIZE, false));
+        bufWrite = 0;
+        quadLen = 0;
+        padLen = 0;
+        shaBegin();
+        active = true;
+        return 0;
+    }
+
+    bool write(const uint8_t *data, size_t len)
+    {
+        shaUpdate(data, len);
+        return Update.write(const_cast<uint8_t *>(data), len) == len;
+    }
+
+    bool writeBase64(const char *src, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
         {
-            code = FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED;
-            ret = false;
+            uint8_t val = firebase_base64_dec_table[(uint8_t)src[i]];
+
+            // the quotes and line breaks
+            if (val == 0x80)
+                continue;
+
+            if (src[i] == '=')
+                padLen++;
+            else if (padLen > 0)
+                return false;
+
+            quad[quadLen++] = val;
+            if (quadLen == 4 && !writeQuad())
+                return false;
         }
-        mbfs->delP(&buf);
-        mbfs->delP(&base64DecBuf);
+        return true;
+    }
+
+    // finish the update when the digest matches the expected digest (if set)
+    int end(MB_FS *mbfs, const MB_String &expected, MB_String &digest)
+    {
+        int code = 0;
+
+        if (!active)
+            code = FIREBASE_ERROR_FW_UPDATE_END_FAILED;
+        else if (base64 && !writeTail())
+            code = FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED;
+
+        if (active)
+            shaEnd(digest);
+
+        if (code == 0 && expected.length() > 0 && !digestEquals(expected, digest))
+            code = FIREBASE_ERROR_FW_UPDATE_DIGEST_MISMATCH;
+
+        // the size from the base64 length counts the pad bytes when the pad length is unknown
+        if (code == 0 && !Update.end(base64 && Update.remaining() <= 2))
+            code = FIREBASE_ERROR_FW_UPDATE_END_FAILED;
+
+        if (code != 0)
+            abort(mbfs);
+
+        release(mbfs);
+        return code;
+    }
+
+    void abort(MB_FS *mbfs)
+    {
+        if (!active)
+            return;
+#if defined(ESP32) || defined(MB_HOST)
+        Update.abort();
+#endif
+        shaAbort();
+        release(mbfs);
+    }
+
+private:
+    bool active = false;
+    bool base64 = false;
+    uint8_t *buf = nullptr;
+    size_t bufWrite = 0;
+    uint8_t quad[4];
+    uint8_t quadLen = 0;
+    uint8_t padLen = 0;
+#if defined(ESP32)
+    mbedtls_sha256_context sha;
+#else
+    br_sha256_context sha;
+#endif
+
+    bool put(uint8_t val)
+    {
+        buf[bufWrite++] = val;
+        return bufWrite < OTA_WRITE_BUFFER_SIZE || flush();
+    }
+
+    bool flush()
+    {
+        size_t len = bufWrite;
+        bufWrite = 0;
+        return len == 0 || write(buf, len);
+    }
+
+    bool writeQuad()
+    {
+        quadLen = 0;
+        if (padLen > 2)
+            return false;
+
+        bool ret = put((quad[0] << 2) | (quad[1] >> 4));
+        if (ret && padLen < 2)
+            ret = put((quad[1] << 4) | (quad[2] >> 2));
+        if (ret && padLen < 1)
+            ret = put((quad[2] << 6) | quad[3]);
         return ret;
     }
+
+    bool writeTail()
+    {
+        // the unpadded data
+        if (quadLen == 1)
+            return false;
+        if (quadLen > 1)
+        {
+            padLen += 4 - quadLen;
+            while (quadLen < 4)
+                quad[quadLen++] = 0;
+            if (!writeQuad())
+                return false;
+        }
+        return flush();
+    }
+
+    void release(MB_FS *mbfs)
+    {
+        if (buf)
+            mbfs->delP(&buf);
+        buf = nullptr;
+        active = false;
+    }
+
+    bool digestEquals(const MB_String &expected, const MB_String &digest)
+    {
+        if (expected.length() != digest.length())
+            return false;
+        for (size_t i = 0; i < digest.length(); i++)
+        {
+            if (tolower(expected[i]) != digest[i])
+                return false;
+        }
+        return true;
+    }
+
+#if defined(ESP32)
+#if defined(ESP_IDF_VERSION_MAJOR) && ESP_IDF_VERSION_MAJOR >= 5
+    void shaBegin()
+    {
+        mbedtls_sha256_init(&sha);
+        mbedtls_sha256_starts(&sha, 0);
+    }
+    void shaUpdate(const uint8_t *data, size_t len) { mbedtls_sha256_update(&sha, data, len); }
+    void shaFinish(uint8_t *out) { mbedtls_sha256_finish(&sha, out); }
+#else
+    void shaBegin()
+    {
+        mbedtls_sha256_init(&sha);
+        mbedtls_sha256_starts_ret(&sha, 0);
+    }
+    void shaUpdate(const uint8_t *data, size_t len) { mbedtls_sha256_update_ret(&sha, data, len); }
+    void shaFinish(uint8_t *out) { mbedtls_sha256_finish_ret(&sha, out); }
+#endif
+    void shaAbort() { mbedtls_sha256_free(&sha); }
+#else
+    void shaBegin() { br_sha256_init(&sha); }
+    void shaUpdate(const uint8_t *data, size_t len) { br_sha256_update(&sha, data, len); }
+    void shaFinish(uint8_t *out) { br_sha256_out(&sha, out); }
+    void shaAbort() {}
+#endif
+
+    void shaEnd(MB_String &digest)
+    {
+        uint8_t out[32];
+        shaFinish(out);
+        shaAbort();
+        digest.clear();
+        for (size_t i = 0; i < sizeof(out); i++)
+        {
+            digest += "0123456789abcdef"[out[i] >> 4];
+            digest += "0123456789abcdef"[out[i] & 0x0f];
+        }
+    }
+#endif
 };
 
 class Utils
@@ -1671,6 +1987,8 @@ public:
 
     void createDirs(MB_String dirs, firebase_mem_storage_type storageType)
     {
+        (void)dirs;
+        (void)storageType;
 #if defined(SD_FS)
         MB_String dir;
         size_t count = 0;
@@ -40,17 +40,19 @@ FIREBASE_CLASS::FIREBASE_CLASS()
 
 FIREBASE_CLASS::~FIREBASE_CLASS()
 {
-    if (auth)
-        delete auth;
-    auth = nullptr;
+    Core.internal.sessions.clear();
+    Core.internal.queueSessions.clear();
 
-    if (config)
+    // The config and auth of begin() belong to the sketch, only those of pre_begin() are ours.
+    if (!extConfig)
     {
-        Core.internal.sessions.clear();
-        Core.internal.queueSessions.clear();
-        delete config;
-        config = nullptr;
+        if (auth)
+            delete auth;
+        if (config)
+            delete config;
     }
+    auth = nullptr;
+    config = nullptr;
 }
 
 void FIREBASE_CLASS::begin(FirebaseConfig *config, FirebaseAuth *auth)
@@ -124,6 +126,12 @@ struct token_info_t FIREBASE_CLASS::authTokenInfo()
 
 bool FIREBASE_CLASS::ready()
 {
+#if defined(ESP32)
+    // lock-free read of the token state when the token is refreshed in background
+    if (Core.tokenPublished() && Core.networkStatus)
+        return true;
+#endif
+
     if (Core.isExpired())
     {
         for (size_t id = 0; id < Core.internal.sessions.size(); id++)
@@ -136,6 +144,19 @@ bool FIREBASE_CLASS::ready()
     return Core.tokenReady();
 }
 
+#if defined(ESP32)
+bool FIREBASE_CLASS::refreshTokenInBackground(bool enable)
+{
+    if (!enable)
+    {
+        Core.endTokenRefreshTask();
+        return true;
+    }
+
+    return Core.beginTokenRefreshTask();
+}
+#endif
+
 bool FIREBASE_CLASS::authenticated()
 {
     return Core.authenticated;
@@ -368,6 +389,52 @@ void FIREBASE_CLASS::setDoubleDigits(uint8_t digits)
         Core.internal.fb_double_digits = digits;
 }
 
+MB_AllocStats FIREBASE_CLASS::getAllocStats(mb_alloc_tag tag)
+{
+    return MB_Alloc::getStats(tag);
+}
+
+void FIREBASE_CLASS::setAllocPolicy(mb_alloc_tag tag, uint32_t psramMinLen)
+{
+    MB_Alloc::setPolicy(tag, psramMinLen);
+}
+
+void FIREBASE_CLASS::setHeapWatchdog(size_t minBlock, MB_AllocWatchdogCallback cb)
+{
+    MB_Alloc::setWatchdog(minBlock, cb);
+}
+
+size_t FIREBASE_CLASS::getMaxFreeBlock()
+{
+    return MB_Alloc::largestFreeBlock();
+}
+
+void FIREBASE_CLASS::printAllocStats(Print *out)
+{
+    if (out)
+        MB_Alloc::print(out);
+}
+
+#if defined(PERF_TRACE_ENABLED)
+size_t FIREBASE_CLASS::getPerfTrace(FB_PerfTraceEntry *entries, size_t len)
+{
+    if (!entries)
+        return 0;
+    return FB_PerfTrace::get().copy(entries, len);
+}
+
+void FIREBASE_CLASS::printPerfTrace(Print *out)
+{
+    if (out)
+        FB_PerfTrace::get().print(out);
+}
+
+void FIREBASE_CLASS::clearPerfTrace()
+{
+    FB_PerfTrace::get().clear();
+}
+#endif
+
 #if defined(MBFS_SD_FS) && defined(MBFS_CARD_TYPE_SD)
 
 bool FIREBASE_CLASS::sdBegin(int8_t ss, int8_t sck, int8_t miso, int8_t mosi, uint32_t frequency)
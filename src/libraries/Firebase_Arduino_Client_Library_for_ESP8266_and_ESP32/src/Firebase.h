@@ -236,6 +236,21 @@ public:
    */
   bool ready();
 
+#if defined(ESP32)
+  /** Refresh the id token in the background task before it expires (ESP32 only).
+   *
+   * @param enable The boolean to enable or disable the background token refresh.
+   * @return Boolean type status indicates the success of the operation.
+   *
+   * @note The current token is used until the refreshed token was swapped in by ready(),
+   * ready() reads the published token state without waiting for the token request.
+   *
+   * The sign in, the OAuth2 access token and the expired token are still handled by ready().
+   * The external client is not supported.
+   */
+  bool refreshTokenInBackground(bool enable);
+#endif
+
   /** Provide the grant access status for Firebase Services.
    *
    * @return Boolean type status indicates the device can access to the services
@@ -358,6 +373,71 @@ public:
    */
   void setDoubleDigits(uint8_t digits);
 
+  /** Get the allocation stats of the tag.
+   *
+   * @param tag The mb_alloc_tag e.g. mb_alloc_tag_tls.
+   * @return MB_AllocStats of the tag.
+   *
+   * @note The live, peak, psram and blocks are available when ENABLE_ALLOC_STATS is defined.
+   */
+  MB_AllocStats getAllocStats(mb_alloc_tag tag);
+
+  /** Set the PSRAM threshold of the tag.
+   *
+   * @param tag The mb_alloc_tag e.g. mb_alloc_tag_http.
+   * @param psramMinLen The allocations of this size and larger go to PSRAM, 0 for all and
+   * MB_ALLOC_PSRAM_NEVER for none.
+   *
+   * @note The threshold applies when the PSRAM usage of the allocator is enabled
+   * (FIREBASE_USE_PSRAM) and PSRAM or external heap is available.
+   */
+  void setAllocPolicy(mb_alloc_tag tag, uint32_t psramMinLen);
+
+  /** Set the largest free block watchdog.
+   *
+   * @param minBlock The largest free block of internal RAM below which the callback is called, 0 to disable.
+   * @param cb The MB_AllocWatchdogCallback function, void(size_t largestBlock, size_t freeHeap).
+   *
+   * @note The largest free block is checked before the new server connection and when the allocation failed,
+   * the callback is called once every time the largest free block falls below minBlock.
+   */
+  void setHeapWatchdog(size_t minBlock, MB_AllocWatchdogCallback cb);
+
+  /** Get the largest free block of internal RAM.
+   *
+   * @return The largest free block size or 0 if not available.
+   */
+  size_t getMaxFreeBlock();
+
+  /** Print the allocation stats of all tags, one per line as
+   * <tag> live=<bytes> peak=<bytes> psram=<bytes> blocks=<n> allocs=<n> fails=<n>.
+   *
+   * @param out The Print object e.g. Serial.
+   */
+  void printAllocStats(Print *out);
+
+#if defined(PERF_TRACE_ENABLED)
+  /** Get the last connect, handshake, token, request, wait and response phases of all sessions.
+   *
+   * @param entries The FB_PerfTraceEntry array to copy the entries to, from the oldest to the newest.
+   * @param len The number of elements of entries.
+   * @return The number of entries copied.
+   *
+   * @note Available when ENABLE_PERF_TRACE is defined, the trace keeps the last FB_PERF_TRACE_SIZE phases.
+   */
+  size_t getPerfTrace(FB_PerfTraceEntry *entries, size_t len);
+
+  /** Print the trace entries, one per line as <seq> <session> <phase> <cycles> <us> <value>.
+   *
+   * @param out The Print object e.g. Serial.
+   */
+  void printPerfTrace(Print *out);
+
+  /** Clear the trace entries.
+   */
+  void clearPerfTrace();
+#endif
+
 #if defined(FIREBASE_ESP32_CLIENT) || defined(FIREBASE_ESP8266_CLIENT)
 
 #if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
@@ -200,6 +200,20 @@
  * 🏷️ For debug port assignment.
  * #define FIREBASE_DEFAULT_DEBUG_PORT Serial
  *
+ * 🏷️ For routing all connections to a local server e.g. Firebase Emulator or loopback test server.
+ * A port that is not a secure port of the SSL client (443, 8883 ...) connects in plain mode.
+ * #define FIREBASE_HOST_OVERRIDE "127.0.0.1"
+ * #define FIREBASE_PORT_OVERRIDE 8080
+ *
+ * 🏷️ For the per session connect, handshake, request, wait, response and token phase counters
+ * and the trace ring of the last FB_PERF_TRACE_SIZE (32) phases.
+ * #define ENABLE_PERF_TRACE
+ * #define FB_PERF_TRACE_SIZE 64
+ *
+ * 🏷️ For the live and peak bytes of each allocation tag (json, string, tls, http, rtdb-queue, firesense),
+ * the live blocks are kept in a table of about 16 bytes per block when enabled.
+ * #define ENABLE_ALLOC_STATS
+ *
  */
 #define ENABLE_ESP8266_ENC28J60_ETH
 
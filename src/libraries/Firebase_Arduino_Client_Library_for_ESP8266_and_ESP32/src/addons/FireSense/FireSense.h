@@ -723,6 +723,10 @@ private:
     void getDateTimeString(MB_String &s);
     void setupStream();
     void mRun();
+#if defined(ESP32)
+    void waitReady();
+    unsigned long remainingMs(unsigned long start, unsigned long interval, unsigned long now);
+#endif
     void printError(FirebaseData *fbdo);
     void printUpdate(const char *msg, int type, float value = 0);
     void pauseStream();
@@ -1964,6 +1968,8 @@ void FireSenseClass::unpauseStream()
 
 void FireSenseClass::mRun()
 {
+    MB_AllocTagScope scope(mb_alloc_tag_firesense);
+
     delay(0);
     if (configReady())
     {
@@ -2029,7 +2035,8 @@ void FireSenseClass::run()
         {
             _this->mRun();
             yield();
-            vTaskDelay(5 / portTICK_PERIOD_MS);
+            // sleep until the command stream data arrives or the nearest timer
+            _this->waitReady();
         }
 
         firesense_run_task_handle = NULL;
@@ -2044,6 +2051,89 @@ void FireSenseClass::run()
 #endif
 }
 
+#if defined(ESP32)
+unsigned long FireSenseClass::remainingMs(unsigned long start, unsigned long interval, unsigned long now)
+{
+    unsigned long elapsed = now - start;
+    return elapsed >= interval ? 0 : interval - elapsed;
+}
+
+void FireSenseClass::waitReady()
+{
+    // the shortest wait, when any timer was due or the device is initializing
+    const unsigned long minWait = 5;
+    unsigned long waitMs = 1000;
+    int fd = -1;
+
+    if (configReady() && timeReady && initReady && configLoadReady && Firebase.ready())
+    {
+        unsigned long now = millis();
+
+        for (size_t i = 0; i < channelsList.size(); i++)
+        {
+            if (channelsList[i].type == channel_type_t::Input || channelsList[i].type == channel_type_t::Analog_input || channelsList[i].type == channel_type_t::Value)
+            {
+                unsigned long ms = remainingMs(channelsList[i].lastPolling, channelsList[i].pollingInterval, now);
+                if (waitMs > ms)
+                    waitMs = ms;
+            }
+        }
+
+        unsigned long ms = 0;
+
+        if (controllerEnable && (!conditionsLoaded || conditionsList.size() > 0))
+        {
+            ms = conditionMillis > 0 ? remainingMs(conditionMillis, config->condition_process_interval, now) : 0;
+            if (waitMs > ms)
+                waitMs = ms;
+        }
+
+        ms = logMillis > 0 ? remainingMs(logMillis, config->log_interval, now) : 0;
+        if (waitMs > ms)
+            waitMs = ms;
+
+        ms = lastSeenMillis > 0 ? remainingMs(lastSeenMillis, config->last_seen_interval, now) : 0;
+        if (waitMs > ms)
+            waitMs = ms;
+
+        // the command stream of shared Firebase Data object is read in this task
+        if (!config->stream_fbdo && !config->disable_command)
+        {
+            if (config->shared_fbdo->tcpClient.connected())
+            {
+                // the records that were already decrypted or the bytes buffered by the client are not
+                // seen by select, read them now
+                if (config->shared_fbdo->tcpClient.available() > 0)
+                    return;
+                fd = config->shared_fbdo->tcpClient.socketFd();
+            }
+
+            // not connected or external client, keep polling
+            if (fd < 0)
+                waitMs = minWait;
+        }
+    }
+    else
+        waitMs = minWait;
+
+    if (waitMs < minWait)
+        waitMs = minWait;
+
+    if (fd > -1)
+    {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(fd, &readSet);
+        struct timeval tv;
+        tv.tv_sec = waitMs / 1000;
+        tv.tv_usec = (waitMs % 1000) * 1000;
+        select(fd + 1, &readSet, NULL, NULL, &tv);
+    }
+    else
+        vTaskDelay(waitMs / portTICK_PERIOD_MS);
+}
+#endif
+
 void FireSenseClass::restart()
 {
     if (!configReady())
@@ -2281,6 +2371,8 @@ void FireSenseClass::updateConfig()
 
 bool FireSenseClass::loadConfig()
 {
+    MB_AllocTagScope scope(mb_alloc_tag_firesense);
+
     if (!configReady() || !Firebase.ready() || !Firebase.authenticated())
     {
         run();
@@ -2496,6 +2588,8 @@ void FireSenseClass::setClock(float time_zone, float daylight_offset_in_sec)
 
 void FireSenseClass::addCondition(struct firesense_condition_t cond, bool addToDatabase)
 {
+    MB_AllocTagScope scope(mb_alloc_tag_firesense);
+
     if (!configReady())
         return;
 
@@ -3079,6 +3173,8 @@ void FireSenseClass::loadStatus()
 
 void FireSenseClass::readStream(FIREBASE_STREAM_CLASS *data)
 {
+    MB_AllocTagScope scope(mb_alloc_tag_firesense);
+
     if (!configReady())
         return;
 
@@ -3198,6 +3294,8 @@ void FireSenseClass::readStream(FirebaseData *fbdo)
 
 void FireSenseClass::addChannel(struct channel_info_t &channel, bool addToDatabase)
 {
+    MB_AllocTagScope scope(mb_alloc_tag_firesense);
+
     if (!configReady())
         return;
     printUpdate(channel.id.c_str(), 39);
@@ -38,6 +38,9 @@
 #include "./client/SSLClient/ESP_SSLClient.h"
 #endif
 #include "./FB_Network.h"
+#if defined(PERF_TRACE_ENABLED)
+#include "./core/FB_Perf.h"
+#endif
 
 #if defined(ESP32)
 #include "IPAddress.h"
@@ -95,6 +98,9 @@ public:
   Firebase_TCP_Client()
   {
     _tcp_client = new ESP_SSLClient();
+#if defined(PERF_TRACE_ENABLED)
+    _perf.session = FB_PerfTrace::get().newSession();
+#endif
   };
 
   virtual ~Firebase_TCP_Client()
@@ -103,6 +109,11 @@ public:
     if (_tcp_client)
       delete (ESP_SSLClient *)_tcp_client;
     _tcp_client = nullptr;
+    BSSL_TrustAnchorCache::release(_x509);
+    _x509 = nullptr;
+    if (_pinned_key)
+      delete _pinned_key;
+    _pinned_key = nullptr;
   }
 
   /**
@@ -133,6 +144,12 @@ public:
    */
   void setGSMClient(Client *client, void *modem = nullptr, const char *pin = nullptr, const char *apn = nullptr, const char *user = nullptr, const char *password = nullptr)
   {
+    (void)client;
+    (void)modem;
+    (void)pin;
+    (void)apn;
+    (void)user;
+    (void)password;
 #if defined(FIREBASE_GSM_MODEM_IS_AVAILABLE)
     _client_type = firebase_client_type_external_gsm_client;
     _basic_client = client;
@@ -171,10 +188,10 @@ public:
   {
     if (caCert)
     {
-      if (_x509)
-        delete _x509;
-
-      _x509 = new X509List(caCert);
+      // The certificate is decoded once and shared by the clients
+      const X509List *x509 = BSSL_TrustAnchorCache::acquire(caCert);
+      BSSL_TrustAnchorCache::release(_x509);
+      _x509 = x509;
       _tcp_client->setTrustAnchors(_x509);
 
       setCertType(firebase_cert_type_data);
@@ -206,21 +223,31 @@ public:
           filename.prepend('/');
       }
 
+      // The file is read when the certificate is set or updated (not per connection), the decoded
+      // certificate is cached by its content, the rotated file with the same name is decoded again.
+      const X509List *x509 = nullptr;
+
       int len = _mbfs->open(filename, storageType, mb_fs_open_mode_read);
-      if (len > -1)
+      if (len > 0)
       {
         uint8_t *der = (uint8_t *)_mbfs->newP(len);
-        if (_mbfs->available(storageType))
-          _mbfs->read(storageType, der, len);
+        int read = 0;
+        if (der && _mbfs->available(storageType))
+          read = _mbfs->read(storageType, der, len);
         _mbfs->close(storageType);
 
-        if (_x509)
-          delete _x509;
-
-        _x509 = new X509List(der, len);
-        _tcp_client->setTrustAnchors(_x509);
+        if (read == len)
+          x509 = BSSL_TrustAnchorCache::acquire(der, len);
         _mbfs->delP(&der);
+      }
+      else if (len == 0)
+        _mbfs->close(storageType);
 
+      if (x509)
+      {
+        BSSL_TrustAnchorCache::release(_x509);
+        _x509 = x509;
+        _tcp_client->setTrustAnchors(_x509);
         setCertType(firebase_cert_type_file);
       }
     }
@@ -228,6 +255,28 @@ public:
     return getCertType() == firebase_cert_type_file;
   }
 
+  /**
+   * Set the server public key to verify instead of the certificate chain.
+   * @param pemKey The PEM public key.
+   * @note The key is parsed once until the different key was set.
+   */
+  void setPinnedKey(const char *pemKey)
+  {
+    if (!pemKey)
+      return;
+
+    if (!_pinned_key || pemKey != _pinned_key_src)
+    {
+      if (_pinned_key)
+        delete _pinned_key;
+      _pinned_key = new PublicKey(pemKey);
+      _pinned_key_src = pemKey;
+    }
+
+    _tcp_client->setKnownKey(_pinned_key);
+    setCertType(firebase_cert_type_key);
+  }
+
   /**
    * Set TCP connection time out in seconds.
    * @param timeoutSec The time out in seconds.
@@ -248,6 +297,119 @@ public:
     _tx_size = tx;
   }
 
+  /**  Set the BearSSL maximum fragment length to negotiate.
+   *
+   * @param len The fragment length (512, 1024, 2048 or 4096) or 0 to disable.
+   */
+  void setMaxFragmentLength(uint16_t len) { _mfl_len = len; }
+
+  /**  Get the BearSSL IO buffer peak usage.
+   *
+   * @param rx The peak number of bytes used in receive buffer.
+   * @param tx The peak number of bytes used in transmit buffer.
+   */
+  void getIOBufferUsage(size_t &rx, size_t &tx)
+  {
+    rx = 0;
+    tx = 0;
+    if (_tcp_client)
+      _tcp_client->getBufferUsage(rx, tx);
+  }
+
+  /**
+   * Hold the written request data until uncork or the response is polled.
+   * @note The request header and body are sent in full TLS records up to the negotiated
+   * record size instead of the partial record that each write can flush.
+   */
+  void cork()
+  {
+    if (_corked || !_tcp_client)
+      return;
+
+    _corked = true;
+    _tcp_client->getWriteStats(_cork_records, _cork_writes, _cork_bytes);
+
+#if defined(PERF_TRACE_ENABLED)
+    perfEndResponse();
+    _perf_waiting = false;
+    _perf_request_bytes = _perf.bytesOut;
+    FB_PerfTrace::mark(_perf_request);
+#endif
+  }
+
+  /**
+   * Send the held request data and count the request records.
+   */
+  void uncork()
+  {
+    if (!_corked)
+      return;
+
+    _corked = false;
+
+    if (!_tcp_client)
+      return;
+
+    _tcp_client->flushWrite();
+
+    uint32_t records = 0, writes = 0, bytes = 0;
+    _tcp_client->getWriteStats(records, writes, bytes);
+
+    _write_stats.requests++;
+    _write_stats.lastRecords = records - _cork_records;
+    _write_stats.lastSocketWrites = writes - _cork_writes;
+    _write_stats.lastBytes = bytes - _cork_bytes;
+    _write_stats.records += _write_stats.lastRecords;
+    _write_stats.socketWrites += _write_stats.lastSocketWrites;
+    _write_stats.bytes += _write_stats.lastBytes;
+
+#if defined(PERF_TRACE_ENABLED)
+    perfAdd(fb_perf_phase_request, _perf_request, micros() - _perf_request.us, _perf.bytesOut - _perf_request_bytes);
+    _perf_waiting = true;
+    FB_PerfTrace::mark(_perf_wait);
+#endif
+  }
+
+  /**
+   * Get the TLS records and TCP send calls of the corked requests.
+   * @return FB_TCPWriteStats data.
+   */
+  FB_TCPWriteStats getWriteStats() { return _write_stats; }
+
+  void resetWriteStats() { _write_stats = FB_TCPWriteStats(); }
+
+#if defined(PERF_TRACE_ENABLED)
+  /**
+   * Get the phase times and counters of this client.
+   * @return FB_PerfStats data.
+   */
+  FB_PerfStats getPerfStats()
+  {
+    _perf.txRecords = _write_stats.records;
+    return _perf;
+  }
+
+  void resetPerfStats()
+  {
+    uint8_t session = _perf.session;
+    _perf = FB_PerfStats();
+    _perf.session = session;
+  }
+#endif
+
+  /**
+   * Enable or disable the Nagle algorithm of the internal WiFi client socket.
+   * @param noDelay True to send the segments without waiting for the ACK of the previous one.
+   */
+  void setNoDelay(bool noDelay)
+  {
+    _no_delay = noDelay;
+#if defined(FIREBASE_WIFI_IS_AVAILABLE) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO)) && defined(BASE_WIFICLIENT)
+    if (_client_type == firebase_client_type_internal_basic_client && _basic_client && _basic_client->connected())
+      reinterpret_cast<BASE_WIFICLIENT *>(_basic_client)->setNoDelay(_no_delay);
+#endif
+  }
+
   /**
    * Get the ethernet link status.
    * @return true for link up or false for link down.
@@ -329,6 +491,8 @@ public:
 
   void ethDNSWorkAround(SPI_ETH_Module *eth, const char *host, uint16_t port)
   {
+    (void)host;
+    (void)port;
 
     if (!eth)
       return;
@@ -503,6 +667,8 @@ public:
    */
   int hostByName(const char *name, IPAddress &ip)
   {
+    (void)name;
+    (void)ip;
 #if defined(FIREBASE_WIFI_IS_AVAILABLE)
     return WiFi.hostByName(name, ip);
 #else
@@ -521,6 +687,7 @@ public:
     _host = host;
     _port = port;
     _tcp_client->setBufferSizes(_rx_size, _tx_size);
+    _tcp_client->setMaxFragmentLength(_mfl_len);
     _last_error = 0;
     this->response_code = response_code;
     return true;
@@ -563,6 +730,9 @@ public:
       return true;
     }
 
+    // the new connection allocates the TLS buffers
+    MB_Alloc::checkWatchdog();
+
     if (!_basic_client)
     {
       if (_client_type == firebase_client_type_external_generic_client)
@@ -585,14 +755,38 @@ public:
 
     _tcp_client->setClient(_basic_client);
     _tcp_client->setDebugLevel(2);
+
+    // Route the connection to a local server (emulator or host test server) when set at build time.
+    // A non TLS port makes the SSL client work in plain mode.
+#if defined(FIREBASE_HOST_OVERRIDE)
+    _host = FIREBASE_HOST_OVERRIDE;
+#endif
+#if defined(FIREBASE_PORT_OVERRIDE)
+    _port = FIREBASE_PORT_OVERRIDE;
+#endif
+
+#if defined(PERF_TRACE_ENABLED)
+    perfEndResponse();
+    _perf_waiting = false;
+    fb_perf_mark_t perf_start;
+    FB_PerfTrace::mark(perf_start);
+    bool perf_connected = _tcp_client->connect(_host.c_str(), _port);
+    perfConnected(perf_start, perf_connected);
+    if (!perf_connected)
+#else
     if (!_tcp_client->connect(_host.c_str(), _port))
+#endif
       return setError(FIREBASE_ERROR_TCP_ERROR_CONNECTION_REFUSED);
 
+    // the handshake records of the request that was corked before connecting are not counted
+    if (_corked)
+      _tcp_client->getWriteStats(_cork_records, _cork_writes, _cork_bytes);
+
 #if defined(FIREBASE_WIFI_IS_AVAILABLE) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
     if (_client_type == firebase_client_type_internal_basic_client)
     {
 #if defined(BASE_WIFICLIENT)
-      reinterpret_cast<BASE_WIFICLIENT *>(_basic_client)->setNoDelay(true);
+      reinterpret_cast<BASE_WIFICLIENT *>(_basic_client)->setNoDelay(_no_delay);
 #endif
     }
 #endif
@@ -647,6 +841,11 @@ public:
    */
   void stop()
   {
+#if defined(PERF_TRACE_ENABLED)
+    perfEndResponse();
+    _perf_waiting = false;
+#endif
+    _corked = false;
     if (_tcp_client)
       _tcp_client->stop();
   }
@@ -675,7 +874,8 @@ public:
     if (!_tcp_client->connected() && !connect())
       return setError(FIREBASE_ERROR_TCP_ERROR_CONNECTION_REFUSED);
 
-    int toSend = _chunkSize;
+    // the corked data is copied to the TLS record buffer in one call
+    int toSend = _corked ? (int)size : _chunkSize;
     int sent = 0;
     while (sent < (int)size)
     {
@@ -688,6 +888,10 @@ public:
       sent += toSend;
     }
 
+#if defined(PERF_TRACE_ENABLED)
+    _perf.bytesOut += size;
+#endif
+
     setError(FIREBASE_ERROR_HTTP_CODE_OK);
 
     return size;
@@ -709,6 +913,46 @@ public:
 
   int send(const char *data, size_t size) { return write((uint8_t *)data, size); }
 
+  /**
+   * Get the free space of the SSL output buffer to write the data in place.
+   * @param len The length of free space.
+   * @return The pointer to the free space or nullptr when it is unavailable e.g. in non-secure mode.
+   * @note Call commitWriteBuffer with the number of bytes that was written to the buffer.
+   */
+  uint8_t *getWriteBuffer(size_t &len)
+  {
+    len = 0;
+
+    if (!_tcp_client || !networkReady())
+      return nullptr;
+
+    if (!_tcp_client->connected() && !connect())
+      return nullptr;
+
+    return _tcp_client->getWriteBuffer(len);
+  }
+
+  /**
+   * Commit the data that was written to the buffer from getWriteBuffer.
+   * @param size The number of bytes written.
+   * @return The size of data that was committed or 0 for error.
+   */
+  size_t commitWriteBuffer(size_t size)
+  {
+    if (!_tcp_client || _tcp_client->commitWriteBuffer(size) != size)
+    {
+      setError(FIREBASE_ERROR_TCP_ERROR_SEND_REQUEST_FAILED);
+      return 0;
+    }
+
+#if defined(PERF_TRACE_ENABLED)
+    _perf.bytesOut += size;
+#endif
+
+    setError(FIREBASE_ERROR_HTTP_CODE_OK);
+    return size;
+  }
+
   /**
    * The TCP data print function.
    * @param data The data to print.
@@ -765,7 +1009,17 @@ public:
     if (!_tcp_client)
       return setError(FIREBASE_ERROR_TCP_CLIENT_NOT_INITIALIZED);
 
+    // the request is complete when its response is polled
+    uncork();
+
+#if defined(PERF_TRACE_ENABLED)
+    int ret = _tcp_client->available();
+    if (ret > 0)
+      perfRead(0);
+    return ret;
+#else
     return _tcp_client->available();
+#endif
   }
 
   /**
@@ -777,7 +1031,14 @@ public:
     if (!_basic_client)
       return setError(FIREBASE_ERROR_TCP_CLIENT_NOT_INITIALIZED);
 
+#if defined(PERF_TRACE_ENABLED)
+    int ret = _tcp_client->read();
+    if (ret > -1)
+      perfRead(1);
+    return ret;
+#else
     return _tcp_client->read();
+#endif
   }
 
   int read(uint8_t *buf, size_t len)
@@ -796,7 +1057,14 @@ public:
     if (!_basic_client)
       return setError(FIREBASE_ERROR_TCP_CLIENT_NOT_INITIALIZED);
 
+#if defined(PERF_TRACE_ENABLED)
+    int ret = _tcp_client->read(buf, len);
+    if (ret > 0)
+      perfRead(ret);
+    return ret;
+#else
     return _tcp_client->read(buf, len);
+#endif
   }
 
   /**
@@ -1112,6 +1380,8 @@ public:
 
   int setOption(int option, int *value)
   {
+    (void)option;
+    (void)value;
 #if defined(ESP32) && defined(FIREBASE_WIFI_IS_AVAILABLE)
 // Actually we wish to use setSocketOption directly but it is ambiguous in old ESP32 core v1.0.x.;
 // Use setOption instead for old core support.
@@ -1122,6 +1392,19 @@ public:
     return 0;
   }
 
+  /**
+   * Get the socket file descriptor of the internal WiFi client.
+   * @return The socket or -1 if the client is external or not connected.
+   */
+  int socketFd()
+  {
+#if defined(ESP32) && defined(FIREBASE_WIFI_IS_AVAILABLE) && defined(BASE_WIFICLIENT)
+    if (_basic_client && _client_type == firebase_client_type_internal_basic_client)
+      return reinterpret_cast<BASE_WIFICLIENT *>(_basic_client)->fd();
+#endif
+    return -1;
+  }
+
   void setInSecure()
   {
     _tcp_client->setInsecure();
@@ -1151,7 +1434,9 @@ private:
   bool _isKeepAlive = false;
 
   ESP_SSLClient *_tcp_client = nullptr;
-  X509List *_x509 = nullptr;
+  const X509List *_x509 = nullptr;
+  PublicKey *_pinned_key = nullptr;
+  const char *_pinned_key_src = nullptr;
 
   MB_String _host;
   uint16_t _port = 443;
@@ -1176,10 +1461,15 @@ private:
   void *_modem = nullptr;
 #endif
   int _chunkSize = 1024;
+  bool _corked = false;
+  bool _no_delay = true;
+  uint32_t _cork_records = 0, _cork_writes = 0, _cork_bytes = 0;
+  FB_TCPWriteStats _write_stats;
   bool _clock_ready = false;
   int _last_error = 0;
   volatile bool _network_status = false;
   int _rx_size = 1024, _tx_size = 512;
+  uint16_t _mfl_len = 0;
   int *response_code = nullptr;
   FirebaseConfig *_config = nullptr;
   FirebaseAuth *_auth = nullptr;
@@ -1187,6 +1477,91 @@ private:
   firebase_cert_type _cert_type = firebase_cert_type_undefined;
   firebase_client_type _client_type = firebase_client_type_undefined;
   SPI_ETH_Module *eth = NULL;
+
+#if defined(PERF_TRACE_ENABLED)
+  FB_PerfStats _perf;
+  fb_perf_mark_t _perf_request, _perf_wait, _perf_response;
+  bool _perf_waiting = false, _perf_reading = false, _perf_connected = false;
+  unsigned long _perf_last_read_us = 0;
+  uint32_t _perf_request_bytes = 0, _perf_response_bytes = 0, _perf_hs_count = 0;
+
+  void perfAdd(fb_perf_phase phase, const fb_perf_mark_t &start, uint32_t us, int32_t value)
+  {
+    _perf.phaseCount[phase]++;
+    _perf.phaseUs[phase] += us;
+    _perf.lastUs[phase] = us;
+
+    uint32_t heap = FB_PerfTrace::freeHeap();
+    if (heap > 0 && (_perf.heapMin == 0 || heap < _perf.heapMin))
+      _perf.heapMin = heap;
+
+    FB_PerfTrace::get().add(phase, _perf.session, start, us, value);
+  }
+
+  // The connect phase excludes the TLS handshake which is done in the same connect call,
+  // the handshake entry shares its start.
+  void perfConnected(const fb_perf_mark_t &start, bool success)
+  {
+    uint32_t us = micros() - start.us;
+    uint32_t count = 0, hs_us = 0;
+    bool resumed = false;
+    _tcp_client->getHandshakeInfo(count, hs_us, resumed);
+
+    bool handshake = count != _perf_hs_count;
+    _perf_hs_count = count;
+
+    perfAdd(fb_perf_phase_connect, start, handshake && us > hs_us ? us - hs_us : us, success);
+
+    if (handshake)
+    {
+      if (resumed)
+        _perf.resumedHandshakes++;
+      else
+        _perf.fullHandshakes++;
+      perfAdd(fb_perf_phase_handshake, start, hs_us, resumed);
+    }
+
+    if (!success)
+      return;
+
+    if (_perf_connected)
+      _perf.reconnects++;
+    _perf_connected = true;
+
+    // the request that was corked before connecting starts now
+    if (_corked)
+      FB_PerfTrace::mark(_perf_request);
+  }
+
+  // The first available byte ends the wait and starts the response
+  void perfRead(int len)
+  {
+    if (_perf_waiting)
+    {
+      _perf_waiting = false;
+      perfAdd(fb_perf_phase_wait, _perf_wait, micros() - _perf_wait.us, 0);
+      _perf_reading = true;
+      FB_PerfTrace::mark(_perf_response);
+      _perf_last_read_us = _perf_response.us;
+      _perf_response_bytes = _perf.bytesIn;
+    }
+
+    if (len > 0)
+    {
+      _perf.bytesIn += len;
+      _perf_last_read_us = micros();
+    }
+  }
+
+  // The response ends at the last byte read before the next request, connection or stop
+  void perfEndResponse()
+  {
+    if (!_perf_reading)
+      return;
+    _perf_reading = false;
+    perfAdd(fb_perf_phase_response, _perf_response, _perf_last_read_us - _perf_response.us, _perf.bytesIn - _perf_response_bytes);
+  }
+#endif
 };
 
 #endif /* Firebase_TCP_Client_H */
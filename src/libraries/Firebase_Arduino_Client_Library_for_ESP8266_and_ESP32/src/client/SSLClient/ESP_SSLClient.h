@@ -37,6 +37,7 @@
 #include "ESP_SSLClient_Const.h"
 #if defined(USE_EMBED_SSL_ENGINE) || defined(USE_LIB_SSL_ENGINE)
 #include "client/BSSL_TCP_Client.h"
+#include "client/BSSL_TrustAnchorCache.h"
 class ESP_SSLClient : public BSSL_TCP_Client
 {
 public:
@@ -33,6 +33,17 @@
 // For external SRAM (PSRAM) support
 #define ESP_SSLCLIENT_USE_PSRAM
 
+// For ESP32 hardware AES in AES-GCM cipher suites
+#define ESP_SSLCLIENT_USE_HW_CRYPTO
+
+// For sharing the receive buffers between the SSL clients, the buffer is held
+// only while the record is being received and read
+#define ESP_SSLCLIENT_USE_RX_BUFFER_POOL
+
+// For placing the shared receive buffers in external SRAM (PSRAM) when
+// ESP_SSLCLIENT_USE_PSRAM is not defined
+// #define ESP_SSLCLIENT_RX_BUFFER_POOL_USE_PSRAM
+
 #if defined __has_include
 #if __has_include(<Custom_ESP_SSLClient_FS.h>)
 #include "Custom_ESP_SSLClient_FS.h"
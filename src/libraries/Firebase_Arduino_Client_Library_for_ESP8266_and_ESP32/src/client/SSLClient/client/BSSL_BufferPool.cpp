@@ -0,0 +1,191 @@
+/**
+ * BSSL_BufferPool v1.0.0 for Arduino devices.
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef BSSL_BUFFER_POOL_CPP
+#define BSSL_BUFFER_POOL_CPP
+
+#include <Arduino.h>
+#include "../ESP_SSLClient_FS.h"
+
+#if defined(USE_LIB_SSL_ENGINE) || defined(USE_EMBED_SSL_ENGINE)
+
+#include "BSSL_BufferPool.h"
+#include "../../../mbfs/MB_Alloc.h"
+
+#if defined(ESP32)
+static portMUX_TYPE bssl_buffer_pool_mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+BSSL_BufferPool::slot_t BSSL_BufferPool::_slots[ESP_SSLCLIENT_RX_BUFFER_POOL_SIZE] = {};
+size_t BSSL_BufferPool::_peak = 0;
+
+uint8_t *BSSL_BufferPool::acquire(size_t len)
+{
+    int fit = -1, empty = -1;
+
+    mLock();
+    for (int i = 0; i < ESP_SSLCLIENT_RX_BUFFER_POOL_SIZE; i++)
+    {
+        if (_slots[i].used)
+            continue;
+
+        // the smallest free buffer that fits
+        if (_slots[i].buf && _slots[i].len >= len)
+        {
+            if (fit < 0 || _slots[i].len < _slots[fit].len)
+                fit = i;
+        }
+        else if (empty < 0 || !_slots[i].buf)
+            empty = i;
+    }
+
+    if (fit >= 0)
+    {
+        _slots[fit].used = true;
+        mUnlock();
+        return _slots[fit].buf;
+    }
+
+    // Reserve the slot before allocation outside the lock
+    uint8_t *old = nullptr;
+    if (empty >= 0)
+    {
+        _slots[empty].used = true;
+        old = _slots[empty].buf;
+        _slots[empty].buf = nullptr;
+        _slots[empty].len = 0;
+    }
+    mUnlock();
+
+    // The smaller free buffer is replaced by the larger one
+    if (old)
+        MB_Alloc::free(old);
+
+    uint8_t *buf = mAlloc(len);
+
+    if (empty >= 0)
+    {
+        mLock();
+        if (buf)
+        {
+            _slots[empty].buf = buf;
+            _slots[empty].len = len;
+        }
+        else
+            _slots[empty].used = false;
+        mUpdatePeak();
+        mUnlock();
+    }
+
+    return buf;
+}
+
+void BSSL_BufferPool::release(uint8_t *buf)
+{
+    if (!buf)
+        return;
+
+    mLock();
+    for (int i = 0; i < ESP_SSLCLIENT_RX_BUFFER_POOL_SIZE; i++)
+    {
+        if (_slots[i].buf == buf)
+        {
+            _slots[i].used = false;
+            mUnlock();
+            return;
+        }
+    }
+    mUnlock();
+
+    // The buffer was allocated when the pool is full
+    MB_Alloc::free(buf);
+}
+
+void BSSL_BufferPool::trim()
+{
+    for (int i = 0; i < ESP_SSLCLIENT_RX_BUFFER_POOL_SIZE; i++)
+    {
+        uint8_t *buf = nullptr;
+        mLock();
+        if (!_slots[i].used)
+        {
+            buf = _slots[i].buf;
+            _slots[i].buf = nullptr;
+            _slots[i].len = 0;
+        }
+        mUnlock();
+        if (buf)
+            MB_Alloc::free(buf);
+    }
+}
+
+size_t BSSL_BufferPool::size()
+{
+    size_t total = 0;
+    mLock();
+    for (int i = 0; i < ESP_SSLCLIENT_RX_BUFFER_POOL_SIZE; i++)
+        total += _slots[i].len;
+    mUnlock();
+    return total;
+}
+
+size_t BSSL_BufferPool::peak() { return _peak; }
+
+uint8_t *BSSL_BufferPool::mAlloc(size_t len)
+{
+#if defined(ESP_SSLCLIENT_USE_PSRAM) || defined(ESP_SSLCLIENT_RX_BUFFER_POOL_USE_PSRAM)
+    return reinterpret_cast<uint8_t *>(MB_Alloc::alloc(mb_alloc_tag_tls, len, true));
+#else
+    return reinterpret_cast<uint8_t *>(MB_Alloc::alloc(mb_alloc_tag_tls, len, false));
+#endif
+}
+
+void BSSL_BufferPool::mLock()
+{
+#if defined(ESP32)
+    portENTER_CRITICAL(&bssl_buffer_pool_mux);
+#endif
+}
+
+void BSSL_BufferPool::mUnlock()
+{
+#if defined(ESP32)
+    portEXIT_CRITICAL(&bssl_buffer_pool_mux);
+#endif
+}
+
+void BSSL_BufferPool::mUpdatePeak()
+{
+    size_t total = 0;
+    for (int i = 0; i < ESP_SSLCLIENT_RX_BUFFER_POOL_SIZE; i++)
+        total += _slots[i].len;
+    if (total > _peak)
+        _peak = total;
+}
+
+#endif
+
+#endif
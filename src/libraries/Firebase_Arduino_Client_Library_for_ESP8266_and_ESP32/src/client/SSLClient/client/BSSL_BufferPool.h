@@ -0,0 +1,95 @@
+/**
+ * BSSL_BufferPool v1.0.0 for Arduino devices.
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef BSSL_BUFFER_POOL_H
+#define BSSL_BUFFER_POOL_H
+
+#include <Arduino.h>
+#include "../ESP_SSLClient_FS.h"
+
+#if defined(USE_LIB_SSL_ENGINE) || defined(USE_EMBED_SSL_ENGINE)
+
+// The maximum number of buffers kept in the pool
+#if !defined(ESP_SSLCLIENT_RX_BUFFER_POOL_SIZE)
+#define ESP_SSLCLIENT_RX_BUFFER_POOL_SIZE 2
+#endif
+
+// The receive buffers shared by the SSL clients.
+// The buffer is lent to the SSL engine while the record is being received, decrypted and read,
+// and it is returned when the engine is waiting for the next record header.
+class BSSL_BufferPool
+{
+public:
+    /**
+     * Lend the buffer.
+     * @param len The minimum buffer size.
+     * @return The buffer or nullptr when out of memory.
+     * @note The new buffer is allocated when no free pool buffer fits, the buffer that
+     * can't be kept in the pool will be freed on release.
+     */
+    static uint8_t *acquire(size_t len);
+
+    /**
+     * Return the lent buffer.
+     * @param buf The buffer from acquire.
+     */
+    static void release(uint8_t *buf);
+
+    /**
+     * Free the pool buffers those are not lent.
+     */
+    static void trim();
+
+    /**
+     * Get the total size of the buffers kept in the pool.
+     */
+    static size_t size();
+
+    /**
+     * Get the peak total size of the buffers kept in the pool.
+     */
+    static size_t peak();
+
+private:
+    struct slot_t
+    {
+        uint8_t *buf;
+        size_t len;
+        bool used;
+    };
+
+    static slot_t _slots[ESP_SSLCLIENT_RX_BUFFER_POOL_SIZE];
+    static size_t _peak;
+
+    static uint8_t *mAlloc(size_t len);
+    static void mLock();
+    static void mUnlock();
+    static void mUpdatePeak();
+};
+
+#endif
+
+#endif /** BSSL_BUFFER_POOL_H */
@@ -56,6 +56,8 @@ namespace bssl
   {
     free(_indexName);
     free(_dataName);
+    _clearCache();
+    delete _x509;
   }
 
   CertStore::CertInfo CertStore::_preprocessCert(uint32_t length, uint32_t offset, const void *raw)
@@ -107,6 +109,7 @@ namespace bssl
     // In case initCertStore called multiple times, don't leak old filenames
     free(_indexName);
     free(_dataName);
+    _clearCache();
 
     // No strdup_P, so manually do it
     _indexName = (char *)malloc(strlen_P(indexFileName) + 1);
@@ -212,17 +215,27 @@ namespace bssl
       return nullptr;
     }
 
-    File index = cs->_fs->open(cs->_indexName, FILE_READ);
-    if (!index)
+    // The recently used trust anchors, no file I/O and decoding
+    for (int i = 0; i < ESP_SSLCLIENT_CERT_STORE_CACHE_SIZE; i++)
+    {
+      CacheItem &item = cs->_cache[i];
+      if (item.x509 && !memcmp(item.x509->getTrustAnchors()->dn.data, hashed_dn, sizeof(ci.sha256)))
+      {
+        item.refs++;
+        return item.x509->getTrustAnchors();
+      }
+    }
+
+    if (!cs->_index && !cs->_loadIndex())
     {
       return nullptr;
     }
 
-    while (index.read((uint8_t *)&ci, sizeof(ci)) == sizeof(ci))
+    for (size_t i = 0; i < cs->_indexCount; i++)
     {
-      if (!memcmp(ci.sha256, hashed_dn, sizeof(ci.sha256)))
+      if (!memcmp(cs->_index[i].sha256, hashed_dn, sizeof(ci.sha256)))
       {
-        index.close();
+        ci = cs->_index[i];
         uint8_t *der = (uint8_t *)malloc(ci.length);
         if (!der)
         {
@@ -246,33 +259,99 @@ namespace bssl
           return nullptr;
         }
         data.close();
-        cs->_x509 = new (std::nothrow) X509List(der, ci.length);
+        X509List *x509 = new (std::nothrow) X509List(der, ci.length);
         free(der);
-        if (!cs->_x509)
+        if (!x509)
         {
           DEBUG_BSSL("CertStore::findHashedTA: OOM\n");
           return nullptr;
         }
 
-        br_x509_trust_anchor *ta = (br_x509_trust_anchor *)cs->_x509->getTrustAnchors();
+        br_x509_trust_anchor *ta = (br_x509_trust_anchor *)x509->getTrustAnchors();
         memcpy(ta->dn.data, ci.sha256, sizeof(ci.sha256));
         ta->dn.len = sizeof(ci.sha256);
 
+        // Replace the unused cache item, or keep it as the uncached list until it is freed
+        for (int j = 0; j < ESP_SSLCLIENT_CERT_STORE_CACHE_SIZE; j++)
+        {
+          CacheItem &item = cs->_cache[(cs->_cacheIndex + j) % ESP_SSLCLIENT_CERT_STORE_CACHE_SIZE];
+          if (item.refs == 0)
+          {
+            delete item.x509;
+            item.x509 = x509;
+            item.refs = 1;
+            cs->_cacheIndex = (cs->_cacheIndex + j + 1) % ESP_SSLCLIENT_CERT_STORE_CACHE_SIZE;
+            return ta;
+          }
+        }
+
+        delete cs->_x509;
+        cs->_x509 = x509;
         return ta;
       }
     }
-    index.close();
     return nullptr;
   }
 
   void CertStore::freeHashedTA(void *ctx, const br_x509_trust_anchor *ta)
   {
     CertStore *cs = static_cast<CertStore *>(ctx);
-    (void)ta; // Unused
+
+    // The cached trust anchors are kept for the next handshake
+    for (int i = 0; i < ESP_SSLCLIENT_CERT_STORE_CACHE_SIZE; i++)
+    {
+      CacheItem &item = cs->_cache[i];
+      if (item.x509 && item.x509->getTrustAnchors() == ta)
+      {
+        if (item.refs > 0)
+          item.refs--;
+        return;
+      }
+    }
+
     delete cs->_x509;
     cs->_x509 = nullptr;
   }
 
+  bool CertStore::_loadIndex()
+  {
+    File index = _fs->open(_indexName, FILE_READ);
+    if (!index)
+    {
+      return false;
+    }
+
+    size_t count = index.size() / sizeof(CertInfo);
+    _index = (CertInfo *)malloc(count * sizeof(CertInfo) + 1);
+    if (!_index)
+    {
+      index.close();
+      return false;
+    }
+
+    _indexCount = 0;
+    while (_indexCount < count && index.read((uint8_t *)&_index[_indexCount], sizeof(CertInfo)) == sizeof(CertInfo))
+    {
+      _indexCount++;
+    }
+    index.close();
+    return true;
+  }
+
+  void CertStore::_clearCache()
+  {
+    free(_index);
+    _index = nullptr;
+    _indexCount = 0;
+    for (int i = 0; i < ESP_SSLCLIENT_CERT_STORE_CACHE_SIZE; i++)
+    {
+      delete _cache[i].x509;
+      _cache[i].x509 = nullptr;
+      _cache[i].refs = 0;
+    }
+    _cacheIndex = 0;
+  }
+
 }
 
 #endif
@@ -37,6 +37,10 @@
 
 #if defined(ESP_SSL_FS_SUPPORTED)
 
+// The maximum number of the decoded trust anchors kept in RAM
+#if !defined(ESP_SSLCLIENT_CERT_STORE_CACHE_SIZE)
+#define ESP_SSLCLIENT_CERT_STORE_CACHE_SIZE 2
+#endif
 
 #include "../bssl/bearssl.h"
 #include "BSSL_Helper.h"
@@ -90,6 +94,23 @@ namespace bssl
       uint32_t length;
     };
     static CertInfo _preprocessCert(uint32_t length, uint32_t offset, const void *raw);
+
+    // The index file is read once into RAM on the first lookup
+    CertInfo *_index = nullptr;
+    size_t _indexCount = 0;
+
+    // The recently used trust anchors those were decoded from the data file
+    class CacheItem
+    {
+    public:
+      X509List *x509 = nullptr;
+      uint16_t refs = 0;
+    };
+    CacheItem _cache[ESP_SSLCLIENT_CERT_STORE_CACHE_SIZE];
+    int _cacheIndex = 0;
+
+    bool _loadIndex();
+    void _clearCache();
   };
 
 };
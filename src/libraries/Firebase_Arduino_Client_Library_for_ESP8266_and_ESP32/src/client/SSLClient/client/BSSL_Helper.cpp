@@ -44,6 +44,10 @@
 #endif
 #endif
 
+#if defined(ESP32) && defined(ESP_SSLCLIENT_USE_HW_CRYPTO)
+#include <mbedtls/aes.h>
+#endif
+
 namespace key_bssl
 {
   // Code here is pulled from brssl sources, with the copyright and license
@@ -1048,6 +1052,52 @@ namespace bssl
     return true;
   }
 
+#if defined(ESP32) && defined(ESP_SSLCLIENT_USE_HW_CRYPTO)
+
+  // The ESP32 AES context holds only the key which loaded to the accelerator on use,
+  // it must fit in the SSL record context which sized for BearSSL AES implementations.
+  struct esp32_aes_ctr_keys
+  {
+    const br_block_ctr_class *vtable;
+    mbedtls_aes_context aes;
+  };
+
+  static_assert(sizeof(esp32_aes_ctr_keys) <= sizeof(br_aes_gen_ctr_keys), "AES context is too large");
+
+  static void esp32_aes_ctr_init(const br_block_ctr_class **ctx, const void *key, size_t len)
+  {
+    esp32_aes_ctr_keys *kc = reinterpret_cast<esp32_aes_ctr_keys *>(ctx);
+    kc->vtable = &esp32_aes_ctr_vtable;
+    mbedtls_aes_init(&kc->aes);
+    mbedtls_aes_setkey_enc(&kc->aes, reinterpret_cast<const unsigned char *>(key), len << 3);
+  }
+
+  static uint32_t esp32_aes_ctr_run(const br_block_ctr_class *const *ctx, const void *iv, uint32_t cc, void *data, size_t len)
+  {
+    esp32_aes_ctr_keys *kc = reinterpret_cast<esp32_aes_ctr_keys *>(const_cast<const br_block_ctr_class **>(ctx));
+    unsigned char nonce[16], stream[16];
+    size_t off = 0;
+
+    memcpy(nonce, iv, 12);
+    nonce[12] = cc >> 24;
+    nonce[13] = cc >> 16;
+    nonce[14] = cc >> 8;
+    nonce[15] = cc;
+
+    // Run the whole data at once, the accelerator is acquired once per call.
+    // The 128-bit counter increment of mbedtls is the same as the 32-bit BearSSL counter
+    // as the counter of TLS record never wraps.
+    unsigned char *p = reinterpret_cast<unsigned char *>(data);
+    mbedtls_aes_crypt_ctr(&kc->aes, len, &off, nonce, stream, p, p);
+
+    return cc + (uint32_t)((len + 15) >> 4);
+  }
+
+  const br_block_ctr_class esp32_aes_ctr_vtable = {
+      sizeof(esp32_aes_ctr_keys), 16, 4, esp32_aes_ctr_init, esp32_aes_ctr_run};
+
+#endif
+
 };
 
 #endif
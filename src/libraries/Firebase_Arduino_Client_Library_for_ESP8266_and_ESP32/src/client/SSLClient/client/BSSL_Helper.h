@@ -158,6 +158,24 @@ static const uint16_t faster_suites_P[] PROGMEM = {
     BR_TLS_RSA_WITH_AES_256_CBC_SHA,
     BR_TLS_RSA_WITH_AES_128_CBC_SHA};
 
+// TLS 1.2 ECDHE with AEAD only, AES-GCM first for hardware AES
+static const uint16_t aead_aes_suites_P[] PROGMEM = {
+    BR_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+    BR_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+    BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384,
+    BR_TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384};
+
+// TLS 1.2 ECDHE with AEAD only, ChaCha20-Poly1305 first for software crypto
+static const uint16_t aead_chapol_suites_P[] PROGMEM = {
+    BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+    BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+    BR_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384,
+    BR_TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384};
+
 // Internal opaque structures, not needed by user applications
 namespace key_bssl
 {
@@ -271,6 +289,50 @@ namespace bssl
         br_x509_trust_anchor *_ta;
     };
 
+    // The crypto implementations that installed to the SSL engine for the AEAD
+    // cipher suites and handshake hash. The hardware implementations are provided
+    // through the same BearSSL interfaces.
+    struct CryptoProvider
+    {
+        // AES-CTR and GHASH for AES-GCM
+        const br_block_ctr_class *aes_ctr;
+        br_ghash ghash;
+        // ChaCha20 and Poly1305 for ChaCha20-Poly1305
+        br_chacha20_run chacha20;
+        br_poly1305_run poly1305;
+        // SHA-256 for handshake hash
+        const br_hash_class *sha256;
+        // AES-GCM is faster than ChaCha20-Poly1305
+        bool prefer_aes;
+    };
+
+#if defined(ESP32) && defined(USE_LIB_SSL_ENGINE) && defined(ESP_SSLCLIENT_USE_HW_CRYPTO)
+    // AES-CTR using ESP32 AES accelerator
+    extern const br_block_ctr_class esp32_aes_ctr_vtable;
+#endif
+
+    // The BearSSL portable (constant-time) implementations
+    static const CryptoProvider *portable_crypto_provider()
+    {
+        static const CryptoProvider provider = {&br_aes_ct_ctr_vtable, &br_ghash_ctmul32, &br_chacha20_ct_run,
+                                                &br_poly1305_ctmul_run, &br_sha256_vtable, false};
+        return &provider;
+    }
+
+    // The hardware implementations when available, otherwise the portable implementations
+    static const CryptoProvider *default_crypto_provider()
+    {
+#if defined(ESP32) && defined(USE_LIB_SSL_ENGINE) && defined(ESP_SSLCLIENT_USE_HW_CRYPTO)
+        // ESP32 has no GHASH accelerator and its SHA engine can't resume from the saved state
+        // which BearSSL requires, use the portable implementations for them
+        static const CryptoProvider provider = {&esp32_aes_ctr_vtable, &br_ghash_ctmul32, &br_chacha20_ct_run,
+                                                &br_poly1305_ctmul_run, &br_sha256_vtable, true};
+        return &provider;
+#else
+        return portable_crypto_provider();
+#endif
+    }
+
     extern "C"
     {
 
@@ -295,8 +357,23 @@ namespace bssl
             br_x509_minimal_set_hash(x509, br_sha512_ID, &br_sha512_vtable);
         }
 
+        // Install the AEAD and SHA-256 implementations of crypto provider
+        static void br_ssl_engine_install_crypto(br_ssl_engine_context *eng, const CryptoProvider *cp)
+        {
+            br_ssl_engine_set_hash(eng, br_sha256_ID, cp->sha256);
+#ifndef BEARSSL_SSL_BASIC
+            br_ssl_engine_set_gcm(eng, &br_sslrec_in_gcm_vtable, &br_sslrec_out_gcm_vtable);
+            br_ssl_engine_set_aes_ctr(eng, cp->aes_ctr);
+            br_ssl_engine_set_ghash(eng, cp->ghash);
+            br_ssl_engine_set_chapol(eng, &br_sslrec_in_chapol_vtable, &br_sslrec_out_chapol_vtable);
+            br_ssl_engine_set_chacha20(eng, cp->chacha20);
+            br_ssl_engine_set_poly1305(eng, cp->poly1305);
+#endif
+        }
+
         // Default initializion for our SSL clients
-        static void br_ssl_client_base_init(br_ssl_client_context *cc, const uint16_t *cipher_list, int cipher_cnt)
+        static void br_ssl_client_base_init(br_ssl_client_context *cc, const uint16_t *cipher_list, int cipher_cnt,
+                                            const CryptoProvider *cp = nullptr)
         {
             uint16_t suites[cipher_cnt];
             memcpy_P(suites, cipher_list, cipher_cnt * sizeof(cipher_list[0]));
@@ -315,11 +392,10 @@ namespace bssl
             br_ssl_engine_set_prf_sha384(&cc->eng, &br_tls12_sha384_prf);
             br_ssl_engine_set_default_aes_cbc(&cc->eng);
 #ifndef BEARSSL_SSL_BASIC
-            br_ssl_engine_set_default_aes_gcm(&cc->eng);
             br_ssl_engine_set_default_aes_ccm(&cc->eng);
             br_ssl_engine_set_default_des_cbc(&cc->eng);
-            br_ssl_engine_set_default_chapol(&cc->eng);
 #endif
+            br_ssl_engine_install_crypto(&cc->eng, cp ? cp : default_crypto_provider());
         }
 
         // BearSSL doesn't define a true insecure decoder, so we make one ourselves
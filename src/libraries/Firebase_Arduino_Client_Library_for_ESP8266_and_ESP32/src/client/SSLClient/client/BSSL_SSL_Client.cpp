@@ -44,12 +44,9 @@
 
 #include "BSSL_Helper.h"
 #include "BSSL_SSL_Client.h"
-
-#if defined(ESP8266) && defined(MMU_EXTERNAL_HEAP) && defined(ESP_SSLCLIENT_USE_PSRAM)
-#include <umm_malloc/umm_malloc.h>
-#include <umm_malloc/umm_heap_select.h>
-#define ESP_SSLCLIENT_ESP8266_USE_EXTERNAL_HEAP
-#endif
+#include "BSSL_BufferPool.h"
+#include "BSSL_TrustAnchorCache.h"
+#include "../../../mbfs/MB_Alloc.h"
 
 #if defined(USE_EMBED_SSL_ENGINE)
 #include <list>
@@ -80,6 +77,16 @@
 
 #endif
 
+// The maximum fragment length probe results, shared by all clients
+struct bssl_mfl_cache_t
+{
+    uint32_t hash;
+    int supported;
+};
+
+static bssl_mfl_cache_t bssl_mfl_cache[4] = {};
+static uint8_t bssl_mfl_cache_idx = 0;
+
 BSSL_SSL_Client::BSSL_SSL_Client(Client *client)
 {
     setClient(client);
@@ -288,6 +295,7 @@ int BSSL_SSL_Client::read(uint8_t *buf, size_t size)
         memcpy(buf, _recvapp_buf, read_amount);
     // tell engine we read that many bytes
     br_ssl_engine_recvapp_ack(_eng, read_amount);
+    mReleaseInBuffer();
     // tell the user we read that many bytes
     return read_amount;
 }
@@ -369,6 +377,64 @@ size_t BSSL_SSL_Client::write(const uint8_t *buf, size_t size)
     return size;
 }
 
+uint8_t *BSSL_SSL_Client::getWriteBuffer(size_t &len)
+{
+    len = 0;
+
+    if (!mIsClientInitialized(false) || !_secure)
+        return nullptr;
+
+    if (!mCheckSessionTimeout())
+        return nullptr;
+
+    const char *func_name = __func__;
+    if (!mSoftConnected(func_name))
+        return nullptr;
+
+    // wait until bearssl is ready to send
+    if (mRunUntil(BR_SSL_SENDAPP) < 0)
+        return nullptr;
+
+    // the free space after the data that was not yet acknowledged
+    size_t alen;
+    unsigned char *br_buf = br_ssl_engine_sendapp_buf(_eng, &alen);
+    if (!br_buf || alen <= _write_idx)
+        return nullptr;
+
+    len = alen - _write_idx;
+    return br_buf + _write_idx;
+}
+
+size_t BSSL_SSL_Client::commitWriteBuffer(size_t size)
+{
+    if (!mIsClientInitialized(false) || !_secure || !size)
+        return 0;
+
+    size_t alen;
+    (void)br_ssl_engine_sendapp_buf(_eng, &alen);
+    if (_write_idx + size > alen)
+        return 0;
+
+    _session_ts = millis();
+    _write_idx += size;
+
+    // the same as write(), send the record when the buffer is full
+    if (_write_idx == alen)
+    {
+        br_ssl_engine_sendapp_ack(_eng, _write_idx);
+        _write_idx = 0;
+        if (mRunUntil(BR_SSL_SENDAPP) < 0)
+        {
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+            esp_ssl_debug_print(PSTR("Failed while waiting for the engine to enter BR_SSL_SENDAPP."), _debug_level, esp_ssl_debug_error, __func__);
+#endif
+            return 0;
+        }
+    }
+
+    return size;
+}
+
 size_t BSSL_SSL_Client::write(uint8_t b)
 {
     return write(&b, 1);
@@ -462,6 +528,8 @@ int BSSL_SSL_Client::connectSSL(IPAddress ip, uint16_t port)
     if (!mIsClientInitialized(true))
         return 0;
 
+    mApplyMaxFragmentLength(nullptr, ip, port);
+
     if (!_basic_client->connected() && !mConnectBasicClient(nullptr, ip, port))
         return 0;
 
@@ -478,6 +546,8 @@ int BSSL_SSL_Client::connectSSL(const char *host, uint16_t port)
     if (!mIsClientInitialized(true))
         return 0;
 
+    mApplyMaxFragmentLength(host, IPAddress(), port);
+
     if (!_basic_client->connected() && !mConnectBasicClient(host, IPAddress(), port))
         return 0;
 
@@ -722,7 +792,13 @@ void BSSL_SSL_Client::setClientECCert(const X509List *chain, const PrivateKey *s
 // Returns whether MFLN negotiation for the above buffer sizes succeeded (after connection)
 int BSSL_SSL_Client::getMFLNStatus()
 {
-    return connected() && br_ssl_engine_get_mfln_negotiated(_eng);
+    if (!connected())
+        return 0;
+    if (br_ssl_engine_get_mfln_negotiated(_eng))
+        return 1;
+    // The handshake code of bssl/ checks the extension of the server but doesn't set the flag, the
+    // fragment length was negotiated when the engine asked for the length the server takes.
+    return _mfl_supported && ((size_t)1 << _eng->log_max_frag_len) == _mfl_len;
 }
 
 // Returns an error ID and possibly a string (if dest != null) of the last
@@ -962,7 +1038,8 @@ void BSSL_SSL_Client::setCertStore(CertStoreBase *certStore)
 // Set custom list of ciphers
 bool BSSL_SSL_Client::setCiphers(const uint16_t *cipherAry, int cipherCount)
 {
-    _cipher_list = reinterpret_cast<uint16_t *>(mallocImpl(cipherCount));
+    freeImpl(&_cipher_list);
+    _cipher_list = reinterpret_cast<uint16_t *>(mallocImpl(cipherCount * sizeof(uint16_t)));
     if (!_cipher_list)
     {
 #if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
@@ -985,6 +1062,22 @@ bool BSSL_SSL_Client::setCiphersLessSecure()
     return setCiphers(faster_suites_P, sizeof(faster_suites_P) / sizeof(faster_suites_P[0]));
 }
 
+// TLS 1.2 ECDHE with AES-GCM or ChaCha20-Poly1305 only, ordered by the faster one of crypto provider
+bool BSSL_SSL_Client::setCiphersAEADOnly()
+{
+    const bssl::CryptoProvider *cp = _crypto ? _crypto : bssl::default_crypto_provider();
+    _tls_min = BR_TLS12;
+    _tls_max = BR_TLS12;
+    if (cp->prefer_aes)
+        return setCiphers(aead_aes_suites_P, sizeof(aead_aes_suites_P) / sizeof(aead_aes_suites_P[0]));
+    return setCiphers(aead_chapol_suites_P, sizeof(aead_chapol_suites_P) / sizeof(aead_chapol_suites_P[0]));
+}
+
+void BSSL_SSL_Client::setCryptoProvider(const bssl::CryptoProvider *provider)
+{
+    _crypto = provider;
+}
+
 bool BSSL_SSL_Client::setSSLVersion(uint32_t min, uint32_t max)
 {
     if (((min != BR_TLS10) && (min != BR_TLS11) && (min != BR_TLS12)) ||
@@ -1022,6 +1115,81 @@ bool BSSL_SSL_Client::probeMaxFragmentLength(const String &host, uint16_t port,
     return BSSL_SSL_Client::probeMaxFragmentLength(host.c_str(), port, len);
 }
 
+void BSSL_SSL_Client::setMaxFragmentLength(uint16_t len)
+{
+    // Per spec, only 512, 1024, 2048, and 4096 are supported
+    _mfl_len = (len == 512 || len == 1024 || len == 2048 || len == 4096) ? len : 0;
+}
+
+void BSSL_SSL_Client::getBufferUsage(size_t &rxPeak, size_t &txPeak)
+{
+    rxPeak = _rx_peak;
+    txPeak = _tx_peak;
+}
+
+void BSSL_SSL_Client::flushWrite()
+{
+    if (!mIsClientInitialized(false) || !_secure || !mSoftConnected(__func__))
+        return;
+
+    // the engine keeps the application data until its buffer is full or flushed,
+    // send the pending data as one record now instead of when the response is polled
+    if (_write_idx > 0)
+    {
+        br_ssl_engine_sendapp_ack(_eng, _write_idx);
+        _write_idx = 0;
+    }
+
+    br_ssl_engine_flush(_eng, 0);
+
+    if (mRunUntil(BR_SSL_SENDAPP) < 0)
+    {
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+        esp_ssl_debug_print(PSTR("Could not flush write buffer!"), _debug_level, esp_ssl_debug_error, __func__);
+#endif
+    }
+}
+
+void BSSL_SSL_Client::getWriteStats(uint32_t &records, uint32_t &writes, uint32_t &bytes)
+{
+    records = _tx_records;
+    writes = _tx_writes;
+    bytes = _tx_bytes;
+}
+
+void BSSL_SSL_Client::getHandshakeInfo(uint32_t &count, uint32_t &us, bool &resumed)
+{
+    count = _hs_count;
+    us = _hs_us;
+    resumed = _hs_resumed;
+}
+
+void BSSL_SSL_Client::mCountTxRecords(const unsigned char *buf, size_t len)
+{
+    // walk the record headers, the record or its header can be split between writes
+    while (len > 0)
+    {
+        if (_tx_rec_remain > 0)
+        {
+            size_t n = len < _tx_rec_remain ? len : _tx_rec_remain;
+            _tx_rec_remain -= n;
+            buf += n;
+            len -= n;
+            continue;
+        }
+
+        _tx_hdr[_tx_hdr_len++] = *buf++;
+        len--;
+
+        if (_tx_hdr_len == sizeof(_tx_hdr))
+        {
+            _tx_rec_remain = (uint16_t)((_tx_hdr[3] << 8) | _tx_hdr[4]);
+            _tx_hdr_len = 0;
+            _tx_records++;
+        }
+    }
+}
+
 size_t BSSL_SSL_Client::peekAvailable()
 {
     return available();
@@ -1041,13 +1209,16 @@ void BSSL_SSL_Client::peekConsume(size_t consume)
     br_ssl_engine_recvapp_ack(_eng, consume);
     _recvapp_buf = nullptr;
     _recvapp_len = 0;
+    mReleaseInBuffer();
 }
 
 void BSSL_SSL_Client::setCACert(const char *rootCA)
 {
+    // The decoded trust anchors are shared by the clients those use the same certificate
+    const X509List *ta = BSSL_TrustAnchorCache::acquire(rootCA);
     if (_esp32_ta)
-        delete _esp32_ta;
-    _esp32_ta = new X509List(rootCA);
+        BSSL_TrustAnchorCache::release(_esp32_ta);
+    _esp32_ta = ta;
 }
 
 void BSSL_SSL_Client::setCertificate(const char *client_ca)
@@ -1137,7 +1308,7 @@ void BSSL_SSL_Client::setSecure(const char *rootCABuff, const char *cli_cert, co
 {
     if (_esp32_ta)
     {
-        delete _esp32_ta;
+        BSSL_TrustAnchorCache::release(_esp32_ta);
         _esp32_ta = nullptr;
     }
     if (_esp32_chain)
@@ -1288,9 +1459,10 @@ bool BSSL_SSL_Client::mProbeMaxFragmentLength(Client *probe, uint16_t len)
         return send_abort(probe, supportsLen);
     }
     handLen = (hand[1] << 16) | (hand[2] << 8) | hand[3];
-    if (handLen != fragLen)
+    if (handLen > fragLen)
     {
-        // Got some weird mismatch, this is invalid
+        // The server_hello doesn't fit in the record, this is invalid. The next handshake messages
+        // (certificate, server_key_exchange...) may follow it in the same record.
         return send_abort(probe, supportsLen);
     }
 
@@ -1407,6 +1579,61 @@ bool BSSL_SSL_Client::mProbeMaxFragmentLength(const char *name, IPAddress ip, ui
     return ret;
 }
 
+void BSSL_SSL_Client::mApplyMaxFragmentLength(const char *name, IPAddress ip, uint16_t port)
+{
+    _iobuf_in_len = _iobuf_in_size;
+    _mfl_supported = false;
+
+    // Probe before the basic client was connected
+    if (_mfl_len == 0 || _basic_client->connected())
+        return;
+
+    // FNV-1a hash of the server and the fragment length
+    uint32_t hash = 2166136261UL;
+    if (name)
+    {
+        for (const char *p = name; *p; p++)
+            hash = (hash ^ (uint8_t)*p) * 16777619UL;
+    }
+    else
+    {
+        for (int i = 0; i < 4; i++)
+            hash = (hash ^ ip[i]) * 16777619UL;
+    }
+    hash = (hash ^ port) * 16777619UL;
+    hash = (hash ^ _mfl_len) * 16777619UL;
+
+    int supported = -1;
+    for (size_t i = 0; i < sizeof(bssl_mfl_cache) / sizeof(bssl_mfl_cache[0]); i++)
+    {
+        if (bssl_mfl_cache[i].hash == hash)
+        {
+            supported = bssl_mfl_cache[i].supported;
+            break;
+        }
+    }
+
+    if (supported < 0)
+    {
+        supported = mProbeMaxFragmentLength(name, ip, port, _mfl_len) ? 1 : 0;
+        bssl_mfl_cache[bssl_mfl_cache_idx].hash = hash;
+        bssl_mfl_cache[bssl_mfl_cache_idx].supported = supported;
+        bssl_mfl_cache_idx = (bssl_mfl_cache_idx + 1) % (sizeof(bssl_mfl_cache) / sizeof(bssl_mfl_cache[0]));
+    }
+
+    _mfl_supported = supported;
+    if (supported)
+    {
+        // The server sends records up to the negotiated length
+        const int MAX_IN_OVERHEAD = 325;
+        _iobuf_in_len = std::min(_iobuf_in_size, _mfl_len + MAX_IN_OVERHEAD);
+    }
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+    else
+        esp_ssl_debug_print(PSTR("Server does not support maximum fragment length negotiation."), _debug_level, esp_ssl_debug_warn, __func__);
+#endif
+}
+
 int BSSL_SSL_Client::mIsClientInitialized(bool notify)
 {
     if (!_basic_client)
@@ -1494,7 +1721,15 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
     _sc = std::make_shared<br_ssl_client_context>();
     _eng = &_sc->eng; // Allocation/deallocation taken care of by the _sc shared_ptr
 
-    _iobuf_in = reinterpret_cast<unsigned char *>(mallocImpl(_iobuf_in_size));
+    if (_iobuf_in_len == 0)
+        _iobuf_in_len = _iobuf_in_size;
+
+#if defined(ESP_SSLCLIENT_USE_RX_BUFFER_POOL)
+    // The handshake holds the buffer until it is done
+    _iobuf_in = BSSL_BufferPool::acquire(_iobuf_in_len);
+#else
+    _iobuf_in = reinterpret_cast<unsigned char *>(mallocImpl(_iobuf_in_len));
+#endif
     _iobuf_out = reinterpret_cast<unsigned char *>(mallocImpl(_iobuf_out_size));
 
     if (!_sc || !_iobuf_in || !_iobuf_out)
@@ -1509,9 +1744,9 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
 
     // If no cipher list yet set, use defaults
     if (!_cipher_list)
-        bssl::br_ssl_client_base_init(_sc.get(), suites_P, sizeof(suites_P) / sizeof(suites_P[0]));
+        bssl::br_ssl_client_base_init(_sc.get(), suites_P, sizeof(suites_P) / sizeof(suites_P[0]), _crypto);
     else
-        bssl::br_ssl_client_base_init(_sc.get(), _cipher_list, _cipher_cnt);
+        bssl::br_ssl_client_base_init(_sc.get(), _cipher_list, _cipher_cnt, _crypto);
 
     // Only failure possible in the installation is OOM
     if (!mInstallClientX509Validator())
@@ -1524,7 +1759,7 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
         return 0;
     }
 
-    br_ssl_engine_set_buffers_bidi(_eng, _iobuf_in, _iobuf_in_size, _iobuf_out, _iobuf_out_size);
+    br_ssl_engine_set_buffers_bidi(_eng, _iobuf_in, _iobuf_in_len, _iobuf_out, _iobuf_out_size);
     br_ssl_engine_set_versions(_eng, _tls_min, _tls_max);
 
     // Apply any client certificates, if supplied.
@@ -1565,6 +1800,10 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
 
     br_ssl_engine_inject_entropy(_eng, rng_seeds, sizeof rng_seeds);
 
+    // The offered session id, the server resumes the session when it echoes this id
+    uint8_t offered_id[32];
+    size_t offered_id_len = 0;
+
     // Restore session from the storage spot, if present
     if (_session)
     {
@@ -1572,8 +1811,16 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
         esp_ssl_debug_print(PSTR("Set SSL session!"), _debug_level, esp_ssl_debug_info, __func__);
 #endif
         br_ssl_engine_set_session_parameters(_eng, _session->getSession());
+        offered_id_len = _session->getSession()->session_id_len;
+        memcpy(offered_id, _session->getSession()->session_id, offered_id_len);
     }
 
+    unsigned long hs_start = micros();
+
+    // the new connection starts with a record header
+    _tx_rec_remain = 0;
+    _tx_hdr_len = 0;
+
     if (!br_ssl_client_reset(_sc.get(), host, _session ? 1 : 0))
     {
 #if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
@@ -1607,10 +1854,17 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
     _is_connected = true;
     _secure = true;
     _session_ts = millis();
+    _hs_us = micros() - hs_start;
+    _hs_count++;
+    _hs_resumed = false;
 
     // Save session
     if (_session)
+    {
         br_ssl_engine_get_session_parameters(_eng, _session->getSession());
+        _hs_resumed = offered_id_len > 0 && _session->getSession()->session_id_len == offered_id_len &&
+                      memcmp(_session->getSession()->session_id, offered_id, offered_id_len) == 0;
+    }
 
     // Session is already validated here, there is no need to keep following
     _x509_minimal = nullptr;
@@ -1799,6 +2053,11 @@ unsigned BSSL_SSL_Client::mUpdateEngine()
     {
         // get the state
         unsigned state = br_ssl_engine_current_state(_eng);
+#if defined(ESP_SSLCLIENT_USE_RX_BUFFER_POOL)
+        // The receive buffer was returned to the pool while waiting for the next record
+        if (!_iobuf_in && !(state & BR_SSL_CLOSED))
+            state |= BR_SSL_RECVREC;
+#endif
         // debug
         if (_bssl_last_state == 0 || state != _bssl_last_state)
         {
@@ -1820,6 +2079,8 @@ unsigned BSSL_SSL_Client::mUpdateEngine()
             int wlen;
 
             buf = br_ssl_engine_sendrec_buf(_eng, &len);
+            if (len > _tx_peak)
+                _tx_peak = len;
             wlen = _basic_client->write(buf, len);
             _basic_client->flush();
             if (wlen <= 0)
@@ -1838,6 +2099,9 @@ unsigned BSSL_SSL_Client::mUpdateEngine()
             }
             if (wlen > 0)
             {
+                _tx_writes++;
+                _tx_bytes += wlen;
+                mCountTxRecords(buf, wlen);
                 br_ssl_engine_sendrec_ack(_eng, wlen);
             }
             continue;
@@ -1906,10 +2170,21 @@ unsigned BSSL_SSL_Client::mUpdateEngine()
          */
         if (state & BR_SSL_RECVREC)
         {
-            size_t len;
-            unsigned char *buf = br_ssl_engine_recvrec_buf(_eng, &len);
             // do we have the record you're looking for?
             const auto avail = _basic_client->available();
+            // borrow the receive buffer for the incoming record
+            if (avail > 0 && !_iobuf_in)
+            {
+                if (!mAcquireInBuffer())
+                {
+                    setWriteError(esp_ssl_out_of_memory);
+                    stop();
+                    return 0;
+                }
+                continue;
+            }
+            size_t len;
+            unsigned char *buf = br_ssl_engine_recvrec_buf(_eng, &len);
             if (avail > 0)
             {
                 // I suppose so!
@@ -1927,6 +2202,8 @@ unsigned BSSL_SSL_Client::mUpdateEngine()
                 }
                 if (rlen > 0)
                 {
+                    if ((size_t)(buf - _eng->ibuf) + rlen > _rx_peak)
+                        _rx_peak = (size_t)(buf - _eng->ibuf) + rlen;
                     br_ssl_engine_recvrec_ack(_eng, rlen);
                 }
                 continue;
@@ -1934,6 +2211,7 @@ unsigned BSSL_SSL_Client::mUpdateEngine()
             // guess not, tell the state we're waiting still
             else
             {
+                mReleaseInBuffer();
 
 #if defined __has_include
 #if __has_include(<Ethernet.h>)
@@ -1983,6 +2261,7 @@ void BSSL_SSL_Client::mPrintClientError(const int ssl_error, int level, const ch
 
 void BSSL_SSL_Client::mPrintSSLError(const unsigned br_error_code, int level, const char *func_name)
 {
+    (void)br_error_code;
 #if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
     char dest[300];
     getLastSSLError(dest, 300);
@@ -2054,7 +2333,7 @@ void BSSL_SSL_Client::mClearAuthenticationSettings()
     _ta = nullptr;
     if (_esp32_ta)
     {
-        delete _esp32_ta;
+        BSSL_TrustAnchorCache::release(_esp32_ta);
         _esp32_ta = nullptr;
     }
 }
@@ -2068,7 +2347,7 @@ void BSSL_SSL_Client::mClear()
     _x509_insecure = nullptr;
     _x509_knownkey = nullptr;
 
-    freeImpl(&_iobuf_in);
+    mFreeInBuffer();
     freeImpl(&_iobuf_out);
     _now = 0; // You can override or ensure time() is correct w/configTime
     _ta = nullptr;
@@ -2080,11 +2359,12 @@ void BSSL_SSL_Client::mClear()
     _session = nullptr;
     freeImpl(&_cipher_list);
     _cipher_cnt = 0;
+    _crypto = nullptr;
     _tls_min = BR_TLS10;
     _tls_max = BR_TLS12;
     if (_esp32_ta)
     {
-        delete _esp32_ta;
+        BSSL_TrustAnchorCache::release(_esp32_ta);
         _esp32_ta = nullptr;
     }
 }
@@ -2188,7 +2468,7 @@ void BSSL_SSL_Client::mFreeSSL()
     _x509_minimal = nullptr;
     _x509_insecure = nullptr;
     _x509_knownkey = nullptr;
-    freeImpl(&_iobuf_in);
+    mFreeInBuffer();
     freeImpl(&_iobuf_out);
     // Reset non-allocated ptrs (pointing to bits potentially free'd above)
     _recvapp_buf = nullptr;
@@ -2200,6 +2480,57 @@ void BSSL_SSL_Client::mFreeSSL()
     _is_connected = false;
 }
 
+bool BSSL_SSL_Client::mAcquireInBuffer()
+{
+    if (_iobuf_in)
+        return true;
+
+    _iobuf_in = BSSL_BufferPool::acquire(_iobuf_in_len);
+    if (!_iobuf_in)
+    {
+        _oom_err = true;
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+        esp_ssl_debug_print(PSTR("OOM error."), _debug_level, esp_ssl_debug_error, __func__);
+#endif
+        return false;
+    }
+
+    _eng->ibuf = _iobuf_in;
+    _eng->ibuf_len = _iobuf_in_len;
+    return true;
+}
+
+void BSSL_SSL_Client::mReleaseInBuffer()
+{
+#if defined(ESP_SSLCLIENT_USE_RX_BUFFER_POOL)
+    // The handshake messages may span the records, keep the buffer until it is done.
+    // The engine is ready for the next record header when ixa == ixb == 0 and ixc == 5.
+    // These are the private engine fields as make_ready_in() of bssl/ssl_engine.c sets them in the
+    // BearSSL 0.6 (bearssl-esp8266) sources of ESP_SSLClient v2.1.16, check them again when the
+    // BearSSL sources are updated.
+    if (!_handshake_done || !_iobuf_in || !_eng || _eng->ibuf != _iobuf_in ||
+        _eng->ixa != 0 || _eng->ixb != 0 || _eng->ixc != 5)
+        return;
+
+    _eng->ibuf = nullptr;
+    _eng->ibuf_len = 0;
+    BSSL_BufferPool::release(_iobuf_in);
+    _iobuf_in = nullptr;
+    _recvapp_buf = nullptr;
+    _recvapp_len = 0;
+#endif
+}
+
+void BSSL_SSL_Client::mFreeInBuffer()
+{
+#if defined(ESP_SSLCLIENT_USE_RX_BUFFER_POOL)
+    BSSL_BufferPool::release(_iobuf_in);
+    _iobuf_in = nullptr;
+#else
+    freeImpl(&_iobuf_in);
+#endif
+}
+
 uint8_t *BSSL_SSL_Client::mStreamLoad(Stream &stream, size_t size)
 {
     uint8_t *dest = reinterpret_cast<uint8_t *>(malloc(size + 1));
@@ -2220,38 +2551,11 @@ uint8_t *BSSL_SSL_Client::mStreamLoad(Stream &stream, size_t size)
 // Allocate memory
 void *BSSL_SSL_Client::mallocImpl(size_t len, bool clear)
 {
-    void *p;
-    size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM) && defined(ESP_SSLCLIENT_USE_PSRAM)
-
-    if (ESP.getPsramSize() > 0)
-        p = (void *)ps_malloc(newLen);
-    else
-        p = (void *)malloc(newLen);
-
-    if (!p)
-        return NULL;
-
+#if defined(ESP_SSLCLIENT_USE_PSRAM)
+    return MB_Alloc::alloc(mb_alloc_tag_tls, getReservedLen(len), true, clear);
 #else
-
-#if defined(ESP_SSLCLIENT_ESP8266_USE_EXTERNAL_HEAP)
-    ESP.setExternalHeap();
-#endif
-
-    p = reinterpret_cast<void *>(malloc(newLen));
-    bool nn = p ? true : false;
-
-#if defined(ESP_SSLCLIENT_ESP8266_USE_EXTERNAL_HEAP)
-    ESP.resetHeap();
-#endif
-
-    if (!nn)
-        return NULL;
-
+    return MB_Alloc::alloc(mb_alloc_tag_tls, getReservedLen(len), false, clear);
 #endif
-    if (clear)
-        memset(p, 0, newLen);
-    return p;
 }
 
 // Free reserved memory at pointer.
@@ -2260,7 +2564,7 @@ void BSSL_SSL_Client::freeImpl(void *ptr)
     void **p = reinterpret_cast<void **>(ptr);
     if (*p)
     {
-        free(*p);
+        MB_Alloc::free(*p);
         *p = 0;
     }
 }
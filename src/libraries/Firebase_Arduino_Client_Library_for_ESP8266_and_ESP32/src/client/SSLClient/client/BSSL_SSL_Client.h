@@ -170,6 +170,10 @@ public:
 
     int availableForWrite() override;
 
+    uint8_t *getWriteBuffer(size_t &len);
+
+    size_t commitWriteBuffer(size_t size);
+
     void setSession(BearSSL_Session *session);
 
     void setKnownKey(const PublicKey *pk, unsigned usages = BR_KEYTYPE_KEYX | BR_KEYTYPE_SIGN);
@@ -200,6 +204,10 @@ public:
 
     bool setCiphersLessSecure();
 
+    bool setCiphersAEADOnly();
+
+    void setCryptoProvider(const bssl::CryptoProvider *provider);
+
     bool setSSLVersion(uint32_t min, uint32_t max);
 
     bool probeMaxFragmentLength(IPAddress ip, uint16_t port, uint16_t len);
@@ -208,6 +216,16 @@ public:
 
     bool probeMaxFragmentLength(const String &host, uint16_t port, uint16_t len);
 
+    void setMaxFragmentLength(uint16_t len);
+
+    void getBufferUsage(size_t &rxPeak, size_t &txPeak);
+
+    void flushWrite();
+
+    void getWriteStats(uint32_t &records, uint32_t &writes, uint32_t &bytes);
+
+    void getHandshakeInfo(uint32_t &count, uint32_t &us, bool &resumed);
+
     size_t peekAvailable() EMBED_SSL_ENGINE_BASE_OVERRIDE;
 
     const char *peekBuffer() EMBED_SSL_ENGINE_BASE_OVERRIDE;
@@ -258,6 +276,9 @@ private:
 
     bool mProbeMaxFragmentLength(const char *name, IPAddress ip, uint16_t port, uint16_t len);
 
+    // Select the receive buffer size from the (cached) probe result of the server
+    void mApplyMaxFragmentLength(const char *name, IPAddress ip, uint16_t port);
+
     int mIsClientInitialized(bool notify);
 
     int mConnectBasicClient(const char *host, IPAddress ip, uint16_t port);
@@ -292,6 +313,17 @@ private:
 
     void mFreeSSL();
 
+    // Borrow the receive buffer from the pool and install it to the engine
+    bool mAcquireInBuffer();
+
+    // Return the receive buffer to the pool when the engine is waiting for the next record
+    void mReleaseInBuffer();
+
+    // Count the TLS records of the data written to the basic client
+    void mCountTxRecords(const unsigned char *buf, size_t len);
+
+    void mFreeInBuffer();
+
     uint8_t *mStreamLoad(Stream &stream, size_t size);
 
     void *mallocImpl(size_t len, bool clear = true);
@@ -327,6 +359,32 @@ private:
     unsigned char *_iobuf_out = nullptr;
     int _iobuf_in_size = 512;
     int _iobuf_out_size = 512;
+    // The receive buffer size of the current connection
+    int _iobuf_in_len = 0;
+
+    // The maximum fragment length to negotiate or 0 if not set
+    uint16_t _mfl_len = 0;
+
+    // The server takes the maximum fragment length of _mfl_len, from the probe or its cached result
+    bool _mfl_supported = false;
+
+    // The peak number of bytes used in receive and transmit buffers
+    size_t _rx_peak = 0;
+    size_t _tx_peak = 0;
+
+    // The TLS records, basic client writes and bytes sent
+    uint32_t _tx_records = 0;
+    uint32_t _tx_writes = 0;
+    uint32_t _tx_bytes = 0;
+    // The remaining bytes of the record being sent and its partially sent header
+    uint16_t _tx_rec_remain = 0;
+    uint8_t _tx_hdr[5];
+    uint8_t _tx_hdr_len = 0;
+
+    // The completed handshakes, the time of the last one and whether it resumed the session
+    uint32_t _hs_count = 0;
+    uint32_t _hs_us = 0;
+    bool _hs_resumed = false;
 
     time_t _now = 0;
     const X509List *_ta = nullptr;
@@ -354,11 +412,14 @@ private:
     uint16_t *_cipher_list = nullptr;
     uint8_t _cipher_cnt = 0;
 
+    // Crypto implementations or nullptr if default
+    const bssl::CryptoProvider *_crypto = nullptr;
+
     // TLS ciphers allowed
     uint32_t _tls_min = BR_TLS10;
     uint32_t _tls_max = BR_TLS12;
 
-    X509List *_esp32_ta = nullptr;
+    const X509List *_esp32_ta = nullptr;
     X509List *_esp32_chain = nullptr;
     PrivateKey *_esp32_sk = nullptr;
 
@@ -257,7 +257,13 @@ bool BSSL_TCP_Client::connectSSL()
     return 1;
 }
 
-bool BSSL_TCP_Client::connectSSL(const String host, uint16_t port) { return connectSSL(); }
+bool BSSL_TCP_Client::connectSSL(const String host, uint16_t port)
+{
+    // the host and port are the ones given to connect()
+    (void)host;
+    (void)port;
+    return connectSSL();
+}
 
 void BSSL_TCP_Client::stop()
 {
@@ -303,6 +309,16 @@ void BSSL_TCP_Client::setBufferSizes(int recv, int xmit)
 
 int BSSL_TCP_Client::availableForWrite() { return _ssl_client.availableForWrite(); };
 
+uint8_t *BSSL_TCP_Client::getWriteBuffer(size_t &len)
+{
+    len = 0;
+    if (!_ssl_client.connected())
+        return nullptr;
+    return _ssl_client.getWriteBuffer(len);
+}
+
+size_t BSSL_TCP_Client::commitWriteBuffer(size_t size) { return _ssl_client.commitWriteBuffer(size); }
+
 void BSSL_TCP_Client::setSession(BearSSL_Session *session) { _ssl_client.setSession(session); };
 
 void BSSL_TCP_Client::setKnownKey(const PublicKey *pk, unsigned usages)
@@ -374,6 +390,16 @@ bool BSSL_TCP_Client::setCiphersLessSecure()
     return _ssl_client.setCiphersLessSecure();
 }
 
+bool BSSL_TCP_Client::setCiphersAEADOnly()
+{
+    return _ssl_client.setCiphersAEADOnly();
+}
+
+void BSSL_TCP_Client::setCryptoProvider(const bssl::CryptoProvider *provider)
+{
+    _ssl_client.setCryptoProvider(provider);
+}
+
 bool BSSL_TCP_Client::setSSLVersion(uint32_t min, uint32_t max)
 {
     return _ssl_client.setSSLVersion(min, max);
@@ -385,6 +411,16 @@ bool BSSL_TCP_Client::probeMaxFragmentLength(const char *hostname, uint16_t port
 
 bool BSSL_TCP_Client::probeMaxFragmentLength(const String &host, uint16_t port, uint16_t len) { return _ssl_client.probeMaxFragmentLength(host, port, len); };
 
+void BSSL_TCP_Client::setMaxFragmentLength(uint16_t len) { _ssl_client.setMaxFragmentLength(len); }
+
+void BSSL_TCP_Client::getBufferUsage(size_t &rxPeak, size_t &txPeak) { _ssl_client.getBufferUsage(rxPeak, txPeak); }
+
+void BSSL_TCP_Client::flushWrite() { _ssl_client.flushWrite(); }
+
+void BSSL_TCP_Client::getWriteStats(uint32_t &records, uint32_t &writes, uint32_t &bytes) { _ssl_client.getWriteStats(records, writes, bytes); }
+
+void BSSL_TCP_Client::getHandshakeInfo(uint32_t &count, uint32_t &us, bool &resumed) { _ssl_client.getHandshakeInfo(count, us, resumed); }
+
 // peek buffer API is present
 bool BSSL_TCP_Client::hasPeekBufferAPI() const { return true; }
 
@@ -346,6 +346,21 @@ public:
 
     int availableForWrite() override;
 
+    /**
+     * Get the free space of the SSL engine output buffer to write the application data in place.
+     * @param len The length of free space.
+     * @return The pointer to the free space or nullptr when it is unavailable e.g. in non-secure mode.
+     * @note Call commitWriteBuffer with the number of bytes written to the buffer.
+     */
+    uint8_t *getWriteBuffer(size_t &len);
+
+    /**
+     * Commit the application data that was written to the buffer from getWriteBuffer.
+     * @param size The number of bytes written.
+     * @return The size of data that was committed or 0 for error.
+     */
+    size_t commitWriteBuffer(size_t size);
+
     void setSession(BearSSL_Session *session);
 
     void setKnownKey(const PublicKey *pk, unsigned usages = BR_KEYTYPE_KEYX | BR_KEYTYPE_SIGN);
@@ -382,6 +397,10 @@ public:
 
     bool setCiphersLessSecure();
 
+    bool setCiphersAEADOnly();
+
+    void setCryptoProvider(const bssl::CryptoProvider *provider);
+
     bool setSSLVersion(uint32_t min = BR_TLS10, uint32_t max = BR_TLS12);
 
     bool probeMaxFragmentLength(IPAddress ip, uint16_t port, uint16_t len);
@@ -390,6 +409,43 @@ public:
 
     bool probeMaxFragmentLength(const String &host, uint16_t port, uint16_t len);
 
+    /**
+     * Negotiate the maximum fragment length and size the receive buffer to it.
+     * @param len The fragment length (512, 1024, 2048 or 4096) or 0 to disable.
+     * @note The server support is probed once per host before connecting.
+     */
+    void setMaxFragmentLength(uint16_t len);
+
+    /**
+     * Get the peak number of bytes used in the receive and transmit buffers.
+     * @param rxPeak The receive buffer peak usage.
+     * @param txPeak The transmit buffer peak usage.
+     */
+    void getBufferUsage(size_t &rxPeak, size_t &txPeak);
+
+    /**
+     * Send the written data that is waiting in the transmit buffer as one record.
+     * @note The written data is sent when the transmit buffer is full or before reading
+     * the response otherwise.
+     */
+    void flushWrite();
+
+    /**
+     * Get the number of TLS records, basic client writes and bytes sent.
+     * @param records The TLS records including the handshake records.
+     * @param writes The writes to the basic client (TCP send calls).
+     * @param bytes The bytes sent.
+     */
+    void getWriteStats(uint32_t &records, uint32_t &writes, uint32_t &bytes);
+
+    /**
+     * Get the TLS handshakes done.
+     * @param count The number of completed handshakes.
+     * @param us The time of the last handshake in microseconds.
+     * @param resumed True if the last handshake resumed the session set by setSession.
+     */
+    void getHandshakeInfo(uint32_t &count, uint32_t &us, bool &resumed);
+
     bool hasPeekBufferAPI() const EMBED_SSL_ENGINE_BASE_OVERRIDE;
 
     size_t peekAvailable() EMBED_SSL_ENGINE_BASE_OVERRIDE;
@@ -0,0 +1,214 @@
+/**
+ * BSSL_TrustAnchorCache v1.0.0 for Arduino devices.
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef BSSL_TRUST_ANCHOR_CACHE_CPP
+#define BSSL_TRUST_ANCHOR_CACHE_CPP
+
+#include <Arduino.h>
+#include "../ESP_SSLClient_FS.h"
+
+#if defined(USE_LIB_SSL_ENGINE) || defined(USE_EMBED_SSL_ENGINE)
+
+#include "BSSL_TrustAnchorCache.h"
+#include <new>
+
+#if defined(ESP32)
+static portMUX_TYPE bssl_ta_cache_mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+BSSL_TrustAnchorCache::entry_t BSSL_TrustAnchorCache::_entries[ESP_SSLCLIENT_TRUST_ANCHOR_CACHE_SIZE] = {};
+
+const X509List *BSSL_TrustAnchorCache::acquire(const char *pem)
+{
+    if (!pem)
+        return nullptr;
+    return mDecode(reinterpret_cast<const uint8_t *>(pem), strlen_P(pem), true);
+}
+
+const X509List *BSSL_TrustAnchorCache::acquire(const uint8_t *der, size_t len)
+{
+    if (!der || !len)
+        return nullptr;
+    return mDecode(der, len, false);
+}
+
+void BSSL_TrustAnchorCache::release(const X509List *list)
+{
+    if (!list)
+        return;
+
+    mLock();
+    for (int i = 0; i < ESP_SSLCLIENT_TRUST_ANCHOR_CACHE_SIZE; i++)
+    {
+        if (_entries[i].list == list)
+        {
+            // keep the decoded list for the next use
+            if (_entries[i].refs > 0)
+                _entries[i].refs--;
+            mUnlock();
+            return;
+        }
+    }
+    mUnlock();
+
+    delete list;
+}
+
+void BSSL_TrustAnchorCache::clear()
+{
+    for (int i = 0; i < ESP_SSLCLIENT_TRUST_ANCHOR_CACHE_SIZE; i++)
+    {
+        entry_t entry = {};
+        mLock();
+        if (_entries[i].refs == 0)
+        {
+            entry = _entries[i];
+            _entries[i] = entry_t();
+        }
+        mUnlock();
+        mFree(entry);
+    }
+}
+
+uint32_t BSSL_TrustAnchorCache::hash(const void *data, size_t len, uint32_t hash)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < len; i++)
+        hash = (hash ^ pgm_read_byte(p + i)) * 16777619UL;
+    return hash;
+}
+
+const X509List *BSSL_TrustAnchorCache::mDecode(const uint8_t *src, size_t len, bool pem)
+{
+    uint32_t key = hash(src, len);
+
+    const X509List *list = mFind(key, src, len, pem);
+    if (list)
+        return list;
+
+    X509List *decoded = pem ? new (std::nothrow) X509List(reinterpret_cast<const char *>(src)) : new (std::nothrow) X509List(src, len);
+    if (!decoded)
+        return nullptr;
+
+    // The invalid certificate is not cached, the empty list is freed on release
+    if (decoded->getCount() == 0)
+        return decoded;
+
+    return mAdd(key, src, len, pem, decoded);
+}
+
+const X509List *BSSL_TrustAnchorCache::mFind(uint32_t key, const uint8_t *src, size_t len, bool pem)
+{
+    X509List *list = nullptr;
+    mLock();
+    for (int i = 0; i < ESP_SSLCLIENT_TRUST_ANCHOR_CACHE_SIZE; i++)
+    {
+        entry_t &entry = _entries[i];
+        // the hash collision is rejected by the full compare
+        if (entry.list && entry.key == key && entry.len == len && entry.pem == pem &&
+            memcmp_P(entry.src, src, len) == 0)
+        {
+            entry.refs++;
+            list = entry.list;
+            break;
+        }
+    }
+    mUnlock();
+    return list;
+}
+
+const X509List *BSSL_TrustAnchorCache::mAdd(uint32_t key, const uint8_t *src, size_t len, bool pem, X509List *list)
+{
+    // The list is not cached when its source can't be kept for comparison, it is freed on release
+    uint8_t *copy = new (std::nothrow) uint8_t[len];
+    if (!copy)
+        return list;
+    memcpy_P(copy, src, len);
+
+    entry_t evicted = {};
+    int slot = -1;
+
+    mLock();
+    for (int i = 0; i < ESP_SSLCLIENT_TRUST_ANCHOR_CACHE_SIZE; i++)
+    {
+        if (!_entries[i].list)
+        {
+            slot = i;
+            break;
+        }
+        // the unused list can be replaced
+        if (_entries[i].refs == 0 && slot < 0)
+            slot = i;
+    }
+
+    if (slot >= 0)
+    {
+        evicted = _entries[slot];
+        _entries[slot].key = key;
+        _entries[slot].src = copy;
+        _entries[slot].len = len;
+        _entries[slot].pem = pem;
+        _entries[slot].list = list;
+        _entries[slot].refs = 1;
+        copy = nullptr;
+    }
+    mUnlock();
+
+    mFree(evicted);
+
+    // The cache is full, the list is freed on release
+    if (copy)
+        delete[] copy;
+
+    return list;
+}
+
+void BSSL_TrustAnchorCache::mFree(entry_t &entry)
+{
+    if (entry.list)
+        delete entry.list;
+    if (entry.src)
+        delete[] entry.src;
+    entry = entry_t();
+}
+
+void BSSL_TrustAnchorCache::mLock()
+{
+#if defined(ESP32)
+    portENTER_CRITICAL(&bssl_ta_cache_mux);
+#endif
+}
+
+void BSSL_TrustAnchorCache::mUnlock()
+{
+#if defined(ESP32)
+    portEXIT_CRITICAL(&bssl_ta_cache_mux);
+#endif
+}
+
+#endif
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * BSSL_TrustAnchorCache v1.0.0 for Arduino devices.
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef BSSL_TRUST_ANCHOR_CACHE_H
+#define BSSL_TRUST_ANCHOR_CACHE_H
+
+#include <Arduino.h>
+#include "../ESP_SSLClient_FS.h"
+#include "BSSL_SSL_Client.h"
+
+#if defined(USE_LIB_SSL_ENGINE) || defined(USE_EMBED_SSL_ENGINE)
+
+// The maximum number of decoded certificate lists kept in the cache
+#if !defined(ESP_SSLCLIENT_TRUST_ANCHOR_CACHE_SIZE)
+#define ESP_SSLCLIENT_TRUST_ANCHOR_CACHE_SIZE 4
+#endif
+
+// The decoded trust anchors shared by the SSL clients.
+// The PEM/DER certificate is decoded once into the X509List which kept in RAM,
+// the following requests of the same certificate return the cached list without decoding.
+// The entries are keyed by the certificate content, the hash only skips the entries those
+// can't match and the hit is confirmed by comparing the full certificate bytes.
+class BSSL_TrustAnchorCache
+{
+public:
+    /**
+     * Get the trust anchors of the PEM certificate.
+     * @param pem The PEM certificate(s) in RAM or PROGMEM.
+     * @return The certificate list or nullptr when out of memory.
+     * @note The list should be returned with release when no longer used.
+     */
+    static const X509List *acquire(const char *pem);
+
+    /**
+     * Get the trust anchors of the DER certificate.
+     * @param der The DER certificate in RAM or PROGMEM.
+     * @param len The DER certificate length.
+     * @return The certificate list or nullptr when out of memory.
+     */
+    static const X509List *acquire(const uint8_t *der, size_t len);
+
+    /**
+     * Return the certificate list.
+     * @param list The certificate list from acquire, find or add.
+     */
+    static void release(const X509List *list);
+
+    /**
+     * Free the certificate lists those are not used.
+     */
+    static void clear();
+
+    /**
+     * Get the FNV-1a hash of the data.
+     * @param data The data in RAM or PROGMEM.
+     * @param len The data length.
+     * @param hash The hash to continue from.
+     */
+    static uint32_t hash(const void *data, size_t len, uint32_t hash = 2166136261UL);
+
+private:
+    struct entry_t
+    {
+        uint32_t key;
+        // the copy of the certificate bytes that the list was decoded from
+        uint8_t *src;
+        size_t len;
+        bool pem;
+        X509List *list;
+        uint16_t refs;
+    };
+
+    static entry_t _entries[ESP_SSLCLIENT_TRUST_ANCHOR_CACHE_SIZE];
+
+    static const X509List *mDecode(const uint8_t *src, size_t len, bool pem);
+    static const X509List *mFind(uint32_t key, const uint8_t *src, size_t len, bool pem);
+    static const X509List *mAdd(uint32_t key, const uint8_t *src, size_t len, bool pem, X509List *list);
+    static void mFree(entry_t &entry);
+    static void mLock();
+    static void mUnlock();
+};
+
+#endif
+
+#endif /** BSSL_TRUST_ANCHOR_CACHE_H */
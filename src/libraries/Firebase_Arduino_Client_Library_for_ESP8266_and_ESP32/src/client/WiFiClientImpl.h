@@ -423,67 +423,41 @@ private:
         if (!tcpConnected() || !size)
             return 0;
 
-        int res = 0;
         int retry = 10;
-        int socketFileDescriptor = _socket;
         size_t totalBytesSent = 0;
-        size_t bytesRemaining = size;
 
-        while (retry)
+        while (totalBytesSent < size && retry)
         {
-            // use select to make sure the socket is ready for writing
+            // send first, the socket is usually writable and select is only needed when the send buffer is full
+            int res = send(_socket, (void *)(buf + totalBytesSent), size - totalBytesSent, MSG_DONTWAIT);
+            if (res > 0)
+            {
+                totalBytesSent += res;
+                retry = 10;
+                continue;
+            }
+
+            if (res < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                // log_e("fail on fd %d, errno: %d, \"%s\"", _socket, errno, strerror(errno));
+                tcpClose();
+                break;
+            }
+
+            // wait until the socket is ready for writing
             fd_set set;
             struct timeval tv;
-            FD_ZERO(&set);                      // empties the set
-            FD_SET(socketFileDescriptor, &set); // adds FD to the set
+            FD_ZERO(&set);
+            FD_SET(_socket, &set);
             tv.tv_sec = 0;
             tv.tv_usec = 1000000;
             retry--;
 
-            if (select(socketFileDescriptor + 1, NULL, &set, NULL, &tv) < 0)
-            {
-                return 0;
-            }
-
-            if (FD_ISSET(socketFileDescriptor, &set))
-            {
-                res = send(socketFileDescriptor, (void *)buf, bytesRemaining, MSG_DONTWAIT);
-                if (res > 0)
-                {
-                    totalBytesSent += res;
-                    if (totalBytesSent >= size)
-                    {
-                        // completed successfully
-                        retry = 0;
-                    }
-                    else
-                    {
-                        buf += res;
-                        bytesRemaining -= res;
-                        retry = 10;
-                    }
-                }
-                else if (res < 0)
-                {
-                    // log_e("fail on fd %d, errno: %d, \"%s\"", _socket, errno, strerror(errno));
-                    if (errno != EAGAIN)
-                    {
-                        // if resource was busy, can try again, otherwise give up
-                        res = 0;
-                        retry = 0;
-                        tcpClose();
-                    }
-                }
-                else
-                {
-                    // Try again
-                }
-            }
+            if (select(_socket + 1, NULL, &set, NULL, &tv) < 0)
+                break;
         }
-        return totalBytesSent;
 
-        // return ssize_t or signed size_t for error
-        return lwip_write(_socket, buf, size);
+        return totalBytesSent;
     }
 
     size_t tcpRead(uint8_t *dst, size_t len)
@@ -0,0 +1,236 @@
+/**
+ * Firebase performance counters and trace ring v1.0.0
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef FIREBASE_PERF_H
+#define FIREBASE_PERF_H
+
+#include <Arduino.h>
+#include "./FB_Const.h"
+
+#if defined(PERF_TRACE_ENABLED)
+
+static const char firebase_perf_pgm_str_1[] PROGMEM = "connect";
+static const char firebase_perf_pgm_str_2[] PROGMEM = "handshake";
+static const char firebase_perf_pgm_str_3[] PROGMEM = "token";
+static const char firebase_perf_pgm_str_4[] PROGMEM = "request";
+static const char firebase_perf_pgm_str_5[] PROGMEM = "wait";
+static const char firebase_perf_pgm_str_6[] PROGMEM = "response";
+
+// The start of a phase
+struct fb_perf_mark_t
+{
+    uint32_t cycles = 0;
+    unsigned long us = 0;
+};
+
+// The ring of the last FB_PERF_TRACE_SIZE phases of all sessions.
+// The writers (the sessions, token and stream tasks) reserve the entry by incrementing the head
+// and publish it with its sequence number, the reader skips the entry that is being written or
+// was overwritten while it was copied.
+class FB_PerfTrace
+{
+public:
+    static FB_PerfTrace &get()
+    {
+        static FB_PerfTrace trace;
+        return trace;
+    }
+
+    /* The cycle counter, micros on the devices without it */
+    static uint32_t cycles()
+    {
+#if defined(ESP32) || defined(ESP8266)
+        return ESP.getCycleCount();
+#elif defined(MB_ARDUINO_PICO)
+        return rp2040.getCycleCount();
+#else
+        return micros();
+#endif
+    }
+
+    static uint32_t freeHeap()
+    {
+#if defined(MB_ARDUINO_ESP)
+        return ESP.getFreeHeap();
+#elif defined(MB_ARDUINO_PICO)
+        return rp2040.getFreeHeap();
+#else
+        return 0;
+#endif
+    }
+
+    static void mark(fb_perf_mark_t &m)
+    {
+        m.cycles = cycles();
+        m.us = micros();
+    }
+
+    static const char *phaseName(uint8_t phase)
+    {
+        switch (phase)
+        {
+        case fb_perf_phase_connect:
+            return firebase_perf_pgm_str_1;
+        case fb_perf_phase_handshake:
+            return firebase_perf_pgm_str_2;
+        case fb_perf_phase_token:
+            return firebase_perf_pgm_str_3;
+        case fb_perf_phase_request:
+            return firebase_perf_pgm_str_4;
+        case fb_perf_phase_wait:
+            return firebase_perf_pgm_str_5;
+        default:
+            return firebase_perf_pgm_str_6;
+        }
+    }
+
+    /* The id of the new session, 1 to 255 */
+    uint8_t newSession()
+    {
+        uint8_t id = (uint8_t)(increment(sessions) % 255) + 1;
+        return id;
+    }
+
+    void add(uint8_t phase, uint8_t session, const fb_perf_mark_t &start, uint32_t us, int32_t value)
+    {
+        uint32_t index = increment(head);
+        FB_PerfTraceEntry &entry = entries[index % FB_PERF_TRACE_SIZE];
+        entry.seq = 0;
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        entry.cycles = start.cycles;
+        entry.us = us;
+        entry.value = value;
+        entry.phase = phase;
+        entry.session = session;
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        entry.seq = seqOf(index);
+    }
+
+    /**
+     * Copy the entries from the oldest to the newest.
+     * @param out The entries to copy to.
+     * @param len The number of entries of out.
+     * @return The number of entries copied.
+     */
+    size_t copy(FB_PerfTraceEntry *out, size_t len)
+    {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        uint32_t end = head;
+        uint32_t n = end < FB_PERF_TRACE_SIZE ? end : FB_PERF_TRACE_SIZE;
+        if (n > len)
+            n = len;
+
+        size_t count = 0;
+        for (uint32_t i = end - n; i != end; i++)
+        {
+            const FB_PerfTraceEntry &entry = entries[i % FB_PERF_TRACE_SIZE];
+            uint16_t seq = seqOf(i);
+            if (entry.seq != seq)
+                continue;
+            out[count] = entry;
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            if (entry.seq != seq)
+                continue;
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     * Print the entries from the oldest to the newest, one per line as
+     * <seq> <session> <phase> <cycles> <us> <value>
+     */
+    void print(Print *out)
+    {
+        FB_PerfTraceEntry buf[FB_PERF_TRACE_SIZE];
+        size_t n = copy(buf, FB_PERF_TRACE_SIZE);
+        MB_String line;
+        for (size_t i = 0; i < n; i++)
+        {
+            line.clear();
+            line += (int)buf[i].seq;
+            line += ' ';
+            line += (int)buf[i].session;
+            line += ' ';
+            line.appendP(phaseName(buf[i].phase));
+            line += ' ';
+            line += buf[i].cycles;
+            line += ' ';
+            line += buf[i].us;
+            line += ' ';
+            line += buf[i].value;
+            line.appendP(PSTR("\r\n"));
+            out->print(line.c_str());
+        }
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < FB_PERF_TRACE_SIZE; i++)
+            entries[i].seq = 0;
+    }
+
+private:
+    volatile uint32_t head = 0;
+    volatile uint32_t sessions = 0;
+    FB_PerfTraceEntry entries[FB_PERF_TRACE_SIZE];
+
+    static uint16_t seqOf(uint32_t index) { return (uint16_t)(index % 65535) + 1; }
+
+    static uint32_t increment(volatile uint32_t &v)
+    {
+#if defined(ESP8266)
+        // no atomic instructions on single core ESP8266
+        noInterrupts();
+        uint32_t old = v++;
+        interrupts();
+        return old;
+#else
+        return __atomic_fetch_add(&v, 1, __ATOMIC_SEQ_CST);
+#endif
+    }
+};
+
+// Record the phase from the construction to the destruction of the scope e.g. the token request
+class FB_PerfScope
+{
+public:
+    FB_PerfScope(fb_perf_phase phase, uint8_t session) : phase(phase), session(session) { FB_PerfTrace::mark(start); }
+    ~FB_PerfScope() { FB_PerfTrace::get().add(phase, session, start, micros() - start.us, value); }
+
+    // The value of the trace entry
+    int32_t value = 0;
+
+private:
+    fb_perf_phase phase;
+    uint8_t session;
+    fb_perf_mark_t start;
+};
+
+#endif
+
+#endif
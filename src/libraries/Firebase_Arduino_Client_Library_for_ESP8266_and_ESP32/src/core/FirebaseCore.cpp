@@ -50,6 +50,10 @@ void FirebaseCore::begin(FirebaseConfig *cfg, FirebaseAuth *authen)
 
 void FirebaseCore::end()
 {
+#if defined(ESP32)
+    endTokenRefreshTask();
+#endif
+
     freeJson();
 
     wifiCreds.clearAP();
@@ -77,7 +81,7 @@ bool FirebaseCore::parseSAFile()
         initJson();
 
         size_t len = res;
-        char *buf = reinterpret_cast<char *>(mbfs.newP(len + 10));
+        char *buf = reinterpret_cast<char *>(mbfs.newP(len + 10, true, mb_alloc_tag_other));
         if (mbfs.available(mbfs_type config->service_account.json.storage_type))
         {
             if ((int)len == mbfs.read(mbfs_type config->service_account.json.storage_type, (uint8_t *)buf, len))
@@ -100,7 +104,7 @@ bool FirebaseCore::parseSAFile()
 
                 if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_6)) // private_key
                 {
-                    char *buff = reinterpret_cast<char *>(mbfs.newP(strlen(resultPtr->to<const char *>())));
+                    char *buff = reinterpret_cast<char *>(mbfs.newP(strlen(resultPtr->to<const char *>()), true, mb_alloc_tag_other));
                     size_t c = 0;
                     for (size_t i = 0; i < strlen(resultPtr->to<const char *>()); i++)
                     {
@@ -281,11 +285,23 @@ bool FirebaseCore::isExpired()
     if (!config || !auth || config->signer.tokens.token_type == token_type_legacy_token || config->signer.test_mode)
         return false;
 
+#if defined(ESP32)
+    // the token is refreshed by the background task and nothing is due
+    if (tokenPublished())
+        return false;
+#endif
+
     time_t now = 0;
 
     // adjust the expiry time when needed
     adjustTime(now);
 
+#if defined(ESP32)
+    // the id token will be refreshed by the background task, the current token is still usable
+    if (handleTokenRefreshTask(now))
+        return false;
+#endif
+
     // time is up or expiry time was reset or unset?
     return (now > (int)(config->signer.tokens.expires - config->signer.preRefreshSeconds) || config->signer.tokens.expires == 0);
 }
@@ -557,7 +573,7 @@ uint32_t FirebaseCore::getTimestamp(int year, int mon, int date, int hour, int m
 
 void FirebaseCore::getBaseTime()
 {
-#if defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO)
+#if defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST)
 
     if (baseTs < time(nullptr))
         baseTs = time(nullptr);
@@ -604,6 +620,7 @@ void FirebaseCore::timeBegin()
     {
         // Reset system timestamp when config changed
         baseTs = 0;
+        internal.fb_ntp_started = false;
         if (config->time_zone > FIREBASE_NON_TS)
             internal.fb_gmt_offset = config->time_zone;
         if (config->daylight_offset > FIREBASE_NON_TS)
@@ -624,10 +641,21 @@ void FirebaseCore::readNTPTime()
         if (WiFI_CONNECTED)
         {
 
+#if (defined(FIREBASE_ENABLE_NTP_TIME) || defined(ENABLE_NTP_TIME)) && (defined(ESP32) || defined(ESP8266)) && !defined(FIREBASE_HAS_WIFI_TIME)
+
+            // Start SNTP once and read the clock in the next calls instead of waiting here,
+            // the clock can also be set from the Date header of the server response.
+            if (!internal.fb_ntp_started)
+            {
+                configTime(config->time_zone * 3600, config->daylight_offset * 60, "pool.ntp.org", "time.nist.gov");
+                internal.fb_ntp_started = true;
+            }
+
+            baseTs = time(nullptr) > FIREBASE_DEFAULT_TS ? time(nullptr) : baseTs;
+#else
+
 #if defined(FIREBASE_ENABLE_NTP_TIME) || defined(ENABLE_NTP_TIME)
-#if (defined(ESP32) || defined(ESP8266))
-            configTime(config->time_zone * 3600, config->daylight_offset * 60, "pool.ntp.org", "time.nist.gov");
-#elif defined(ARDUINO_RASPBERRY_PI_PICO_W)
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
             NTP.begin("pool.ntp.org", "time.nist.gov");
             NTP.waitSet();
 #endif
@@ -646,12 +674,24 @@ void FirebaseCore::readNTPTime()
 
                 FBUtils::idle();
             } while (millis() - ms < 10000 && baseTs < FIREBASE_DEFAULT_TS);
+#endif
         }
     }
 
     internal.fb_clock_rdy = baseTs > FIREBASE_DEFAULT_TS;
 }
 
+void FirebaseCore::syncServerTime(time_t ts)
+{
+    // The clock which was set by NTP or user is more accurate than the Date header
+    if (ts < FIREBASE_DEFAULT_TS || timeReady())
+        return;
+
+    setTimestamp(ts);
+    internal.fb_base_time_type = firebase_cfg_int_t::base_time_type_auto;
+    internal.fb_clock_rdy = timeReady();
+}
+
 void FirebaseCore::tokenProcessingTask()
 {
     // All sessions should be closed
@@ -805,6 +845,10 @@ bool FirebaseCore::refreshToken()
     if (!initClient(firebase_auth_pgm_str_9 /* "securetoken" */, token_status_on_refresh))
         return false;
 
+#if defined(PERF_TRACE_ENABLED)
+    FB_PerfScope perf(fb_perf_phase_token, FB_PERF_SESSION_CORE);
+#endif
+
     jsonPtr->add(pgm2Str(firebase_auth_pgm_str_11 /* "grantType" */), pgm2Str(firebase_auth_pgm_str_12 /* "refresh_token" */));
     jsonPtr->add(pgm2Str(firebase_auth_pgm_str_13 /* "refreshToken" */), internal.refresh_token.c_str());
 
@@ -832,7 +876,11 @@ bool FirebaseCore::refreshToken()
     struct firebase_auth_token_error_t error;
 
     int httpCode = FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
-    if (handleTokenResponse(httpCode))
+    bool ret = handleTokenResponse(httpCode);
+#if defined(PERF_TRACE_ENABLED)
+    perf.value = httpCode;
+#endif
+    if (ret)
     {
         if (jh.parse(jsonPtr, resultPtr, firebase_storage_ss_pgm_str_16 /* "error/code" */))
         {
@@ -886,6 +934,323 @@ bool FirebaseCore::refreshToken()
     return true;
 }
 
+#if defined(ESP32)
+bool FirebaseCore::beginTokenRefreshTask()
+{
+    if (token_refresh_task_handle)
+        return token_refresh_task_enable;
+
+    // The external client can't be used by two sessions at the same time
+    firebase_client_type type = tcpClient ? tcpClient->type() : _cli_type;
+    if (type != firebase_client_type_undefined && type != firebase_client_type_internal_basic_client)
+        return false;
+
+    token_refresh_task_enable = true;
+    token_refresh_state.store(firebase_token_refresh_idle, std::memory_order_release);
+    token_refresh_millis.store(0, std::memory_order_relaxed);
+
+    TaskFunction_t taskCode = [](void *param)
+    {
+        // The task's own client, the current token and sessions are not blocked by the refresh
+        Firebase_TCP_Client *client = new Firebase_TCP_Client();
+        client->_client_type = firebase_client_type_internal_basic_client;
+
+        for (;;)
+        {
+            // sleep until the refresh was requested or the task was stopped
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+            if (!Core.token_refresh_task_enable)
+                break;
+
+            if (Core.token_refresh_state.load(std::memory_order_acquire) == firebase_token_refresh_requested)
+            {
+                bool ret = Core.refreshTokenInTask(client);
+                Core.token_refresh_state.store(ret ? firebase_token_refresh_done : firebase_token_refresh_failed,
+                                               std::memory_order_release);
+            }
+        }
+
+        delete client;
+
+        Core.token_refresh_task_handle = NULL;
+
+        vTaskDelete(NULL);
+    };
+
+    xTaskCreatePinnedToCore(taskCode, pgm2Str(firebase_auth_pgm_str_63 /* "TokenRefresh" */), TOKEN_REFRESH_TASK_STACK_SIZE,
+                            NULL, 1, &token_refresh_task_handle, 1);
+
+    if (!token_refresh_task_handle)
+        token_refresh_task_enable = false;
+
+    return token_refresh_task_enable;
+}
+
+void FirebaseCore::endTokenRefreshTask()
+{
+    token_published.store(false, std::memory_order_release);
+
+    if (!token_refresh_task_handle || !token_refresh_task_enable)
+        return;
+
+    // The task exits after the running refresh was finished
+    token_refresh_task_enable = false;
+    xTaskNotifyGive(token_refresh_task_handle);
+}
+
+bool FirebaseCore::handleTokenRefreshTask(time_t now)
+{
+    if (!token_refresh_task_handle || !token_refresh_task_enable)
+    {
+        token_published.store(false, std::memory_order_release);
+        return false;
+    }
+
+    // Only one caller applies the response when called from the other tasks
+    uint8_t state = firebase_token_refresh_done;
+    if (token_refresh_state.compare_exchange_strong(state, firebase_token_refresh_applying, std::memory_order_acq_rel))
+        applyRefreshedToken();
+    else if (state == firebase_token_refresh_failed &&
+             token_refresh_state.compare_exchange_strong(state, firebase_token_refresh_applying, std::memory_order_acq_rel))
+    {
+        // keep the current token and retry after the interval
+        syncRefreshServerTime();
+        token_refresh_millis.store(millis(), std::memory_order_relaxed);
+        token_refresh.error.message.clear();
+        token_refresh_state.store(firebase_token_refresh_idle, std::memory_order_release);
+    }
+
+    // Only the id token which can be exchanged with the refresh token is refreshed in background,
+    // the expired token is handled by the synchronous token request.
+    bool usable = config->signer.tokens.status == token_status_ready &&
+                  config->signer.tokens.token_type == token_type_id_token &&
+                  internal.rtok_len > 0 && internal.ltok_len == 0 &&
+                  config->signer.tokens.expires > 0 && now < (time_t)config->signer.tokens.expires;
+
+    unsigned long lastMs = token_refresh_millis.load(std::memory_order_relaxed);
+
+    if (usable && now > (time_t)(config->signer.tokens.expires - config->signer.preRefreshSeconds) &&
+        (lastMs == 0 || millis() - lastMs > MIN_TOKEN_REFRESH_TASK_RETRY_INTERVAL))
+    {
+        // Only the caller that takes the idle state writes the request, the other tasks and the
+        // refresh task don't touch the request until it was published with the requested state.
+        state = firebase_token_refresh_idle;
+        if (token_refresh_state.compare_exchange_strong(state, firebase_token_refresh_requesting, std::memory_order_acq_rel))
+        {
+            token_refresh.refresh_token = internal.refresh_token;
+            token_refresh.api_key = config->api_key;
+            token_refresh_millis.store(millis(), std::memory_order_relaxed);
+            token_refresh_state.store(firebase_token_refresh_requested, std::memory_order_release);
+            xTaskNotifyGive(token_refresh_task_handle);
+        }
+    }
+
+    publishToken(usable, now);
+
+    return usable;
+}
+
+void FirebaseCore::publishToken(bool usable, time_t now)
+{
+    // hide the state while its times are updated
+    token_published.store(false, std::memory_order_release);
+
+    if (!usable)
+        return;
+
+    time_t refreshAt = config->signer.tokens.expires - config->signer.preRefreshSeconds;
+    unsigned long refreshIn = refreshAt > now ? (refreshAt - now) * 1000 : 0;
+
+    // the failed refresh is retried after the interval
+    unsigned long lastMs = token_refresh_millis.load(std::memory_order_relaxed);
+    if (refreshIn == 0 && lastMs > 0 && millis() - lastMs < MIN_TOKEN_REFRESH_TASK_RETRY_INTERVAL)
+        refreshIn = MIN_TOKEN_REFRESH_TASK_RETRY_INTERVAL - (millis() - lastMs);
+
+    unsigned long expireIn = (config->signer.tokens.expires - now) * 1000;
+    if (refreshIn > expireIn)
+        refreshIn = expireIn;
+
+    token_published_ms.store(millis(), std::memory_order_relaxed);
+    token_refresh_in_ms.store(refreshIn, std::memory_order_relaxed);
+    token_expire_in_ms.store(expireIn, std::memory_order_relaxed);
+    token_published.store(true, std::memory_order_release);
+}
+
+bool FirebaseCore::tokenPublished()
+{
+    if (!token_published.load(std::memory_order_acquire))
+        return false;
+
+    unsigned long elapsed = millis() - token_published_ms.load(std::memory_order_relaxed);
+
+    switch (token_refresh_state.load(std::memory_order_acquire))
+    {
+    case firebase_token_refresh_idle:
+        // the refresh is not due yet
+        return elapsed < token_refresh_in_ms.load(std::memory_order_relaxed);
+    case firebase_token_refresh_requesting:
+    case firebase_token_refresh_requested:
+        // the current token is usable while it is refreshed
+        return elapsed < token_expire_in_ms.load(std::memory_order_relaxed);
+    default:
+        // the response is waiting to be applied by the caller
+        return false;
+    }
+}
+
+void FirebaseCore::applyRefreshedToken()
+{
+    syncRefreshServerTime();
+
+    // The token was reset or signed in again while refreshing
+    if (config->signer.tokens.token_type == token_type_id_token &&
+        strcmp(token_refresh.refresh_token.c_str(), internal.refresh_token.c_str()) == 0)
+    {
+        internal.auth_token.swap(token_refresh.id_token);
+        internal.atok_len = internal.auth_token.length();
+        internal.ltok_len = 0;
+
+        if (token_refresh.new_refresh_token.length() > 0)
+        {
+            internal.refresh_token.swap(token_refresh.new_refresh_token);
+            internal.rtok_len = internal.refresh_token.length();
+        }
+
+        // the expiry time was counted from the response time
+        config->signer.tokens.expires = getTime() - (millis() - token_refresh.response_millis) / 1000 + token_refresh.expires_in;
+        config->signer.tokens.last_millis = token_refresh.response_millis;
+
+        if (token_refresh.uid.length() > 0)
+            auth->token.uid = token_refresh.uid.c_str();
+
+        config->signer.tokens.status = token_status_ready;
+        config->signer.tokens.error.code = 0;
+        config->signer.tokens.error.message.clear();
+        internal.fb_last_jwt_generation_error_cb_millis = 0;
+        sendTokenStatusCB();
+    }
+
+    token_refresh.refresh_token.clear();
+    token_refresh.id_token.clear();
+    token_refresh.new_refresh_token.clear();
+    token_refresh.uid.clear();
+    token_refresh_millis.store(0, std::memory_order_relaxed);
+
+    token_refresh_state.store(firebase_token_refresh_idle, std::memory_order_release);
+}
+
+bool FirebaseCore::refreshTokenInTask(Firebase_TCP_Client *client)
+{
+#if defined(PERF_TRACE_ENABLED)
+    FB_PerfScope perf(fb_perf_phase_token, FB_PERF_SESSION_CORE);
+#endif
+
+    token_refresh.error.code = 0;
+    token_refresh.server_time = 0;
+
+    client->stop();
+
+    client->setCACert(nullptr);
+
+    if (!taskNetworkReady(client) || !client->isInitialized())
+        return false;
+
+    client->setBufferSizes(2048, 1024);
+
+    MB_String host;
+    hh.addGAPIsHost(host, firebase_auth_pgm_str_9 /* "securetoken" */);
+
+    client->begin(host.c_str(), 443, &token_refresh.response_code);
+
+    FirebaseJson json;
+    FirebaseJsonData result;
+
+    json.add(pgm2Str(firebase_auth_pgm_str_11 /* "grantType" */), pgm2Str(firebase_auth_pgm_str_12 /* "refresh_token" */));
+    json.add(pgm2Str(firebase_auth_pgm_str_13 /* "refreshToken" */), token_refresh.refresh_token.c_str());
+
+    MB_String req;
+    hh.addRequestHeaderFirst(req, http_post);
+
+    req += firebase_auth_pgm_str_10; // "/v1/token?Key=""
+    req += token_refresh.api_key;
+    hh.addRequestHeaderLast(req);
+
+    hh.addGAPIsHostHeader(req, firebase_auth_pgm_str_9 /* "securetoken" */);
+    hh.addUAHeader(req);
+    hh.addContentLengthHeader(req, strlen(json.raw()));
+    hh.addContentTypeHeader(req, firebase_pgm_str_62 /* "application/json" */);
+    hh.addNewLine(req);
+
+    req += json.raw(); // {"grantType":"refresh_token","refreshToken":"<refresh token>"}
+
+    client->send(req.c_str());
+
+    req.clear();
+    if (token_refresh.response_code < 0)
+        return false;
+
+    int httpCode = FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
+    bool ret = handleTokenResponse(httpCode, client, &json, &token_refresh.server_time);
+    token_refresh.response_millis = millis();
+#if defined(PERF_TRACE_ENABLED)
+    perf.value = httpCode;
+#endif
+    if (!ret)
+        return false;
+
+    if (jh.parse(&json, &result, firebase_storage_ss_pgm_str_16 /* "error/code" */))
+    {
+        token_refresh.error.code = result.to<int>();
+        if (jh.parse(&json, &result, firebase_storage_ss_pgm_str_17 /* "error/message" */))
+            token_refresh.error.message = result.to<const char *>();
+        return false;
+    }
+
+    if (!jh.parse(&json, &result, firebase_auth_pgm_str_14 /* "id_token" */))
+        return false;
+
+    token_refresh.id_token = result.to<const char *>();
+
+    if (jh.parse(&json, &result, firebase_auth_pgm_str_12 /* "refresh_token" */))
+        token_refresh.new_refresh_token = result.to<const char *>();
+
+    token_refresh.expires_in = DEFAULT_AUTH_TOKEN_EXPIRED_SECONDS;
+    if (jh.parse(&json, &result, firebase_auth_pgm_str_15 /* "expires_in" */))
+        token_refresh.expires_in = atoi(result.to<const char *>());
+
+    if (jh.parse(&json, &result, firebase_auth_pgm_str_16 /* "user_id" */))
+        token_refresh.uid = result.to<const char *>();
+
+    return true;
+}
+
+bool FirebaseCore::taskNetworkReady(Firebase_TCP_Client *client, unsigned long dataTime)
+{
+    // The network status, the reconnection and the timeouts of the config belong to the sessions
+    // of loop(), the task checks its own client and reads the timeout.
+    client->setConfig(config, &mbfs);
+
+    if (!client->networkReady())
+        return false;
+
+    unsigned long tmo = DEFAULT_SERVER_RESPONSE_TIMEOUT;
+    if (config && config->timeout.serverResponse >= MIN_SERVER_RESPONSE_TIMEOUT &&
+        config->timeout.serverResponse <= MAX_SERVER_RESPONSE_TIMEOUT)
+        tmo = config->timeout.serverResponse;
+
+    return dataTime == 0 || millis() - dataTime <= tmo;
+}
+
+void FirebaseCore::syncRefreshServerTime()
+{
+    // the Date of the response and the time since it was read
+    if (token_refresh.server_time > 0)
+        syncServerTime(token_refresh.server_time + (millis() - token_refresh.response_millis) / 1000);
+    token_refresh.server_time = 0;
+}
+#endif
+
 void FirebaseCore::newClient(Firebase_TCP_Client **client)
 {
     freeClient(client);
@@ -1045,10 +1410,25 @@ void FirebaseCore::sendTokenStatusCB()
         config->token_status_callback(tokenInfo);
 }
 
-bool FirebaseCore::handleTokenResponse(int &httpCode)
+bool FirebaseCore::handleTokenResponse(int &httpCode, Firebase_TCP_Client *client, FirebaseJson *json, time_t *serverTime)
 {
+    if (!client)
+        client = tcpClient;
 
-    if (!reconnect(tcpClient, nullptr))
+    if (!json)
+        json = jsonPtr;
+
+    // the refresh task doesn't reconnect the network or write the shared network status
+    auto networkReady = [&](unsigned long dataTime)
+    {
+#if defined(ESP32)
+        if (serverTime)
+            return taskNetworkReady(client, dataTime);
+#endif
+        return reconnect(client, nullptr, dataTime);
+    };
+
+    if (!networkReady(0))
         return false;
 
     MB_String header, payload;
@@ -1056,12 +1436,12 @@ bool FirebaseCore::handleTokenResponse(int &httpCode)
     struct server_response_data_t response;
     struct firebase_tcp_response_handler_t tcpHandler;
 
-    hh.intTCPHandler(tcpClient, tcpHandler, 2048, 2048, nullptr, false);
+    hh.intTCPHandler(client, tcpHandler, 2048, 2048, nullptr, false);
 
-    while (tcpClient->connected() && tcpClient->available() == 0)
+    while (client->connected() && client->available() == 0)
     {
         FBUtils::idle();
-        if (!reconnect(tcpClient, nullptr, tcpHandler.dataTime))
+        if (!networkReady(tcpHandler.dataTime))
             return false;
     }
 
@@ -1075,17 +1455,17 @@ bool FirebaseCore::handleTokenResponse(int &httpCode)
     {
         FBUtils::idle();
 
-        if (!reconnect(tcpClient, nullptr, tcpHandler.dataTime))
+        if (!networkReady(tcpHandler.dataTime))
             return false;
 
-        if (!hh.readStatusLine(&sh, &mbfs, tcpClient, tcpHandler, response))
+        if (!hh.readStatusLine(&sh, &mbfs, client, tcpHandler, response))
         {
 
             // The next chunk data can be the remaining http header
             if (tcpHandler.isHeader)
             {
                 // Read header, complete?
-                if (hh.readHeader(&sh, &mbfs, tcpClient, tcpHandler, response))
+                if (hh.readHeader(&sh, &mbfs, client, tcpHandler, response))
                 {
                     if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT)
                         tcpHandler.error.code = 0;
@@ -1101,10 +1481,10 @@ bool FirebaseCore::handleTokenResponse(int &httpCode)
                 // Read the avilable data
                 // chunk transfer encoding?
                 if (response.isChunkedEnc)
-                    tcpHandler.bufferAvailable = hh.readChunkedData(&sh, &mbfs, tcpClient,
+                    tcpHandler.bufferAvailable = hh.readChunkedData(&sh, &mbfs, client,
                                                                     pChunk, nullptr, tcpHandler);
                 else
-                    tcpHandler.bufferAvailable = hh.readLine(tcpClient,
+                    tcpHandler.bufferAvailable = hh.readLine(client,
                                                              pChunk, tcpHandler.chunkBufSize);
 
                 if (tcpHandler.bufferAvailable > 0)
@@ -1126,19 +1506,24 @@ bool FirebaseCore::handleTokenResponse(int &httpCode)
     // To make sure all chunks read and
     // ready to send next request
     if (response.isChunkedEnc)
-        tcpClient->flush();
+        client->flush();
 
     mbfs.delP(&pChunk);
 
-    if (tcpClient->connected())
-        tcpClient->stop();
+    if (client->connected())
+        client->stop();
 
     httpCode = response.httpCode;
 
-    if (jsonPtr && payload.length() > 0 && !response.noContent)
+    if (serverTime)
+        *serverTime = response.date;
+    else
+        syncServerTime(response.date);
+
+    if (json && payload.length() > 0 && !response.noContent)
     {
         // Just a simple JSON which is suitable for parsing in low memory device
-        jsonPtr->setJsonData(payload.c_str());
+        json->setJsonDataLazy(payload.c_str());
         payload.clear();
         return true;
     }
@@ -1148,6 +1533,7 @@ bool FirebaseCore::handleTokenResponse(int &httpCode)
 
 bool FirebaseCore::handleError(int code, const char *descr, int errNum)
 {
+    (void)errNum;
     setTokenError(code);
     config->signer.tokens.error.message.insert(0, descr);
     sendTokenStatusCB();
@@ -1179,7 +1565,7 @@ bool FirebaseCore::createJWT()
         jsonPtr->add(pgm2Str(firebase_auth_pgm_str_18 /* "typ" */), pgm2Str(firebase_auth_pgm_str_28 /* "JWT" */));
 
         size_t len = bh.encodedLength(strlen(jsonPtr->raw()));
-        char *buf = reinterpret_cast<char *>(mbfs.newP(len));
+        char *buf = reinterpret_cast<char *>(mbfs.newP(len, true, mb_alloc_tag_other));
         bh.encodeUrl(&mbfs, buf, (unsigned char *)jsonPtr->raw(), strlen(jsonPtr->raw()));
         config->signer.encHeader = buf;
         mbfs.delP(&buf);
@@ -1274,7 +1660,7 @@ bool FirebaseCore::createJWT()
         }
 
         len = bh.encodedLength(strlen(jsonPtr->raw()));
-        buf = reinterpret_cast<char *>(mbfs.newP(len));
+        buf = reinterpret_cast<char *>(mbfs.newP(len, true, mb_alloc_tag_other));
         bh.encodeUrl(&mbfs, buf, (unsigned char *)jsonPtr->raw(), strlen(jsonPtr->raw()));
         config->signer.encPayload = buf;
         mbfs.delP(&buf);
@@ -1287,7 +1673,7 @@ bool FirebaseCore::createJWT()
 
         // create message digest from encoded header and payload
 
-        config->signer.hash = reinterpret_cast<char *>(mbfs.newP(config->signer.hashSize));
+        config->signer.hash = reinterpret_cast<char *>(mbfs.newP(config->signer.hashSize, true, mb_alloc_tag_other));
         br_sha256_context mc;
         br_sha256_init(&mc);
         br_sha256_update(&mc, config->signer.encHeadPayload.c_str(), config->signer.encHeadPayload.length());
@@ -1334,7 +1720,7 @@ bool FirebaseCore::createJWT()
         mbfs.delP(&config->signer.hash);
 
         size_t len = bh.encodedLength(config->signer.signatureSize);
-        char *buf = reinterpret_cast<char *>(mbfs.newP(len));
+        char *buf = reinterpret_cast<char *>(mbfs.newP(len, true, mb_alloc_tag_other));
         bh.encodeUrl(&mbfs, buf, config->signer.signature, config->signer.signatureSize);
         config->signer.encSignature = buf;
         mbfs.delP(&buf);
@@ -1377,6 +1763,10 @@ bool FirebaseCore::getIdToken(bool createUser, MB_StringPtr email, MB_StringPtr
                         : token_status_on_request))
         return false;
 
+#if defined(PERF_TRACE_ENABLED)
+    FB_PerfScope perf(fb_perf_phase_token, FB_PERF_SESSION_CORE);
+#endif
+
     if (createUser)
     {
         MB_String _email = email, _password = password;
@@ -1431,7 +1821,11 @@ bool FirebaseCore::getIdToken(bool createUser, MB_StringPtr email, MB_StringPtr
     jsonPtr->clear();
 
     int httpCode = FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
-    if (handleTokenResponse(httpCode))
+    bool ret = handleTokenResponse(httpCode);
+#if defined(PERF_TRACE_ENABLED)
+    perf.value = httpCode;
+#endif
+    if (ret)
     {
         struct firebase_auth_token_error_t error;
 
@@ -1799,6 +2193,10 @@ bool FirebaseCore::requestTokens(bool refresh)
     if (!initClient(firebase_pgm_str_61 /* "www" */, refresh ? token_status_on_refresh : token_status_on_request))
         return false;
 
+#if defined(PERF_TRACE_ENABLED)
+    FB_PerfScope perf(fb_perf_phase_token, FB_PERF_SESSION_CORE);
+#endif
+
     MB_String req;
     hh.addRequestHeaderFirst(req, http_post);
 
@@ -1864,7 +2262,11 @@ bool FirebaseCore::requestTokens(bool refresh)
     struct firebase_auth_token_error_t error;
 
     int httpCode = FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
-    if (handleTokenResponse(httpCode))
+    bool ret = handleTokenResponse(httpCode);
+#if defined(PERF_TRACE_ENABLED)
+    perf.value = httpCode;
+#endif
+    if (ret)
     {
         config->signer.tokens.jwt.clear();
         if (jh.parse(jsonPtr, resultPtr, firebase_storage_ss_pgm_str_16 /* "error/code" */))
@@ -2064,6 +2466,13 @@ bool FirebaseCore::tokenReady()
     if (!config)
         return false;
 
+#if defined(ESP32)
+    // read the token state that was published for the background refresh,
+    // the token request and network check are not needed
+    if (tokenPublished() && networkStatus)
+        return true;
+#endif
+
     checkToken();
 
     // call checkToken to send callback before checking connection.
@@ -2268,6 +2677,9 @@ void FirebaseCore::errorToString(int httpCode, MB_String &buff)
     case FIREBASE_ERROR_FW_UPDATE_END_FAILED:
         buff += firebase_ota_err_pgm_str_4; // "Updater end() failed."
         return;
+    case FIREBASE_ERROR_FW_UPDATE_DIGEST_MISMATCH:
+        buff += firebase_ota_err_pgm_str_7; // "firmware SHA-256 digest does not match"
+        return;
 #endif
 
 #if defined(MBFS_FLASH_FS) || defined(MBFS_SD_FS)
@@ -2336,6 +2748,9 @@ void FirebaseCore::errorToString(int httpCode, MB_String &buff)
     case FIREBASE_ERROR_FCM_ID_TOKEN_AT_INDEX_NOT_FOUND:
         buff += firebase_fcm_err_pgm_str_4; // "ID token or registration token was not not found at index"
         return;
+    case FIREBASE_ERROR_FCM_INVALID_TOKEN:
+        buff += firebase_fcm_err_pgm_str_5; // "ID token or registration token contains invalid characters"
+        return;
 
     default:
         // The default case will never be happened.
@@ -35,9 +35,45 @@
 #include "./client/FB_TCP_Client.h"
 #include "./FirebaseFS.h"
 #include "./mbfs/MB_FS.h"
+#if defined(ESP32)
+#include <atomic>
+#endif
 
 using namespace mb_string;
 
+#if defined(ESP32)
+enum firebase_token_refresh_state
+{
+    firebase_token_refresh_idle,
+    // the caller that won the idle state is writing the request
+    firebase_token_refresh_requesting,
+    firebase_token_refresh_requested,
+    firebase_token_refresh_done,
+    firebase_token_refresh_failed,
+    firebase_token_refresh_applying
+};
+
+/* The data exchanged with the background token refresh task.
+ * The request is written by the caller that moved the state from idle to requesting and
+ * is published with the requested state, the response is written by the task before the
+ * done or failed state was set.
+ */
+struct firebase_token_refresh_t
+{
+    MB_String refresh_token;
+    MB_String api_key;
+    MB_String id_token;
+    MB_String new_refresh_token;
+    MB_String uid;
+    unsigned long expires_in = 0;
+    unsigned long response_millis = 0;
+    // the Date of the response, the clock is set with it by the caller
+    time_t server_time = 0;
+    int response_code = 0;
+    struct firebase_auth_token_error_t error;
+};
+#endif
+
 class FirebaseCore
 {
     friend class FIREBASE_CLASS;
@@ -55,6 +91,7 @@ class FirebaseCore
 
     friend class FIREBASE_STREAM_CLASS;
     friend class FIREBASE_MP_STREAM_CLASS;
+    friend class FirebaseSSEParser;
     friend class UtilsClass;
     friend class FB_RTDB;
     friend class FirebaseData;
@@ -101,6 +138,20 @@ private:
     volatile bool networkStatus = false;
     bool networkChecking = false;
 
+#if defined(ESP32)
+    TaskHandle_t token_refresh_task_handle = NULL;
+    volatile bool token_refresh_task_enable = false;
+    std::atomic<uint8_t> token_refresh_state{firebase_token_refresh_idle};
+    // The id token is valid and refreshed by the background task
+    std::atomic<bool> token_published{false};
+    // The millis when the token state was published, the time from then to the refresh and to the expiry
+    std::atomic<unsigned long> token_published_ms{0};
+    std::atomic<unsigned long> token_refresh_in_ms{0};
+    std::atomic<unsigned long> token_expire_in_ms{0};
+    struct firebase_token_refresh_t token_refresh;
+    std::atomic<unsigned long> token_refresh_millis{0};
+#endif
+
     /* intitialize the class */
     void begin(FirebaseConfig *config, FirebaseAuth *auth);
     /* free memory */
@@ -145,6 +196,8 @@ private:
     bool timeReady();
     void timeBegin();
     void readNTPTime();
+    /* set the clock from the server response Date header when it was not set */
+    void syncServerTime(time_t ts);
 
     /* exchane the auth token with the refresh token */
     bool refreshToken();
@@ -156,8 +209,29 @@ private:
     void freeClient(Firebase_TCP_Client **client);
     /* handle the token processing task error */
     bool handleTaskError(int code, int httpCode = 0);
-    // parse the auth token response
-    bool handleTokenResponse(int &httpCode);
+    // parse the auth token response, with serverTime (the refresh task) the network is only checked
+    // and the response Date is returned instead of setting the clock
+    bool handleTokenResponse(int &httpCode, Firebase_TCP_Client *client = nullptr, FirebaseJson *json = nullptr,
+                             time_t *serverTime = nullptr);
+#if defined(ESP32)
+    /* start the task that refreshes the id token before it expires */
+    bool beginTokenRefreshTask();
+    /* stop the background token refresh task */
+    void endTokenRefreshTask();
+    /* swap in the refreshed token, request the refresh when due and publish the token state */
+    bool handleTokenRefreshTask(time_t now);
+    /* lock-free read of the published token state, true when the token is usable and nothing to do */
+    bool tokenPublished();
+    void publishToken(bool usable, time_t now);
+    /* apply the token that was refreshed by the background task */
+    void applyRefreshedToken();
+    /* exchange the refresh token with the task's own client */
+    bool refreshTokenInTask(Firebase_TCP_Client *client);
+    /* the network check of the task, the shared status and config are only read */
+    bool taskNetworkReady(Firebase_TCP_Client *client, unsigned long dataTime = 0);
+    /* set the clock with the Date of the refresh response */
+    void syncRefreshServerTime();
+#endif
     /* process the tokens (generation, signing, request and refresh) */
     void tokenProcessingTask();
     bool handleError(int code, const char *descr, int errNum = 0);
@@ -529,6 +529,8 @@ bool FB_Firestore::firestore_sendRequest(FirebaseData *fbdo, struct firebase_fir
     bool ret = false;
     bool hasParam = false;
     MB_String header;
+    // the whole request header is sent at once, reserve for the token and the common header lines
+    header.reserve(strlen(Core.getToken()) + 512);
     firebase_request_method method = http_undefined;
     if (req->requestType == firebase_firestore_request_type_get_doc ||
         req->requestType == firebase_firestore_request_type_list_doc ||
@@ -680,35 +682,19 @@ bool FB_Firestore::firestore_sendRequest(FirebaseData *fbdo, struct firebase_fir
         Core.hh.addContentLengthHeader(header, req->payload.length());
     }
 
-    Core.hh.addGAPIsHostHeader(header, firebase_cfs_pgm_str_55 /* "firestore." */);
+    // session host was set in connect
+    header += Core.hh.getHeaderTemplate(&Core.sh, fbdo->session.header_tmpl[firebase_header_template_firestore],
+                                        fbdo->session.host.c_str(), Core.config->signer.customHeaders,
+                                        Core.config->signer.test_mode ? nullptr : Core.getToken(), Core.getTokenType());
 
-    if (!Core.config->signer.test_mode)
-    {
-
-        Core.hh.addAuthHeaderFirst(header, Core.getTokenType());
-        fbdo->tcpClient.send(header.c_str());
-        header.clear();
-
-        if (fbdo->session.response.code < 0)
-            return false;
-
-        fbdo->tcpClient.send(Core.getToken());
-
-        if (fbdo->session.response.code < 0)
-            return false;
-
-        Core.hh.addNewLine(header);
-    }
-
-    Core.hh.addUAHeader(header);
     bool keepAlive = false;
 #if defined(USE_CONNECTION_KEEP_ALIVE_MODE)
     keepAlive = true;
 #endif
     Core.hh.addConnectionHeader(header, keepAlive);
-    Core.hh.getCustomHeaders(&Core.sh,header, Core.config->signer.customHeaders);
     Core.hh.addNewLine(header);
     fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
+    fbdo->tcpClient.cork();
     fbdo->tcpClient.send(header.c_str());
 
     if (fbdo->session.response.code < 0)
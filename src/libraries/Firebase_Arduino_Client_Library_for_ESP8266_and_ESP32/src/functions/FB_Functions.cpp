@@ -637,6 +637,7 @@ bool FB_Functions::functions_sendRequest(FirebaseData *fbdo, struct firebase_fun
 
     fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
 
+    fbdo->tcpClient.cork();
     fbdo->tcpSend(header.c_str());
     if (fbdo->session.response.code < 0)
         return false;
@@ -196,7 +196,11 @@ bool GG_CloudStorage::mDownload(FirebaseData *fbdo, MB_StringPtr bucketID, MB_St
 bool GG_CloudStorage::mDownloadOTA(FirebaseData *fbdo, MB_StringPtr bucketID,
                                    MB_StringPtr remoteFileName, DownloadProgressCallback callback)
 {
-#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
+    (void)fbdo;
+    (void)bucketID;
+    (void)remoteFileName;
+    (void)callback;
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST))
     struct firebase_gcs_req_t req;
     req.bucketID = bucketID;
     req.remoteFileName = remoteFileName;
@@ -354,14 +358,7 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
                 if (req->fileSize < gcs_min_chunkSize)
                     req->requestType = firebase_gcs_request_type_upload_multipart;
                 else
-                {
-                    uint32_t chunkLen = req->fileSize / 4;
-                    uint32_t factor = (chunkLen / gcs_min_chunkSize);
-                    if (factor * gcs_min_chunkSize < gcs_min_chunkSize)
-                        gcs_chunkSize = gcs_min_chunkSize;
-                    else
-                        gcs_chunkSize = factor * gcs_min_chunkSize;
-                }
+                    req->chunkSize = getChunkSize(req->fileSize);
             }
         }
     }
@@ -494,6 +491,8 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
     {
         Core.hh.addGAPIsHostHeader(header, firebase_pgm_str_61 /* "www" */);
 
+        fbdo->tcpClient.cork();
+
         if (!Core.config->signer.test_mode)
         {
             Core.hh.addAuthHeaderFirst(header, Core.getTokenType());
@@ -589,19 +588,30 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
 
         Core.hh.addContentLengthHeader(header, strlen(fbdo->session.jsonPtr->raw()));
     }
+    else if (req->requestType == firebase_gcs_request_type_upload_resumable_run && req->queryStatus)
+    {
+        // ask for the last committed byte of the interrupted upload
+        Core.hh.addContentLengthHeader(header, 0);
+        header += firebase_gcs_pgm_str_11; // "Content-Range: bytes "
+        header += firebase_gcs_pgm_str_49; // "*/"
+        header += req->fileSize;
+        Core.hh.addNewLine(header);
+    }
     else if (req->requestType == firebase_gcs_request_type_upload_resumable_run)
     {
+        if (req->chunkSize == 0)
+            req->chunkSize = getChunkSize(req->fileSize);
 
         req->chunkPos = req->chunkRange + 1;
-        if (req->chunkRange == -1 && req->fileSize <= gcs_chunkSize)
+        if (req->chunkRange == -1 && req->fileSize <= req->chunkSize)
             req->chunkLen = req->fileSize;
-        else if (req->chunkRange == -1 && req->fileSize > gcs_chunkSize)
-            req->chunkLen = gcs_chunkSize;
+        else if (req->chunkRange == -1 && req->fileSize > req->chunkSize)
+            req->chunkLen = req->chunkSize;
         else if (req->chunkRange != -1)
         {
             int b = req->fileSize - req->chunkRange;
-            if (b > (int)gcs_chunkSize)
-                req->chunkLen = gcs_chunkSize;
+            if (b > (int)req->chunkSize)
+                req->chunkLen = req->chunkSize;
             else
                 req->chunkLen = b - 1;
         }
@@ -679,19 +689,21 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
             {
                 if (available > bufLen)
                     available = bufLen;
-                read = Core.mbfs.read(mbfs_type req->storageType, buf, available);
 
-                byteRead += read;
+                // the file is read into the SSL output buffer directly if possible, buf is used otherwise
+                read = fbdo->tcpWriteFile(req->storageType, buf, available);
 
-                reportUploadProgress(fbdo, req, byteRead);
-
-                if ((int)fbdo->tcpWrite(buf, read) != read)
+                if (read <= 0)
                 {
                     fbdo->session.response.code = FIREBASE_ERROR_UPLOAD_DATA_ERRROR;
                     fbdo->closeSession();
                     break;
                 }
 
+                byteRead += read;
+
+                reportUploadProgress(fbdo, req, byteRead);
+
                 available = Core.mbfs.available(mbfs_type req->storageType);
             }
 
@@ -711,66 +723,12 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
 
             reportUploadProgress(fbdo, req, req->fileSize);
         }
-        else if (req->requestType == firebase_gcs_request_type_upload_resumable_run)
+        else if (req->requestType == firebase_gcs_request_type_upload_resumable_run && !req->queryStatus)
         {
-            size_t byteRead = 0;
-            int available = 0;
-
-            int bufLen = Core.ut.getUploadBufSize(Core.config, firebase_con_mode_gc_storage);
-            uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(bufLen + 1));
-            int read = 0;
-            size_t totalBytes = req->fileSize;
-
-            if (req->chunkRange != -1 || req->location.length() > 0)
-            {
-                // Fix in ESP32 core 2.0.x
-                Core.mbfs.close(mbfs_type req->storageType);
-                Core.mbfs.open(req->localFileName, mbfs_type req->storageType, mb_fs_open_mode_read);
-                byteRead = req->chunkPos;
-                Core.mbfs.seek(mbfs_type req->storageType, req->chunkPos);
-                totalBytes = req->chunkPos + req->chunkLen;
-            }
-
-            available = totalBytes;
-
             reportUploadProgress(fbdo, req, req->chunkPos);
 
-            while (byteRead < totalBytes)
-            {
-                FBUtils::idle();
-                if (available > bufLen)
-                    available = bufLen;
-                read = Core.mbfs.read(mbfs_type req->storageType, buf, available);
-
-                if (fbdo->tcpClient.connected())
-                {
-                    if ((int)fbdo->tcpWrite(buf, read) != read)
-                    {
-                        fbdo->session.response.code = FIREBASE_ERROR_UPLOAD_DATA_ERRROR;
-                        fbdo->closeSession();
-                        break;
-                    }
-                }
-                else
-                {
-                    fbdo->session.response.code = FIREBASE_ERROR_UPLOAD_DATA_ERRROR;
-                    fbdo->closeSession();
-                    break;
-                }
-
-                byteRead += read;
-
-                reportUploadProgress(fbdo, req, byteRead);
-
-                available = Core.mbfs.available(mbfs_type req->storageType);
-                if (byteRead + available > totalBytes)
-                    available = totalBytes - byteRead;
-            }
-
-            Core.mbfs.delP(&buf);
-
-            if (Core.mbfs.available(mbfs_type req->storageType) == 0)
-                Core.mbfs.close(mbfs_type req->storageType);
+            if (!sendChunk(fbdo, req, req->chunkPos, req->chunkLen))
+                fbdo->closeSession();
         }
 
         if (fbdo->tcpClient.connected())
@@ -801,14 +759,13 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
                 }
                 else if (req->requestType == firebase_gcs_request_type_upload_resumable_run)
                 {
-                    if (Core.mbfs.available(mbfs_type req->storageType) == 0)
+                    // no incomplete (308) status, all bytes were committed
+                    if (!req->incomplete)
                     {
                         UploadStatusInfo in;
                         makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_upload_status_complete,
                                          100, 0, 0, "");
                         sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
-                        fbdo->session.long_running_task -= _resumableUploadTasks.size();
-                        _resumableUploadTasks.clear();
                     }
                 }
                 return true;
@@ -824,7 +781,6 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
         sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
     }
     else if (req->requestType == firebase_gcs_request_type_upload_resumable_init ||
-             req->requestType == firebase_gcs_request_type_upload_resumable_run ||
              req->requestType == firebase_gcs_request_type_upload_simple ||
              req->requestType == firebase_gcs_request_type_upload_multipart)
     {
@@ -832,8 +788,6 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
         makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_upload_status_error,
                          0, 0, 0, fbdo->errorReason());
         sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
-        fbdo->session.long_running_task -= _resumableUploadTasks.size();
-        _resumableUploadTasks.clear();
     }
 
     if (Core.mbfs.ready(mbfs_type req->storageType) && req->requestType == firebase_gcs_request_type_download)
@@ -1053,12 +1007,186 @@ void GG_CloudStorage::makeDownloadStatus(DownloadStatusInfo &info, const MB_Stri
     info.errorMsg = msg;
 }
 
+uint32_t GG_CloudStorage::getChunkSize(size_t fileSize)
+{
+    // Except the last chunk, the chunk size should be the multiple of 256 KiB.
+    uint32_t chunkLen = Core.config->gcs.upload_chunk_size > 0 ? Core.config->gcs.upload_chunk_size : fileSize / 4;
+    uint32_t factor = chunkLen / gcs_min_chunkSize;
+    return factor > 0 ? factor * gcs_min_chunkSize : gcs_min_chunkSize;
+}
+
+bool GG_CloudStorage::sendChunk(FirebaseData *fbdo, struct firebase_gcs_req_t *req, size_t offset, size_t len)
+{
+    int bufLen = Core.ut.getUploadBufSize(Core.config, firebase_con_mode_gc_storage);
+
+    // Fix in ESP32 core 2.0.x
+    Core.mbfs.close(mbfs_type req->storageType);
+    int ret = Core.mbfs.open(req->localFileName, mbfs_type req->storageType, mb_fs_open_mode_read);
+    if (ret < 0)
+    {
+        fbdo->session.response.code = ret;
+        return false;
+    }
+
+    Core.mbfs.seek(mbfs_type req->storageType, offset);
+
+    size_t sent = 0;
+    bool success = true;
+
+#if defined(ESP32)
+    struct gcs_chunk_reader_t reader;
+    reader.storageType = req->storageType;
+    reader.bufLen = bufLen;
+    reader.remaining = len;
+
+    if (startChunkReader(reader))
+    {
+        int i = 0;
+        while (sent < len)
+        {
+            FBUtils::idle();
+
+            xSemaphoreTake(reader.filled, portMAX_DELAY);
+
+            if (reader.len[i] <= 0 || !fbdo->tcpClient.connected() ||
+                (int)fbdo->tcpWrite(reader.buf[i], reader.len[i]) != reader.len[i])
+            {
+                success = false;
+                break;
+            }
+
+            sent += reader.len[i];
+
+            // the buffer is free to read the next part
+            xSemaphoreGive(reader.empty);
+
+            reportUploadProgress(fbdo, req, offset + sent);
+
+            i = 1 - i;
+        }
+
+        stopChunkReader(reader);
+    }
+    else
+#endif
+    {
+        uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(bufLen + 1, false));
+
+        while (buf && sent < len)
+        {
+            FBUtils::idle();
+
+            int read = fbdo->tcpWriteFile(req->storageType, buf, len - sent > (size_t)bufLen ? bufLen : len - sent);
+
+            if (read <= 0)
+                break;
+
+            sent += read;
+
+            reportUploadProgress(fbdo, req, offset + sent);
+        }
+
+        Core.mbfs.delP(&buf);
+        success = sent == len;
+    }
+
+    Core.mbfs.close(mbfs_type req->storageType);
+
+    if (!success)
+        fbdo->session.response.code = FIREBASE_ERROR_UPLOAD_DATA_ERRROR;
+
+    return success;
+}
+
+#if defined(ESP32)
+bool GG_CloudStorage::startChunkReader(struct gcs_chunk_reader_t &reader)
+{
+    reader.buf[0] = reinterpret_cast<uint8_t *>(Core.mbfs.newP(reader.bufLen, false));
+    reader.buf[1] = reinterpret_cast<uint8_t *>(Core.mbfs.newP(reader.bufLen, false));
+    reader.filled = xSemaphoreCreateCounting(2, 0);
+    reader.empty = xSemaphoreCreateCounting(2, 2);
+    reader.done = xSemaphoreCreateBinary();
+
+    TaskFunction_t taskCode = [](void *param)
+    {
+        struct gcs_chunk_reader_t *r = reinterpret_cast<struct gcs_chunk_reader_t *>(param);
+        int i = 0;
+
+        while (r->remaining > 0)
+        {
+            xSemaphoreTake(r->empty, portMAX_DELAY);
+
+            if (r->abort)
+                break;
+
+            r->len[i] = Core.mbfs.read(mbfs_type r->storageType, r->buf[i],
+                                       r->remaining > (size_t)r->bufLen ? r->bufLen : r->remaining);
+
+            // stop reading at the file error, the sender sees the zero length
+            r->remaining = r->len[i] > 0 ? r->remaining - r->len[i] : 0;
+
+            xSemaphoreGive(r->filled);
+
+            i = 1 - i;
+        }
+
+        xSemaphoreGive(r->done);
+        vTaskDelete(NULL);
+    };
+
+    // The reader runs on the other core while this task waits for the TLS write.
+    if (reader.buf[0] && reader.buf[1] && reader.filled && reader.empty && reader.done &&
+        xTaskCreatePinnedToCore(taskCode, pgm2Str(firebase_gcs_pgm_str_50 /* "gcsChunkReader" */), 6000,
+                                &reader, 3, NULL, 0) == pdPASS)
+        return true;
+
+    // no reader task to wait for
+    if (reader.done)
+    {
+        vSemaphoreDelete(reader.done);
+        reader.done = NULL;
+    }
+
+    stopChunkReader(reader);
+    return false;
+}
+
+void GG_CloudStorage::stopChunkReader(struct gcs_chunk_reader_t &reader)
+{
+    if (reader.done)
+    {
+        // wake up the reader which waits for the free buffer, and wait until it exits
+        reader.abort = true;
+        xSemaphoreGive(reader.empty);
+        xSemaphoreTake(reader.done, portMAX_DELAY);
+        vSemaphoreDelete(reader.done);
+        reader.done = NULL;
+    }
+
+    if (reader.filled)
+        vSemaphoreDelete(reader.filled);
+
+    if (reader.empty)
+        vSemaphoreDelete(reader.empty);
+
+    reader.filled = NULL;
+    reader.empty = NULL;
+
+    Core.mbfs.delP(&reader.buf[0]);
+    Core.mbfs.delP(&reader.buf[1]);
+}
+#endif
+
 void GG_CloudStorage::mRunResumableUploadTask()
 {
     if (Core.internal.resumable_upload_loop_task_enabnle)
     {
 #if defined(ESP32)
 
+        // the running task takes the tasks of all sessions
+        if (Core.internal.resumable_upload_task_handle)
+            return;
+
         static GG_CloudStorage *_this = this;
         MB_String taskName = "ResumableUpload_";
         taskName += random(1,100);
@@ -1102,20 +1230,37 @@ bool GG_CloudStorage::mRunResumableUpload()
     if (_resumableUploadTasks.size() == 0)
         return false;
 
-    if (_resumableUplaodTaskIndex < _resumableUploadTasks.size() - 1)
-        _resumableUplaodTaskIndex++;
-    else
+    if (_resumableUplaodTaskIndex >= _resumableUploadTasks.size())
         _resumableUplaodTaskIndex = 0;
 
-    struct fb_gcs_upload_resumable_task_info_t *taskInfo = &_resumableUploadTasks[_resumableUplaodTaskIndex];
+    // The task was taken out from the queue before running, the next chunk task of this upload
+    // will be added to the end of queue which lets the uploads of other sessions run in between.
+    struct fb_gcs_upload_resumable_task_info_t taskInfo = _resumableUploadTasks[_resumableUplaodTaskIndex];
 
-    if (!taskInfo->done)
+    // wait for the network before sending the chunk or resuming the upload
+    if (!taskInfo.fbdo->reconnect())
     {
-        taskInfo->done = true;
-        if (!gcs_sendRequest(taskInfo->fbdo, &taskInfo->req))
-            taskInfo->fbdo->closeSession();
+        _resumableUplaodTaskIndex++;
+        return true;
     }
 
+    _resumableUploadTasks.erase(_resumableUploadTasks.begin() + _resumableUplaodTaskIndex);
+
+    if (!gcs_sendRequest(taskInfo.fbdo, &taskInfo.req))
+    {
+        // resend the interrupted chunk from the last committed byte
+        if (!resumeUpload(taskInfo.fbdo, &taskInfo.req))
+        {
+            UploadStatusInfo in;
+            makeUploadStatus(in, taskInfo.req.localFileName, taskInfo.req.remoteFileName, firebase_gcs_upload_status_error,
+                             0, 0, 0, taskInfo.fbdo->errorReason());
+            sendUploadCallback(taskInfo.fbdo, in, taskInfo.req.uploadCallback, taskInfo.req.uploadStatusInfo);
+        }
+        taskInfo.fbdo->closeSession();
+    }
+
+    taskInfo.fbdo->session.long_running_task--;
+
     mResumableUploadUpdate();
 
     return _resumableUploadTasks.size() > 0;
@@ -1123,16 +1268,8 @@ bool GG_CloudStorage::mRunResumableUpload()
 
 void GG_CloudStorage::mResumableUploadUpdate()
 {
-    size_t n = 0;
-    for (size_t i = 0; i < _resumableUploadTasks.size(); i++)
-        if (_resumableUploadTasks[i].done)
-            n++;
-
-    if (n == _resumableUploadTasks.size())
-    {
-        _resumableUploadTasks.clear();
+    if (_resumableUploadTasks.size() == 0)
         _resumable_upload_task_enable = false;
-    }
 }
 
 void GG_CloudStorage::runResumableUploadTask()
@@ -1148,6 +1285,40 @@ void GG_CloudStorage::runResumableUploadTask()
         mRunResumableUploadTask();
 }
 
+void GG_CloudStorage::addResumableTask(FirebaseData *fbdo, struct firebase_gcs_req_t *req, const MB_String &location,
+                                       int chunkRange, bool queryStatus, uint8_t resumeRetry)
+{
+    struct fb_gcs_upload_resumable_task_info_t ruTask;
+    fbdo->createResumableTask(ruTask, req->fileSize, location, req->localFileName, req->remoteFileName,
+                              req->storageType, firebase_gcs_request_type_upload_resumable_run);
+    ruTask.req.chunkRange = chunkRange;
+    ruTask.req.chunkSize = req->chunkSize;
+    ruTask.req.queryStatus = queryStatus;
+    ruTask.req.resumeRetry = resumeRetry;
+    ruTask.req.uploadCallback = req->uploadCallback;
+    ruTask.req.uploadStatusInfo = req->uploadStatusInfo;
+    _resumableUploadTasks.push_back(ruTask);
+
+    fbdo->session.long_running_task++;
+    _resumable_upload_task_enable = true;
+}
+
+bool GG_CloudStorage::resumeUpload(FirebaseData *fbdo, struct firebase_gcs_req_t *req)
+{
+    if (req->resumeRetry >= Core.config->gcs.upload_resume_retry)
+        return false;
+
+    // The client error e.g. invalid or expired upload session can't be resumed.
+    int code = fbdo->session.response.code;
+    if (code >= FIREBASE_ERROR_HTTP_CODE_BAD_REQUEST && code < FIREBASE_ERROR_HTTP_CODE_INTERNAL_SERVER_ERROR &&
+        code != FIREBASE_ERROR_HTTP_CODE_REQUEST_TIMEOUT && code != FIREBASE_ERROR_HTTP_CODE_TOO_MANY_REQUESTS)
+        return false;
+
+    // Query the committed range (308 response with Range header) before sending the rest of file.
+    addResumableTask(fbdo, req, req->location, -1, true, req->resumeRetry + 1);
+    return true;
+}
+
 bool GG_CloudStorage::handleResponse(FirebaseData *fbdo, struct firebase_gcs_req_t *req)
 {
 
@@ -1208,41 +1379,25 @@ bool GG_CloudStorage::handleResponse(FirebaseData *fbdo, struct firebase_gcs_req
 
             if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT) // resume incomplete
             {
+                req->incomplete = true;
+
+                // no Range header, no byte was committed, start over from the first byte
+                int chunkRange = -1;
                 int p1 = 0;
                 if (Core.sh.find(tcpHandler.header, firebase_gcs_pgm_str_48 /* "Range: bytes=0-" */, false, 0, p1))
-                {
-                    if (_resumableUploadTasks.size() > 0)
-                    {
-                        struct fb_gcs_upload_resumable_task_info_t ruTask;
-                        fbdo->createResumableTask(ruTask, req->fileSize, req->location,
-                                                  req->localFileName, req->remoteFileName, req->storageType,
-                                                  firebase_gcs_request_type_upload_resumable_run);
-                        ruTask.req.chunkRange = atoi(tcpHandler.header.substr(p1 + strlen_P(firebase_gcs_pgm_str_48 /* "Range: bytes=0-" */),
-                                                                              tcpHandler.header.length() - p1 - strlen_P(firebase_gcs_pgm_str_48 /* "Range: bytes=0-" */))
-                                                         .c_str());
-                        ruTask.req.uploadCallback = req->uploadCallback;
-                        ruTask.req.uploadStatusInfo = req->uploadStatusInfo;
-                        _resumableUploadTasks.push_back(ruTask);
-
-                        fbdo->session.long_running_task++;
-                        _resumable_upload_task_enable = true;
-                    }
-                }
-            }
-            else if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.location.length() > 0)
-            {
-                struct fb_gcs_upload_resumable_task_info_t ruTask;
-                fbdo->createResumableTask(ruTask, req->fileSize, response.location, req->localFileName,
-                                          req->remoteFileName, req->storageType, firebase_gcs_request_type_upload_resumable_run);
-                ruTask.req.uploadCallback = req->uploadCallback;
-                ruTask.req.uploadStatusInfo = req->uploadStatusInfo;
-                _resumableUploadTasks.push_back(ruTask);
-
-                fbdo->session.long_running_task++;
-                _resumable_upload_task_enable = true;
+                    chunkRange = atoi(tcpHandler.header.substr(p1 + strlen_P(firebase_gcs_pgm_str_48 /* "Range: bytes=0-" */),
+                                                               tcpHandler.header.length() - p1 - strlen_P(firebase_gcs_pgm_str_48 /* "Range: bytes=0-" */))
+                                          .c_str());
+
+                // the retry count is kept until the chunk after the resumption was committed
+                addResumableTask(fbdo, req, req->location, chunkRange, false, req->queryStatus ? req->resumeRetry : 0);
             }
+            else if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.location.length() > 0 &&
+                     req->requestType == firebase_gcs_request_type_upload_resumable_init)
+                addResumableTask(fbdo, req, response.location, -1, false, 0);
 
-            if (_resumable_upload_task_enable && _resumableUploadTasks.size() == 1)
+            if (_resumable_upload_task_enable && _resumableUploadTasks.size() == 1 &&
+                req->requestType == firebase_gcs_request_type_upload_resumable_init)
                 mRunResumableUploadTask();
 
             if (_resumable_upload_task_enable && response.contentLen == 0)
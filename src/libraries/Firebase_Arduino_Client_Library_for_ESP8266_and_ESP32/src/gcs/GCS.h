@@ -190,11 +190,28 @@ public:
 
 private:
     const uint32_t gcs_min_chunkSize = 256 * 1024; // Min Google recommended length
-    uint32_t gcs_chunkSize = 256 * 1024;
     bool _resumable_upload_task_enable = false;
     MB_VECTOR<struct fb_gcs_upload_resumable_task_info_t> _resumableUploadTasks;
     size_t _resumableUplaodTaskIndex = 0;
 
+#if defined(ESP32)
+    // The double buffers which the next part of chunk is read from file while the current part is sent.
+    struct gcs_chunk_reader_t
+    {
+        firebase_mem_storage_type storageType = mem_storage_type_undefined;
+        uint8_t *buf[2] = {nullptr, nullptr};
+        int len[2] = {0, 0};
+        int bufLen = 0;
+        size_t remaining = 0;
+        volatile bool abort = false;
+        SemaphoreHandle_t filled = NULL;
+        SemaphoreHandle_t empty = NULL;
+        SemaphoreHandle_t done = NULL;
+    };
+    bool startChunkReader(struct gcs_chunk_reader_t &reader);
+    void stopChunkReader(struct gcs_chunk_reader_t &reader);
+#endif
+
     void rescon(FirebaseData *fbdo, const char *host);
     void setGetOptions(struct firebase_gcs_req_t *req, MB_String &header, bool hasParams);
     void setListOptions(struct firebase_gcs_req_t *req, MB_String &header, bool hasParams);
@@ -228,6 +245,11 @@ private:
     bool mDeleteFile(FirebaseData *fbdo, MB_StringPtr bucketID, MB_StringPtr fileName, DeleteOptions *options = nullptr);
     bool mListFiles(FirebaseData *fbdo, MB_StringPtr bucketID, ListOptions *options = nullptr);
     bool parseJsonResponse(FirebaseData *fbdo, PGM_P key_path);
+    uint32_t getChunkSize(size_t fileSize);
+    bool sendChunk(FirebaseData *fbdo, struct firebase_gcs_req_t *req, size_t offset, size_t len);
+    void addResumableTask(FirebaseData *fbdo, struct firebase_gcs_req_t *req, const MB_String &location,
+                          int chunkRange, bool queryStatus, uint8_t resumeRetry);
+    bool resumeUpload(FirebaseData *fbdo, struct firebase_gcs_req_t *req);
     bool mRunResumableUpload();
     void mResumableUploadUpdate();
     void mRunResumableUploadTask();
@@ -43,7 +43,15 @@
 
 FirebaseJsonBase::FirebaseJsonBase()
 {
-    MB_JSON_InitHooks(&MB_JSON_hooks);
+    MB_JSON_InitHooks(fb_js_user_hooks() ? fb_js_user_hooks() : &MB_JSON_hooks);
+}
+
+bool FirebaseJsonBase::setHooks(MB_JSON_Hooks *hooks)
+{
+    if (!MB_JSON_InitHooks(hooks ? hooks : &MB_JSON_hooks))
+        return false;
+    fb_js_user_hooks() = hooks;
+    return true;
 }
 
 FirebaseJsonBase::~FirebaseJsonBase()
@@ -58,6 +66,7 @@ FirebaseJsonBase &FirebaseJsonBase::mClear()
         MB_JSON_Delete(root);
     root = NULL;
     buf.clear();
+    mTapeEnd();
     errorPos = -1;
     return *this;
 }
@@ -72,6 +81,8 @@ void FirebaseJsonBase::mCopy(FirebaseJsonBase &other)
     this->root_type = other.root_type;
     this->iterator_data = other.iterator_data;
     this->buf = other.buf;
+    if (this->iterator_data.buf_ptr != NULL)
+        this->iterator_data.buf_ptr = this->buf.c_str();
 }
 
 bool FirebaseJsonBase::setRaw(const char *raw)
@@ -101,6 +112,273 @@ bool FirebaseJsonBase::setRaw(const char *raw)
     return root != NULL;
 }
 
+bool FirebaseJsonBase::setRawLazy(const char *raw)
+{
+    mClear();
+
+    // the object after the spaces as setRaw, the other data is set as setRaw
+    size_t i = 0;
+    while (raw && raw[i] == ' ')
+        i++;
+
+    if (raw && raw[i] == '{')
+    {
+        tapeRaw = raw;
+        this->root_type = Root_Type_JSON;
+        if (mTapeBuild())
+            return true;
+        mTapeEnd();
+    }
+
+    // not an object or not valid, the error position is reported by the tree parser
+    return setRaw(raw);
+}
+
+bool FirebaseJsonBase::mTapeBuild()
+{
+    // one pass over the raw buffer, the entries keep the value positions and the subtree sizes
+    // so the path lookup skips the elements which are not on the path
+    const char *s = tapeRaw.c_str();
+    size_t n = tapeRaw.length();
+    MB_VECTOR<uint32_t> open; // the entries of the open objects and arrays
+    tape_state state = tape_state_value;
+    size_t i = tapeSkipSpace(0);
+
+    if (i == n || s[i] != '{')
+        return false;
+
+    while (true)
+    {
+        i = tapeSkipSpace(i);
+        if (i == n)
+            return false;
+
+        struct tape_entry_t e;
+        e.ofs = i;
+
+        if (state == tape_state_key)
+        {
+            size_t end = s[i] == '"' ? tapeStringEnd(i) : 0;
+            if (end == 0)
+                return false;
+            e.ofs = i + 1;
+            e.len = end - i - 1;
+            e.type = MB_JSON_Invalid;
+            tape.push_back(e);
+            i = tapeSkipSpace(end + 1);
+            if (i == n || s[i] != ':')
+                return false;
+            i++;
+            state = tape_state_value;
+        }
+        else if (state == tape_state_value)
+        {
+            if (s[i] == '{' || s[i] == '[')
+            {
+                if (open.size() >= MB_JSON_NESTING_LIMIT)
+                    return false;
+                char close = s[i] == '{' ? '}' : ']';
+                e.type = s[i] == '{' ? MB_JSON_Object : MB_JSON_Array;
+                uint32_t index = tape.size();
+                open.push_back(index);
+                tape.push_back(e);
+                i = tapeSkipSpace(i + 1);
+                if (i < n && s[i] == close)
+                    state = tape_state_next;
+                else
+                    state = e.type == MB_JSON_Object ? tape_state_key : tape_state_value;
+                continue;
+            }
+
+            if (s[i] == '"')
+            {
+                size_t end = tapeStringEnd(i);
+                if (end == 0)
+                    return false;
+                e.type = MB_JSON_String;
+                e.len = end + 1 - i;
+            }
+            else if (strncmp(s + i, (const char *)MBSTRING_FLASH_MCR("true"), 4) == 0)
+            {
+                e.type = MB_JSON_True;
+                e.len = 4;
+            }
+            else if (strncmp(s + i, (const char *)MBSTRING_FLASH_MCR("false"), 5) == 0)
+            {
+                e.type = MB_JSON_False;
+                e.len = 5;
+            }
+            else if (strncmp(s + i, (const char *)MBSTRING_FLASH_MCR("null"), 4) == 0)
+            {
+                e.type = MB_JSON_NULL;
+                e.len = 4;
+            }
+            else if (s[i] == '-' || (s[i] >= '0' && s[i] <= '9'))
+            {
+                // the characters strtod takes from the span of the tree parser, at most 63
+                char num[64];
+                size_t len = 0;
+                while (len < sizeof(num) - 1 && i + len < n && strchr((const char *)MBSTRING_FLASH_MCR("0123456789+-eE."), s[i + len]) != NULL)
+                {
+                    num[len] = s[i + len];
+                    len++;
+                }
+                num[len] = '\0';
+                char *numEnd = NULL;
+                strtod(num, &numEnd);
+                if (numEnd == num)
+                    return false;
+                e.type = MB_JSON_Number;
+                e.len = numEnd - num;
+            }
+            else
+                return false;
+
+            tape.push_back(e);
+            i += e.len;
+            state = tape_state_next;
+        }
+        else
+        {
+            uint32_t top = open[open.size() - 1];
+            bool isObj = tape[top].type == MB_JSON_Object;
+            if (s[i] == ',')
+            {
+                i++;
+                state = isObj ? tape_state_key : tape_state_value;
+                continue;
+            }
+
+            if (s[i] != (isObj ? '}' : ']'))
+                return false;
+
+            i++;
+            tape[top].len = i - tape[top].ofs;
+            tape[top].skip = tape.size() - top;
+            open.pop_back();
+
+            if (open.size() == 0)
+                return tapeSkipSpace(i) == n;
+        }
+    }
+}
+
+size_t FirebaseJsonBase::tapeSkipSpace(size_t i)
+{
+    const char *s = tapeRaw.c_str();
+    while (s[i] != '\0' && (unsigned char)s[i] <= 32)
+        i++;
+    return i;
+}
+
+size_t FirebaseJsonBase::tapeStringEnd(size_t i)
+{
+    // the position of the closing quote, 0 if the string is not closed or has an escape the tree
+    // parser rejects
+    const char *s = tapeRaw.c_str();
+    bool escaped = false;
+    for (size_t start = i++; s[i] != '\0'; i++)
+    {
+        if (s[i] == '"')
+        {
+            if (!escaped)
+                return i;
+            MB_JSON *e = MB_JSON_ParseWithLength(s + start, i + 1 - start);
+            bool valid = e != NULL;
+            MB_JSON_Delete(e);
+            return valid ? i : 0;
+        }
+        if (s[i] == '\\' && s[i + 1] != '\0')
+        {
+            escaped = true;
+            i++;
+        }
+    }
+    return 0;
+}
+
+bool FirebaseJsonBase::tapeKeyEquals(size_t index, const MB_String &key)
+{
+    const char *k = tapeRaw.c_str() + tape[index].ofs;
+    size_t len = tape[index].len;
+
+    if (memchr(k, '\\', len) == NULL)
+        return len == key.length() && memcmp(k, key.c_str(), len) == 0;
+
+    // the escaped key is compared as the tree parser unescapes it
+    MB_JSON *e = MB_JSON_ParseWithLength(k - 1, len + 2);
+    bool ret = MB_JSON_IsString(e) && strcmp(e->valuestring, key.c_str()) == 0;
+    MB_JSON_Delete(e);
+    return ret;
+}
+
+bool FirebaseJsonBase::mTapeGet(FirebaseJsonData *result, const char *path, bool prettify)
+{
+    MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
+    makeList(path, keys, '/');
+
+    // the same rules as searchElements, the key type should match the parent type
+    size_t index = 0;
+    bool found = keys.size() > 0;
+    for (size_t k = 0; k < keys.size() && found; k++)
+    {
+        bool isArrKey = isArrayKey(keys[k].c_str());
+        size_t end = index + tape[index].skip;
+        size_t i = index + 1;
+        found = false;
+
+        if (tape[index].type == MB_JSON_Array && isArrKey)
+        {
+            int arrIndex = getArrIndex(keys[k].c_str());
+            for (int j = 0; j < arrIndex && i < end; j++)
+                i += tape[i].skip;
+            found = i < end;
+        }
+        else if (tape[index].type == MB_JSON_Object && !isArrKey)
+        {
+            // the first matched key as MB_JSON_GetObjectItemCaseSensitive
+            while (i < end && !tapeKeyEquals(i, keys[k]))
+                i += 1 + tape[i + 1].skip;
+            found = i < end;
+            i++;
+        }
+
+        index = i;
+    }
+
+    clearList(keys);
+
+    // only the found value is parsed
+    if (found && result != NULL)
+    {
+        MB_JSON *data = MB_JSON_ParseWithLength(tapeRaw.c_str() + tape[index].ofs, tape[index].len);
+        found = data != NULL;
+        if (found)
+            mSetResult(result, data, prettify);
+        MB_JSON_Delete(data);
+    }
+
+    return found;
+}
+
+void FirebaseJsonBase::mTapeParse()
+{
+    if (tape.size() == 0)
+        return;
+
+    root = parse(tapeRaw.c_str());
+    mTapeEnd();
+}
+
+void FirebaseJsonBase::mTapeEnd()
+{
+    tape.clear();
+#if defined(MB_USE_STD_VECTOR)
+    MB_VECTOR<struct tape_entry_t>().swap(tape);
+#endif
+    tapeRaw.clear();
+}
+
 MB_JSON *FirebaseJsonBase::parse(const char *raw)
 {
     const char *s = NULL;
@@ -111,6 +389,7 @@ MB_JSON *FirebaseJsonBase::parse(const char *raw)
 
 void FirebaseJsonBase::prepareRoot()
 {
+    mTapeParse();
     if (root == NULL)
     {
         if (root_type == Root_Type_JSONArray)
@@ -345,28 +624,20 @@ void FirebaseJsonBase::replace(MB_VECTOR<MB_String> &keys, struct search_result_
 size_t FirebaseJsonBase::mIteratorBegin(MB_JSON *parent)
 {
     mIteratorEnd();
-    char *p = MB_JSON_PrintUnformatted(parent);
+
+    // the elements are collected while the tree is serialized, one pass without searching the buffer
+    char *p = MB_JSON_PrintUnformattedWithSpans(parent, mIteratorSpan, this);
+    iterator_data.frames.clear();
     if (p == NULL)
+    {
+        iterator_data.result.clear();
         return 0;
+    }
 
     buf = p;
     MB_JSON_free(p);
     iterator_data.buf_size = buf.length();
-    int index = -1;
-    mIterate(parent, index);
-    return iterator_data.result.size();
-}
-
-size_t FirebaseJsonBase::mIteratorBegin(MB_JSON *parent, MB_VECTOR<MB_String> *keys)
-{
-    mIteratorEnd();
-
-    if (keys == NULL)
-        return 0;
-
-    int index = -1;
-    mIterate(parent, index);
-
+    iterator_data.buf_ptr = buf.c_str();
     return iterator_data.result.size();
 }
 
@@ -376,150 +647,97 @@ void FirebaseJsonBase::mIteratorEnd(bool clearBuf)
         buf.clear();
     iterator_data.path.clear();
     iterator_data.buf_size = 0;
-    iterator_data.buf_offset = 0;
+    iterator_data.buf_ptr = NULL;
     iterator_data.result.clear();
-    iterator_data.depth = -1;
-    iterator_data._depth = 0;
+    iterator_data.frames.clear();
     if (iterator_data.parentArr != NULL)
         MB_JSON_Delete(iterator_data.parentArr);
     iterator_data.parentArr = NULL;
 }
 
-void FirebaseJsonBase::mIterate(MB_JSON *parent, int &arrIndex)
+void FirebaseJsonBase::mIteratorSpan(const MB_JSON *item, const char *output, size_t offset, MB_JSON_bool end, void *arg)
 {
-    if (!parent)
-        return;
+    FirebaseJsonBase *self = reinterpret_cast<FirebaseJsonBase *>(arg);
+    struct iterator_data_t &data = self->iterator_data;
 
-    bool isAr = isArray(parent);
+    if (end)
+    {
+        struct iterator_frame_t &frame = data.frames[data.frames.size() - 1];
+        if (frame.result_index > -1)
+            data.result[frame.result_index].value_len = offset - data.result[frame.result_index].value_ofs;
+        data.frames.pop_back();
+        return;
+    }
 
-    if (isAr)
-        arrIndex = 0;
+    struct iterator_frame_t frame;
+    bool isAr = self->isArray((MB_JSON *)item);
 
-    MB_JSON *e = parent->child;
-    if (e)
+    // the root is not collected, the object/array items of an array are not collected but their children
+    if (data.frames.size() > 0)
     {
-        iterator_data.depth++;
-        while (e)
-        {
+        bool isItem = data.frames[data.frames.size() - 1].items;
 
-            if (isArray(e) || isObject(e))
-                mCollectIterator(e, e->string ? JSON_OBJECT : JSON_ARRAY, arrIndex);
+        if (!isItem || (!isAr && !self->isObject((MB_JSON *)item)))
+        {
+            struct iterator_result_t result;
+            result.value_ofs = offset;
+            result.type = item->string ? JSON_OBJECT : JSON_ARRAY;
+            result.depth = data.frames.size() - 1;
 
-            if (isArray(e))
+            // the key was serialized as "key": right before the value, its opening quote follows { or ,
+            if (item->string && offset > 2)
             {
-                MB_JSON *item = e->child;
-                int _arrIndex = 0;
-
-                if (e->child)
-                {
-                    iterator_data.depth++;
-                    while (item)
-                    {
-
-                        if (isArray(item) || isObject(item))
-                            mIterate(item, _arrIndex);
-                        else
-                            mCollectIterator(item, item->string ? JSON_OBJECT : JSON_ARRAY, _arrIndex);
-                        item = item->next;
-                        _arrIndex++;
-                    }
-                }
+                size_t i = offset - 3;
+                while (i > 0 && !(output[i] == '"' && (output[i - 1] == '{' || output[i - 1] == ',')))
+                    i--;
+                result.key_ofs = i + 1;
+                result.key_len = offset - 2 - result.key_ofs;
             }
-            else if (isObject(e))
-                mIterate(e, arrIndex);
-            else
-                mCollectIterator(e, e->string ? JSON_OBJECT : JSON_ARRAY, arrIndex);
 
-            e = e->next;
-
-            if (isAr)
-                arrIndex++;
+            data.result.push_back(result);
+            frame.result_index = data.result.size() - 1;
         }
-    }
-}
 
-void FirebaseJsonBase::mCollectIterator(MB_JSON *e, int type, int &arrIndex)
-{
-    struct iterator_result_t result;
-
-    if (e->string)
-    {
-        size_t pos = buf.find((const char *)e->string, iterator_data.buf_offset);
-        if (pos != MB_String::npos)
-        {
-            result.ofs1 = pos;
-            result.len1 = strlen(e->string);
-            iterator_data.buf_offset = (e->type != MB_JSON_Object && e->type != MB_JSON_Array) ? pos + result.len1 : pos;
-        }
+        frame.items = isAr && !isItem;
     }
 
-    char *p = MB_JSON_PrintUnformatted(e);
-    if (p)
-    {
-        if (result.ofs1 == 0)
-            result.ofs1 = iterator_data.buf_offset;
-
-        int i = iterator_data.buf_offset;
-        size_t pos = buf.find(p, i);
-        if (pos != MB_String::npos)
-        {
-            result.ofs2 = pos - result.ofs1 - result.len1;
-            result.len2 = strlen(p);
-            MB_JSON_free(p);
-            iterator_data.buf_offset = (e->type != MB_JSON_Object && e->type != MB_JSON_Array) ? pos + result.len2 : pos;
-        }
-    }
-    result.type = type;
-    result.depth = iterator_data.depth;
-    iterator_data.result.push_back(result);
+    data.frames.push_back(frame);
 }
 
 int FirebaseJsonBase::mIteratorGet(size_t index, int &type, String &key, String &value)
 {
     key.remove(0, key.length());
     value.remove(0, value.length());
-    int depth = -1;
 
-    if (buf.length() == iterator_data.buf_size)
+    struct fb_js_iterator_view_t view = mViewAt(index);
+    if (view.depth > -1)
     {
-        if (index > iterator_data.result.size() - 1)
-            return depth;
-
-        if (iterator_data.result[index].len1 > 0)
-        {
-            char *m_key = (char *)newP(iterator_data.result[index].len1 + 1);
-            if (m_key)
-            {
-                memset(m_key, 0, iterator_data.result[index].len1 + 1);
-                strncpy(m_key, &buf[iterator_data.result[index].ofs1], iterator_data.result[index].len1);
-                key = m_key;
-                delP(&m_key);
-            }
-        }
+        struct iterator_result_t &r = iterator_data.result[index];
+        key = copyView(r.key_ofs, r.key_len);
+        value = copyView(r.value_ofs, r.value_len);
 
-        char *m_val = (char *)newP(iterator_data.result[index].len2 + 1);
-        if (m_val)
-        {
-            memset(m_val, 0, iterator_data.result[index].len2 + 1);
-            int ofs = iterator_data.result[index].ofs1 + iterator_data.result[index].len1 + iterator_data.result[index].ofs2;
-            int len = iterator_data.result[index].len2;
+        type = view.type;
+    }
+    return view.depth;
+}
 
-            if (iterator_data.result[index].type == JSON_STRING)
-            {
-                if (buf[ofs] == '"')
-                    ofs++;
-                if (buf[ofs + len - 1] == '"')
-                    len--;
-            }
+bool FirebaseJsonBase::iteratorValid()
+{
+    // constant time check that the buffer was not replaced or resized since iteratorBegin
+    const char *p = buf.c_str();
+    if (p != iterator_data.buf_ptr || iterator_data.buf_ptr == NULL)
+        return false;
+    return p[iterator_data.buf_size] == '\0' && (iterator_data.buf_size == 0 || p[iterator_data.buf_size - 1] != '\0');
+}
 
-            strncpy(m_val, &buf[ofs], len);
-            value = m_val;
-            delP(&m_val);
-        }
-        type = iterator_data.result[index].type;
-        depth = iterator_data.result[index].depth;
-    }
-    return depth;
+String FirebaseJsonBase::copyView(size_t ofs, size_t len)
+{
+    // terminate the view in place for the copy
+    char c = buf[ofs + len];
+    buf[ofs + len] = '\0';
+    String s = buf.c_str() + ofs;
+    buf[ofs + len] = c;
+    return s;
 }
 
 struct FirebaseJsonBase::fb_js_iterator_value_t FirebaseJsonBase::mValueAt(size_t index)
@@ -530,8 +748,26 @@ struct FirebaseJsonBase::fb_js_iterator_value_t FirebaseJsonBase::mValueAt(size_
     return value;
 }
 
+struct FirebaseJsonBase::fb_js_iterator_view_t FirebaseJsonBase::mViewAt(size_t index)
+{
+    struct fb_js_iterator_view_t view;
+
+    if (!iteratorValid() || index >= iterator_data.result.size())
+        return view;
+
+    struct iterator_result_t &r = iterator_data.result[index];
+    view.type = r.type;
+    view.depth = r.depth;
+    view.key = buf.c_str() + r.key_ofs;
+    view.keyLen = r.key_len;
+    view.value = buf.c_str() + r.value_ofs;
+    view.valueLen = r.value_len;
+    return view;
+}
+
 void FirebaseJsonBase::toBuf(fb_json_serialize_mode mode)
 {
+    mTapeParse();
     if (root != NULL)
     {
         char *out = mode == fb_json_serialize_mode_pretty ? MB_JSON_Print(root) : MB_JSON_PrintUnformatted(root);
@@ -549,6 +785,7 @@ bool FirebaseJsonBase::mReadClient(Client *client)
     buf.clear();
     if (readClient(client, buf))
     {
+        mTapeEnd();
         if (root != NULL)
             MB_JSON_Delete(root);
         root = parse(buf.c_str());
@@ -563,6 +800,7 @@ bool FirebaseJsonBase::mReadStream(Stream *s, int timeoutMS)
     // non-blocking read
     if (readStream(s, serData, buf, true, timeoutMS))
     {
+        mTapeEnd();
         if (root != NULL)
             MB_JSON_Delete(root);
         root = parse(buf.c_str());
@@ -578,6 +816,7 @@ bool FirebaseJsonBase::mReadSdFat(SD_FAT_FILE &file, int timeoutMS)
     // non-blocking read
     if (readSdFatFile(file, serData, buf, true, timeoutMS))
     {
+        mTapeEnd();
         if (root != NULL)
             MB_JSON_Delete(root);
         root = parse(buf.c_str());
@@ -654,6 +893,7 @@ void FirebaseJsonBase::mGetPath(MB_String &path, MB_VECTOR<MB_String> paths, int
 
 size_t FirebaseJsonBase::mGetSerializedBufferLength(bool prettify)
 {
+    mTapeParse();
     if (!root)
         return 0;
     return MB_JSON_SerializedBufferLength(root, prettify);
@@ -676,6 +916,9 @@ int FirebaseJsonBase::mResponseCode()
 
 bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const char *path, bool prettify)
 {
+    if (tape.size() > 0)
+        return mTapeGet(result, path, prettify);
+
     bool ret = false;
     prepareRoot();
     MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
@@ -706,15 +949,7 @@ bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const cha
         if (data != NULL)
         {
             if (result != NULL)
-            {
-                result->clear();
-                char *p = prettify ? MB_JSON_Print(data) : MB_JSON_PrintUnformatted(data);
-                result->stringValue = p;
-                MB_JSON_free(p);
-                result->type_num = data->type;
-                result->success = true;
-                mSetElementType(result);
-            }
+                mSetResult(result, data, prettify);
             ret = true;
         }
     }
@@ -723,6 +958,17 @@ bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const cha
     return ret;
 }
 
+void FirebaseJsonBase::mSetResult(FirebaseJsonData *result, MB_JSON *data, bool prettify)
+{
+    result->clear();
+    char *p = prettify ? MB_JSON_Print(data) : MB_JSON_PrintUnformatted(data);
+    result->stringValue = p;
+    MB_JSON_free(p);
+    result->type_num = data->type;
+    result->success = true;
+    mSetElementType(result);
+}
+
 void FirebaseJsonBase::mSetResInt(FirebaseJsonData *data, const char *value)
 {
     if (strlen(value) > 0)
@@ -895,6 +1141,7 @@ FirebaseJson &FirebaseJson::operator=(FirebaseJson other)
 
 FirebaseJson::FirebaseJson(FirebaseJson &other)
 {
+    other.mTapeParse();
     if (isObject(other.root))
         mCopy(other);
 }
@@ -1034,6 +1281,7 @@ FirebaseJsonArray &FirebaseJsonArray::clear()
 
 FirebaseJsonArray &FirebaseJsonArray::add(FirebaseJson &value)
 {
+    value.mTapeParse();
     MB_JSON *e = MB_JSON_Duplicate(value.root, true);
     nAdd(e);
     return *this;
@@ -1082,6 +1330,7 @@ bool FirebaseJsonData::getJSON(FirebaseJson &json)
 
 bool FirebaseJsonData::mGetJSON(const char *source, FirebaseJson &json)
 {
+    json.mTapeEnd();
     if (json.root != NULL)
         MB_JSON_Delete(json.root);
 
@@ -1107,42 +1356,14 @@ void FirebaseJsonData::delP(void *ptr)
     void **p = (void **)ptr;
     if (*p)
     {
-        free(*p);
+        MB_Alloc::free(*p);
         *p = 0;
     }
 }
 
 void *FirebaseJsonData::newP(size_t len)
 {
-    void *p;
-    size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-    if (ESP.getPsramSize() > 0)
-        p = (void *)ps_malloc(newLen);
-    else
-        p = (void *)malloc(newLen);
-    if (!p)
-        return NULL;
-
-#else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.setExternalHeap();
-#endif
-
-    p = (void *)malloc(newLen);
-    bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.resetHeap();
-#endif
-
-    if (!nn)
-        return NULL;
-
-#endif
-    memset(p, 0, newLen);
-    return p;
+    return MB_Alloc::alloc(MB_Alloc::tag(mb_alloc_tag_json), getReservedLen(len), FBJS_USE_PSRAM, true);
 }
 
 void FirebaseJsonData::clear()
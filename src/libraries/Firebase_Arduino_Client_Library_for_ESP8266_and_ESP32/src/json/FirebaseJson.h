@@ -178,6 +178,16 @@ fb_json_putchar(char c)
 
 #define Serial_Printf fb_json_printf
 
+#elif !defined(ARDUINO) && (defined(__linux__) || defined(__APPLE__))
+
+extern "C" __attribute__((weak)) void
+fb_json_putchar(char c)
+{
+    putchar(c);
+}
+
+#define Serial_Printf printf
+
 #endif
 
 /// HTTP codes see RFC7231
@@ -216,72 +226,37 @@ static size_t getReservedLen(size_t len)
     return (size_t)newlen;
 }
 
-static void *fb_js_malloc(size_t len)
-{
-    void *p;
-    size_t newLen = getReservedLen(len);
-
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-    if (ESP.getPsramSize() > 0)
-        p = (void *)ps_malloc(newLen);
-    else
-        p = (void *)malloc(newLen);
-    if (!p)
-        return NULL;
+// The JSON nodes and buffers are allocated with the json tag, in PSRAM when FIREBASEJSON_USE_PSRAM or FIREBASE_USE_PSRAM is defined
+#if defined(MB_STRING_USE_PSRAM)
+#define FBJS_USE_PSRAM true
 #else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.setExternalHeap();
-#endif
-
-    p = (void *)malloc(newLen);
-    bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.resetHeap();
+#define FBJS_USE_PSRAM false
 #endif
 
-    if (!nn)
-        return NULL;
-#endif
-    return p;
+static void *fb_js_malloc(size_t len)
+{
+    return MB_Alloc::alloc(MB_Alloc::tag(mb_alloc_tag_json), getReservedLen(len), FBJS_USE_PSRAM);
 }
 
 static void fb_js_free(void *ptr)
 {
-    if (ptr)
-        free(ptr);
+    MB_Alloc::free(ptr);
 }
 
 static void *fb_js_realloc(void *ptr, size_t sz)
 {
-    size_t newLen = getReservedLen(sz);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-    if (ESP.getPsramSize() > 0)
-        ptr = (void *)ps_realloc(ptr, newLen);
-    else
-        ptr = (void *)realloc(ptr, newLen);
-#else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.setExternalHeap();
-#endif
-
-    ptr = (void *)realloc(ptr, newLen);
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.resetHeap();
-#endif
-
-#endif
-    if (!ptr)
-        return NULL;
-
-    return ptr;
+    return MB_Alloc::realloc(MB_Alloc::tag(mb_alloc_tag_json), ptr, getReservedLen(sz), FBJS_USE_PSRAM);
 }
 
 static MB_JSON_Hooks MB_JSON_hooks __attribute__((used)) = {fb_js_malloc, fb_js_free, fb_js_realloc};
 
+// The user allocator set by FirebaseJsonBase::setHooks, NULL for default.
+inline MB_JSON_Hooks *&fb_js_user_hooks()
+{
+    static MB_JSON_Hooks *hooks = NULL;
+    return hooks;
+}
+
 namespace fb_js
 {
 
@@ -347,7 +322,7 @@ public:
     template <typename T>
     bool getArray(T source, FirebaseJsonArray &jsonArray)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGetArray(getStr(source, addr), jsonArray);
         delAddr(addr);
         return ret;
@@ -374,7 +349,7 @@ public:
     template <typename T>
     bool getJSON(T source, FirebaseJson &json)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGetJSON(getStr(source, addr), json);
         delAddr(addr);
         return ret;
@@ -517,20 +492,20 @@ private:
     void *newP(size_t len);
 
     template <typename T>
-    auto getStr(const T &val, uint32_t &addr) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value || std::is_same<T, StringSumHelper>::value, const char *>::type
+    auto getStr(const T &val, uintptr_t &addr) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value || std::is_same<T, StringSumHelper>::value, const char *>::type
     {
         addr = 0;
         return val.c_str();
     }
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, const char *>::type
     {
         return getStr(reinterpret_cast<PGM_P>(val), addr);
     }
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_const_chars<T>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_const_chars<T>::value, const char *>::type
     {
         int len = strlen_P((PGM_P)val) + 1;
         char *out = (char *)newP(len);
@@ -541,7 +516,7 @@ private:
         return (const char *)out;
     }
 
-    void delAddr(uint32_t addr)
+    void delAddr(uintptr_t addr)
     {
         if (addr > 0)
         {
@@ -582,28 +557,52 @@ private:
         int stopIndex = 0;
     };
 
+    // the key and value positions in the serialized buffer
     struct iterator_result_t
     {
-        uint16_t ofs1 = 0;
-        uint8_t len1 = 0;
-        uint8_t ofs2 = 0;
-        uint16_t len2 = 0;
+        uint32_t key_ofs = 0;
+        uint32_t key_len = 0;
+        uint32_t value_ofs = 0;
+        uint32_t value_len = 0;
         uint8_t type = 0;
         int16_t depth = -1;
     };
 
+    // the element which its value is being serialized
+    struct iterator_frame_t
+    {
+        int result_index = -1;
+        bool items = false; // the children are the array items which the nested object/array is not collected
+    };
+
     struct iterator_data_t
     {
         MB_VECTOR<struct iterator_result_t> result;
-        int buf_offset = 0;
+        MB_VECTOR<struct iterator_frame_t> frames;
         size_t buf_size = 0;
-        int depth = -1;
-        int _depth = 0;
+        const char *buf_ptr = NULL;
         MB_JSON *parent = NULL;
         MB_JSON *parentArr = NULL;
         MB_String path;
     };
 
+    // the value position in the raw buffer of the lazy parsed object, the object member is
+    // its key entry followed by the value entries
+    struct tape_entry_t
+    {
+        uint32_t ofs = 0;
+        uint32_t len = 0;
+        uint32_t skip = 1; // the number of entries of the value and its children
+        uint8_t type = 0;  // MB_JSON type, MB_JSON_Invalid for the member key
+    };
+
+    enum tape_state
+    {
+        tape_state_key = 0,
+        tape_state_value = 1,
+        tape_state_next = 2
+    };
+
     struct fb_js_iterator_value_t
     {
         int type = 0;
@@ -612,9 +611,27 @@ private:
         String value;
     };
 
+    struct fb_js_iterator_view_t
+    {
+        int type = 0;
+        int depth = -1;
+        const char *key = "";
+        size_t keyLen = 0;
+        const char *value = "";
+        size_t valueLen = 0;
+    };
+
     FirebaseJsonBase &mClear();
     void mIteratorEnd(bool clearBuf = true);
     bool setRaw(const char *raw);
+    bool setRawLazy(const char *raw);
+    bool mTapeBuild();
+    size_t tapeSkipSpace(size_t i);
+    size_t tapeStringEnd(size_t i);
+    bool tapeKeyEquals(size_t index, const MB_String &key);
+    bool mTapeGet(FirebaseJsonData *result, const char *path, bool prettify);
+    void mTapeParse();
+    void mTapeEnd();
     void prepareRoot();
     MB_JSON *parse(const char *raw);
     void searchElements(MB_VECTOR<MB_String> &keys, MB_JSON *parent, struct search_result_t &r);
@@ -630,11 +647,12 @@ private:
     void replaceItem(MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *value);
     void replace(MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *item);
     size_t mIteratorBegin(MB_JSON *parent);
-    size_t mIteratorBegin(MB_JSON *parent, MB_VECTOR<MB_String> *keys);
-    void mCollectIterator(MB_JSON *e, int type, int &arrIndex);
-    void mIterate(MB_JSON *parent, int &arrIndex);
+    static void mIteratorSpan(const MB_JSON *item, const char *output, size_t offset, MB_JSON_bool end, void *arg);
     int mIteratorGet(size_t index, int &type, String &key, String &value);
     struct fb_js_iterator_value_t mValueAt(size_t index);
+    struct fb_js_iterator_view_t mViewAt(size_t index);
+    bool iteratorValid();
+    String copyView(size_t ofs, size_t len);
     void toBuf(fb_json_serialize_mode mode);
     bool mReadClient(Client *client);
     bool mReadStream(Stream *s, int timeoutMS);
@@ -649,6 +667,7 @@ private:
     void mSetDoubleDigits(uint8_t digits);
     int mResponseCode();
     bool mGet(MB_JSON *parent, FirebaseJsonData *result, const char *path, bool prettify = false);
+    void mSetResult(FirebaseJsonData *result, MB_JSON *data, bool prettify);
     void mSetResInt(FirebaseJsonData *data, const char *value);
     void mSetResFloat(FirebaseJsonData *data, const char *value);
     void mSetElementType(FirebaseJsonData *result);
@@ -669,6 +688,18 @@ public:
     FirebaseJsonBase();
     virtual ~FirebaseJsonBase();
 
+    /**
+     * Set the allocator for the JSON nodes and print buffers, NULL to restore the default.
+     *
+     * @param hooks The MB_JSON_Hooks that holds the malloc, free and realloc functions.
+     * @return false when the nodes or print buffers of the current allocator are still alive,
+     * the allocator is not changed.
+     *
+     * @note The node is always released by the allocator that allocated it, set this before any
+     * JSON object was created or after all of them were destroyed.
+     */
+    static bool setHooks(MB_JSON_Hooks *hooks);
+
     typedef enum
     {
         fb_json_func_type_undefined = 0,
@@ -703,9 +734,11 @@ protected:
     MB_JSON *root = NULL;
     MB_JSON_Hooks *hooks = NULL;
     MB_String buf;
+    MB_VECTOR<struct tape_entry_t> tape;
+    MB_String tapeRaw;
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_bool<T>::value || is_num_int<T>::value || std::is_same<T, float>::value || std::is_same<T, double>::value || std::is_same<T, long double>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_bool<T>::value || is_num_int<T>::value || std::is_same<T, float>::value || std::is_same<T, double>::value || std::is_same<T, long double>::value, const char *>::type
     {
         MB_String t;
 
@@ -726,20 +759,20 @@ protected:
     }
 
     template <typename T>
-    auto getStr(const T &val, uint32_t &addr) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value || std::is_same<T, StringSumHelper>::value, const char *>::type
+    auto getStr(const T &val, uintptr_t &addr) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value || std::is_same<T, StringSumHelper>::value, const char *>::type
     {
         addr = 0;
         return val.c_str();
     }
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, const char *>::type
     {
         return getStr(reinterpret_cast<PGM_P>(val), addr);
     }
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_const_chars<T>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_const_chars<T>::value, const char *>::type
     {
         int len = strlen_P((PGM_P)val) + 1;
         char *out = (char *)newP(len);
@@ -753,6 +786,7 @@ protected:
     template <typename T>
     bool toStringPtrHandler(T *ptr, bool prettify)
     {
+        mTapeParse();
         if (!root || !ptr)
             return false;
 
@@ -772,6 +806,7 @@ protected:
     template <typename T>
     auto toStringHandler(T &out, bool prettify) -> typename std::enable_if<is_string<T>::value, bool>::type
     {
+        mTapeParse();
         if (!root)
             return false;
 
@@ -788,6 +823,7 @@ protected:
     template <typename T>
     auto toStringHandler(T &out, bool prettify) -> typename std::enable_if<std::is_same<T, MB_SERIAL_CLASS>::value, bool>::type
     {
+        mTapeParse();
         char *p = prettify ? MB_JSON_Print(root) : MB_JSON_PrintUnformatted(root);
         if (p)
         {
@@ -825,6 +861,7 @@ protected:
     {
         bool ret = false;
 
+        mTapeParse();
         if (!root)
             return false;
 
@@ -858,7 +895,7 @@ protected:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            MB_Alloc::free(*p);
             *p = 0;
         }
     }
@@ -877,35 +914,7 @@ protected:
 
     void *newP(size_t len)
     {
-        void *p;
-        size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-        if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
-        else
-            p = (void *)malloc(newLen);
-        if (!p)
-            return NULL;
-
-#else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.setExternalHeap();
-#endif
-
-        p = (void *)malloc(newLen);
-        bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.resetHeap();
-#endif
-
-        if (!nn)
-            return NULL;
-
-#endif
-        memset(p, 0, newLen);
-        return p;
+        return MB_Alloc::alloc(MB_Alloc::tag(mb_alloc_tag_json), getReservedLen(len), FBJS_USE_PSRAM, true);
     }
 
     void strcat_c(char *str, char c)
@@ -1721,6 +1730,7 @@ class FirebaseJsonArray : public FirebaseJsonBase
 
 public:
     typedef struct FirebaseJsonBase::fb_js_iterator_value_t IteratorValue;
+    typedef struct FirebaseJsonBase::fb_js_iterator_view_t IteratorView;
 
     FirebaseJsonArray()
     {
@@ -1749,7 +1759,7 @@ public:
     template <typename T>
     bool setJsonArrayData(T data)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = setRaw(getStr(data, addr));
         delAddr(addr);
         return ret;
@@ -1858,7 +1868,7 @@ public:
     template <typename T>
     bool isMember(T path)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGet(root, NULL, getStr(path, addr));
         delAddr(addr);
         return ret;
@@ -1868,7 +1878,11 @@ public:
      * Parse and collect all node/array elements in FirebaseJsonArray object.
      * @return number of child/array elements in FirebaseJson object.
      */
-    size_t iteratorBegin(const char *data = NULL) { return mIteratorBegin(root); }
+    size_t iteratorBegin(const char *data = NULL)
+    {
+        (void)data;
+        return mIteratorBegin(root);
+    }
 
     /**
      * Get child/array elements from FirebaseJsonArray objects at specified index.
@@ -1896,6 +1910,25 @@ public:
      */
     IteratorValue valueAt(size_t index) { return mValueAt(index); }
 
+    /**
+     * Get child/array elements at specified index without copying.
+     *
+     * @param index The element index to get.
+     * @return IteratorView struct.
+     *
+     * This should call after iteratorBegin.
+     *
+     * The IteratorView struct contains the following members.
+     * int type
+     * int depth, -1 for invalid index
+     * const char *key and size_t keyLen
+     * const char *value and size_t valueLen
+     *
+     * The key and value point to the iterator buffer (not NUL terminated) and
+     * are valid until iteratorEnd is called or the object was changed.
+     */
+    IteratorView viewAt(size_t index) { return mViewAt(index); }
+
     /**
      * Clear all iterator buffer (should be called since iteratorBegin was called).
      */
@@ -2016,7 +2049,7 @@ private:
     template <typename T>
     auto dataGetHandler(T arg, FirebaseJsonData &result, bool prettify) -> typename std::enable_if<is_string<T>::value, bool>::type
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGet(root, &result, getStr(arg, addr), prettify);
         delAddr(addr);
         return ret;
@@ -2031,7 +2064,7 @@ private:
     template <typename T>
     auto dataRemoveHandler(T arg) -> typename std::enable_if<is_string<T>::value, bool>::type
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mRemove(getStr(arg, addr));
         delAddr(addr);
         return ret;
@@ -2099,7 +2132,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         nAdd(MB_JSON_CreateString(getStr(arg, addr)));
         delAddr(addr);
         return *this;
@@ -2114,7 +2147,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateNull());
         delAddr(addr);
     }
@@ -2134,7 +2167,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateBool(arg2));
         delAddr(addr);
     }
@@ -2153,7 +2186,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, -1)));
         delAddr(addr);
     }
@@ -2172,7 +2205,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, floatDigits)));
         delAddr(addr);
     }
@@ -2191,7 +2224,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, doubleDigits)));
         delAddr(addr);
     }
@@ -2210,8 +2243,8 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr1 = 0;
-        uint32_t addr2 = 0;
+        uintptr_t addr1 = 0;
+        uintptr_t addr2 = 0;
         mSet(getStr(arg1, addr1), MB_JSON_CreateString(getStr(arg2, addr2)));
         delAddr(addr1);
         delAddr(addr2);
@@ -2220,7 +2253,7 @@ private:
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename std::enable_if<(is_num_int<T1>::value || is_num_float<T1>::value || is_bool<T1>::value) && is_string<T2>::value>::type
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSetIdx(arg1, MB_JSON_CreateString(getStr(arg2, addr)));
         delAddr(addr);
     }
@@ -2233,8 +2266,9 @@ private:
 
         root_type = Root_Type_JSONArray;
 
+        arg2.mTapeParse();
         MB_JSON *e = MB_JSON_Duplicate(arg2.root, true);
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), e);
         delAddr(addr);
     }
@@ -2242,6 +2276,7 @@ private:
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 &arg2) -> typename std::enable_if<(is_num_int<T1>::value || is_num_float<T1>::value || is_bool<T1>::value) && std::is_same<T2, FirebaseJson>::value>::type
     {
+        arg2.mTapeParse();
         MB_JSON *e = MB_JSON_Duplicate(arg2.root, true);
         mSetIdx(arg1, e);
     }
@@ -2255,7 +2290,7 @@ private:
         root_type = Root_Type_JSONArray;
 
         MB_JSON *e = MB_JSON_Duplicate(arg2.root, true);
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), e);
         delAddr(addr);
     }
@@ -2267,7 +2302,7 @@ private:
         mSetIdx(arg1, e);
     }
 
-    void delAddr(uint32_t addr)
+    void delAddr(uintptr_t addr)
     {
         if (addr > 0)
         {
@@ -2286,6 +2321,7 @@ class FirebaseJson : public FirebaseJsonBase
 public:
     typedef enum FirebaseJsonBase::fb_js_json_data_type jsonDataType;
     typedef struct FirebaseJsonBase::fb_js_iterator_value_t IteratorValue;
+    typedef struct FirebaseJsonBase::fb_js_iterator_view_t IteratorView;
 
     FirebaseJson() { this->root_type = Root_Type_JSON; }
 
@@ -2320,12 +2356,31 @@ public:
     template <typename T>
     bool setJsonData(T data)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = setRaw(getStr(data, addr));
         delAddr(addr);
         return ret;
     }
 
+    /**
+     * Set the JSON object data (JSON object literal) as FirebaseJson object without building the element tree.
+     *
+     * @param data The JSON object literal string to set.
+     * @return boolean status of the operation.
+     *
+     * @note The data is kept as is with the position of its elements, get and isMember parse only the element
+     * of the path. The other functions parse the whole object first as setJsonData.
+     * The data which is not a JSON object is set as setJsonData.
+     */
+    template <typename T>
+    bool setJsonDataLazy(T data)
+    {
+        uintptr_t addr = 0;
+        bool ret = setRawLazy(getStr(data, addr));
+        delAddr(addr);
+        return ret;
+    }
+
     /**
      * Set JSON data via derived Stream object to FirebaseJson object.
      *
@@ -2370,7 +2425,7 @@ public:
     template <typename T>
     FirebaseJson &add(T key)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         nAdd(getStr(key, addr), NULL);
         delAddr(addr);
         return *this;
@@ -2386,7 +2441,7 @@ public:
     template <typename T1, typename T2>
     FirebaseJson &add(T1 key, T2 value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_add);
         delAddr(addr);
         return *this;
@@ -2395,7 +2450,7 @@ public:
     template <typename T>
     FirebaseJson &add(T key, FirebaseJson &value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_add);
         delAddr(addr);
         return *this;
@@ -2404,7 +2459,7 @@ public:
     template <typename T>
     FirebaseJson &add(T key, FirebaseJsonArray &value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_add);
         delAddr(addr);
         return *this;
@@ -2465,7 +2520,7 @@ public:
     template <typename T>
     bool get(FirebaseJsonData &result, T path, bool prettify = false)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGet(root, &result, getStr(path, addr), prettify);
         delAddr(addr);
         return ret;
@@ -2480,7 +2535,7 @@ public:
     template <typename T>
     bool isMember(T path)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGet(root, NULL, getStr(path, addr));
         delAddr(addr);
         return ret;
@@ -2491,7 +2546,11 @@ public:
      *
      * @return number of child/array elements in FirebaseJson object.
      */
-    size_t iteratorBegin() { return mIteratorBegin(root); }
+    size_t iteratorBegin()
+    {
+        mTapeParse();
+        return mIteratorBegin(root);
+    }
 
     /**
      * Get child/array elements from FirebaseJson objects at specified index.
@@ -2519,6 +2578,25 @@ public:
      */
     IteratorValue valueAt(size_t index) { return mValueAt(index); }
 
+    /**
+     * Get child/array elements at specified index without copying.
+     *
+     * @param index The element index to get.
+     * @return IteratorView struct.
+     *
+     * This should call after iteratorBegin.
+     *
+     * The IteratorView struct contains the following members.
+     * int type
+     * int depth, -1 for invalid index
+     * const char *key and size_t keyLen
+     * const char *value and size_t valueLen
+     *
+     * The key and value point to the iterator buffer (not NUL terminated) and
+     * are valid until iteratorEnd is called or the object was changed.
+     */
+    IteratorView viewAt(size_t index) { return mViewAt(index); }
+
     /**
      * Clear all iterator buffer (should be called since iteratorBegin was called).
      */
@@ -2535,7 +2613,7 @@ public:
     template <typename T>
     void set(T key)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(key, addr), NULL);
         delAddr(addr);
     }
@@ -2556,7 +2634,7 @@ public:
     template <typename T1, typename T2>
     FirebaseJson &set(T1 key, T2 value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_set);
         delAddr(addr);
         return *this;
@@ -2565,7 +2643,7 @@ public:
     template <typename T>
     FirebaseJson &set(T key, FirebaseJson &value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_set);
         delAddr(addr);
         return *this;
@@ -2574,7 +2652,7 @@ public:
     template <typename T>
     FirebaseJson &set(T key, FirebaseJsonArray &value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_set);
         delAddr(addr);
         return *this;
@@ -2589,7 +2667,7 @@ public:
     template <typename T>
     bool remove(T path)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mRemove(getStr(path, addr));
         delAddr(addr);
         return ret;
@@ -2643,7 +2721,7 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr), MB_JSON_CreateBool(arg2));
         else if (type == fb_json_func_type_set)
@@ -2660,7 +2738,7 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, -1)));
         else if (type == fb_json_func_type_set)
@@ -2677,7 +2755,7 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, floatDigits)));
         else if (type == fb_json_func_type_set)
@@ -2694,7 +2772,7 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, doubleDigits)));
         else if (type == fb_json_func_type_set)
@@ -2711,8 +2789,8 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr1 = 0;
-        uint32_t addr2 = 0;
+        uintptr_t addr1 = 0;
+        uintptr_t addr2 = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr1), MB_JSON_CreateString(getStr(arg2, addr2)));
         else if (type == fb_json_func_type_set)
@@ -2730,8 +2808,9 @@ private:
 
         root_type = Root_Type_JSON;
 
+        json.mTapeParse();
         MB_JSON *e = MB_JSON_Duplicate(json.root, true);
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg, addr), e);
         else if (type == fb_json_func_type_set)
@@ -2749,7 +2828,7 @@ private:
         root_type = Root_Type_JSON;
 
         MB_JSON *e = MB_JSON_Duplicate(arr.root, true);
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg, addr), e);
         else if (type == fb_json_func_type_set)
@@ -2758,7 +2837,7 @@ private:
         return *this;
     }
 
-    void delAddr(uint32_t addr)
+    void delAddr(uintptr_t addr)
     {
         if (addr > 0)
         {
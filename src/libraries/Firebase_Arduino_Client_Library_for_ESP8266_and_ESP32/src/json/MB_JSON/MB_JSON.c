@@ -200,7 +200,51 @@ static void *MB_JSON_CDECL internal_realloc(void *pointer, size_t size)
 /* strlen of character literals resolved at compile time */
 #define MB_JSON_static_strlen(string_literal) (sizeof(string_literal) - sizeof(""))
 
-static MB_JSON_internal_hooks MB_JSON_global_hooks = {MB_JSON_internal_malloc, MB_JSON_internal_free, MB_JSON_internal_realloc};
+/* The allocator set by MB_JSON_InitHooks, the global hooks count the live blocks of it.
+ * The allocator can't be changed while its blocks are alive, a block is always freed by the allocator of it. */
+static MB_JSON_Hooks MB_JSON_user_hooks = {MB_JSON_internal_malloc, MB_JSON_internal_free, MB_JSON_internal_realloc};
+static size_t MB_JSON_live_blocks = 0;
+
+#if defined(_MSC_VER)
+#define MB_JSON_live_inc() (MB_JSON_live_blocks++)
+#define MB_JSON_live_dec() (MB_JSON_live_blocks--)
+#define MB_JSON_live_get() (MB_JSON_live_blocks)
+#else
+#define MB_JSON_live_inc() __atomic_add_fetch(&MB_JSON_live_blocks, 1, __ATOMIC_RELAXED)
+#define MB_JSON_live_dec() __atomic_sub_fetch(&MB_JSON_live_blocks, 1, __ATOMIC_RELAXED)
+#define MB_JSON_live_get() __atomic_load_n(&MB_JSON_live_blocks, __ATOMIC_ACQUIRE)
+#endif
+
+static void *MB_JSON_CDECL MB_JSON_counted_malloc(size_t size)
+{
+    void *pointer = MB_JSON_user_hooks.malloc_fn(size);
+    if (pointer != NULL)
+    {
+        MB_JSON_live_inc();
+    }
+    return pointer;
+}
+
+static void MB_JSON_CDECL MB_JSON_counted_free(void *pointer)
+{
+    if (pointer != NULL)
+    {
+        MB_JSON_live_dec();
+        MB_JSON_user_hooks.free_fn(pointer);
+    }
+}
+
+static void *MB_JSON_CDECL MB_JSON_counted_realloc(void *pointer, size_t size)
+{
+    void *new_pointer = MB_JSON_user_hooks.realloc_fn(pointer, size);
+    if (pointer == NULL && new_pointer != NULL)
+    {
+        MB_JSON_live_inc();
+    }
+    return new_pointer;
+}
+
+static MB_JSON_internal_hooks MB_JSON_global_hooks = {MB_JSON_counted_malloc, MB_JSON_counted_free, MB_JSON_counted_realloc};
 
 static unsigned char *MB_JSON_strdup(const unsigned char *string, const MB_JSON_internal_hooks *const hooks)
 {
@@ -223,36 +267,47 @@ static unsigned char *MB_JSON_strdup(const unsigned char *string, const MB_JSON_
     return copy;
 }
 
-MB_JSON_PUBLIC(void)
+MB_JSON_PUBLIC(MB_JSON_bool)
 MB_JSON_InitHooks(MB_JSON_Hooks *hooks)
 {
-    if (hooks == NULL)
-    {
-        /* Reset hooks */
-        MB_JSON_global_hooks.allocate = malloc;
-        MB_JSON_global_hooks.deallocate = free;
-        MB_JSON_global_hooks.reallocate = realloc;
-        return;
-    }
+    /* Reset hooks when NULL */
+    MB_JSON_Hooks next = {MB_JSON_internal_malloc, MB_JSON_internal_free, MB_JSON_internal_realloc};
 
-    MB_JSON_global_hooks.allocate = malloc;
-    if (hooks->malloc_fn != NULL)
+    if (hooks != NULL)
     {
-        MB_JSON_global_hooks.allocate = hooks->malloc_fn;
+        if (hooks->malloc_fn != NULL)
+        {
+            next.malloc_fn = hooks->malloc_fn;
+        }
+
+        if (hooks->free_fn != NULL)
+        {
+            next.free_fn = hooks->free_fn;
+        }
+
+        /* use realloc only if both free and malloc are used */
+        next.realloc_fn = hooks->realloc_fn;
+        if ((next.malloc_fn == MB_JSON_internal_malloc) && (next.free_fn == MB_JSON_internal_free))
+        {
+            next.realloc_fn = MB_JSON_internal_realloc;
+        }
     }
 
-    MB_JSON_global_hooks.deallocate = free;
-    if (hooks->free_fn != NULL)
+    if ((next.malloc_fn == MB_JSON_user_hooks.malloc_fn) && (next.free_fn == MB_JSON_user_hooks.free_fn) && (next.realloc_fn == MB_JSON_user_hooks.realloc_fn))
     {
-        MB_JSON_global_hooks.deallocate = hooks->free_fn;
+        return true;
     }
 
-    /* use realloc only if both free and malloc are used */
-    MB_JSON_global_hooks.reallocate = hooks->realloc_fn;
-    if ((MB_JSON_global_hooks.allocate == malloc) && (MB_JSON_global_hooks.deallocate == free))
+    /* the live blocks must be freed by the allocator of them */
+    if (MB_JSON_live_get() > 0)
     {
-        MB_JSON_global_hooks.reallocate = realloc;
+        return false;
     }
+
+    MB_JSON_user_hooks = next;
+    MB_JSON_global_hooks.reallocate = next.realloc_fn != NULL ? MB_JSON_counted_realloc : NULL;
+
+    return true;
 }
 
 /* Internal constructor. */
@@ -454,6 +509,8 @@ typedef struct
     MB_JSON_bool noalloc;
     MB_JSON_bool format; /* is this print a formatted print */
     MB_JSON_internal_hooks hooks;
+    MB_JSON_SpanHook span_hook; /* optional, reports the value positions */
+    void *span_arg;
 } MB_JSON_printbuffer;
 
 typedef struct
@@ -1277,7 +1334,7 @@ size_t MB_JSON_SerializedBufferLength(const MB_JSON *const item, MB_JSON_bool fo
     return buf_len->size;
 }
 
-static unsigned char *MB_JSON_print(const MB_JSON *const item, MB_JSON_bool format, const MB_JSON_internal_hooks *const hooks)
+static unsigned char *MB_JSON_print(const MB_JSON *const item, MB_JSON_bool format, const MB_JSON_internal_hooks *const hooks, MB_JSON_SpanHook span_hook, void *span_arg)
 {
     static const size_t default_buffer_size = 256;
     MB_JSON_printbuffer buffer[1];
@@ -1290,6 +1347,8 @@ static unsigned char *MB_JSON_print(const MB_JSON *const item, MB_JSON_bool form
     buffer->length = default_buffer_size;
     buffer->format = format;
     buffer->hooks = *hooks;
+    buffer->span_hook = span_hook;
+    buffer->span_arg = span_arg;
     if (buffer->buffer == NULL)
     {
         goto fail;
@@ -1346,19 +1405,198 @@ fail:
 MB_JSON_PUBLIC(char *)
 MB_JSON_Print(const MB_JSON *item)
 {
-    return (char *)MB_JSON_print(item, true, &MB_JSON_global_hooks);
+    return (char *)MB_JSON_print(item, true, &MB_JSON_global_hooks, NULL, NULL);
 }
 
 MB_JSON_PUBLIC(char *)
 MB_JSON_PrintUnformatted(const MB_JSON *item)
 {
-    return (char *)MB_JSON_print(item, false, &MB_JSON_global_hooks);
+    return (char *)MB_JSON_print(item, false, &MB_JSON_global_hooks, NULL, NULL);
+}
+
+MB_JSON_PUBLIC(char *)
+MB_JSON_PrintUnformattedWithSpans(const MB_JSON *item, MB_JSON_SpanHook hook, void *arg)
+{
+    return (char *)MB_JSON_print(item, false, &MB_JSON_global_hooks, hook, arg);
+}
+
+MB_JSON_PUBLIC(void)
+MB_JSON_ScannerInit(MB_JSON_Scanner *scanner, MB_JSON_ScanHook hook, void *arg)
+{
+    if (scanner == NULL)
+    {
+        return;
+    }
+
+    memset(scanner, 0, sizeof(MB_JSON_Scanner));
+    scanner->value_offset = (size_t)-1;
+    scanner->hook = hook;
+    scanner->arg = arg;
+}
+
+static void scanner_end_member(MB_JSON_Scanner *const scanner)
+{
+    if (scanner->value_offset != (size_t)-1)
+    {
+        if (scanner->hook != NULL)
+        {
+            scanner->hook(scanner->key_offset, scanner->key_length, scanner->value_offset, scanner->value_end - scanner->value_offset, scanner->arg);
+        }
+        scanner->value_offset = (size_t)-1;
+    }
+}
+
+static void scanner_value_byte(MB_JSON_Scanner *const scanner)
+{
+    /* the bytes of the top level member value */
+    if ((scanner->depth == 1) && scanner->root_object && !scanner->expect_key)
+    {
+        if (scanner->value_offset == (size_t)-1)
+        {
+            scanner->value_offset = scanner->offset;
+        }
+        scanner->value_end = scanner->offset + 1;
+    }
+}
+
+MB_JSON_PUBLIC(MB_JSON_bool)
+MB_JSON_ScannerFeed(MB_JSON_Scanner *scanner, const char *buffer, size_t length)
+{
+    size_t i = 0;
+
+    if ((scanner == NULL) || (buffer == NULL && length > 0))
+    {
+        return false;
+    }
+
+    for (i = 0; (i < length) && !scanner->error; i++, scanner->offset++)
+    {
+        char c = buffer[i];
+
+        if (scanner->in_string)
+        {
+            if (scanner->escape)
+            {
+                scanner->escape = false;
+            }
+            else if (c == '\\')
+            {
+                scanner->escape = true;
+            }
+            else if (c == '\"')
+            {
+                scanner->in_string = false;
+                if (scanner->in_key)
+                {
+                    scanner->in_key = false;
+                    scanner->key_length = scanner->offset - scanner->key_offset;
+                    continue;
+                }
+            }
+            else if ((unsigned char)c < 0x20)
+            {
+                /* unescaped control character */
+                scanner->error = true;
+                continue;
+            }
+
+            if (!scanner->in_key)
+            {
+                scanner_value_byte(scanner);
+            }
+            continue;
+        }
+
+        if ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'))
+        {
+            continue;
+        }
+
+        if (scanner->complete)
+        {
+            /* trailing garbage after the root value */
+            scanner->error = true;
+            continue;
+        }
+
+        switch (c)
+        {
+        case '"':
+            scanner->in_string = true;
+            if ((scanner->depth == 1) && scanner->expect_key)
+            {
+                scanner->in_key = true;
+                scanner->key_offset = scanner->offset + 1;
+            }
+            else
+            {
+                scanner_value_byte(scanner);
+            }
+            break;
+
+        case '{':
+        case '[':
+            scanner_value_byte(scanner);
+            if (scanner->depth >= MB_JSON_NESTING_LIMIT)
+            {
+                scanner->error = true;
+                break;
+            }
+            scanner->depth++;
+            if (scanner->depth == 1)
+            {
+                scanner->root_object = (c == '{');
+                scanner->expect_key = scanner->root_object;
+            }
+            break;
+
+        case '}':
+        case ']':
+            if (scanner->depth == 0)
+            {
+                scanner->error = true;
+                break;
+            }
+            if (scanner->depth == 1)
+            {
+                scanner_end_member(scanner);
+                scanner->depth = 0;
+                scanner->complete = true;
+                break;
+            }
+            scanner->depth--;
+            scanner_value_byte(scanner);
+            break;
+
+        case ':':
+            if (scanner->depth == 1)
+            {
+                scanner->expect_key = false;
+            }
+            break;
+
+        case ',':
+            if (scanner->depth == 1)
+            {
+                scanner_end_member(scanner);
+                scanner->expect_key = scanner->root_object;
+            }
+            break;
+
+        default:
+            /* number, true, false and null */
+            scanner_value_byte(scanner);
+            break;
+        }
+    }
+
+    return !scanner->error;
 }
 
 MB_JSON_PUBLIC(char *)
 MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer, MB_JSON_bool fmt)
 {
-    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0}};
+    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0}, 0, 0};
 
     if (prebuffer < 0)
     {
@@ -1389,7 +1627,7 @@ MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer, MB_JSON_bool fmt)
 MB_JSON_PUBLIC(MB_JSON_bool)
 MB_JSON_PrintPreallocated(MB_JSON *item, char *buffer, const int length, const MB_JSON_bool format)
 {
-    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0}};
+    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0}, 0, 0};
 
     if ((length < 0) || (buffer == NULL))
     {
@@ -1504,8 +1742,27 @@ static MB_JSON_bool MB_JSON_get_value_buffer_length(const MB_JSON *const item, M
     }
 }
 
+static MB_JSON_bool MB_JSON_print_value_content(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer);
+
 /* Render a value to text. */
 static MB_JSON_bool MB_JSON_print_value(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
+{
+    if ((output_buffer == NULL) || (output_buffer->span_hook == NULL))
+    {
+        return MB_JSON_print_value_content(item, output_buffer);
+    }
+
+    output_buffer->span_hook(item, (const char *)output_buffer->buffer, output_buffer->offset, false, output_buffer->span_arg);
+    if (!MB_JSON_print_value_content(item, output_buffer))
+    {
+        return false;
+    }
+    MB_JSON_update_offset(output_buffer);
+    output_buffer->span_hook(item, (const char *)output_buffer->buffer, output_buffer->offset, true, output_buffer->span_arg);
+    return true;
+}
+
+static MB_JSON_bool MB_JSON_print_value_content(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
 {
     unsigned char *output = NULL;
 
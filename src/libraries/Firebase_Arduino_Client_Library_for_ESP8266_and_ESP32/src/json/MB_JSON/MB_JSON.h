@@ -140,6 +140,32 @@ typedef struct MB_JSON_Hooks
 
 typedef int MB_JSON_bool;
 
+/* Called when the rendering of item value starts (end = 0) and ends (end = 1), offset is the position in output. */
+typedef void (*MB_JSON_SpanHook)(const MB_JSON *item, const char *output, size_t offset, MB_JSON_bool end, void *arg);
+
+/* Called by the scanner when the value of a top level object member ends, the offsets are counted from the first byte fed. */
+typedef void (*MB_JSON_ScanHook)(size_t key_offset, size_t key_length, size_t value_offset, size_t value_length, void *arg);
+
+/* The incremental scanner state, the JSON text is fed in pieces as it arrives and the top level members are reported without building the tree. */
+typedef struct MB_JSON_Scanner
+{
+    size_t offset; /* the number of bytes fed */
+    int depth; /* the current nesting depth, 0 outside the root value */
+    unsigned char in_string;
+    unsigned char escape; /* the previous byte in string was the unescaped backslash */
+    unsigned char in_key;
+    unsigned char expect_key;
+    unsigned char root_object; /* the members are only reported when the root is object */
+    size_t key_offset;
+    size_t key_length;
+    size_t value_offset; /* (size_t)-1 when the member value was not started */
+    size_t value_end;
+    MB_JSON_bool complete; /* the root object or array was closed */
+    MB_JSON_bool error;
+    MB_JSON_ScanHook hook;
+    void *arg;
+} MB_JSON_Scanner;
+
 /* Limits how deeply nested arrays/objects can be before MB_JSON rejects to parse them.
  * This is to prevent stack overflows. */
 #ifndef MB_JSON_NESTING_LIMIT
@@ -149,8 +175,8 @@ typedef int MB_JSON_bool;
 /* returns the version of MB_JSON as a string */
 MB_JSON_PUBLIC(const char*) MB_JSON_Version(void);
 
-/* Supply malloc, realloc and free functions to MB_JSON */
-MB_JSON_PUBLIC(void) MB_JSON_InitHooks(MB_JSON_Hooks* hooks);
+/* Supply malloc, realloc and free functions to MB_JSON, false when the blocks of the current ones are still alive */
+MB_JSON_PUBLIC(MB_JSON_bool) MB_JSON_InitHooks(MB_JSON_Hooks* hooks);
 
 size_t MB_JSON_SerializedBufferLength(const MB_JSON *const item, MB_JSON_bool format);
 
@@ -164,10 +190,17 @@ MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithLength(const char *value, size_t buff
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithOpts(const char *value, const char **return_parse_end, MB_JSON_bool require_null_terminated);
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated);
 
+/* Start scanning the new JSON text, hook can be NULL. */
+MB_JSON_PUBLIC(void) MB_JSON_ScannerInit(MB_JSON_Scanner *scanner, MB_JSON_ScanHook hook, void *arg);
+/* Feed the next piece of JSON text to the scanner. Returns 0 when the text is malformed. */
+MB_JSON_PUBLIC(MB_JSON_bool) MB_JSON_ScannerFeed(MB_JSON_Scanner *scanner, const char *buffer, size_t length);
+
 /* Render a MB_JSON entity to text for transfer/storage. */
 MB_JSON_PUBLIC(char *) MB_JSON_Print(const MB_JSON *item);
 /* Render a MB_JSON entity to text for transfer/storage without any formatting. */
 MB_JSON_PUBLIC(char *) MB_JSON_PrintUnformatted(const MB_JSON *item);
+/* Render a MB_JSON entity to text without any formatting and report the position of every value to hook. */
+MB_JSON_PUBLIC(char *) MB_JSON_PrintUnformattedWithSpans(const MB_JSON *item, MB_JSON_SpanHook hook, void *arg);
 /* Render a MB_JSON entity to text using a buffered strategy. prebuffer is a guess at the final size. guessing well reduces reallocation. fmt=0 gives unformatted, =1 gives formatted */
 MB_JSON_PUBLIC(char *) MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer, MB_JSON_bool fmt);
 /* Render a MB_JSON entity to text using a buffer already allocated in memory with given length. Returns 1 on success and 0 on failure. */
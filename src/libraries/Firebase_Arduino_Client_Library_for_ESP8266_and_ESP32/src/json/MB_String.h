@@ -1,11 +1,23 @@
 
 /**
- * Mobizt's SRAM/PSRAM supported String, version 1.2.12
+ * Mobizt's SRAM/PSRAM supported String, version 1.2.15
  *
  * Created March 25, 2024
  *
  * Changes Log
  *
+ * v1.2.15
+ * - allocate through MB_Alloc (string tag, PSRAM policy and stats)
+ * - fix append, insert and assign of a part of the string itself
+ *
+ * v1.2.14
+ * - add allocator hooks (MB_String::setHooks)
+ *
+ * v1.2.13
+ * - geometric buffer growth and shrink_to_fit
+ * - inline buffer for short strings
+ * - add move constructor and assignment, fix operator+ modifies its operands
+ *
  * v1.2.12
  * - using std namespace
  * 
@@ -97,12 +109,23 @@
 #define MB_STRING_MINOR 2
 #define MB_STRING_PATCH 5
 
+#include "../mbfs/MB_Alloc.h"
+
 #if defined(ESP8266) && defined(MMU_EXTERNAL_HEAP) && defined(MB_STRING_USE_PSRAM)
 #include <umm_malloc/umm_malloc.h>
 #include <umm_malloc/umm_heap_select.h>
 #define ESP8266_USE_EXTERNAL_HEAP
 #endif
 
+// The size of inline buffer for short string (including NUL terminator), 0 to disable.
+#if !defined(MB_STRING_SSO_SIZE)
+#if defined(__AVR__) || defined(ESP8266_USE_EXTERNAL_HEAP)
+#define MB_STRING_SSO_SIZE 0
+#else
+#define MB_STRING_SSO_SIZE 16
+#endif
+#endif
+
 #if defined(ESP8266) || defined(ESP32)
 #define MBSTRING_FLASH_MCR FPSTR
 #elif defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT)
@@ -113,6 +136,28 @@
 
 class MB_String;
 
+// The allocator that replaces the default (heap/PSRAM) allocation of the string buffers,
+// e.g. the counting allocator for profiling the string building.
+typedef struct MB_String_Hooks
+{
+    void *(*malloc_fn)(size_t sz);
+    void *(*realloc_fn)(void *ptr, size_t sz);
+    void (*free_fn)(void *ptr);
+} MB_String_Hooks;
+
+inline MB_String_Hooks *&mb_string_hooks()
+{
+    static MB_String_Hooks *hooks = NULL;
+    return hooks;
+}
+
+// The number of live string buffers, the allocator can only be changed when none is alive
+inline size_t &mb_string_blocks()
+{
+    static size_t blocks = 0;
+    return blocks;
+}
+
 #define pgm2Str(p) (MB_String().appendP(p).c_str())
 #define num2Str(v, p) (MB_String().appendNum(v, p).c_str())
 
@@ -147,7 +192,7 @@ namespace mb_string
     {
 
     public:
-        mb_string_ptr_t(uint32_t addr = 0, mb_string_sub_type type = mb_string_sub_type_cstring, int precision = -1, const StringSumHelper *s = nullptr)
+        mb_string_ptr_t(uintptr_t addr = 0, mb_string_sub_type type = mb_string_sub_type_cstring, int precision = -1, const StringSumHelper *s = nullptr)
         {
             _addr = addr;
             _type = type;
@@ -156,13 +201,13 @@ namespace mb_string
         }
         int precision() { return _precision; }
         mb_string_sub_type type() { return _type; }
-        uint32_t address() { return _addr; }
+        uintptr_t address() { return _addr; }
         const StringSumHelper *stringsumhelper() { return _ssh; }
 
     private:
         mb_string_sub_type _type = mb_string_sub_type_none;
         int _precision = -1;
-        uint32_t _addr = 0;
+        uintptr_t _addr = 0;
         const StringSumHelper *_ssh = nullptr;
 
     } MB_StringPtr;
@@ -389,17 +434,17 @@ namespace mb_string
     };
 
     template <typename T>
-    uint32_t toAddr(T &v) { return reinterpret_cast<uint32_t>(&v); }
+    uintptr_t toAddr(T &v) { return reinterpret_cast<uintptr_t>(&v); }
 
 #if defined(__AVR__)
     template <typename T>
-    T addrTo(int address)
+    T addrTo(uintptr_t address)
     {
         return reinterpret_cast<T>(address);
     }
 #else
     template <typename T>
-    auto addrTo(int address) -> typename std::enable_if<!std::is_same<T, nullptr_t>::value, T>::type
+    auto addrTo(uintptr_t address) -> typename std::enable_if<!std::is_same<T, nullptr_t>::value, T>::type
     {
         return reinterpret_cast<T>(address);
     }
@@ -408,6 +453,7 @@ namespace mb_string
     template <typename T>
     auto getSubType(T val) -> typename std::enable_if<is_num_int<T>::value || is_num_float<T>::value || std::is_same<T, bool>::value || is_const_chars<T>::value || is_arduino_flash_string_helper<T>::value || is_arduino_string<T>::value || is_std_string<T>::value || is_mb_string<T>::value || std::is_same<T, StringSumHelper>::value, mb_string_sub_type>::type
     {
+        (void)val;
         if (is_num_uint64<T>::value)
             return mb_string_sub_type_uint64;
         else if (is_num_int64<T>::value)
@@ -457,25 +503,25 @@ namespace mb_string
     template <typename T>
     auto toStringPtr(const T &val) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value, MB_StringPtr>::type
     {
-        return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val));
+        return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val));
     }
 
     template <typename T>
     auto toStringPtr(const T &val) -> typename std::enable_if<std::is_same<T, StringSumHelper>::value, MB_StringPtr>::type
     {
 #if defined(ESP8266)
-        return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val), -1);
+        return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val), -1);
 
 #else
-        return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val), -1, &val);
+        return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val), -1, &val);
 #endif
     }
 
     template <typename T>
-    auto toStringPtr(T val) -> typename std::enable_if<is_const_chars<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uint32_t>(val), getSubType(val)); }
+    auto toStringPtr(T val) -> typename std::enable_if<is_const_chars<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uintptr_t>(val), getSubType(val)); }
 
     template <typename T>
-    auto toStringPtr(T &val) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uint32_t>(val), getSubType(val)); }
+    auto toStringPtr(T &val) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uintptr_t>(val), getSubType(val)); }
 
 #if !defined(__AVR__)
     template <typename T>
@@ -492,7 +538,7 @@ namespace mb_string
     }
 
     template <typename T>
-    auto toStringPtr(T &val, int precision = -1) -> typename std::enable_if<is_num_int<T>::value || is_num_float<T>::value || std::is_same<T, bool>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val), precision); }
+    auto toStringPtr(T &val, int precision = -1) -> typename std::enable_if<is_num_int<T>::value || is_num_float<T>::value || std::is_same<T, bool>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val), precision); }
 }
 
 using namespace mb_string;
@@ -524,6 +570,13 @@ public:
         *this = value;
     }
 
+#if !defined(__AVR__)
+    MB_String(MB_String &&value) noexcept
+    {
+        move(value);
+    }
+#endif
+
     MB_String(const __FlashStringHelper *str)
     {
         *this = str;
@@ -748,6 +801,16 @@ public:
         return *this;
     }
 
+#if !defined(__AVR__)
+    MB_String &operator=(MB_String &&rhs) noexcept
+    {
+        if (this != &rhs)
+            move(rhs);
+
+        return *this;
+    }
+#endif
+
     MB_String &operator+=(const MB_String &rhs)
     {
         concat(rhs);
@@ -756,6 +819,13 @@ public:
 
     MB_String &operator+=(const char *cstr)
     {
+        // a part of this string, e.g. s += s.c_str()
+        if (inBuffer(cstr))
+        {
+            concat(cstr, strlen(cstr));
+            return (*this);
+        }
+
         size_t len = strlen_P(cstr);
         size_t slen = length();
 
@@ -896,6 +966,7 @@ public:
     template <typename T = int>
     auto appendNum(T value, int precision = 0) -> typename std::enable_if<is_num_int<T>::value || is_bool<T>::value, MB_String &>::type
     {
+        (void)precision;
         char *s = NULL;
 
         if (is_bool<T>::value)
@@ -1017,7 +1088,6 @@ public:
         {
             memmove(buf, buf + p1, p2 - p1 + 1);
             buf[p2 - p1 + 1] = '\0';
-            _reserve(p2 - p1 + 1, true);
         }
     }
 
@@ -1026,16 +1096,10 @@ public:
         if (!cstr)
             return;
 
-        size_t slen = length();
-
         if (n > strlen(cstr))
             n = strlen(cstr);
 
-        if (_reserve(slen + n, false))
-        {
-            memmove(buf + slen, cstr, n);
-            *(buf + slen + n) = '\0';
-        }
+        concat(cstr, n);
     }
 
     void append(size_t n, char c)
@@ -1109,18 +1173,22 @@ public:
     void shrink_to_fit()
     {
         size_t slen = length();
-        _reserve(slen, true);
+        if (slen == 0)
+            clear();
+        else
+            _reserve(slen, true);
     }
 
     void pop_back()
     {
-        if (length() > 0)
-        {
-            size_t slen = length();
-            if (slen > 0)
-                buf[slen - 1] = '\0';
-            _reserve(slen, true);
-        }
+        size_t slen = length();
+        if (slen > 0)
+            buf[slen - 1] = '\0';
+    }
+
+    size_t capacity() const
+    {
+        return maxLength();
     }
 
     size_t size() const
@@ -1174,8 +1242,6 @@ public:
         memmove(buf + index, buf + index + len, rightLen);
 
         buf[index + rightLen] = '\0';
-
-        _reserve(length(), true);
     }
 
     size_t length() const
@@ -1216,12 +1282,10 @@ public:
     {
         if (len == 0)
             len = 4;
-        ESP.setExternalHeap();
         if (buf)
-            buf = (char *)realloc(buf, len);
+            buf = (char *)mRealloc(buf, len);
         else
-            buf = (char *)malloc(len);
-        ESP.resetHeap();
+            buf = (char *)mMalloc(len);
 
         if (buf)
         {
@@ -1233,7 +1297,7 @@ public:
 
     void resize(size_t len)
     {
-        if (_reserve(len, true))
+        if (_reserve(len, false))
             buf[len] = '\0';
     }
 
@@ -1292,6 +1356,13 @@ public:
 
     MB_String &insert(size_t pos, const char *cstr)
     {
+        // a part of this string is copied first, the buffer is moved while inserting
+        if (inBuffer(cstr))
+        {
+            MB_String part = cstr;
+            return insert(pos, part.c_str());
+        }
+
         size_t insLen = strlen(cstr);
 
         if (length() > 0 && length() > pos && insLen > 0)
@@ -1476,20 +1547,36 @@ public:
 
     static const size_t npos = -1;
 
+    /**
+     * Set the allocator for the string buffers, NULL to restore the default.
+     * The buffer is always released by the allocator that allocated it, the allocator can't be
+     * changed while any string buffer is alive.
+     * @return false when the string buffers of the current allocator are still alive.
+     */
+    static bool setHooks(MB_String_Hooks *hooks)
+    {
+        if (__atomic_load_n(&mb_string_blocks(), __ATOMIC_ACQUIRE) > 0)
+            return false;
+        mb_string_hooks() = hooks;
+        return true;
+    }
+
 private:
 #if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_UNOWIFIR4)
 
     char *int32Str(signed long value)
     {
         char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%ld"), value);
+        if (t)
+            snprintf(t, 64, (const char *)MBSTRING_FLASH_MCR("%ld"), value);
         return t;
     }
 
     char *uint32Str(unsigned long value)
     {
         char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%lu"), value);
+        if (t)
+            snprintf(t, 64, (const char *)MBSTRING_FLASH_MCR("%lu"), value);
         return t;
     }
 
@@ -1498,21 +1585,24 @@ private:
     char *int64Str(signed long long value)
     {
         char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%lld"), value);
+        if (t)
+            snprintf(t, 64, (const char *)MBSTRING_FLASH_MCR("%lld"), value);
         return t;
     }
 
     char *uint64Str(unsigned long long value)
     {
         char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%llu"), value);
+        if (t)
+            snprintf(t, 64, (const char *)MBSTRING_FLASH_MCR("%llu"), value);
         return t;
     }
 
     char *boolStr(bool value)
     {
         char *t = (char *)newP(8);
-        value ? strcpy(t, (const char *)MBSTRING_FLASH_MCR("true")) : strcpy(t, (const char *)MBSTRING_FLASH_MCR("false"));
+        if (t)
+            value ? strcpy(t, (const char *)MBSTRING_FLASH_MCR("true")) : strcpy(t, (const char *)MBSTRING_FLASH_MCR("false"));
         return t;
     }
 
@@ -1547,14 +1637,16 @@ private:
     char *nullStr()
     {
         char *t = (char *)newP(6);
-        strcpy(t, (const char *)MBSTRING_FLASH_MCR("null"));
+        if (t)
+            strcpy(t, (const char *)MBSTRING_FLASH_MCR("null"));
         return t;
     }
 
     char *pgmStr(PGM_P p)
     {
         char *t = (char *)newP(strlen_P(p));
-        strcpy_P(t, p);
+        if (t)
+            strcpy_P(t, p);
         return t;
     }
 
@@ -1580,33 +1672,13 @@ private:
 
     void *newP(size_t len)
     {
-        void *p;
         size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-        if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
-        else
-            p = (void *)malloc(newLen);
-        if (!p)
-            return NULL;
-
-#else
 
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.setExternalHeap();
-#endif
+        void *p = mMalloc(newLen);
 
-        p = (void *)malloc(newLen);
-        bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.resetHeap();
-#endif
-
-        if (!nn)
+        if (!p)
             return NULL;
 
-#endif
         memset(p, 0, newLen);
         return p;
     }
@@ -1616,11 +1688,57 @@ private:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            mFree(*p);
             *p = 0;
         }
     }
 
+    // The allocator is not changed while the buffers are alive (setHooks), the buffer is always freed
+    // by the allocator that allocated it.
+    void *mMalloc(size_t len)
+    {
+        void *p;
+        if (mb_string_hooks())
+            p = mb_string_hooks()->malloc_fn(len);
+        else
+            p = MB_Alloc::alloc(MB_Alloc::tag(mb_alloc_tag_string), len, usePSRAM());
+        if (p)
+            __atomic_add_fetch(&mb_string_blocks(), 1, __ATOMIC_RELAXED);
+        return p;
+    }
+
+    void *mRealloc(void *ptr, size_t len)
+    {
+        void *p;
+        if (mb_string_hooks())
+            p = mb_string_hooks()->realloc_fn(ptr, len);
+        else
+            p = MB_Alloc::realloc(MB_Alloc::tag(mb_alloc_tag_string), ptr, len, usePSRAM());
+        if (!ptr && p)
+            __atomic_add_fetch(&mb_string_blocks(), 1, __ATOMIC_RELAXED);
+        return p;
+    }
+
+    void mFree(void *ptr)
+    {
+        if (!ptr)
+            return;
+        __atomic_sub_fetch(&mb_string_blocks(), 1, __ATOMIC_RELAXED);
+        if (mb_string_hooks())
+            mb_string_hooks()->free_fn(ptr);
+        else
+            MB_Alloc::free(ptr);
+    }
+
+    static bool usePSRAM()
+    {
+#if defined(MB_STRING_USE_PSRAM)
+        return true;
+#else
+        return false;
+#endif
+    }
+
     size_t getReservedLen(size_t len)
     {
         int blen = len + 1;
@@ -1673,8 +1791,12 @@ private:
 
         if (slen + len > maxLength())
         {
+            // a part of this string moves with the buffer
+            size_t ofs = inBuffer(cstr) ? cstr - buf : npos;
             if (!_reserve(slen + len, false))
                 return;
+            if (ofs != npos)
+                cstr = buf + ofs;
         }
 
         memmove(buf + slen, cstr, len);
@@ -1689,25 +1811,40 @@ private:
         concat(cstr, strlen(cstr));
     }
 
+    // the pointer is in the buffer of this string, e.g. its c_str()
+    bool inBuffer(const char *p) const
+    {
+        return buf && p >= buf && p < buf + bufLen;
+    }
+
+    bool isInline() const
+    {
+#if MB_STRING_SSO_SIZE > 0
+        return buf == sso;
+#else
+        return false;
+#endif
+    }
+
     void move(MB_String &rhs)
     {
-        if (buf)
+        // the inline buffer can't be taken, copy the short string instead
+        if (!rhs.buf || rhs.isInline())
         {
-            if (bufLen >= rhs.bufLen)
-            {
-                strcpy(buf, rhs.buf);
-                bufLen = rhs.bufLen;
-                rhs.bufLen = 0;
-                return;
-            }
+            if (rhs.length() > 0)
+                copy(rhs.buf, rhs.length());
             else
-            {
-                free(buf);
-            }
+                clear();
+            rhs.clear();
+            return;
         }
+
+        allocate(0, false);
         buf = rhs.buf;
         bufLen = rhs.bufLen;
         rhs.buf = NULL;
+        rhs.bufLen = 0;
+        rhs.clear();
     }
 
     void allocate(size_t len, bool shrink)
@@ -1715,63 +1852,64 @@ private:
 
         if (len == 0)
         {
-            if (buf)
-                free(buf);
+            if (buf && !isInline())
+                mFree(buf);
             buf = NULL;
             bufLen = 0;
             return;
         }
 
-        if (len > bufLen || shrink)
-        {
+        if (len == bufLen || (len < bufLen && !shrink))
+            return;
 
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-            ESP.setExternalHeap();
-#endif
+        // the content that will be kept, truncated when shrinking below its length
+        size_t slen = length();
+        if (slen >= len)
+            slen = len - 1;
 
-            if (shrink || (bufLen > 0 && buf))
+#if MB_STRING_SSO_SIZE > 0
+        if (len <= MB_STRING_SSO_SIZE)
+        {
+            if (!isInline())
             {
-                int slen = length();
-
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-                if (ESP.getPsramSize() > 0)
-                    buf = (char *)ps_realloc(buf, len);
-                else
-                    buf = (char *)realloc(buf, len);
-#else
-                buf = (char *)realloc(buf, len);
-#endif
                 if (buf)
                 {
-                    buf[slen] = '\0';
-                    bufLen = len;
+                    memcpy(sso, buf, slen);
+                    mFree(buf);
                 }
+                buf = sso;
+                bufLen = MB_STRING_SSO_SIZE;
             }
-            else
-            {
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-                if (ESP.getPsramSize() > 0)
-                    buf = (char *)ps_malloc(len);
-                else
-                    buf = (char *)malloc(len);
-#else
-                buf = (char *)malloc(len);
+            buf[slen] = '\0';
+            return;
+        }
 #endif
-                if (buf)
-                {
-                    buf[0] = '\0';
-                    bufLen = len;
-                }
-            }
 
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-            ESP.resetHeap();
-#endif
+        char *p = NULL;
+
+        if (buf && !isInline())
+            p = (char *)mRealloc(buf, len);
+        else
+        {
+            p = (char *)mMalloc(len);
+            // move out of the inline buffer
+            if (p && buf)
+                memcpy(p, buf, slen);
+        }
+
+        // keep the current buffer when allocation failed
+        if (p)
+        {
+            buf = p;
+            buf[slen] = '\0';
+            bufLen = len;
         }
     }
 
     MB_String &copy(const char *cstr, size_t length)
     {
+        // a part of this string, e.g. s = s.c_str() + 1, moves with the buffer
+        size_t ofs = inBuffer(cstr) ? cstr - buf : npos;
 
         if (!_reserve(length, false))
         {
@@ -1779,7 +1917,10 @@ private:
             return *this;
         }
 
-        memcpy_P(buf, (PGM_P)cstr, length);
+        if (ofs != npos)
+            memmove(buf, buf + ofs, length);
+        else
+            memcpy_P(buf, (PGM_P)cstr, length);
         buf[length] = '\0';
 
         return *this;
@@ -1792,7 +1933,14 @@ private:
         if (shrink)
             allocate(newlen, true);
         else if (newlen > bufLen)
-            allocate(newlen, false);
+        {
+            // grow the allocated buffer geometrically to avoid reallocation on every append
+            size_t cap = bufLen > 0 && bufLen * 2 > newlen ? bufLen * 2 : newlen;
+            allocate(cap, false);
+            // try the exact size when the larger one can't be allocated
+            if (cap > newlen && bufLen < newlen)
+                allocate(newlen, false);
+        }
 
         return newlen <= bufLen;
     }
@@ -2038,6 +2186,9 @@ private:
 
     char *buf = NULL;
     size_t bufLen = 0;
+#if MB_STRING_SSO_SIZE > 0
+    char sso[MB_STRING_SSO_SIZE];
+#endif
 };
 
 inline MB_String operator+(const MB_String &lhs, const MB_String &rhs)
@@ -2049,35 +2200,88 @@ inline MB_String operator+(const MB_String &lhs, const MB_String &rhs)
     return res;
 }
 
+inline MB_String operator+(const MB_String &lhs, const char *rhs)
+{
+    MB_String res;
+    res.reserve(lhs.length() + (rhs ? strlen_P(rhs) : 0));
+    res += lhs;
+    if (rhs)
+        res += rhs;
+    return res;
+}
+
+inline MB_String operator+(const char *lhs, const MB_String &rhs)
+{
+    MB_String res;
+    res.reserve((lhs ? strlen_P(lhs) : 0) + rhs.length());
+    if (lhs)
+        res += lhs;
+    res += rhs;
+    return res;
+}
+
+inline MB_String operator+(const MB_String &lhs, char rhs)
+{
+    MB_String res;
+    res.reserve(lhs.length() + 1);
+    res += lhs;
+    res += rhs;
+    return res;
+}
+
+inline MB_String operator+(char lhs, const MB_String &rhs)
+{
+    MB_String res;
+    res.reserve(rhs.length() + 1);
+    res += lhs;
+    res += rhs;
+    return res;
+}
+
 #if !defined(__AVR__)
 
+// The temporary operand buffer is reused through the chain e.g. a + b + c + d.
+
 inline MB_String operator+(MB_String &&lhs, const MB_String &rhs)
 {
     lhs += rhs;
     return std::move(lhs);
 }
 
-inline MB_String operator+(MB_String &lhs, MB_String &&rhs)
+inline MB_String operator+(MB_String &&lhs, MB_String &&rhs)
 {
     lhs += rhs;
     return std::move(lhs);
 }
 
-inline MB_String operator+(MB_String &lhs, char rhs)
+inline MB_String operator+(const MB_String &lhs, MB_String &&rhs)
 {
-    lhs += rhs;
-    return std::move(lhs);
+    if (rhs.length() == 0)
+        return lhs;
+    rhs.insert(0, lhs);
+    return std::move(rhs);
 }
 
-inline MB_String operator+(char lhs, MB_String &rhs)
+inline MB_String operator+(MB_String &&lhs, const char *rhs)
 {
-    rhs.insert(0, lhs);
-    return rhs;
+    if (rhs)
+        lhs += rhs;
+    return std::move(lhs);
 }
 
 inline MB_String operator+(MB_String &&lhs, char rhs)
 {
-    return std::move(lhs.insert(0, rhs));
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+inline MB_String operator+(char lhs, MB_String &&rhs)
+{
+    if (rhs.length() == 0)
+        rhs += lhs;
+    else
+        rhs.insert(0, lhs);
+    return std::move(rhs);
 }
 
 #endif
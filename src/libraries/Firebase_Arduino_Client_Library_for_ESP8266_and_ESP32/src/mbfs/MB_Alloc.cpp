@@ -0,0 +1,552 @@
+/**
+ * The tagged memory allocation for Arduino devices, MB_Alloc v1.0.0
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MB_ALLOC_CPP
+#define MB_ALLOC_CPP
+
+#include <Arduino.h>
+#include "../FirebaseFS.h"
+#include "MB_Alloc.h"
+
+// The block table is only in this file, the option can't differ between the allocation and free.
+#if defined(ENABLE_ALLOC_STATS) || defined(FIREBASE_ENABLE_ALLOC_STATS)
+#define MB_ALLOC_STATS
+#endif
+
+#if defined(ESP8266) && defined(MMU_EXTERNAL_HEAP)
+#include <umm_malloc/umm_malloc.h>
+#include <umm_malloc/umm_heap_select.h>
+#define MB_ALLOC_ESP8266_EXTERNAL_HEAP
+#endif
+
+#if defined(ESP32)
+#include <esp_heap_caps.h>
+static portMUX_TYPE mb_alloc_mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+#if defined(MB_ALLOC_STATS)
+
+// The live block, the blocks are kept by their addresses in the open addressing table,
+// the memory of the pointer that was not allocated here is never read.
+typedef struct mb_alloc_block_t
+{
+    void *ptr;
+    uint32_t len;
+    uint8_t tag;
+    uint8_t psram;
+} mb_alloc_block;
+
+#define MB_ALLOC_BLOCKS_MIN 64
+
+static mb_alloc_block *mb_alloc_blocks = NULL;
+static size_t mb_alloc_blocks_cap = 0;
+static size_t mb_alloc_blocks_len = 0;
+
+#endif
+
+// The PSRAM threshold of each tag, the large and long-lived blocks go to PSRAM
+static uint32_t mb_alloc_policy[mb_alloc_tag_max] = {
+    0,    // other
+    0,    // json, the documents are kept by the user
+    256,  // string, the short strings are in the string object, the rest are mostly temporary
+    0,    // tls, the I/O buffers live with the connection
+    1024, // http, the chunk buffers live for one request
+    0,    // rtdb_queue
+    0     // firesense
+};
+
+static MB_AllocStats mb_alloc_stats[mb_alloc_tag_max];
+
+static size_t mb_alloc_watchdog_block = 0;
+static size_t mb_alloc_lowest_block = 0;
+static bool mb_alloc_watchdog_low = false;
+static MB_AllocWatchdogCallback mb_alloc_watchdog_cb = NULL;
+
+static const char *const mb_alloc_tag_names[mb_alloc_tag_max] = {"other", "json", "string", "tls", "http", "rtdb-queue", "firesense"};
+
+MB_ALLOC_SCOPE_TLS uint8_t MB_Alloc::_scope_tag = mb_alloc_tag_max;
+
+static void mb_alloc_lock()
+{
+#if defined(ESP32)
+    portENTER_CRITICAL(&mb_alloc_mux);
+#endif
+}
+
+static void mb_alloc_unlock()
+{
+#if defined(ESP32)
+    portEXIT_CRITICAL(&mb_alloc_mux);
+#endif
+}
+
+static bool mb_alloc_has_psram()
+{
+#if defined(BOARD_HAS_PSRAM)
+    return ESP.getPsramSize() > 0;
+#elif defined(MB_ALLOC_ESP8266_EXTERNAL_HEAP)
+    return true;
+#else
+    return false;
+#endif
+}
+
+static void *mb_alloc_raw(void *ptr, size_t len, bool psram)
+{
+    (void)psram;
+#if defined(BOARD_HAS_PSRAM)
+    if (psram)
+        return ptr ? ps_realloc(ptr, len) : ps_malloc(len);
+#elif defined(MB_ALLOC_ESP8266_EXTERNAL_HEAP)
+    if (psram)
+    {
+        ESP.setExternalHeap();
+        void *p = ptr ? ::realloc(ptr, len) : ::malloc(len);
+        ESP.resetHeap();
+        return p;
+    }
+#endif
+    return ptr ? ::realloc(ptr, len) : ::malloc(len);
+}
+
+// Allocate in the region of the policy then in the other one
+static void *mb_alloc_route(void *ptr, uint8_t tag, size_t len, bool psram, bool &inPsram)
+{
+    bool hasPsram = psram && mb_alloc_has_psram();
+    inPsram = hasPsram && len >= mb_alloc_policy[tag];
+
+    void *p = mb_alloc_raw(ptr, len, inPsram);
+    if (!p && hasPsram)
+    {
+        inPsram = !inPsram;
+        p = mb_alloc_raw(ptr, len, inPsram);
+    }
+    return p;
+}
+
+// The stats update functions must be called with the lock
+static void mb_alloc_add(uint8_t tag, uint32_t len, bool psram)
+{
+    (void)len;
+    (void)psram;
+    MB_AllocStats &stats = mb_alloc_stats[tag];
+    stats.allocs++;
+#if defined(MB_ALLOC_STATS)
+    stats.blocks++;
+    stats.live += len;
+    if (psram)
+        stats.psram += len;
+    if (stats.live > stats.peak)
+        stats.peak = stats.live;
+#endif
+}
+
+static void mb_alloc_fail(uint8_t tag)
+{
+    mb_alloc_lock();
+    mb_alloc_stats[tag].fails++;
+    mb_alloc_unlock();
+    MB_Alloc::checkWatchdog();
+}
+
+#if defined(MB_ALLOC_STATS)
+
+static void mb_alloc_sub(uint8_t tag, uint32_t len, bool psram)
+{
+    MB_AllocStats &stats = mb_alloc_stats[tag];
+    stats.blocks--;
+    stats.live -= len;
+    if (psram)
+        stats.psram -= len;
+}
+
+static size_t mb_alloc_slot(const void *ptr, size_t cap)
+{
+    uintptr_t h = reinterpret_cast<uintptr_t>(ptr) >> 3;
+    return (size_t)(h * 2654435761u) & (cap - 1);
+}
+
+// The block table functions below must be called with the lock, the table is never full
+static mb_alloc_block *mb_alloc_find(const void *ptr)
+{
+    if (!mb_alloc_blocks)
+        return NULL;
+
+    size_t mask = mb_alloc_blocks_cap - 1;
+    for (size_t i = mb_alloc_slot(ptr, mb_alloc_blocks_cap);; i = (i + 1) & mask)
+    {
+        if (mb_alloc_blocks[i].ptr == ptr)
+            return &mb_alloc_blocks[i];
+        if (!mb_alloc_blocks[i].ptr)
+            return NULL;
+    }
+}
+
+static void mb_alloc_insert(mb_alloc_block *blocks, size_t cap, const mb_alloc_block &block)
+{
+    size_t i = mb_alloc_slot(block.ptr, cap);
+    while (blocks[i].ptr)
+        i = (i + 1) & (cap - 1);
+    blocks[i] = block;
+}
+
+static void mb_alloc_remove(mb_alloc_block *block)
+{
+    size_t mask = mb_alloc_blocks_cap - 1;
+    size_t i = block - mb_alloc_blocks;
+    size_t j = i;
+
+    // shift back the following blocks of the probe sequence, no tombstone
+    for (;;)
+    {
+        j = (j + 1) & mask;
+        if (!mb_alloc_blocks[j].ptr)
+            break;
+
+        // the block stays when its home slot is in the cyclic range (i, j]
+        size_t k = mb_alloc_slot(mb_alloc_blocks[j].ptr, mb_alloc_blocks_cap);
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+
+        mb_alloc_blocks[i] = mb_alloc_blocks[j];
+        i = j;
+    }
+
+    mb_alloc_blocks[i].ptr = NULL;
+    mb_alloc_blocks_len--;
+}
+
+// Double the block table of the capacity cap, the table is allocated outside the lock
+static bool mb_alloc_grow(size_t cap)
+{
+    size_t newCap = cap ? cap * 2 : MB_ALLOC_BLOCKS_MIN;
+    mb_alloc_block *blocks = reinterpret_cast<mb_alloc_block *>(::calloc(newCap, sizeof(mb_alloc_block)));
+    if (!blocks)
+        return false;
+
+    mb_alloc_lock();
+
+    // the other task has grown it
+    if (mb_alloc_blocks_cap != cap)
+    {
+        mb_alloc_unlock();
+        ::free(blocks);
+        return true;
+    }
+
+    for (size_t i = 0; i < mb_alloc_blocks_cap; i++)
+    {
+        if (mb_alloc_blocks[i].ptr)
+            mb_alloc_insert(blocks, newCap, mb_alloc_blocks[i]);
+    }
+
+    mb_alloc_block *old = mb_alloc_blocks;
+    mb_alloc_blocks = blocks;
+    mb_alloc_blocks_cap = newCap;
+    mb_alloc_unlock();
+
+    ::free(old);
+    return true;
+}
+
+// Add the block to the table and the stats, false if the table can't grow
+static bool mb_alloc_track(void *ptr, uint8_t tag, uint32_t len, bool psram)
+{
+    mb_alloc_block block = {ptr, len, tag, psram};
+
+    for (;;)
+    {
+        mb_alloc_lock();
+        size_t cap = mb_alloc_blocks_cap;
+
+        // the load factor is kept at 3/4
+        if ((mb_alloc_blocks_len + 1) * 4 <= cap * 3)
+        {
+            mb_alloc_insert(mb_alloc_blocks, cap, block);
+            mb_alloc_blocks_len++;
+            mb_alloc_add(tag, len, psram);
+            mb_alloc_unlock();
+            return true;
+        }
+
+        mb_alloc_unlock();
+
+        if (!mb_alloc_grow(cap))
+            return false;
+    }
+}
+
+// Remove the block from the table and the stats, false if it was not allocated here
+static bool mb_alloc_untrack(void *ptr, mb_alloc_block &block)
+{
+    mb_alloc_lock();
+    mb_alloc_block *b = mb_alloc_find(ptr);
+    if (b)
+    {
+        block = *b;
+        mb_alloc_sub(block.tag, block.len, block.psram);
+        mb_alloc_remove(b);
+    }
+    mb_alloc_unlock();
+    return b != NULL;
+}
+
+#endif
+
+void *MB_Alloc::alloc(uint8_t tag, size_t len, bool psram, bool clear)
+{
+    if (tag >= mb_alloc_tag_max)
+        tag = mb_alloc_tag_other;
+
+    bool inPsram = false;
+    void *p = mb_alloc_route(nullptr, tag, len, psram, inPsram);
+
+#if defined(MB_ALLOC_STATS)
+    if (p && !mb_alloc_track(p, tag, len, inPsram))
+    {
+        ::free(p);
+        p = NULL;
+    }
+#endif
+
+    if (!p)
+    {
+        mb_alloc_fail(tag);
+        return NULL;
+    }
+
+#if !defined(MB_ALLOC_STATS)
+    mb_alloc_lock();
+    mb_alloc_add(tag, len, inPsram);
+    mb_alloc_unlock();
+#endif
+
+    if (clear)
+        memset(p, 0, len);
+    return p;
+}
+
+void *MB_Alloc::realloc(uint8_t tag, void *ptr, size_t len, bool psram)
+{
+    if (!ptr)
+        return alloc(tag, len, psram);
+
+    if (tag >= mb_alloc_tag_max)
+        tag = mb_alloc_tag_other;
+
+    bool inPsram = false;
+
+#if defined(MB_ALLOC_STATS)
+    // The block is removed before it is resized, its address can be reused by the other task
+    // as soon as it was moved.
+    mb_alloc_block block;
+    bool tracked = mb_alloc_untrack(ptr, block);
+
+    // the block keeps its tag
+    if (tracked)
+        tag = block.tag;
+
+    void *p = mb_alloc_route(ptr, tag, len, psram, inPsram);
+    if (!p)
+    {
+        // the block is still valid
+        if (tracked)
+            mb_alloc_track(ptr, block.tag, block.len, block.psram);
+        mb_alloc_fail(tag);
+        return NULL;
+    }
+
+    // the block that was not allocated here or can't be tracked is freed as is
+    if (tracked)
+        mb_alloc_track(p, tag, len, inPsram);
+#else
+    void *p = mb_alloc_route(ptr, tag, len, psram, inPsram);
+    if (!p)
+    {
+        mb_alloc_fail(tag);
+        return NULL;
+    }
+
+    mb_alloc_lock();
+    mb_alloc_add(tag, len, inPsram);
+    mb_alloc_unlock();
+#endif
+
+    return p;
+}
+
+void MB_Alloc::free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+#if defined(MB_ALLOC_STATS)
+    // the block that was not allocated here is freed as is
+    mb_alloc_block block;
+    mb_alloc_untrack(ptr, block);
+#endif
+
+    ::free(ptr);
+}
+
+uint8_t MB_Alloc::tag(uint8_t defaultTag)
+{
+    uint8_t tag = _scope_tag;
+    return tag < mb_alloc_tag_max ? tag : defaultTag;
+}
+
+void MB_Alloc::setPolicy(uint8_t tag, uint32_t psramMinLen)
+{
+    if (tag < mb_alloc_tag_max)
+        mb_alloc_policy[tag] = psramMinLen;
+}
+
+uint32_t MB_Alloc::getPolicy(uint8_t tag)
+{
+    return tag < mb_alloc_tag_max ? mb_alloc_policy[tag] : MB_ALLOC_PSRAM_NEVER;
+}
+
+MB_AllocStats MB_Alloc::getStats(uint8_t tag)
+{
+    MB_AllocStats stats;
+    if (tag < mb_alloc_tag_max)
+    {
+        mb_alloc_lock();
+        stats = mb_alloc_stats[tag];
+        mb_alloc_unlock();
+    }
+    return stats;
+}
+
+void MB_Alloc::resetStats()
+{
+    mb_alloc_lock();
+    for (int i = 0; i < mb_alloc_tag_max; i++)
+    {
+        mb_alloc_stats[i].peak = mb_alloc_stats[i].live;
+        mb_alloc_stats[i].allocs = 0;
+        mb_alloc_stats[i].fails = 0;
+    }
+    mb_alloc_lowest_block = 0;
+    mb_alloc_unlock();
+}
+
+size_t MB_Alloc::largestFreeBlock()
+{
+#if defined(ESP32)
+    return heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#elif defined(ESP8266)
+    return ESP.getMaxFreeBlockSize();
+#elif defined(MB_HOST)
+    return host_largest_free_block();
+#else
+    return 0;
+#endif
+}
+
+size_t MB_Alloc::lowestFreeBlock() { return mb_alloc_lowest_block; }
+
+void MB_Alloc::setWatchdog(size_t minBlock, MB_AllocWatchdogCallback cb)
+{
+    mb_alloc_watchdog_block = minBlock;
+    mb_alloc_watchdog_cb = cb;
+    mb_alloc_watchdog_low = false;
+}
+
+bool MB_Alloc::checkWatchdog()
+{
+    size_t block = largestFreeBlock();
+    if (block == 0)
+        return true;
+
+    mb_alloc_lock();
+    if (mb_alloc_lowest_block == 0 || block < mb_alloc_lowest_block)
+        mb_alloc_lowest_block = block;
+    mb_alloc_unlock();
+
+    if (mb_alloc_watchdog_block == 0 || block >= mb_alloc_watchdog_block)
+    {
+        mb_alloc_watchdog_low = false;
+        return true;
+    }
+
+    // once until it recovers
+    if (!mb_alloc_watchdog_low)
+    {
+        mb_alloc_watchdog_low = true;
+        if (mb_alloc_watchdog_cb)
+        {
+#if defined(ESP32)
+            mb_alloc_watchdog_cb(block, heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+#elif defined(ESP8266)
+            mb_alloc_watchdog_cb(block, ESP.getFreeHeap());
+#elif defined(MB_HOST)
+            mb_alloc_watchdog_cb(block, host_free_heap());
+#else
+            mb_alloc_watchdog_cb(block, 0);
+#endif
+        }
+    }
+
+    return false;
+}
+
+const char *MB_Alloc::tagName(uint8_t tag)
+{
+    return mb_alloc_tag_names[tag < mb_alloc_tag_max ? tag : (uint8_t)mb_alloc_tag_other];
+}
+
+void MB_Alloc::print(Print *out)
+{
+    if (!out)
+        return;
+
+    for (int i = 0; i < mb_alloc_tag_max; i++)
+    {
+        MB_AllocStats stats = getStats(i);
+        out->print(tagName(i));
+        out->print(" live=");
+        out->print(stats.live);
+        out->print(" peak=");
+        out->print(stats.peak);
+        out->print(" psram=");
+        out->print(stats.psram);
+        out->print(" blocks=");
+        out->print(stats.blocks);
+        out->print(" allocs=");
+        out->print(stats.allocs);
+        out->print(" fails=");
+        out->println(stats.fails);
+    }
+
+    out->print("largest_block=");
+    out->print((unsigned long)largestFreeBlock());
+    out->print(" lowest_block=");
+    out->println((unsigned long)lowestFreeBlock());
+}
+
+#endif
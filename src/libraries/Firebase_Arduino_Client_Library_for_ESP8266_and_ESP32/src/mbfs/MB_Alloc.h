@@ -0,0 +1,181 @@
+/**
+ * The tagged memory allocation for Arduino devices, MB_Alloc v1.0.0
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MB_ALLOC_H
+#define MB_ALLOC_H
+
+#include <Arduino.h>
+#include "MB_MCU.h"
+
+// The PSRAM threshold of the tag that never uses PSRAM
+#define MB_ALLOC_PSRAM_NEVER 0xffffffff
+
+// The scope tag is per task where the tasks are used
+#if defined(ESP32)
+#define MB_ALLOC_SCOPE_TLS thread_local
+#else
+#define MB_ALLOC_SCOPE_TLS
+#endif
+
+typedef enum
+{
+    // The allocations that are not tagged
+    mb_alloc_tag_other,
+    // FirebaseJson nodes and buffers
+    mb_alloc_tag_json,
+    // MB_String buffers
+    mb_alloc_tag_string,
+    // SSL client I/O buffers, cipher list and handshake data
+    mb_alloc_tag_tls,
+    // Request and response chunk buffers, upload and download buffers
+    mb_alloc_tag_http,
+    // The RTDB error queue items
+    mb_alloc_tag_rtdb_queue,
+    // FireSense addon
+    mb_alloc_tag_firesense,
+    mb_alloc_tag_max
+} mb_alloc_tag;
+
+typedef struct mb_alloc_stats_t
+{
+    // The live bytes and their peak, available when ENABLE_ALLOC_STATS is defined
+    uint32_t live = 0;
+    uint32_t peak = 0;
+    // The live bytes in PSRAM, available when ENABLE_ALLOC_STATS is defined
+    uint32_t psram = 0;
+    // The number of live blocks, available when ENABLE_ALLOC_STATS is defined
+    uint32_t blocks = 0;
+    // The number of allocations and the failed ones
+    uint32_t allocs = 0;
+    uint32_t fails = 0;
+
+} MB_AllocStats;
+
+/**
+ * The function that is called when the largest free block of internal RAM falls below the watchdog size.
+ * @param largestBlock The largest free block in bytes.
+ * @param freeHeap The free internal heap in bytes.
+ */
+typedef void (*MB_AllocWatchdogCallback)(size_t largestBlock, size_t freeHeap);
+
+// The common allocation of MB_FS, FirebaseJson, MB_String and SSL client.
+// The allocation goes to PSRAM (ESP32 PSRAM or ESP8266 external heap) when the caller enables PSRAM usage
+// and its size reaches the PSRAM threshold of its tag, the smaller ones stay in internal RAM.
+// When ENABLE_ALLOC_STATS is defined, the size and tag of every live block are kept in a table by its
+// address for the live bytes of each tag.
+class MB_Alloc
+{
+public:
+    /**
+     * Allocate memory.
+     * @param tag The mb_alloc_tag.
+     * @param len The number of bytes.
+     * @param psram True if the caller enables PSRAM usage.
+     * @param clear True to fill with zero.
+     * @return The pointer to the memory or NULL.
+     */
+    static void *alloc(uint8_t tag, size_t len, bool psram, bool clear = false);
+
+    /**
+     * Resize the memory that was allocated by alloc.
+     * @param tag The mb_alloc_tag of the new allocation when ptr is NULL.
+     * @param ptr The pointer to the memory or NULL.
+     * @param len The new number of bytes.
+     * @param psram True if the caller enables PSRAM usage.
+     * @return The pointer to the memory or NULL, ptr is still valid when failed.
+     */
+    static void *realloc(uint8_t tag, void *ptr, size_t len, bool psram);
+
+    /**
+     * Free the memory that was allocated by alloc or realloc.
+     * @param ptr The pointer to the memory or NULL.
+     */
+    static void free(void *ptr);
+
+    /**
+     * Get the tag of the allocation without tag (the MB_String and FirebaseJson allocations)
+     * which is the scope tag if set or the default tag.
+     */
+    static uint8_t tag(uint8_t defaultTag);
+
+    /**
+     * Set the PSRAM threshold of the tag.
+     * @param tag The mb_alloc_tag.
+     * @param psramMinLen The allocations of this size and larger go to PSRAM, 0 for all and
+     * MB_ALLOC_PSRAM_NEVER for none.
+     */
+    static void setPolicy(uint8_t tag, uint32_t psramMinLen);
+
+    static uint32_t getPolicy(uint8_t tag);
+
+    static MB_AllocStats getStats(uint8_t tag);
+
+    /* Clear the allocation counts and set the peaks to the live bytes */
+    static void resetStats();
+
+    /* The largest free block of internal RAM, 0 if not available */
+    static size_t largestFreeBlock();
+
+    /* The lowest largest free block seen by checkWatchdog, 0 if not checked */
+    static size_t lowestFreeBlock();
+
+    /**
+     * Set the largest free block watchdog.
+     * @param minBlock The largest free block below which the callback is called, 0 to disable.
+     * @param cb The MB_AllocWatchdogCallback function.
+     */
+    static void setWatchdog(size_t minBlock, MB_AllocWatchdogCallback cb);
+
+    /**
+     * Check the largest free block, call the watchdog callback when it falls below the watchdog size.
+     * @return false if the largest free block is below the watchdog size.
+     */
+    static bool checkWatchdog();
+
+    static const char *tagName(uint8_t tag);
+
+    /* Print the stats of all tags, one per line as <tag> live=<bytes> peak=<bytes> psram=<bytes> blocks=<n> allocs=<n> fails=<n> */
+    static void print(Print *out);
+
+private:
+    friend class MB_AllocTagScope;
+    static MB_ALLOC_SCOPE_TLS uint8_t _scope_tag;
+};
+
+// Tag the untagged allocations (MB_String, FirebaseJson) of the current task from the construction
+// to the destruction of the scope e.g. the queue item copies.
+class MB_AllocTagScope
+{
+public:
+    MB_AllocTagScope(uint8_t tag) : prev(MB_Alloc::_scope_tag) { MB_Alloc::_scope_tag = tag; }
+    ~MB_AllocTagScope() { MB_Alloc::_scope_tag = prev; }
+
+private:
+    uint8_t prev;
+};
+
+#endif
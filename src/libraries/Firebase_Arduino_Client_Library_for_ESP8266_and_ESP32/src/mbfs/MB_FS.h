@@ -40,6 +40,7 @@
 #endif
 #endif
 #include "MB_FS_Interfaces.h"
+#include "MB_Alloc.h"
 #include MB_STRING_INCLUDE_CLASS
 
 #if defined(MBFS_FLASH_FS) || defined(MBFS_SD_FS)
@@ -153,6 +154,11 @@ public:
     // Assign the SD card interfaces with GPIO pins.
     bool sdBegin(int ss = -1, int sck = -1, int miso = -1, int mosi = -1, uint32_t frequency = 4000000)
     {
+        (void)ss;
+        (void)sck;
+        (void)miso;
+        (void)mosi;
+        (void)frequency;
         if (sd_rdy)
             return true;
 
@@ -299,6 +305,9 @@ public:
     // Assign the SD_MMC card interfaces (ESP32 only).
     bool sdMMCBegin(const char *mountpoint, bool mode1bit, bool format_if_mount_failed)
     {
+        (void)mountpoint;
+        (void)mode1bit;
+        (void)format_if_mount_failed;
 
         if (sd_rdy)
             return true;
@@ -333,7 +342,7 @@ public:
         flash_rdy = MBFS_FLASH_FS.begin();
 #endif
 
-#elif defined(ESP8266) || defined(MB_ARDUINO_PICO)
+#elif defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST)
         flash_rdy = MBFS_FLASH_FS.begin();
 #endif
 
@@ -803,46 +812,19 @@ public:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            MB_Alloc::free(*p);
             *p = 0;
         }
     }
 
-    // Allocate memory
-    void *newP(size_t len, bool clear = true)
+    // Allocate memory, the tag is one of mb_alloc_tag for the allocation stats and PSRAM policy
+    void *newP(size_t len, bool clear = true, uint8_t tag = mb_alloc_tag_http)
     {
-        void *p;
-        size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-
-        if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
-        else
-            p = (void *)malloc(newLen);
-
-        if (!p)
-            return NULL;
-
+#if defined(MB_STRING_USE_PSRAM)
+        return MB_Alloc::alloc(tag, getReservedLen(len), true, clear);
 #else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.setExternalHeap();
-#endif
-
-        p = (void *)malloc(newLen);
-        bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.resetHeap();
-#endif
-
-        if (!nn)
-            return NULL;
-
+        return MB_Alloc::alloc(tag, getReservedLen(len), false, clear);
 #endif
-        if (clear)
-            memset(p, 0, newLen);
-        return p;
     }
 
     size_t getReservedLen(size_t len)
@@ -958,6 +940,8 @@ private:
 
     int openSDFile(const MB_String &filename, mb_fs_open_mode mode)
     {
+        (void)filename;
+        (void)mode;
         int ret = MB_FS_ERROR_FILE_IO_ERROR;
 
 #if defined(MBFS_SD_FS)
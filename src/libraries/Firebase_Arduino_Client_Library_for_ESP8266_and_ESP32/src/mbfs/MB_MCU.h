@@ -43,5 +43,12 @@
 #endif
 #endif
 
+// Desktop build against an Arduino API shim (no Arduino core).
+#if !defined(ARDUINO) && (defined(__linux__) || defined(__APPLE__))
+#ifndef MB_HOST
+#define MB_HOST
+#endif
+#endif
+
 
 #endif
\ No newline at end of file
@@ -83,6 +83,248 @@ bool FB_CM::send(FirebaseData *fbdo, FCM_HTTPv1_JSON_Message *msg)
     return ret;
 }
 
+bool FB_CM::mSendBatch(FirebaseData *fbdo, FCM_HTTPv1_JSON_Message *msg, const char *tokens[], size_t numToken,
+                       FCM_BatchResultCallback callback)
+{
+    Core.tokenReady();
+
+    if (Core.getTokenType() != token_type_oauth2_access_token)
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_OAUTH2_REQUIRED;
+        return false;
+    }
+
+    fbdo->tcpClient.setSPIEthernet(_spi_ethernet_module);
+
+    fbdo->session.http_code = 0;
+
+    if (!fbdo->reconnect())
+        return false;
+
+    if (!Core.waitIdle(fbdo->session.response.code))
+        return false;
+
+    if (fbdo->session.long_running_task > 0)
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_LONG_RUNNING_TASK;
+        return false;
+    }
+
+    if (Core.internal.fb_processing)
+        return false;
+
+    // build the message once with the placeholder token, only the token is substituted for each device
+    MB_String token = msg->token;
+    MB_String placeholder = firebase_fcm_pgm_str_72; // "__fcm_batch_token__"
+    msg->token = placeholder;
+    fcm_prepareV1Payload(msg);
+    msg->token = token;
+
+    size_t pos = raw.find(placeholder);
+    if (pos == MB_String::npos)
+    {
+        raw.clear();
+        fbdo->session.response.code = FIREBASE_ERROR_MISSING_DATA;
+        return false;
+    }
+
+    MB_String prefix = raw.substr(0, pos);
+    MB_String suffix = raw.substr(pos + placeholder.length());
+    raw.clear();
+
+    Core.internal.fb_processing = true;
+
+    fcm_connect(fbdo, firebase_fcm_msg_mode_httpv1);
+    fbdo->session.con_mode = firebase_con_mode_fcm;
+    fbdo->tcpClient.setCACert(nullptr);
+
+    // the request header except the content length is the same for all messages
+    MB_String req;
+    prepareHeader(fbdo, firebase_fcm_msg_mode_httpv1, nullptr, req);
+    Core.hh.addContentTypeHeader(req, firebase_pgm_str_62 /* "application/json" */);
+    size_t headerLen = req.length();
+    req.reserve(headerLen + prefix.length() + suffix.length() + 256);
+
+    // the indexes and send time of the messages waiting for their responses
+    size_t pending[FCM_BATCH_PIPELINE_DEPTH];
+    unsigned long sentMs[FCM_BATCH_PIPELINE_DEPTH];
+    size_t head = 0, count = 0, next = 0;
+    // the indexes of the messages to send again, before the next token, the pending and resend
+    // messages are never more than FCM_BATCH_PIPELINE_DEPTH
+    size_t resend[FCM_BATCH_PIPELINE_DEPTH];
+    size_t resendCount = 0;
+    uint32_t sent = 0;
+    unsigned long batchMs = millis();
+    bool ret = true;
+
+    FCM_BatchResult result;
+
+    while (next < numToken || count > 0 || resendCount > 0)
+    {
+        // the requests sent ahead are coalesced into full records until the next response is polled
+        fbdo->tcpClient.cork();
+
+        // send ahead until the pipeline is full
+        while (count < FCM_BATCH_PIPELINE_DEPTH && (resendCount > 0 || next < numToken))
+        {
+            // the resent messages were checked and counted when they were sent first
+            bool resending = resendCount > 0;
+            size_t index = resending ? resend[0] : next;
+
+            if (!resending)
+            {
+                if (!tokens[next] || strlen(tokens[next]) == 0)
+                {
+                    next++;
+                    continue;
+                }
+
+                // the token is copied into the JSON string as is
+                if (!isValidBatchToken(tokens[next]))
+                {
+                    batchStats.failed++;
+                    ret = false;
+
+                    if (callback)
+                    {
+                        result.index = next;
+                        result.token = tokens[next];
+                        result.httpCode = FIREBASE_ERROR_FCM_INVALID_TOKEN;
+                        result.payload = "";
+                        callback(result);
+                    }
+
+                    next++;
+                    continue;
+                }
+            }
+
+            // the connection was lost, read (fail) the pending messages before reconnecting
+            if (!fbdo->tcpClient.connected())
+            {
+                if (count > 0)
+                    break;
+                batchStats.connections++;
+            }
+
+            if (resending)
+            {
+                resendCount--;
+                memmove(resend, resend + 1, resendCount * sizeof(size_t));
+            }
+            else
+            {
+                sent++;
+                batchStats.sent++;
+                next++;
+            }
+
+            req.erase(headerLen);
+            Core.hh.addContentLengthHeader(req, prefix.length() + strlen(tokens[index]) + suffix.length());
+            Core.hh.addConnectionHeader(req, true);
+            Core.hh.addNewLine(req);
+            req += prefix;
+            req += tokens[index];
+            req += suffix;
+
+            fbdo->tcpSend(req.c_str());
+
+            if (fbdo->session.response.code < 0)
+            {
+                fbdo->closeSession();
+                batchStats.failed++;
+                ret = false;
+
+                if (callback)
+                {
+                    result.index = index;
+                    result.token = tokens[index];
+                    result.httpCode = fbdo->session.response.code;
+                    result.payload = "";
+                    callback(result);
+                }
+
+                break;
+            }
+
+            size_t tail = (head + count) % FCM_BATCH_PIPELINE_DEPTH;
+            pending[tail] = index;
+            sentMs[tail] = millis();
+            count++;
+        }
+
+        if (count == 0)
+            continue;
+
+        struct server_response_data_t response;
+        bool readOk = readBatchResponse(fbdo, response);
+
+        size_t index = pending[head];
+        uint32_t latency = millis() - sentMs[head];
+        head = (head + 1) % FCM_BATCH_PIPELINE_DEPTH;
+        count--;
+
+        batchStats.lastLatencyMs = latency;
+        batchStats.totalLatencyMs += latency;
+        if (batchStats.maxLatencyMs < latency)
+            batchStats.maxLatencyMs = latency;
+
+        int httpCode = readOk ? response.httpCode : fbdo->session.response.code;
+        if (httpCode == FIREBASE_ERROR_HTTP_CODE_OK)
+            batchStats.succeeded++;
+        else
+        {
+            batchStats.failed++;
+            ret = false;
+        }
+
+        if (callback)
+        {
+            result.index = index;
+            result.token = tokens[index];
+            result.httpCode = httpCode;
+            result.payload = fbdo->session.fcm.payload.c_str();
+            callback(result);
+        }
+
+        if (!readOk)
+            fbdo->closeSession();
+        else if (Core.sh.compare(response.connection, 0, firebase_fcm_pgm_str_73 /* "close" */, true))
+        {
+            // the server does not read the requests after the one it answered with connection close,
+            // send the pending messages again over the new connection, ahead of those still to resend
+            fbdo->closeSession();
+            if (count > 0)
+            {
+                batchStats.resent += count;
+                memmove(resend + count, resend, resendCount * sizeof(size_t));
+                for (size_t i = 0; i < count; i++)
+                    resend[i] = pending[(head + i) % FCM_BATCH_PIPELINE_DEPTH];
+                resendCount += count;
+                count = 0;
+            }
+        }
+    }
+
+    batchStats.lastBatchMs = millis() - batchMs;
+    batchStats.lastMessagesPerSec = batchStats.lastBatchMs > 0 ? sent * 1000 / batchStats.lastBatchMs : sent;
+
+    Core.internal.fb_processing = false;
+
+    return ret;
+}
+
+bool FB_CM::isValidBatchToken(const char *token)
+{
+    // the registration tokens never contain the characters that must be escaped in JSON string
+    for (const char *p = token; *p; p++)
+    {
+        if (*p == '"' || *p == '\\' || (unsigned char)*p < 0x20 || *p == 0x7f)
+            return false;
+    }
+    return true;
+}
+
 bool FB_CM::mSubscribeTopic(FirebaseData *fbdo, MB_StringPtr topic, const char *IID[], size_t numToken)
 {
 
@@ -141,6 +383,16 @@ String FB_CM::payload(FirebaseData *fbdo)
     return fbdo->session.fcm.payload.c_str();
 }
 
+FCM_BatchStats FB_CM::getBatchStats()
+{
+    return batchStats;
+}
+
+void FB_CM::resetBatchStats()
+{
+    batchStats = FCM_BatchStats();
+}
+
 void FB_CM::fcm_connect(FirebaseData *fbdo, firebase_fcm_msg_mode mode)
 {
     fbdo->tcpClient.setSPIEthernet(_spi_ethernet_module);
@@ -166,10 +418,40 @@ void FB_CM::fcm_connect(FirebaseData *fbdo, firebase_fcm_msg_mode mode)
 }
 
 bool FB_CM::sendHeader(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *payload)
+{
+    MB_String header;
+    prepareHeader(fbdo, mode, payload, header);
+
+    if (mode != firebase_fcm_msg_mode_app_instance_info)
+    {
+        Core.hh.addContentTypeHeader(header, firebase_pgm_str_62 /* "application/json" */);
+        Core.hh.addContentLengthHeader(header, strlen(payload));
+    }
+
+    // required for ESP32 core sdk v2.0.x.
+    bool keepAlive = false;
+#if defined(USE_CONNECTION_KEEP_ALIVE_MODE)
+    keepAlive = true;
+#endif
+    Core.hh.addConnectionHeader(header, keepAlive);
+    Core.hh.addNewLine(header);
+
+    fbdo->tcpClient.cork();
+    fbdo->tcpSend(header.c_str());
+    header.clear();
+
+    if (fbdo->session.response.code < 0)
+        return false;
+
+    return true;
+}
+
+void FB_CM::prepareHeader(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *payload, MB_String &header)
 {
     bool msgMode = (mode == firebase_fcm_msg_mode_legacy_http || mode == firebase_fcm_msg_mode_httpv1);
 
-    MB_String header;
+    // the whole request header is sent at once, reserve for the token and the common header lines
+    header.reserve(strlen(Core.getToken()) + server_key.length() + 256);
     if (mode == firebase_fcm_msg_mode_app_instance_info)
         Core.hh.addRequestHeaderFirst(header, http_get);
     else
@@ -214,65 +496,14 @@ bool FB_CM::sendHeader(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const cha
 
     Core.hh.addRequestHeaderLast(header);
 
-    Core.hh.addGAPIsHostHeader(header, msgMode ? firebase_fcm_pgm_str_1 /* "fcm" */ : firebase_fcm_pgm_str_2 /* "iid" */);
-
     // Core.getTokenType() is required as Core.config is not set in fcm legacy
-    if (Core.getTokenType() == token_type_oauth2_access_token && mode == firebase_fcm_msg_mode_httpv1)
-    {
-        Core.hh.addAuthHeaderFirst(header, token_type_oauth2_access_token);
-
-        fbdo->tcpSend(header.c_str());
-        header.clear();
-
-        if (fbdo->session.response.code < 0)
-            return false;
-
-        fbdo->tcpSend(Core.getToken());
-
-        if (fbdo->session.response.code < 0)
-            return false;
-    }
-    else
-    {
-        Core.hh.addAuthHeaderFirst(header, token_type_undefined);
-
-        fbdo->tcpSend(header.c_str());
-        header.clear();
-
-        if (fbdo->session.response.code < 0)
-            return false;
-
-        fbdo->tcpSend(server_key.c_str());
-
-        if (fbdo->session.response.code < 0)
-            return false;
-    }
-
-    Core.hh.addNewLine(header);
-
-    Core.hh.addUAHeader(header);
-
-    if (mode != firebase_fcm_msg_mode_app_instance_info)
-    {
-        Core.hh.addContentTypeHeader(header, firebase_pgm_str_62 /* "application/json" */);
-        Core.hh.addContentLengthHeader(header, strlen(payload));
-    }
+    bool oauth = Core.getTokenType() == token_type_oauth2_access_token && mode == firebase_fcm_msg_mode_httpv1;
 
-    // required for ESP32 core sdk v2.0.x.
-    bool keepAlive = false;
-#if defined(USE_CONNECTION_KEEP_ALIVE_MODE)
-    keepAlive = true;
-#endif
-    Core.hh.addConnectionHeader(header, keepAlive);
-    Core.hh.addNewLine(header);
-
-    fbdo->tcpSend(header.c_str());
-    header.clear();
-
-    if (fbdo->session.response.code < 0)
-        return false;
-
-    return true;
+    // session host was set in fcm_connect
+    header += Core.hh.getHeaderTemplate(&Core.sh, fbdo->session.header_tmpl[firebase_header_template_fcm],
+                                        fbdo->session.host.c_str(), MB_String(),
+                                        oauth ? Core.getToken() : server_key.c_str(),
+                                        oauth ? token_type_oauth2_access_token : token_type_undefined);
 }
 
 void FB_CM::fcm_prepareLegacyPayload(FCM_Legacy_HTTP_Message *msg)
@@ -931,6 +1162,57 @@ bool FB_CM::handleResponse(FirebaseData *fbdo)
     return tcpHandler.error.code == 0 || response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK;
 }
 
+bool FB_CM::readBatchResponse(FirebaseData *fbdo, struct server_response_data_t &response)
+{
+    struct firebase_tcp_response_handler_t tcpHandler;
+
+    Core.hh.initTCPSession(fbdo->session);
+    Core.hh.intTCPHandler(&fbdo->tcpClient, tcpHandler, 768, fbdo->session.resp_size, nullptr, false);
+
+    fbdo->session.fcm.payload.clear();
+
+    bool complete = false;
+
+    // read until the end of this response only, the next response can be in the receive buffer already
+    while (!complete)
+    {
+        if (tcpHandler.available() <= 0 && (!fbdo->waitResponse(tcpHandler) || tcpHandler.available() <= 0))
+            break;
+
+        if (!fbdo->readResponse(&fbdo->session.fcm.payload, tcpHandler, response))
+            break;
+
+        if (!tcpHandler.headerEnded)
+            continue;
+
+        if (response.isChunkedEnc)
+        {
+            // last chunk, read the empty line that ends the message instead of flushing the client
+            if (tcpHandler.bufferAvailable < 0)
+            {
+                char crlf[2];
+                if (fbdo->waitResponse(tcpHandler))
+                    Core.hh.readLine(&fbdo->tcpClient, crlf, sizeof(crlf));
+                complete = true;
+            }
+        }
+        else
+            complete = tcpHandler.payloadRead >= response.contentLen;
+    }
+
+    if (!complete)
+    {
+        if (fbdo->session.response.code >= 0)
+            fbdo->session.response.code = FIREBASE_ERROR_TCP_RESPONSE_READ_FAILED;
+        return false;
+    }
+
+    if (response.httpCode != FIREBASE_ERROR_HTTP_CODE_OK)
+        fbdo->getError(fbdo->session.fcm.payload, tcpHandler, response, false);
+
+    return true;
+}
+
 void FB_CM::rescon(FirebaseData *fbdo, const char *host)
 {
     fbdo->_responseCallback = NULL;
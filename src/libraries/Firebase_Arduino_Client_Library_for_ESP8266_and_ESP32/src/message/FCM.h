@@ -145,6 +145,40 @@ public:
    */
   bool send(FirebaseData *fbdo, FCM_HTTPv1_JSON_Message *msg);
 
+  /** Send the same Firebase Cloud Messaging message to many devices using the FCM HTTP v1 API.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param msg The pointer to the message template which is the FCM_HTTPv1_JSON_Message type data.
+   * @param tokens The registration tokens array.
+   * @param numToken The size of registration tokens array.
+   * @param callback The optional FCM_BatchResultCallback function that receives the result of each token.
+   * @return Boolean type status indicates all messages were sent successfully.
+   *
+   * @note The message is built once and only the token is substituted for each device, the token,
+   * topic and condition of msg are ignored. The messages are sent over one kept-alive connection
+   * and up to FCM_BATCH_PIPELINE_DEPTH messages are sent before their responses are read.
+   * The null or empty tokens are skipped. The tokens that contain the quote, backslash or control characters
+   * are not sent, their result httpCode is FIREBASE_ERROR_FCM_INVALID_TOKEN.
+   *
+   * The FCM_BatchResult data contains index, token, httpCode and payload (server response).
+   */
+  template <typename T = const char *>
+  bool sendBatch(FirebaseData *fbdo, FCM_HTTPv1_JSON_Message *msg, T tokens[], size_t numToken,
+                 FCM_BatchResultCallback callback = NULL)
+  {
+    return mSendBatch(fbdo, msg, tokens, numToken, callback);
+  }
+
+  /** Get the batch messages statistics.
+   *
+   * @return FCM_BatchStats data e.g. messages sent, connections, throughput and response latency.
+   */
+  FCM_BatchStats getBatchStats();
+
+  /** Clear the batch messages statistics.
+   */
+  void resetBatchStats();
+
   /** Subscribe the devices to the topic.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -216,6 +250,8 @@ private:
   void fcm_connect(FirebaseData *fbdo, firebase_fcm_msg_mode mode);
   bool fcm_send(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *msg);
   bool sendHeader(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *payload);
+  void prepareHeader(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *payload, MB_String &header);
+  bool readBatchResponse(FirebaseData *fbdo, struct server_response_data_t &response);
   void fcm_prepareLegacyPayload(FCM_Legacy_HTTP_Message *msg);
   void fcm_prepareV1Payload(FCM_HTTPv1_JSON_Message *msg);
   void fcm_preparSubscriptionPayload(const char *topic, const char *IID[], size_t numToken);
@@ -227,12 +263,16 @@ private:
   bool mUnsubscribeTopic(FirebaseData *fbdo, MB_StringPtr topic, const char *IID[], size_t numToken);
   bool mAppInstanceInfo(FirebaseData *fbdo, const char *IID);
   bool mRegisAPNsTokens(FirebaseData *fbdo, MB_StringPtr application, bool sandbox, const char *APNs[], size_t numToken);
+  bool mSendBatch(FirebaseData *fbdo, FCM_HTTPv1_JSON_Message *msg, const char *tokens[], size_t numToken,
+                  FCM_BatchResultCallback callback);
+  bool isValidBatchToken(const char *token);
   void clear();
 
   MB_String server_key;
   MB_String raw;
   uint16_t port = FIREBASE_PORT;
   SPI_ETH_Module *_spi_ethernet_module = NULL;
+  FCM_BatchStats batchStats;
 };
 
 #endif
@@ -335,8 +335,8 @@ void FB_RTDB::enableClassicRequest(FirebaseData *fbdo, bool enable)
 }
 
 bool FB_RTDB::buildRequest(FirebaseData *fbdo, firebase_request_method method, MB_StringPtr path,
-                           MB_StringPtr payload, firebase_data_type type, int subtype, uint32_t value_addr,
-                           uint32_t query_addr, uint32_t priority_addr, MB_StringPtr etag, bool async,
+                           MB_StringPtr payload, firebase_data_type type, int subtype, uintptr_t value_addr,
+                           uintptr_t query_addr, uintptr_t priority_addr, MB_StringPtr etag, bool async,
                            bool queue, size_t blob_size, MB_StringPtr filename, firebase_mem_storage_type storage_type,
                            RTDB_DownloadProgressCallback downloadCallback, RTDB_UploadProgressCallback uploadCallback)
 {
@@ -526,14 +526,15 @@ bool FB_RTDB::mDeleteNodesByTimestamp(FirebaseData *fbdo, MB_StringPtr path, MB_
         {
             FirebaseJson *js = fbdo->jsonObjectPtr();
             size_t len = js->iteratorBegin();
-            FirebaseJson::IteratorValue value;
+            FirebaseJson::IteratorView value;
             MB_String *nodes = new MB_String[len];
 
             for (size_t i = 0; i < len; i++)
             {
-                value = js->valueAt(i);
-                if (value.type == FirebaseJson::JSON_OBJECT && value.key.length() > 1)
-                    nodes[i] = value.key;
+                // only the keys are needed, no value copy
+                value = js->viewAt(i);
+                if (value.type == FirebaseJson::JSON_OBJECT && value.keyLen > 1)
+                    nodes[i].append(value.key, value.keyLen);
             }
             js->iteratorEnd();
             js->clear();
@@ -737,6 +738,7 @@ void FB_RTDB::setStreamCallback(FirebaseData *fbdo, FirebaseData::StreamEventCal
     }
 
     removeMultiPathStreamCallback(fbdo);
+    fbdo->_streamMux = nullptr;
 
     fbdo->_dataAvailableCallback = dataAvailableCallback;
     fbdo->_timeoutCallback = timeoutCallback;
@@ -768,6 +770,7 @@ void FB_RTDB::setMultiPathStreamCallback(FirebaseData *fbdo, FirebaseData::Multi
     }
 
     removeStreamCallback(fbdo);
+    fbdo->_streamMux = nullptr;
 
     fbdo->_multiPathDataCallback = multiPathDataCallback;
     fbdo->_timeoutCallback = timeoutCallback;
@@ -805,6 +808,44 @@ void FB_RTDB::removeMultiPathStreamCallback(FirebaseData *fbdo)
 #endif
 }
 
+#if defined(ESP32)
+void FB_RTDB::setStreamMux(FirebaseData *fbdo, FirebaseStreamMux *mux,
+                           FirebaseData::StreamTimeoutCallback timeoutCallback, size_t streamTaskStackSize)
+{
+    fbdo->session.rtdb.stream_loop_task_enable = false;
+#else
+void FB_RTDB::setStreamMux(FirebaseData *fbdo, FirebaseStreamMux *mux,
+                           FirebaseData::StreamTimeoutCallback timeoutCallback)
+{
+#endif
+    if (!Core.config)
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_UNINITIALIZED;
+        return;
+    }
+
+    removeStreamCallback(fbdo);
+    removeMultiPathStreamCallback(fbdo);
+
+    fbdo->_streamMux = mux;
+    fbdo->_timeoutCallback = timeoutCallback;
+
+    fbdo->addSession(firebase_con_mode_rtdb_stream);
+    Core.internal.stream_loop_task_enable = true;
+
+#if defined(ESP8266)
+    Core.set_scheduled_callback(std::bind(&FB_RTDB::runStreamTask, this));
+#else
+    runStreamTask();
+#endif
+}
+
+void FB_RTDB::removeStreamMux(FirebaseData *fbdo)
+{
+    fbdo->_streamMux = nullptr;
+    removeStreamCallback(fbdo);
+}
+
 void FB_RTDB::runStreamTask()
 {
     if (!Core.config || !Core.internal.stream_loop_task_enable)
@@ -820,13 +861,13 @@ void FB_RTDB::runStreamTask()
     TaskFunction_t taskCode = [](void *param)
     {
         FirebaseConfig *config = (FirebaseConfig *)param;
-        const TickType_t xDelay = Core.internal.stream_task_delay_ms / portTICK_PERIOD_MS;
         for (;;)
         {
             if (!Core.internal.stream_loop_task_enable)
                 break;
             _this->mRunStream();
-            vTaskDelay(xDelay);
+            // sleep until socket data arrives or the nearest stream deadline
+            _this->waitStream();
         }
 
         Core.internal.stream_task_handle = NULL;
@@ -849,6 +890,131 @@ void FB_RTDB::runStreamTask()
 #endif
 }
 
+#if defined(ESP32)
+unsigned long FB_RTDB::remainingMs(unsigned long start, unsigned long interval, unsigned long now)
+{
+    unsigned long elapsed = now - start;
+    return elapsed >= interval ? 0 : interval - elapsed;
+}
+
+void FB_RTDB::waitStream()
+{
+    RTDB_StreamTaskStats &stats = Core.internal.stream_task_stats;
+
+    // events and dispatch time of the previous wakeup
+    if (stats.wakeups > 0)
+    {
+        stats.lastEventsPerWakeup = stats.events - Core.internal.stream_task_wake_events;
+        if (stats.maxEventsPerWakeup < stats.lastEventsPerWakeup)
+            stats.maxEventsPerWakeup = stats.lastEventsPerWakeup;
+
+        if (stats.lastEventsPerWakeup > 0)
+        {
+            stats.lastDispatchUs = micros() - Core.internal.stream_task_wake_us;
+            if (stats.maxDispatchUs < stats.lastDispatchUs)
+                stats.maxDispatchUs = stats.lastDispatchUs;
+        }
+    }
+
+    unsigned long now = millis();
+    unsigned long waitMs = Core.internal.stream_task_max_wait_ms;
+    bool polling = !Core.config || Core.isExpired() || !Core.tokenReady();
+
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    int maxFd = -1;
+    bool buffered = false;
+
+    for (size_t id = 0; id < Core.internal.sessions.size() && !polling; id++)
+    {
+        FirebaseData *fbdo = addrTo<FirebaseData *>(Core.internal.sessions[id].ptr);
+
+        if (!fbdo || !(fbdo->_dataAvailableCallback || fbdo->_multiPathDataCallback || fbdo->_streamMux || fbdo->_timeoutCallback))
+            continue;
+
+        if (fbdo->session.rtdb.pause || fbdo->session.rtdb.stream_stop)
+            continue;
+
+        unsigned long ms = remainingMs(fbdo->session.rtdb.data_millis, Core.config->timeout.rtdbKeepAlive, now);
+
+        if (fbdo->session.rtdb.data_tmo || fbdo->session.response.code >= 400 ||
+            fbdo->session.con_mode != firebase_con_mode_rtdb_stream)
+            ms = remainingMs(fbdo->session.rtdb.stream_resume_millis, Core.config->timeout.rtdbStreamReconnect, now);
+        else if (fbdo->tcpClient.connected())
+        {
+            // the records that were already decrypted or the bytes buffered by the client are not
+            // seen by select
+            if (fbdo->tcpClient.available() > 0)
+                buffered = true;
+
+            int fd = fbdo->tcpClient.socketFd();
+            // the external client can't be waited for, poll it at the stream task delay
+            if (fd < 0)
+                polling = true;
+            else
+            {
+                FD_SET(fd, &readSet);
+                if (maxFd < fd)
+                    maxFd = fd;
+            }
+        }
+
+        if (fbdo->session.rtdb.data_tmo && fbdo->_timeoutCallback)
+        {
+            unsigned long tmo = remainingMs(fbdo->session.rtdb.stream_tmo_Millis, Core.config->timeout.rtdbStreamError, now);
+            if (ms > tmo)
+                ms = tmo;
+        }
+
+        if (waitMs > ms)
+            waitMs = ms;
+    }
+
+    if (polling || waitMs < Core.internal.stream_task_delay_ms)
+        waitMs = Core.internal.stream_task_delay_ms;
+
+    unsigned long start = micros();
+    int ret = 0;
+
+    if (buffered)
+        ret = 1;
+    else if (maxFd > -1 && !polling)
+    {
+        struct timeval tv;
+        tv.tv_sec = waitMs / 1000;
+        tv.tv_usec = (waitMs % 1000) * 1000;
+        ret = select(maxFd + 1, &readSet, NULL, NULL, &tv);
+    }
+    else
+        vTaskDelay(waitMs / portTICK_PERIOD_MS);
+
+    Core.internal.stream_task_wake_us = micros();
+    Core.internal.stream_task_wake_events = stats.events;
+    stats.wakeups++;
+
+    if (ret > 0)
+        stats.dataWakeups++;
+    else
+    {
+        stats.timerWakeups++;
+        unsigned long elapsed = Core.internal.stream_task_wake_us - start;
+        stats.lastWakeLatencyUs = elapsed > waitMs * 1000 ? elapsed - waitMs * 1000 : 0;
+        if (stats.maxWakeLatencyUs < stats.lastWakeLatencyUs)
+            stats.maxWakeLatencyUs = stats.lastWakeLatencyUs;
+    }
+}
+#endif
+
+RTDB_StreamTaskStats FB_RTDB::getStreamTaskStats()
+{
+    return Core.internal.stream_task_stats;
+}
+
+void FB_RTDB::resetStreamTaskStats()
+{
+    Core.internal.stream_task_stats = RTDB_StreamTaskStats();
+}
+
 void FB_RTDB::mStopStreamLoopTask()
 {
     Core.internal.stream_loop_task_enable = false;
@@ -869,7 +1035,7 @@ void FB_RTDB::mRunStream()
 
         if (fbdo)
         {
-            if ((fbdo->_dataAvailableCallback || fbdo->_multiPathDataCallback || fbdo->_timeoutCallback))
+            if ((fbdo->_dataAvailableCallback || fbdo->_multiPathDataCallback || fbdo->_streamMux || fbdo->_timeoutCallback))
             {
                 if (Core.isExpired())
                 {
@@ -892,7 +1058,7 @@ void FB_RTDB::setMaxRetry(FirebaseData *fbdo, uint8_t num)
     fbdo->session.rtdb.max_retry = num;
 }
 
-void FB_RTDB::setBlobRef(FirebaseData *fbdo, int addr)
+void FB_RTDB::setBlobRef(FirebaseData *fbdo, uintptr_t addr)
 {
     if (fbdo->session.rtdb.blob && fbdo->session.rtdb.isBlobPtr)
     {
@@ -1922,6 +2088,8 @@ bool FB_RTDB::sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_
         fbdo->session.rtdb.stream_path.clear();
         Core.ut.makePath(req->path);
         fbdo->session.rtdb.stream_path += req->path;
+        // new connection, drop the incomplete event of the previous connection
+        fbdo->_sseParser.reset();
     }
     else
     {
@@ -2161,6 +2329,7 @@ bool FB_RTDB::sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_
 bool FB_RTDB::encodeFileToClient(FirebaseData *fbdo, size_t bufSize, const MB_String &filePath,
                                  firebase_mem_storage_type storageType, struct firebase_rtdb_request_info_t *req)
 {
+    (void)filePath;
 
     MB_String filenme = Core.mbfs.name(mbfs_type req->storageType);
     Core.mbfs.close(mbfs_type req->storageType);
@@ -2178,22 +2347,33 @@ bool FB_RTDB::encodeFileToClient(FirebaseData *fbdo, size_t bufSize, const MB_St
     out.bufLen = bufSize;
     uint8_t *outBuf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(out.bufLen));
     out.outT = outBuf;
-    unsigned char *base64EncBuf = Core.bh.creatBase64EncBuffer(&Core.mbfs, false);
-    uint8_t *data = reinterpret_cast<uint8_t *>(Core.mbfs.newP(3));
+    // read the multiple of 12 bytes which the encoder takes per iteration
+    size_t dataLen = bufSize / 4 * 3 / 12 * 12;
+    if (dataLen < 12)
+        dataLen = 12;
+    uint8_t *data = reinterpret_cast<uint8_t *>(Core.mbfs.newP(dataLen));
+    size_t remaining = 0;
 
-    while (Core.mbfs.available(mbfs_type storageType))
+    while (total < size)
     {
-        // read 3 bytes from stream
-        int read = Core.mbfs.read(mbfs_type storageType, data, 3);
-        if (read)
-        {
-            if (!Core.bh.encode<uint8_t>(&Core.mbfs, base64EncBuf, data, read, out, read != 3 /* write remaining */))
-                break;
-            total += read;
-            reportUploadProgress(fbdo, req, total);
-        }
-        else
+        int read = Core.mbfs.read(mbfs_type storageType, data + remaining, dataLen - remaining);
+        if (read <= 0)
+            break;
+
+        total += read;
+
+        // encode the whole 3-byte groups, keep the rest for the next read except for the last read
+        size_t n = remaining + read;
+        size_t encLen = total == size ? n : n / 3 * 3;
+        if (!Core.bh.encode<uint8_t>(&Core.mbfs, Core.bh.base64EncTable(false), data, encLen, out,
+                                     total == size /* write remaining */))
             break;
+
+        remaining = n - encLen;
+        if (remaining > 0)
+            memmove(data, data + encLen, remaining);
+
+        reportUploadProgress(fbdo, req, total);
     }
 
     // remainig data to wrire? write it
@@ -2201,7 +2381,6 @@ bool FB_RTDB::encodeFileToClient(FirebaseData *fbdo, size_t bufSize, const MB_St
         Core.bh.writeOutput(&Core.mbfs, out);
 
     Core.mbfs.delP(&data);
-    Core.mbfs.delP(&base64EncBuf);
     Core.mbfs.delP(&outBuf);
 
     return size == total;
@@ -2369,7 +2548,8 @@ waits:
                 req->fileSize = response.contentLen;
                 tcpHandler.error.code = 0;
 
-                int bufLen = tcpHandler.chunkBufSize;
+                // the largest chunk (the first one) and its terminator
+                int bufLen = pChunkSize + strlen_P(firebase_rtdb_pgm_str_8 /* "\"file,base64," */) + 1;
                 uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(bufLen, false));
 
                 int stage = 0;
@@ -2469,6 +2649,7 @@ waits:
                         // append " and } to make a valid JSON
                         stream += firebase_pgm_str_4;  // "\""
                         stream += firebase_pgm_str_11; // "}"
+                        stream += firebase_pgm_str_12; // "\n"
 
                         payload.erase(0, response.payloadOfs);
 
@@ -2593,6 +2774,10 @@ bool FB_RTDB::parseTCPResponse(FirebaseData *fbdo, firebase_rtdb_request_info_t
                                struct firebase_tcp_response_handler_t &tcpHandler, struct server_response_data_t &response)
 {
 
+    // continuation of the incomplete event from the previous read
+    if (fbdo->session.con_mode == firebase_con_mode_rtdb_stream && fbdo->_sseParser.pending())
+        response.isEvent = true;
+
     if (response.dataType == 0 && !response.isEvent)
     {
         bool getOfs = req->data.type == d_blob || req->method == rtdb_backup ||
@@ -2678,21 +2863,9 @@ bool FB_RTDB::endDownloadOTA(FirebaseData *fbdo, firebase_rtdb_request_info_t *r
     if (tcpHandler.downloadOTA)
     {
 
-#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST))
 
-        // write extra pad
-        if (tcpHandler.base64PadLenTail > 0 && tcpHandler.base64PadLenSignature == 0)
-        {
-            uint8_t pad[tcpHandler.base64PadLenTail];
-            memset(pad, 0, tcpHandler.base64PadLenTail);
-            Core.bh.updateWrite(pad, tcpHandler.base64PadLenTail);
-        }
-
-        if (tcpHandler.error.code == 0)
-        {
-            if (!Update.end())
-                tcpHandler.error.code = FIREBASE_ERROR_FW_UPDATE_END_FAILED;
-        }
+        fbdo->endDownloadOTA(tcpHandler);
 
         if (tcpHandler.error.code != 0)
             fbdo->session.response.code = tcpHandler.error.code;
@@ -2708,6 +2881,7 @@ bool FB_RTDB::endDownloadOTA(FirebaseData *fbdo, firebase_rtdb_request_info_t *r
 int FB_RTDB::handleRedirect(FirebaseData *fbdo, firebase_rtdb_request_info_t *req,
                             struct firebase_tcp_response_handler_t &tcpHandler, struct server_response_data_t &response)
 {
+    (void)tcpHandler;
     if (response.redirect && response.location.length() > 0)
     {
 
@@ -2746,7 +2920,7 @@ void FB_RTDB::sendCB(FirebaseData *fbdo)
 
     // prevent the data available and stream data changed flags reset by
     // streamAvailable without stream callbacks assigned.
-    if (!fbdo->_dataAvailableCallback && !fbdo->_multiPathDataCallback)
+    if (!fbdo->_dataAvailableCallback && !fbdo->_multiPathDataCallback && !fbdo->_streamMux)
         return;
 
     if (!fbdo->streamAvailable())
@@ -2756,6 +2930,8 @@ void FB_RTDB::sendCB(FirebaseData *fbdo)
     // callback
     Core.internal.fb_processing = false;
 
+    Core.internal.stream_task_stats.events++;
+
     if (fbdo->_dataAvailableCallback)
     {
         FIREBASE_STREAM_CLASS s;
@@ -2833,37 +3009,126 @@ void FB_RTDB::sendCB(FirebaseData *fbdo)
         fbdo->session.rtdb.data_available = false;
         s.empty();
     }
+    else if (fbdo->_streamMux)
+    {
+        // the event data was already trimmed and typed by handlePayload, apply it to the shadow tree
+        // and dispatch to the route callbacks without creating the JSON object of the event data.
+        fbdo->_streamMux->dispatch(fbdo->session.rtdb.event_type, fbdo->session.rtdb.path,
+                                   fbdo->session.rtdb.raw, fbdo->session.rtdb.resp_data_type);
+        fbdo->session.rtdb.data_available = false;
+    }
 }
 
-void FB_RTDB::splitStreamPayload(const MB_String &payloads, MB_VECTOR<MB_String> &payload)
+size_t FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
 {
-    int ofs = 0;
-    int pos1 = 0, pos2 = 0, pos3 = 0;
+    // The stream data may contain multiple events in case simultaneously children data changes
+    // and the last event may be incomplete which will be completed in the next read.
+    // All bytes are parsed only once by the SSE parser and each event is sent to callback function.
+    size_t validEvents = 0;
+    size_t ofs = 0, len = payload.length();
 
-    while (pos1 > -1)
+    while (ofs < len)
     {
-        if (Core.sh.find(payloads, firebase_rtdb_pgm_str_12 /* "event: " */, false, ofs, pos1))
+        ofs += fbdo->_sseParser.feed(payload.c_str() + ofs, len - ofs);
+
+        if (fbdo->_sseParser.available() && parseStreamEvent(fbdo, fbdo->_sseParser.event()))
         {
-            ofs = pos1 + 1;
-            if (Core.sh.find(payloads, firebase_rtdb_pgm_str_13 /* "data: " */, false, ofs, pos2))
-            {
-                ofs = pos2 + 1;
-                if (Core.sh.find(payloads, firebase_pgm_str_12 /* "\n" */, false, ofs, pos3))
-                    ofs = pos3 + 1;
-                else
-                    pos3 = payloads.length();
+            validEvents++;
+            sendCB(fbdo);
+        }
 
-                payload.push_back(payloads.substr(pos1, pos3 - pos1));
-            }
+        // the event was lost (out of memory), the shadow data of the user is no longer in sync,
+        // reconnect and the server will send the full data again.
+        if (fbdo->_sseParser.failed())
+        {
+            fbdo->session.response.code = FIREBASE_ERROR_BUFFER_OVERFLOW;
+            Core.errorToString(fbdo->session.response.code, fbdo->session.error);
+            fbdo->_sseParser.reset();
+            fbdo->session.rtdb.data_tmo = true;
+            fbdo->closeSession();
+            return validEvents;
         }
     }
+
+    // Firebase event has single data line, the event is ready before the terminating empty line was received.
+    if (!fbdo->_sseParser.available() && fbdo->_sseParser.flush() && parseStreamEvent(fbdo, fbdo->_sseParser.event()))
+    {
+        validEvents++;
+        sendCB(fbdo);
+    }
+
+    return validEvents;
 }
 
-void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
+bool FB_RTDB::parseStreamEvent(FirebaseData *fbdo, const firebase_sse_event_view_t &event)
 {
     struct server_response_data_t response;
 
-    Core.hh.parseRespPayload(&Core.sh, payload, response, false);
+    response.isEvent = true;
+    response.eventType = event.event;
+
+    bool dataEvent = Core.sh.compare(response.eventType, 0, firebase_pgm_str_16 /* "put" */) ||
+                     Core.sh.compare(response.eventType, 0, firebase_pgm_str_17 /* "patch" */);
+
+    if (dataEvent)
+    {
+        // The event data is {"path":"<path>","data":<data>}, its members were located by the
+        // JSON scanner of the SSE parser while the bytes arrived, the escaped quotes in path
+        // are handled by the scanner.
+        if (!event.path || !event.value || event.valueLen == 0)
+            return false;
+
+        response.eventPath.append(event.path, event.pathLen);
+
+        const char *p = event.value, *end = event.value + event.valueLen;
+
+        response.hasEventData = true;
+        response.payloadLen = end - p;
+
+        size_t blobLen = strlen_P(firebase_rtdb_pgm_str_7 /* "\"blob,base64," */);
+        size_t fileLen = strlen_P(firebase_rtdb_pgm_str_8 /* "\"file,base64," */);
+
+        if ((size_t)response.payloadLen >= blobLen && strncmp_P(p, firebase_rtdb_pgm_str_7, blobLen) == 0)
+        {
+            response.dataType = d_blob;
+            // exclude the closing quote
+            response.payloadLen -= blobLen + 1;
+            response.payloadOfs = p - event.data + blobLen;
+        }
+        else if ((size_t)response.payloadLen >= fileLen && strncmp_P(p, firebase_rtdb_pgm_str_8, fileLen) == 0)
+        {
+            response.dataType = d_file;
+            response.payloadLen -= fileLen + 1;
+        }
+        else
+        {
+            response.eventData.append(p, response.payloadLen);
+
+            switch (*p)
+            {
+            case '"':
+                response.dataType = d_string;
+                break;
+            case '{':
+                response.dataType = d_json;
+                break;
+            case '[':
+                response.dataType = d_array;
+                break;
+            case 't':
+            case 'f':
+                response.dataType = d_boolean;
+                response.boolData = *p == 't';
+                break;
+            case 'n':
+                response.dataType = d_null;
+                break;
+            default:
+                Core.hh.setNumDataType(response.eventData, 0, response, strchr(response.eventData.c_str(), '.') != NULL);
+                break;
+            }
+        }
+    }
 
     fbdo->session.rtdb.resp_data_type = response.dataType;
     fbdo->session.content_length = response.payloadLen;
@@ -2881,7 +3146,7 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
         }
 
         fbdo->session.rtdb.raw.clear();
-        Core.bh.decodeToArray<uint8_t>(&Core.mbfs, payload.c_str() + response.payloadOfs, *fbdo->session.rtdb.blob);
+        Core.bh.decodeToArray<uint8_t>(&Core.mbfs, event.data + response.payloadOfs, response.payloadLen, *fbdo->session.rtdb.blob);
     }
     else if (fbdo->session.rtdb.resp_data_type == d_file)
     {
@@ -2889,11 +3154,10 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
         fbdo->session.rtdb.raw.clear();
     }
 
-    if (Core.sh.compare(response.eventType, 0, firebase_pgm_str_16 /* "put" */) ||
-        Core.sh.compare(response.eventType, 0, firebase_pgm_str_17 /* "patch" */))
+    if (dataEvent)
     {
 
-        handlePayload(fbdo, response, payload);
+        handlePayload(fbdo, response, response.eventData);
 
         // Any stream update?
         // based on BLOB or file event data changes (no old data available for comparision or inconvenient for large data)
@@ -2935,6 +3199,8 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
                 fbdo->closeSession();
         }
     }
+
+    return true;
 }
 
 void FB_RTDB::parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req,
@@ -2946,43 +3212,16 @@ void FB_RTDB::parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req
         // stream data?
         if (response.isEvent)
         {
-            int pos = 0, ofs = 0, jsonCount = 0;
-            bool validJson = false;
-
-            // counting the occurences of JSON sets
-            while (pos > -1)
-            {
-                if (Core.sh.find(payload, firebase_rtdb_pgm_str_12 /* "event: " */, false, ofs, pos))
-                {
-                    ofs = pos + 1;
-                    jsonCount++;
-                }
-            }
-
-            // we need to spit the tream data if stream data contains multiple sets of JSON
-            // that happens in case simultaneously children data changes.
-            // {json1}{json..}{json n}
-            // Then we pase each JSON and send to callback function.
-            MB_VECTOR<MB_String> payloadList;
-            splitStreamPayload(payload, payloadList);
-            for (size_t i = 0; i < payloadList.size(); i++)
-            {
-                if (Core.ut.validJS(payloadList[i].c_str()))
-                {
-                    validJson = true;
-                    parseStreamPayload(fbdo, payloadList[i].c_str());
-                    sendCB(fbdo);
-                }
-            }
-            payloadList.clear(); // clear payload after splitting
+            size_t validEvents = parseStreamPayload(fbdo, payload);
             payload.clear();
 
-            if (validJson)
+            if (validEvents > 0)
             {
                 fbdo->session.rtdb.data_millis = millis();
                 fbdo->session.rtdb.data_tmo = false;
             }
-            else
+            // the incomplete event will be completed in the next read
+            else if (!fbdo->_sseParser.pending())
             {
                 fbdo->session.rtdb.data_millis = 0;
                 fbdo->session.rtdb.data_tmo = true;
@@ -3174,6 +3413,8 @@ bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request
     }
 
     MB_String header;
+    // the whole request header is sent at once, reserve for the path, token and the common header lines
+    header.reserve(req->path.length() + Core.internal.auth_token.length() + 256);
 
     Core.hh.addRequestHeaderFirst(header, fbdo->session.classic_request &&
                                                   (http_method == http_put || http_method == http_delete)
@@ -3203,19 +3444,10 @@ bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request
     {
         header += firebase_rtdb_pgm_str_18; // ".json"
         if (Core.getTokenType() != token_type_oauth2_access_token && !Core.config->signer.test_mode)
+        {
             Core.uh.addParam(header, firebase_rtdb_pgm_str_19 /* "auth=" */, "", hasQueryParams, true);
-
-        fbdo->tcpSend(header.c_str());
-        header.clear();
-
-        if (fbdo->session.response.code < 0)
-            return false;
-
-        if (Core.getTokenType() != token_type_oauth2_access_token && !Core.config->signer.test_mode)
-            fbdo->tcpSend(Core.internal.auth_token.c_str());
-
-        if (fbdo->session.response.code < 0)
-            return false;
+            header += Core.internal.auth_token;
+        }
     }
 
     if (fbdo->session.rtdb.read_tmo > 0)
@@ -3259,31 +3491,15 @@ bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request
         Core.uh.addParam(header, firebase_rtdb_pgm_str_29 /* "print=silent" */, "", hasQueryParams, true);
 
     Core.hh.addRequestHeaderLast(header);
-    Core.hh.addHostHeader(header, Core.config->database_url.c_str());
-    Core.hh.addUAHeader(header);
-    Core.hh.getCustomHeaders(&Core.sh, header, Core.config->signer.customHeaders);
 
-    if (Core.getTokenType() == token_type_oauth2_access_token)
-    {
-        Core.hh.addAuthHeaderFirst(header, token_type_oauth2_access_token);
-
-        if (Core.config->signer.tokens.auth_type.length() > 0 &&
-            Core.config->signer.tokens.auth_type[Core.config->signer.tokens.auth_type.length() - 1] != ' ')
-            header += firebase_pgm_str_9; // " "
-
-        fbdo->tcpSend(header.c_str());
-        header.clear();
-
-        if (fbdo->session.response.code < 0)
-            return false;
+    bool oauth = Core.getTokenType() == token_type_oauth2_access_token;
+    bool authSpace = oauth && Core.config->signer.tokens.auth_type.length() > 0 &&
+                     Core.config->signer.tokens.auth_type[Core.config->signer.tokens.auth_type.length() - 1] != ' ';
 
-        fbdo->tcpSend(Core.internal.auth_token.c_str());
-
-        if (fbdo->session.response.code < 0)
-            return false;
-
-        Core.hh.addNewLine(header);
-    }
+    header += Core.hh.getHeaderTemplate(&Core.sh, fbdo->session.header_tmpl[firebase_header_template_rtdb],
+                                        Core.config->database_url.c_str(), Core.config->signer.customHeaders,
+                                        oauth ? Core.internal.auth_token.c_str() : nullptr,
+                                        token_type_oauth2_access_token, authSpace);
 
     // Timestamp cannot use with ETag header, due to internal server error
     if (!hasServerValue && !hasQuery && req->data.type != d_timestamp &&
@@ -3337,6 +3553,8 @@ bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request
 
     Core.hh.addNewLine(header);
 
+    // the header and payload are sent in full records when the response is polled
+    fbdo->tcpClient.cork();
     fbdo->tcpSend(header.c_str());
     header.clear();
 
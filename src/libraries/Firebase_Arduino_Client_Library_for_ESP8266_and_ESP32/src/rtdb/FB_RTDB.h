@@ -40,6 +40,8 @@
 #include "QueueInfo.h"
 #include "./stream/FB_MP_Stream.h"
 #include "./stream/FB_Stream.h"
+#include "./stream/FB_StreamMux.h"
+#include "./stream/FB_SSE_Parser.h"
 
 #if defined(ESP32)
 #include <freertos/FreeRTOS.h>
@@ -2238,6 +2240,35 @@ public:
                                   FirebaseData::StreamTimeoutCallback timeoutCallback = NULL);
 #endif
 
+  /** Set the stream multiplexer that dispatches the stream events to the route callbacks.
+   * setStreamMux should be called before Firebase.beginStream.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param mux The pointer to FirebaseStreamMux object that holds the route callbacks and the shadow tree.
+   * @param timeoutCallback The Callback function will be called when the stream connection was timed out (optional).
+   *
+   * ESP32 only parameter
+   * @param streamTaskStackSize The stream task (RTOS task) reserved stack memory in byte (optional) (8192 is default).
+   *
+   * @note Only one stream connection (one Firebase Data object) at the common parent path is required
+   * for all routes. The put and patch events are applied to the shadow tree of FirebaseStreamMux
+   * and the route callbacks that the changes were under, over or at their paths will be called.
+   */
+
+#if defined(ESP32)
+  void setStreamMux(FirebaseData *fbdo, FirebaseStreamMux *mux,
+                    FirebaseData::StreamTimeoutCallback timeoutCallback = NULL, size_t streamTaskStackSize = 8192);
+#else
+  void setStreamMux(FirebaseData *fbdo, FirebaseStreamMux *mux,
+                    FirebaseData::StreamTimeoutCallback timeoutCallback = NULL);
+#endif
+
+  /** Remove the stream multiplexer.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   */
+  void removeStreamMux(FirebaseData *fbdo);
+
   /** Remove stream callback functions.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -2259,6 +2290,20 @@ public:
     mRunStream();
   }
 
+  /** Get the stream task statistics.
+   *
+   * @return RTDB_StreamTaskStats data e.g. wakeups, events per wakeup and wake latency.
+   *
+   * @note In ESP32, the stream task sleeps until the stream socket data arrives or the nearest
+   * keep-alive, reconnect or error notification deadline instead of polling at fixed interval.
+   * The events are also counted when the stream was run manually with runStream.
+   */
+  RTDB_StreamTaskStats getStreamTaskStats();
+
+  /** Clear the stream task statistics.
+   */
+  void resetStreamTaskStats();
+
   /** Backup (download) the database at the defined node to the storage memory.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -2613,7 +2658,7 @@ private:
                           firebase_mem_storage_type storageType, struct firebase_rtdb_request_info_t *req);
   void setPtrValue(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
   bool buildRequest(FirebaseData *fbdo, firebase_request_method method, MB_StringPtr path, MB_StringPtr payload,
-                    firebase_data_type type, int subtype, uint32_t value_addr, uint32_t query_addr, uint32_t priority_addr,
+                    firebase_data_type type, int subtype, uintptr_t value_addr, uintptr_t query_addr, uintptr_t priority_addr,
                     MB_StringPtr etag, bool async, bool queue, size_t blob_size, MB_StringPtr filename,
                     firebase_mem_storage_type storage_type = mem_storage_type_undefined,
                     RTDB_DownloadProgressCallback downloadCallback = NULL, RTDB_UploadProgressCallback uploadCallback = NULL);
@@ -2635,7 +2680,7 @@ private:
   bool mRestoreErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType);
   bool mDeleteStorageFile(MB_StringPtr filename, firebase_mem_storage_type storageType);
   bool mSaveErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType);
-  void setBlobRef(FirebaseData *fbdo, int addr);
+  void setBlobRef(FirebaseData *fbdo, uintptr_t addr);
   void mSetwriteSizeLimit(FirebaseData *fbdo, MB_StringPtr size);
   bool mGetRules(FirebaseData *fbdo, firebase_mem_storage_type storageType, MB_StringPtr filename,
                  RTDB_DownloadProgressCallback callback = NULL);
@@ -2658,8 +2703,8 @@ private:
   int handleRedirect(FirebaseData *fbdo, firebase_rtdb_request_info_t *req, struct firebase_tcp_response_handler_t &tcpHandler,
                      struct server_response_data_t &response);
   void sendCB(FirebaseData *fbdo);
-  void splitStreamPayload(const MB_String &payloads, MB_VECTOR<MB_String> &payload);
-  void parseStreamPayload(FirebaseData *fbdo, const MB_String &payload);
+  size_t parseStreamPayload(FirebaseData *fbdo, const MB_String &payload);
+  bool parseStreamEvent(FirebaseData *fbdo, const firebase_sse_event_view_t &event);
   void storeToken(MB_String &atok, const char *databaseSecret);
   void restoreToken(MB_String &atok, firebase_auth_token_type tk);
   bool mSetQueryIndex(FirebaseData *fbdo, MB_StringPtr path, MB_StringPtr node, MB_StringPtr databaseSecret);
@@ -2676,6 +2721,10 @@ private:
   void makeDownloadStatus(RTDB_DownloadStatusInfo &info, const MB_String &local, const MB_String &remote,
                           firebase_rtdb_download_status status, size_t progress, size_t size, int elapsedTime, const MB_String &msg);
   void runStreamTask();
+#if defined(ESP32)
+  void waitStream();
+  unsigned long remainingMs(unsigned long start, unsigned long interval, unsigned long now);
+#endif
   void mStopStreamLoopTask();
   void mRunStream();
 
@@ -2716,12 +2765,12 @@ protected:
     }
   }
 
-  uint32_t getAddr(QueryFilter *v) { return reinterpret_cast<uint32_t>(v); }
-  uint32_t getAddr(FirebaseJson *v) { return reinterpret_cast<uint32_t>(v); }
-  uint32_t getAddr(FirebaseJsonArray *v) { return reinterpret_cast<uint32_t>(v); }
+  uintptr_t getAddr(QueryFilter *v) { return reinterpret_cast<uintptr_t>(v); }
+  uintptr_t getAddr(FirebaseJson *v) { return reinterpret_cast<uintptr_t>(v); }
+  uintptr_t getAddr(FirebaseJsonArray *v) { return reinterpret_cast<uintptr_t>(v); }
 
   template <typename T1, typename T2>
-  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, bool async) ->
+  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, bool async) ->
       typename enable_if<is_string<T1>::value && is_num_int<T2>::value, bool>::type
   {
     return buildRequest(fbdo, http_post, toStringPtr(path), toStringPtr(value, -1), d_integer,
@@ -2730,7 +2779,7 @@ protected:
   }
 
   template <typename T1, typename T2>
-  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, bool async) ->
+  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, bool async) ->
       typename enable_if<is_string<T1>::value && is_bool<T2>::value, bool>::type
   {
     return buildRequest(fbdo, http_post, toStringPtr(path), toStringPtr(value, -1), d_boolean,
@@ -2739,7 +2788,7 @@ protected:
   }
 
   template <typename T1, typename T2>
-  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, bool async) ->
+  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, bool async) ->
       typename enable_if<is_string<T1>::value && is_same<T2, float>::value, bool>::type
   {
     return bbuildRequestEQ(fbdo, http_post, toStringPtr(path), toStringPtr(value, -1), d_float,
@@ -2748,7 +2797,7 @@ protected:
   }
 
   template <typename T1, typename T2>
-  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, bool async) ->
+  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, bool async) ->
       typename enable_if<is_string<T1>::value && is_same<T2, double>::value, bool>::type
   {
     return buildRequest(fbdo, http_post, toStringPtr(path), toStringPtr(value, -1), d_double,
@@ -2757,7 +2806,7 @@ protected:
   }
 
   template <typename T1, typename T2>
-  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, bool async) ->
+  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, bool async) ->
       typename enable_if<is_string<T1>::value && is_string<T2>::value, bool>::type
   {
     return buildRequest(fbdo, http_post, toStringPtr(path), toStringPtr(value), d_string,
@@ -2766,7 +2815,7 @@ protected:
   }
 
   template <typename T1, typename T2>
-  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 json, int priority_addr, bool async) ->
+  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 json, uintptr_t priority_addr, bool async) ->
       typename enable_if<is_string<T1>::value && is_same<T2, FirebaseJson *>::value, bool>::type
   {
     return buildRequest(fbdo, http_post, toStringPtr(path), toStringPtr(_NO_PAYLOAD), d_json,
@@ -2775,7 +2824,7 @@ protected:
   }
 
   template <typename T1, typename T2>
-  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 arr, int priority_addr, bool async) ->
+  auto dataPushHandler(FirebaseData *fbdo, T1 path, T2 arr, uintptr_t priority_addr, bool async) ->
       typename enable_if<is_string<T1>::value && is_same<T2, FirebaseJsonArray *>::value, bool>::type
   {
     return buildRequest(fbdo, http_post, toStringPtr(path), toStringPtr(_NO_PAYLOAD), d_array,
@@ -2802,7 +2851,7 @@ protected:
   }
 
   template <typename T1, typename T2, typename T3>
-  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, T3 etag, bool async) ->
+  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, T3 etag, bool async) ->
       typename enable_if<is_string<T1>::value && is_bool<T2>::value, bool>::type
   {
     return buildRequest(fbdo, http_put, toStringPtr(path), toStringPtr(value, -1), d_boolean,
@@ -2811,7 +2860,7 @@ protected:
   }
 
   template <typename T1, typename T2, typename T3>
-  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, T3 etag, bool async) ->
+  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, T3 etag, bool async) ->
       typename enable_if<is_string<T1>::value && is_num_int<T2>::value, bool>::type
   {
     return buildRequest(fbdo, http_put, toStringPtr(path), toStringPtr(value, -1), d_integer,
@@ -2820,7 +2869,7 @@ protected:
   }
 
   template <typename T1, typename T2, typename T3>
-  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, T3 etag, bool async) ->
+  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, T3 etag, bool async) ->
       typename enable_if<is_string<T1>::value && is_same<T2, float>::value, bool>::type
   {
     return buildRequest(fbdo, http_put, toStringPtr(path), toStringPtr(value, -1), d_float,
@@ -2829,7 +2878,7 @@ protected:
   }
 
   template <typename T1, typename T2, typename T3>
-  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, T3 etag, bool async) ->
+  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, T3 etag, bool async) ->
       typename enable_if<is_string<T1>::value && is_same<T2, double>::value, bool>::type
   {
     return buildRequest(fbdo, http_put, toStringPtr(path), toStringPtr(value, -1), d_double,
@@ -2838,7 +2887,7 @@ protected:
   }
 
   template <typename T1, typename T2, typename T3>
-  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, int priority_addr, T3 etag, bool async) ->
+  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 value, uintptr_t priority_addr, T3 etag, bool async) ->
       typename enable_if<is_string<T1>::value && is_string<T2>::value, bool>::type
   {
     return buildRequest(fbdo, http_put, toStringPtr(path), toStringPtr(value), d_string,
@@ -2847,7 +2896,7 @@ protected:
   }
 
   template <typename T1, typename T2, typename T3>
-  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 json, int priority_addr, T3 etag, bool async) ->
+  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 json, uintptr_t priority_addr, T3 etag, bool async) ->
       typename enable_if<is_string<T1>::value && is_same<T2, FirebaseJson *>::value, bool>::type
   {
     return buildRequest(fbdo, http_put, toStringPtr(path), toStringPtr(_NO_PAYLOAD), d_json,
@@ -2856,7 +2905,7 @@ protected:
   }
 
   template <typename T1, typename T2, typename T3>
-  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 arr, int priority_addr, T3 etag, bool async) ->
+  auto dataSetHandler(FirebaseData *fbdo, T1 path, T2 arr, uintptr_t priority_addr, T3 etag, bool async) ->
       typename enable_if<is_string<T1>::value && is_same<T2, FirebaseJsonArray *>::value, bool>::type
   {
     return buildRequest(fbdo, http_put, toStringPtr(path), toStringPtr(_NO_PAYLOAD), d_array,
@@ -78,6 +78,8 @@ bool QueueManager::add(struct QueueItem q)
 
     if (_queueCollection->size() < _maxQueue)
     {
+        // the item strings live in the queue until it is processed
+        MB_AllocTagScope scope(mb_alloc_tag_rtdb_queue);
         _queueCollection->push_back(q);
         return true;
     }
@@ -0,0 +1,351 @@
+/**
+ * Google's Firebase SSE Parser class, FB_SSE_Parser.cpp version 1.0.0
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_SSE_PARSER_CPP
+#define FIREBASE_SSE_PARSER_CPP
+
+#include "FB_SSE_Parser.h"
+#include "./core/FirebaseCore.h"
+
+FirebaseSSEParser::FirebaseSSEParser()
+{
+    MB_JSON_ScannerInit(&_scan, scanMember, this);
+}
+
+FirebaseSSEParser::~FirebaseSSEParser()
+{
+    release();
+}
+
+size_t FirebaseSSEParser::feed(const char *buf, size_t len)
+{
+    if (_available)
+        clearEvent();
+
+    size_t i = 0;
+
+    while (i < len && !_available)
+    {
+        char c = buf[i];
+
+        // LF after CR was already handled as the end of line
+        if (_cr)
+        {
+            _cr = false;
+            if (c == '\n')
+            {
+                i++;
+                continue;
+            }
+        }
+
+        if (c == '\r' || c == '\n')
+        {
+            _cr = c == '\r';
+            endLine();
+            i++;
+            continue;
+        }
+
+        switch (_state)
+        {
+        case state_line_start:
+            if (c == ':')
+            {
+                // comment line
+                _state = state_skip_line;
+                i++;
+                break;
+            }
+            _nameLen = 0;
+            _state = state_field_name;
+            // fall through
+        case state_field_name:
+            if (c == ':')
+            {
+                setField();
+                _state = _field == field_none ? state_skip_line : state_field_space;
+            }
+            else if (_nameLen < sizeof(_name))
+                _name[_nameLen++] = c;
+            else
+                _nameLen = sizeof(_name) + 1; // unknown long field name
+            i++;
+            break;
+        case state_field_space:
+            // a single leading space of the value is not the part of value
+            _state = state_field_value;
+            if (c == ' ')
+            {
+                i++;
+                break;
+            }
+            // fall through
+        case state_field_value:
+        {
+            // copy up to the end of line at once
+            size_t n = i;
+            while (n < len && buf[n] != '\n' && buf[n] != '\r')
+                n++;
+            appendField(buf + i, n - i);
+            i = n;
+            break;
+        }
+        case state_skip_line:
+        default:
+        {
+            while (i < len && buf[i] != '\n' && buf[i] != '\r')
+                i++;
+            break;
+        }
+        }
+    }
+
+    return i;
+}
+
+bool FirebaseSSEParser::flush()
+{
+    if (_available)
+        return true;
+
+    if (_state != state_line_start || _failed)
+        return false;
+
+    // no data line since the last empty line, the event field is kept for the data of the next read
+    if (_data.len == 0)
+        return false;
+
+    // the JSON data was not closed, its remaining lines are coming
+    if (_scan.depth > 0 || _scan.in_string)
+        return false;
+
+    return dispatch();
+}
+
+void FirebaseSSEParser::reset()
+{
+    clearEvent();
+    _state = state_line_start;
+    _field = field_none;
+    _nameLen = 0;
+    _cr = false;
+    _failed = false;
+    _error = false;
+}
+
+void FirebaseSSEParser::release()
+{
+    reset();
+    freeBuffer(_event);
+    freeBuffer(_data);
+    _view = firebase_sse_event_view_t();
+}
+
+void FirebaseSSEParser::endLine()
+{
+    switch (_state)
+    {
+    case state_line_start:
+        // empty line, dispatch the event
+        dispatch();
+        break;
+    case state_field_name:
+        // field name without colon, its value is empty string
+        setField();
+        if (_field == field_data)
+            appendField("\n", 1);
+        else if (_field == field_event)
+            _event.len = 0;
+        break;
+    case state_field_space:
+    case state_field_value:
+        if (_field == field_data)
+            appendField("\n", 1);
+        break;
+    default:
+        break;
+    }
+
+    _state = state_line_start;
+    _field = field_none;
+}
+
+void FirebaseSSEParser::setField()
+{
+    _field = field_none;
+
+    if (_nameLen == 5 && memcmp(_name, "event", 5) == 0)
+    {
+        _field = field_event;
+        // the last event field wins
+        _event.len = 0;
+    }
+    else if (_nameLen == 4 && memcmp(_name, "data", 4) == 0)
+        _field = field_data;
+}
+
+bool FirebaseSSEParser::dispatch()
+{
+    // the incomplete event is not dispatched
+    if (_failed)
+    {
+        clearEvent();
+        _failed = false;
+        _error = true;
+        _dropCount++;
+        return false;
+    }
+
+    // no data, no event
+    if (_data.len == 0)
+    {
+        _event.len = 0;
+        return false;
+    }
+
+    // remove the last data line break
+    if (_data.p[_data.len - 1] == '\n')
+        _data.len--;
+
+    // buffers were allocated with the extra byte for NUL terminator
+    _data.p[_data.len] = '\0';
+    if (_event.p)
+        _event.p[_event.len] = '\0';
+
+    _view.event = _event.p ? _event.p : "";
+    _view.eventLen = _event.len;
+    _view.data = _data.p;
+    _view.dataLen = _data.len;
+
+    if (_hasPath && _pathLen >= 2 && _data.p[_pathOfs] == '"')
+    {
+        // exclude the quotes
+        _view.path = _data.p + _pathOfs + 1;
+        _view.pathLen = _pathLen - 2;
+    }
+
+    if (_hasValue)
+    {
+        _view.value = _data.p + _valueOfs;
+        _view.valueLen = _valueLen;
+    }
+
+    _available = true;
+    _eventCount++;
+    return true;
+}
+
+void FirebaseSSEParser::clearEvent()
+{
+    _event.len = 0;
+    _data.len = 0;
+    _available = false;
+    _view = firebase_sse_event_view_t();
+    _hasPath = false;
+    _hasValue = false;
+    MB_JSON_ScannerInit(&_scan, scanMember, this);
+}
+
+void FirebaseSSEParser::appendField(const char *src, size_t len)
+{
+    if (_failed)
+        return;
+
+    if (!append(_field == field_event ? _event : _data, src, len))
+    {
+        // drop the rest of the event, it will not be dispatched
+        _failed = true;
+        _state = state_skip_line;
+        return;
+    }
+
+    if (_field == field_data)
+        MB_JSON_ScannerFeed(&_scan, src, len);
+}
+
+void FirebaseSSEParser::scanMember(size_t keyOfs, size_t keyLen, size_t valueOfs, size_t valueLen, void *arg)
+{
+    FirebaseSSEParser *parser = reinterpret_cast<FirebaseSSEParser *>(arg);
+    const char *key = parser->_data.p + keyOfs;
+
+    if (keyLen == 4 && memcmp(key, "path", 4) == 0)
+    {
+        parser->_pathOfs = valueOfs;
+        parser->_pathLen = valueLen;
+        parser->_hasPath = true;
+    }
+    else if (keyLen == 4 && memcmp(key, "data", 4) == 0)
+    {
+        parser->_valueOfs = valueOfs;
+        parser->_valueLen = valueLen;
+        parser->_hasValue = true;
+    }
+}
+
+bool FirebaseSSEParser::append(sse_buffer_t &b, const char *src, size_t len)
+{
+    if (len == 0)
+        return true;
+
+    if (b.len + len + 1 > b.cap)
+    {
+        size_t cap = b.cap > 0 ? b.cap * 2 : 64;
+        while (cap < b.len + len + 1)
+            cap *= 2;
+
+        char *p = reinterpret_cast<char *>(Core.mbfs.newP(cap, false));
+        if (!p)
+            return false;
+
+        if (b.len > 0)
+            memcpy(p, b.p, b.len);
+
+        Core.mbfs.delP(&b.p);
+        b.p = p;
+        b.cap = cap;
+    }
+
+    memcpy(b.p + b.len, src, len);
+    b.len += len;
+    return true;
+}
+
+void FirebaseSSEParser::freeBuffer(sse_buffer_t &b)
+{
+    Core.mbfs.delP(&b.p);
+    b.len = 0;
+    b.cap = 0;
+}
+
+#endif
+
+#endif // ENABLE
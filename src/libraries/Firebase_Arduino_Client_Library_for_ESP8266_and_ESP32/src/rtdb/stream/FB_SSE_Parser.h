@@ -0,0 +1,186 @@
+/**
+ * Google's Firebase SSE Parser class, FB_SSE_Parser.h version 1.0.0
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_SSE_PARSER_H
+#define FIREBASE_SSE_PARSER_H
+#include <Arduino.h>
+#include "./mbfs/MB_FS.h"
+#include "./json/MB_JSON/MB_JSON.h"
+
+/** The view of the dispatched event.
+ *
+ * event The event type (NUL terminated) e.g. put, patch, keep-alive, cancel and auth_revoked.
+ * data The event data (NUL terminated), the data lines joined with '\n'.
+ * path The "path" string member of the event data object without quotes, NULL if not found.
+ * value The "data" member (JSON text) of the event data object, NULL if not found.
+ *
+ * @note The pointers refer to the parser buffers and are valid until the next feed, flush or reset call.
+ * The path and value are not NUL terminated.
+ */
+struct firebase_sse_event_view_t
+{
+    const char *event = "";
+    size_t eventLen = 0;
+    const char *data = "";
+    size_t dataLen = 0;
+    const char *path = nullptr;
+    size_t pathLen = 0;
+    const char *value = nullptr;
+    size_t valueLen = 0;
+};
+
+/** Incremental (push) parser of the text/event-stream.
+ *
+ * The bytes are consumed once as they were read from the network, the field values are copied
+ * to the reused buffers which only grow when the larger event was received.
+ * The data bytes are also fed to the incremental MB_JSON scanner as they arrive, the path and
+ * data members of the event data object are located without scanning the event again.
+ */
+class FirebaseSSEParser
+{
+public:
+    FirebaseSSEParser();
+    ~FirebaseSSEParser();
+
+    /** Feed the stream bytes to the parser.
+     *
+     * @param buf The stream bytes.
+     * @param len The number of bytes.
+     * @return The number of bytes consumed.
+     *
+     * @note The parser stops consuming right after the event was dispatched,
+     * check available() and feed the remaining bytes after the event was used.
+     */
+    size_t feed(const char *buf, size_t len);
+
+    /** Dispatch the event which all lines were received but the terminating empty line.
+     *
+     * @return Boolean value, indicates the event is available.
+     *
+     * @note The incomplete line is kept for the next feed. Nothing is dispatched until a data line was
+     * received, the event field of the data that comes in the next read is kept.
+     */
+    bool flush();
+
+    /** Check whether the event was dispatched and is available to read.
+     */
+    bool available() { return _available; }
+
+    /** Get the view of the dispatched event.
+     */
+    const firebase_sse_event_view_t &event() { return _view; }
+
+    /** Check whether the incomplete event or line is waiting for more bytes.
+     */
+    bool pending() { return !_available && (_state != state_line_start || _event.len > 0 || _data.len > 0 || _failed); }
+
+    /** Check whether the event was dropped because its buffer could not be allocated.
+     *
+     * @note The event stream is not in sync after the event was lost, the connection should be closed.
+     * The status is kept until reset.
+     */
+    bool failed() { return _error; }
+
+    /** Get the number of the events that were dropped.
+     */
+    size_t dropCount() { return _dropCount; }
+
+    /** Clear the parser state for the new connection and keep the buffers.
+     */
+    void reset();
+
+    /** Clear the parser state and free the buffers.
+     */
+    void release();
+
+    /** Get the number of the events that were dispatched.
+     */
+    size_t eventCount() { return _eventCount; }
+
+    /** Get the current total size of the parser buffers.
+     */
+    size_t bufferSize() { return _event.cap + _data.cap; }
+
+private:
+    enum sse_parser_state
+    {
+        state_line_start,
+        state_field_name,
+        state_field_space,
+        state_field_value,
+        state_skip_line
+    };
+
+    enum sse_field_type
+    {
+        field_none,
+        field_event,
+        field_data
+    };
+
+    struct sse_buffer_t
+    {
+        char *p = nullptr;
+        size_t len = 0;
+        size_t cap = 0;
+    };
+
+    sse_parser_state _state = state_line_start;
+    sse_field_type _field = field_none;
+    char _name[8];
+    size_t _nameLen = 0;
+    bool _cr = false;
+    bool _available = false;
+    // the bytes of the current event were lost
+    bool _failed = false;
+    bool _error = false;
+    size_t _eventCount = 0;
+    size_t _dropCount = 0;
+    sse_buffer_t _event;
+    sse_buffer_t _data;
+    firebase_sse_event_view_t _view;
+    MB_JSON_Scanner _scan;
+    size_t _pathOfs = 0, _pathLen = 0, _valueOfs = 0, _valueLen = 0;
+    bool _hasPath = false, _hasValue = false;
+
+    void endLine();
+    void setField();
+    bool dispatch();
+    void clearEvent();
+    void appendField(const char *src, size_t len);
+    bool append(sse_buffer_t &b, const char *src, size_t len);
+    void freeBuffer(sse_buffer_t &b);
+    static void scanMember(size_t keyOfs, size_t keyLen, size_t valueOfs, size_t valueLen, void *arg);
+};
+
+#endif
+
+#endif // ENABLE
@@ -0,0 +1,433 @@
+/**
+ * Google's Firebase StreamMux class, FB_StreamMux.cpp version 1.0.0
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_STREAM_MUX_CPP
+#define FIREBASE_STREAM_MUX_CPP
+
+#include "FB_StreamMux.h"
+
+FirebaseStreamMux::FirebaseStreamMux()
+{
+}
+
+FirebaseStreamMux::~FirebaseStreamMux()
+{
+    clear();
+}
+
+bool FirebaseStreamMux::addRoute(const String &route, StreamMuxEventCallback callback)
+{
+    if (!callback)
+        return false;
+
+    MB_String path = route.c_str();
+    normalize(path);
+
+    for (size_t i = 0; i < _routes.size(); i++)
+    {
+        if (strcmp(_routes[i].path.c_str(), path.c_str()) == 0)
+        {
+            _routes[i].cb = callback;
+            return true;
+        }
+    }
+
+    route_info_t info;
+    info.path = path;
+    info.cb = callback;
+    _routes.push_back(info);
+    return true;
+}
+
+void FirebaseStreamMux::removeRoute(const String &route)
+{
+    MB_String path = route.c_str();
+    normalize(path);
+
+    for (size_t i = 0; i < _routes.size(); i++)
+    {
+        if (strcmp(_routes[i].path.c_str(), path.c_str()) == 0)
+        {
+            _routes.erase(_routes.begin() + i);
+            break;
+        }
+    }
+}
+
+void FirebaseStreamMux::clear()
+{
+    _routes.clear();
+    _shadow.clear();
+    _shadowIsObject = false;
+    _rootValue.clear();
+    _eventCount = 0;
+}
+
+bool FirebaseStreamMux::get(FirebaseJsonData &result, const String &path)
+{
+    MB_String jsPath;
+    MB_String p = path.c_str();
+    normalize(p);
+    if (p.length() == 1 && !_shadowIsObject)
+        return _rootValue.get(result, pgm2Str(firebase_rtdb_ss_pgm_str_17 /* "value" */));
+    toJsonPath(p, jsPath);
+    return _shadow.get(result, jsPath.c_str());
+}
+
+void FirebaseStreamMux::dispatch(const MB_String &eventType, const MB_String &eventPath, const MB_String &data, uint8_t dataType)
+{
+    MB_String path = eventPath;
+    normalize(path);
+
+    MB_VECTOR<MB_String> changed;
+
+    if (strcmp(eventType.c_str(), pgm2Str(firebase_pgm_str_16 /* "put" */)) == 0)
+    {
+        applyPut(path, data.c_str(), dataType);
+        changed.push_back(path);
+    }
+    else if (strcmp(eventType.c_str(), pgm2Str(firebase_pgm_str_17 /* "patch" */)) == 0)
+        applyPatch(path, data.c_str(), changed);
+    else
+    {
+        // cancel and auth_revoked events, the server will send the full data (put at root) after the stream was resumed
+        changed.push_back(MB_String(pgm2Str(firebase_pgm_str_1 /* "/" */)));
+    }
+
+    _eventCount++;
+
+    notify(eventType, changed);
+}
+
+void FirebaseStreamMux::applyPut(const MB_String &path, const char *data, uint8_t dataType)
+{
+    if (dataType == firebase_data_type::d_any)
+        dataType = getRawDataType(data);
+
+    // put at the stream root replaces the entire shadow tree
+    if (path.length() == 1)
+    {
+        _shadow.clear();
+        _rootValue.clear();
+        _shadowIsObject = dataType == firebase_data_type::d_json;
+        if (_shadowIsObject)
+            _shadow.setJsonData(data);
+        else
+            setValue(_rootValue, pgm2Str(firebase_rtdb_ss_pgm_str_17 /* "value" */), data, dataType);
+        return;
+    }
+
+    MB_String jsPath;
+    toJsonPath(path, jsPath);
+
+    if (!_shadowIsObject)
+    {
+        _shadow.clear();
+        _rootValue.clear();
+        _shadowIsObject = true;
+    }
+
+    setValue(_shadow, jsPath.c_str(), data, dataType);
+}
+
+void FirebaseStreamMux::setValue(FirebaseJson &js, const char *jsPath, const char *data, uint8_t dataType)
+{
+    switch (dataType)
+    {
+    case firebase_data_type::d_null:
+        js.remove(jsPath);
+        break;
+    case firebase_data_type::d_json:
+    {
+        FirebaseJson obj;
+        obj.setJsonData(data);
+        js.set(jsPath, obj);
+        break;
+    }
+    case firebase_data_type::d_array:
+    {
+        FirebaseJsonArray arr;
+        arr.setJsonArrayData(data);
+        js.set(jsPath, arr);
+        break;
+    }
+    case firebase_data_type::d_boolean:
+        js.set(jsPath, strcmp(data, pgm2Str(firebase_pgm_str_20 /* "true" */)) == 0);
+        break;
+    case firebase_data_type::d_integer:
+        // 64-bit e.g. the millisecond timestamps, strtoll saturates instead of overflow
+        js.set(jsPath, (int64_t)strtoll(data, NULL, 10));
+        break;
+    case firebase_data_type::d_float:
+    case firebase_data_type::d_double:
+        js.set(jsPath, atof(data));
+        break;
+    case firebase_data_type::d_string:
+    {
+        // FirebaseJson escapes the string it is set, it takes the unescaped value
+        MB_String s;
+        if (decodeString(data, s))
+            js.set(jsPath, s.c_str());
+        break;
+    }
+    default:
+        // blob and file data are not kept in shadow
+        break;
+    }
+}
+
+bool FirebaseStreamMux::decodeString(const char *raw, MB_String &out)
+{
+    // The raw string is the escaped JSON text, quoted when it comes from the patch data and
+    // trimmed when it comes from the put event or FirebaseJson::get, the parser unescapes it.
+    bool quoted = raw[0] == '"';
+    MB_String s;
+    if (!quoted)
+        s += '"';
+    s += raw;
+    if (!quoted)
+        s += '"';
+
+    MB_JSON *item = MB_JSON_Parse(s.c_str());
+    bool ret = item && MB_JSON_IsString(item);
+    if (ret)
+        out = item->valuestring;
+    MB_JSON_Delete(item);
+    return ret;
+}
+
+void FirebaseStreamMux::applyPatch(const MB_String &path, const char *data, MB_VECTOR<MB_String> &changed)
+{
+    // The patch data is the JSON object of the children to be updated (multi-location update),
+    // apply each top level child as a put at its own path. The children are taken as text from the
+    // data, the integers keep their 64 bits (a parsed number is a double), and none is applied
+    // unless the whole object is valid.
+    MB_VECTOR<size_t> spans;
+    size_t i = skipSpace(data, 0);
+    if (data[i] != '{')
+        return;
+
+    i = skipSpace(data, i + 1);
+    while (data[i] != '}')
+    {
+        size_t keyEnd = data[i] == '"' ? valueEnd(data, i) : 0;
+        if (keyEnd == 0)
+            return;
+        size_t ofs = skipSpace(data, keyEnd);
+        if (data[ofs] != ':')
+            return;
+        ofs = skipSpace(data, ofs + 1);
+        size_t end = valueEnd(data, ofs);
+        if (end <= ofs)
+            return;
+        spans.push_back(i);
+        spans.push_back(keyEnd);
+        spans.push_back(ofs);
+        spans.push_back(end);
+
+        i = skipSpace(data, end);
+        if (data[i] == ',')
+            i = skipSpace(data, i + 1);
+        else if (data[i] != '}')
+            return;
+    }
+
+    MB_String key, value;
+    for (size_t k = 0; k < spans.size(); k += 4)
+    {
+        key.clear();
+        key.append(data + spans[k], spans[k + 1] - spans[k]);
+        value.clear();
+        value.append(data + spans[k + 2], spans[k + 3] - spans[k + 2]);
+
+        MB_String name;
+        if (!decodeString(key.c_str(), name))
+            continue;
+
+        MB_String childPath = path;
+        if (childPath.length() > 1)
+            childPath += '/';
+        childPath += name;
+        normalize(childPath);
+
+        applyPut(childPath, value.c_str(), firebase_data_type::d_any);
+        changed.push_back(childPath);
+    }
+}
+
+size_t FirebaseStreamMux::skipSpace(const char *s, size_t i)
+{
+    while (s[i] == ' ' || s[i] == '\t' || s[i] == '\r' || s[i] == '\n')
+        i++;
+    return i;
+}
+
+size_t FirebaseStreamMux::valueEnd(const char *s, size_t i)
+{
+    // The end (one past) of the JSON value at i, 0 when the string or the container is not closed
+    size_t depth = 0;
+    for (; s[i]; i++)
+    {
+        char c = s[i];
+        if (c == '"')
+        {
+            for (i++; s[i] && s[i] != '"'; i++)
+            {
+                if (s[i] == '\\' && s[i + 1])
+                    i++;
+            }
+            if (!s[i])
+                return 0;
+            if (depth == 0)
+                return i + 1;
+        }
+        else if (c == '{' || c == '[')
+            depth++;
+        else if (c == '}' || c == ']')
+        {
+            // a primitive ends at the close of its parent
+            if (depth == 0)
+                return i;
+            if (--depth == 0)
+                return i + 1;
+        }
+        else if (depth == 0 && (c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\n'))
+            return i;
+    }
+    return depth == 0 ? i : 0;
+}
+
+void FirebaseStreamMux::notify(const MB_String &eventType, MB_VECTOR<MB_String> &changed)
+{
+    StreamMuxEvent event;
+
+    for (size_t i = 0; i < _routes.size(); i++)
+    {
+        size_t c = 0;
+        for (c = 0; c < changed.size(); c++)
+        {
+            // route is affected when the changed node is the route, its child or its parent
+            if (isParentOf(changed[c], _routes[i].path) || isParentOf(_routes[i].path, changed[c]))
+                break;
+        }
+
+        if (c == changed.size())
+            continue;
+
+        event.route = _routes[i].path.c_str();
+        event.dataPath = changed[c].c_str();
+        event.eventType = eventType.c_str();
+
+        if (_routes[i].path.length() == 1 && _shadowIsObject)
+        {
+            _shadow.toString(event.value);
+            event.type = pgm2Str(firebase_rtdb_ss_pgm_str_1 /* "json" */);
+        }
+        else
+        {
+            FirebaseJsonData result;
+            if (get(result, _routes[i].path.c_str()))
+            {
+                MB_String s;
+                if (result.typeNum == FirebaseJson::JSON_STRING && decodeString(result.to<const char *>(), s))
+                    event.value = s.c_str();
+                else
+                    event.value = result.to<const char *>();
+                // the RTDB type names of the stream data, FirebaseJson names the object "object"
+                if (result.typeNum == FirebaseJson::JSON_OBJECT)
+                    event.type = pgm2Str(firebase_rtdb_ss_pgm_str_1 /* "json" */);
+                else
+                    event.type = result.type;
+            }
+            else
+            {
+                event.value.remove(0, event.value.length());
+                event.type = pgm2Str(firebase_rtdb_ss_pgm_str_6 /* "null" */);
+            }
+        }
+
+        if (_routes[i].cb)
+            _routes[i].cb(event);
+    }
+}
+
+void FirebaseStreamMux::normalize(MB_String &path)
+{
+    if (path.length() == 0 || path[0] != '/')
+        path.insert(0, 1, '/');
+
+    while (path.length() > 1 && path[path.length() - 1] == '/')
+        path.erase(path.length() - 1, 1);
+}
+
+void FirebaseStreamMux::toJsonPath(const MB_String &path, MB_String &out)
+{
+    // FirebaseJson path has no leading slash
+    out = path.length() > 1 ? path.substr(1, path.length() - 1) : MB_String();
+}
+
+bool FirebaseStreamMux::isParentOf(const MB_String &parent, const MB_String &child)
+{
+    if (parent.length() == 1)
+        return true;
+
+    if (child.length() < parent.length() || strncmp(child.c_str(), parent.c_str(), parent.length()) != 0)
+        return false;
+
+    return child.length() == parent.length() || child[parent.length()] == '/';
+}
+
+uint8_t FirebaseStreamMux::getRawDataType(const char *data)
+{
+    if (!data || strlen(data) == 0)
+        return firebase_data_type::d_null;
+
+    switch (data[0])
+    {
+    case '{':
+        return firebase_data_type::d_json;
+    case '[':
+        return firebase_data_type::d_array;
+    case '"':
+        return firebase_data_type::d_string;
+    case 't':
+    case 'f':
+        return firebase_data_type::d_boolean;
+    case 'n':
+        return firebase_data_type::d_null;
+    default:
+        return strpbrk(data, ".eE") ? firebase_data_type::d_double : firebase_data_type::d_integer;
+    }
+}
+
+#endif
+
+#endif // ENABLE
@@ -0,0 +1,143 @@
+/**
+ * Google's Firebase StreamMux class, FB_StreamMux.h version 1.0.0
+ *
+ * Created October 16, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_STREAM_MUX_H
+#define FIREBASE_STREAM_MUX_H
+#include <Arduino.h>
+#include "./FB_Utils.h"
+#include "./core/FirebaseCore.h"
+
+using namespace mb_string;
+
+/** The event data passed to the route callback.
+ *
+ * route The registered route (relative to the stream path) that matched the event.
+ * dataPath The path (relative to the stream path) that was changed by the event.
+ * eventType The SSE event type e.g. put, patch, cancel and auth_revoked.
+ * value The current value of the route node in the shadow tree (JSON string for object and array, the
+ * unescaped text for string).
+ * type The data type of value e.g. null, int, float, double, boolean, string, json and array.
+ */
+struct firebase_stream_mux_event_t
+{
+    String route;
+    String dataPath;
+    String eventType;
+    String value;
+    String type;
+};
+
+typedef struct firebase_stream_mux_event_t StreamMuxEvent;
+typedef void (*StreamMuxEventCallback)(StreamMuxEvent &);
+
+class FirebaseStreamMux
+{
+    friend class FB_RTDB;
+
+public:
+    FirebaseStreamMux();
+    ~FirebaseStreamMux();
+
+    /** Register the callback for changes at or under the route.
+     *
+     * @param route The path of the node relative to the stream path e.g. "/control" or "/channels/ppg".
+     * @param callback The callback function that accepts StreamMuxEvent data.
+     * @return Boolean value, indicates the success of the operation.
+     *
+     * @note Only one stream connection is needed for all routes, the stream should begin at the
+     * common parent path of the routes.
+     *
+     * The callback will be called when the route node or any of its children or any of its parents
+     * was changed by the put or patch events.
+     */
+    bool addRoute(const String &route, StreamMuxEventCallback callback);
+
+    /** Remove the route callback.
+     *
+     * @param route The path of the node relative to the stream path.
+     */
+    void removeRoute(const String &route);
+
+    /** Remove all route callbacks and clear the shadow tree.
+     */
+    void clear();
+
+    /** Get the shadow tree of the stream path which was kept in sync with the put and patch events.
+     *
+     * @return FirebaseJson object of the stream path data.
+     */
+    FirebaseJson &shadow() { return _shadow; }
+
+    /** Get the current value at the path from the shadow tree.
+     *
+     * The string value is escaped as the result of FirebaseJson::get.
+     *
+     * @param result The FirebaseJsonData object that holds the result.
+     * @param path The path relative to the stream path.
+     * @return Boolean value, indicates the success of the operation.
+     */
+    bool get(FirebaseJsonData &result, const String &path);
+
+    /** Get the number of the stream events that were applied to the shadow tree.
+     */
+    size_t eventCount() { return _eventCount; }
+
+private:
+    struct route_info_t
+    {
+        MB_String path;
+        StreamMuxEventCallback cb = NULL;
+    };
+
+    MB_VECTOR<route_info_t> _routes;
+    FirebaseJson _shadow;
+    bool _shadowIsObject = false;
+    // the stream path value when it is not an object (primitive or array), as the member "value"
+    FirebaseJson _rootValue;
+    size_t _eventCount = 0;
+
+    void dispatch(const MB_String &eventType, const MB_String &eventPath, const MB_String &data, uint8_t dataType);
+    void applyPut(const MB_String &path, const char *data, uint8_t dataType);
+    void setValue(FirebaseJson &js, const char *jsPath, const char *data, uint8_t dataType);
+    bool decodeString(const char *raw, MB_String &out);
+    size_t skipSpace(const char *s, size_t i);
+    size_t valueEnd(const char *s, size_t i);
+    void applyPatch(const MB_String &path, const char *data, MB_VECTOR<MB_String> &changed);
+    void notify(const MB_String &eventType, MB_VECTOR<MB_String> &changed);
+    void normalize(MB_String &path);
+    void toJsonPath(const MB_String &path, MB_String &out);
+    bool isParentOf(const MB_String &parent, const MB_String &child);
+    uint8_t getRawDataType(const char *data);
+};
+
+#endif
+
+#endif // ENABLE
@@ -81,6 +81,12 @@ void FirebaseData::setGenericClient(Client *client, FB_NetworkConnectionRequestC
 
 void FirebaseData::setGSMClient(Client *client, void *modem, const char *pin, const char *apn, const char *user, const char *password)
 {
+    (void)client;
+    (void)modem;
+    (void)pin;
+    (void)apn;
+    (void)user;
+    (void)password;
 #if defined(FIREBASE_GSM_MODEM_IS_AVAILABLE)
 
     Core._cli_type = firebase_client_type_external_gsm_client;
@@ -127,6 +133,57 @@ int FirebaseData::tcpWrite(const uint8_t *data, size_t size)
     return r;
 }
 
+int FirebaseData::tcpWriteFile(firebase_mem_storage_type type, uint8_t *buf, size_t size)
+{
+    // read the opened file into the SSL output buffer directly when it is available,
+    // otherwise read into buf and write
+    size_t avail = 0;
+    uint8_t *dst = tcpClient.getWriteBuffer(avail);
+    int r = 0;
+
+    if (dst && avail > 0)
+    {
+        r = Core.mbfs.read(mbfs_type type, dst, size > avail ? avail : size);
+        if (r > 0 && tcpClient.commitWriteBuffer(r) != (size_t)r)
+            r = -1;
+    }
+    else if (buf)
+    {
+        r = Core.mbfs.read(mbfs_type type, buf, size);
+        if (r > 0 && (int)tcpClient.write(buf, r) != r)
+            r = -1;
+    }
+
+    setSession(false, r > 0);
+    return r;
+}
+
+int FirebaseData::tcpWriteData(const uint8_t *data, uint8_t *buf, size_t size)
+{
+    // the data can be in flash (PROGMEM), copy it to the SSL output buffer directly
+    // when it is available, otherwise copy to buf and write
+    size_t avail = 0;
+    uint8_t *dst = tcpClient.getWriteBuffer(avail);
+    int r = -1;
+
+    if (dst && avail > 0)
+    {
+        size_t n = size > avail ? avail : size;
+        memcpy_P(dst, data, n);
+        if (tcpClient.commitWriteBuffer(n) == n)
+            r = n;
+    }
+    else if (buf)
+    {
+        memcpy_P(buf, data, size);
+        if (tcpClient.write(buf, size) == size)
+            r = size;
+    }
+
+    setSession(false, r > 0);
+    return r;
+}
+
 void FirebaseData::addSession(firebase_con_mode mode)
 {
     setSession(true, false);
@@ -571,6 +628,43 @@ void FirebaseData::setBSSLBufferSize(uint16_t rx, uint16_t tx)
         session.bssl_tx_size = tx;
 }
 
+void FirebaseData::setBSSLMaxFragmentLength(uint16_t len)
+{
+    session.bssl_mfl_len = len;
+}
+
+void FirebaseData::getBSSLBufferUsage(size_t &rx, size_t &tx)
+{
+    tcpClient.getIOBufferUsage(rx, tx);
+}
+
+FB_TCPWriteStats FirebaseData::getTCPWriteStats()
+{
+    return tcpClient.getWriteStats();
+}
+
+void FirebaseData::resetTCPWriteStats()
+{
+    tcpClient.resetWriteStats();
+}
+
+#if defined(PERF_TRACE_ENABLED)
+FB_PerfStats FirebaseData::getPerfStats()
+{
+    return tcpClient.getPerfStats();
+}
+
+void FirebaseData::resetPerfStats()
+{
+    tcpClient.resetPerfStats();
+}
+#endif
+
+void FirebaseData::setNoDelay(bool noDelay)
+{
+    tcpClient.setNoDelay(noDelay);
+}
+
 void FirebaseData::setResponseSize(uint16_t len)
 {
     if (len >= 1024)
@@ -826,6 +920,7 @@ void FirebaseData::setSecure()
     }
 
     tcpClient.setBufferSizes(session.bssl_rx_size, session.bssl_tx_size);
+    tcpClient.setMaxFragmentLength(session.bssl_mfl_len);
 
     if (tcpClient.certType == firebase_cert_type_undefined || session.cert_updated)
     {
@@ -844,7 +939,10 @@ void FirebaseData::setSecure()
             tcpClient.clockReady = Core.internal.fb_clock_rdy;
         }
 
-        if (Core.config->cert.file.length() == 0)
+        // The pinned server key skips the certificate chain validation
+        if (Core.config->cert.pinned_key != NULL)
+            tcpClient.setPinnedKey(Core.config->cert.pinned_key);
+        else if (Core.config->cert.file.length() == 0)
         {
             if (session.cert_ptr > 0)
                 tcpClient.setCACert(reinterpret_cast<const char *>(session.cert_ptr));
@@ -864,7 +962,7 @@ void FirebaseData::setSecure()
 
 void FirebaseData::setCert(const char *ca)
 {
-    int ptr = reinterpret_cast<int>(ca);
+    uintptr_t ptr = reinterpret_cast<uintptr_t>(ca);
     if (ptr != session.cert_ptr)
     {
         session.cert_updated = true;
@@ -958,49 +1056,13 @@ bool FirebaseData::readPayload(MB_String *chunkOut, struct firebase_tcp_response
 
             char *pChunk = reinterpret_cast<char *>(Core.mbfs.newP(tcpHandler.chunkBufSize + 1));
 
-            if (response.isChunkedEnc)
-                delay(1);
-            // read the avilable data
-            // chunk transfer encoding?
-            if (response.isChunkedEnc)
-                tcpHandler.bufferAvailable = Core.hh.readChunkedData(&Core.sh, &Core.mbfs, &tcpClient, pChunk, nullptr, tcpHandler);
-            else
-            {
-
-                if (tcpHandler.payloadLen == 0)
-                    tcpHandler.bufferAvailable = Core.hh.readLine(&tcpClient, pChunk, tcpHandler.chunkBufSize);
-                else
-                {
-                    // for chunk base64 payload, we need to ensure the size is the multiples of 4 for decoding
-                    int readIndex = 0;
-                    while (readIndex < tcpHandler.chunkBufSize && tcpHandler.payloadRead + readIndex < tcpHandler.payloadLen)
-                    {
-                        int r = tcpClient.read();
-                        if (r > -1)
-                            pChunk[readIndex++] = (char)r;
-                        if (!reconnect(tcpHandler.dataTime))
-                            break;
-                    }
-                    tcpHandler.bufferAvailable = readIndex;
-                }
-            }
+            readChunk(pChunk, tcpHandler, response);
 
             if (tcpHandler.bufferAvailable > 0)
             {
-                session.payload_length += tcpHandler.bufferAvailable;
-                if (session.max_payload_length < session.payload_length)
-                    session.max_payload_length = session.payload_length;
-                tcpHandler.payloadRead += tcpHandler.bufferAvailable;
-
-                if (_responseCallback)
-                    _responseCallback(pChunk);
-
-                if (chunkOut)
-                {
-                    checkOvf(chunkOut->length() + tcpHandler.bufferAvailable, response);
-                    if (!session.buffer_ovf)
-                        *chunkOut += pChunk;
-                }
+                checkOvf(chunkOut->length() + tcpHandler.bufferAvailable, response);
+                if (!session.buffer_ovf)
+                    *chunkOut += pChunk;
             }
 
             Core.mbfs.delP(&pChunk);
@@ -1012,6 +1074,57 @@ bool FirebaseData::readPayload(MB_String *chunkOut, struct firebase_tcp_response
     return true;
 }
 
+void FirebaseData::readChunk(char *pChunk, struct firebase_tcp_response_handler_t &tcpHandler,
+                             struct server_response_data_t &response)
+{
+    // the buffer size should be at least chunkBufSize + 1
+
+    if (response.isChunkedEnc)
+        delay(1);
+    // read the avilable data
+    // chunk transfer encoding?
+    if (response.isChunkedEnc)
+        tcpHandler.bufferAvailable = Core.hh.readChunkedData(&Core.sh, &Core.mbfs, &tcpClient, pChunk, nullptr, tcpHandler);
+    else
+    {
+
+        if (tcpHandler.payloadLen == 0)
+            tcpHandler.bufferAvailable = Core.hh.readLine(&tcpClient, pChunk, tcpHandler.chunkBufSize);
+        else
+        {
+            // for chunk base64 payload, we need to ensure the size is the multiples of 4 for decoding
+            int readIndex = 0;
+            while (readIndex < tcpHandler.chunkBufSize && tcpHandler.payloadRead + readIndex < tcpHandler.payloadLen)
+            {
+                int len = tcpHandler.chunkBufSize - readIndex;
+                if (len > tcpHandler.payloadLen - tcpHandler.payloadRead - readIndex)
+                    len = tcpHandler.payloadLen - tcpHandler.payloadRead - readIndex;
+
+                // read the received data at once instead of byte by byte
+                int r = tcpClient.available() > 0 ? tcpClient.readBytes(pChunk + readIndex, len) : 0;
+                if (r > 0)
+                    readIndex += r;
+                if (!reconnect(tcpHandler.dataTime))
+                    break;
+            }
+            tcpHandler.bufferAvailable = readIndex;
+        }
+    }
+
+    if (tcpHandler.bufferAvailable > 0)
+    {
+        pChunk[tcpHandler.bufferAvailable] = 0;
+
+        session.payload_length += tcpHandler.bufferAvailable;
+        if (session.max_payload_length < session.payload_length)
+            session.max_payload_length = session.payload_length;
+        tcpHandler.payloadRead += tcpHandler.bufferAvailable;
+
+        if (_responseCallback)
+            _responseCallback(pChunk);
+    }
+}
+
 bool FirebaseData::readResponse(MB_String *payload, struct firebase_tcp_response_handler_t &tcpHandler,
                                 struct server_response_data_t &response)
 {
@@ -1025,6 +1138,18 @@ bool FirebaseData::readResponse(MB_String *payload, struct firebase_tcp_response
     if (tcpHandler.available() <= 0 && tcpHandler.payloadRead >= response.contentLen && response.contentLen > 0)
         return false;
 
+    // The server closed the connection, nothing more will come. The callers reset the data time on
+    // each read and would wait here forever.
+    if (tcpHandler.available() <= 0 && !tcpClient.connected())
+    {
+        if (response.httpCode == 0)
+        {
+            session.response.code = FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+            tcpHandler.error.code = FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+        }
+        return false;
+    }
+
     if (tcpHandler.available() > 0)
     {
         tcpHandler.chunkBufSize = tcpHandler.defaultChunkSize;
@@ -1046,6 +1171,8 @@ bool FirebaseData::readResponse(MB_String *payload, struct firebase_tcp_response
                     session.chunked_encoding = response.isChunkedEnc;
                     tcpHandler.payloadLen = response.contentLen;
 
+                    Core.syncServerTime(response.date);
+
                     if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK ||
                         response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT ||
                         response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT)
@@ -1113,34 +1240,45 @@ bool FirebaseData::prepareDownload(const MB_String &filename, firebase_mem_stora
 
 void FirebaseData::prepareDownloadOTA(struct firebase_tcp_response_handler_t &tcpHandler, struct server_response_data_t &response)
 {
-#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
+    (void)tcpHandler;
+    (void)response;
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST))
     int size = tcpHandler.decodedPayloadLen > 0 ? tcpHandler.decodedPayloadLen : response.contentLen;
-#if defined(ESP32) || defined(MB_ARDUINO_PICO)
-    tcpHandler.error.code = 0;
-    if (!Update.begin(size))
-        tcpHandler.error.code = FIREBASE_ERROR_FW_UPDATE_TOO_LOW_FREE_SKETCH_SPACE;
-#elif defined(ESP8266)
-    // tcpHandler.error.code = tcpClient.beginUpdate(size, false);
-    Update.begin(size);
-
-#endif
+    session.ota_digest.clear();
+    tcpHandler.error.code = Core.oh.begin(&Core.mbfs, size, tcpHandler.isBase64File);
 #endif
 }
 
 void FirebaseData::endDownloadOTA(struct firebase_tcp_response_handler_t &tcpHandler)
 {
-#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
+    (void)tcpHandler;
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST))
 
-    if (tcpHandler.error.code == 0 && !Update.end())
-        tcpHandler.error.code = FIREBASE_ERROR_FW_UPDATE_END_FAILED;
+    if (tcpHandler.error.code == 0)
+        tcpHandler.error.code = Core.oh.end(&Core.mbfs, session.ota_sha256, session.ota_digest);
+    else
+        Core.oh.abort(&Core.mbfs);
 
 #endif
 }
 
+#if defined(OTA_UPDATE_ENABLED)
+void FirebaseData::setOTASHA256(const char *sha256)
+{
+    session.ota_sha256 = sha256;
+}
+
+String FirebaseData::OTASHA256()
+{
+    return session.ota_digest.c_str();
+}
+#endif
+
 bool FirebaseData::processDownload(const MB_String &filename, firebase_mem_storage_type type,
                                    uint8_t *buf, int bufLen, struct firebase_tcp_response_handler_t &tcpHandler,
                                    struct server_response_data_t &response, int &stage, bool isOTA)
 {
+    (void)filename;
     if (!Core.config)
         return false;
 
@@ -1173,17 +1311,16 @@ bool FirebaseData::processDownload(const MB_String &filename, firebase_mem_stora
             // for RTDB, read payload string instead
             if (session.con_mode == firebase_con_mode_rtdb)
             {
-                MB_String pChunk;
-
-                readPayload(&pChunk, tcpHandler, response);
+                // read in place, the buffer has room for the chunk and its terminator
+                if (tcpHandler.pChunkIdx > 0 && !response.noContent)
+                    readChunk((char *)buf, tcpHandler, response);
 
                 // Last chunk?
                 if (Core.ut.isChunkComplete(&tcpHandler, &response, complete))
                     return true;
 
-                if (tcpHandler.bufferAvailable > 0 && pChunk.length() > 0)
+                if (tcpHandler.bufferAvailable > 0 && tcpHandler.pChunkIdx > 0 && !response.noContent)
                 {
-                    strcpy((char *)buf, pChunk.c_str());
                     bufReady = true;
 
                     if (tcpHandler.pChunkIdx == 1)
@@ -1213,9 +1350,9 @@ bool FirebaseData::processDownload(const MB_String &filename, firebase_mem_stora
                                 tcpHandler.decodedPayloadLen = (3 * (response.contentLen - response.payloadOfs - 1) / 4);
 
                             // check for pad length from base64 signature
-                            if (pChunk[1] == 'F')
+                            if (buf[1] == 'F')
                                 tcpHandler.base64PadLenSignature = 1;
-                            else if (pChunk[2] == 'I')
+                            else if (buf[2] == 'I')
                                 tcpHandler.base64PadLenSignature = 2;
 
                             if (tcpHandler.base64PadLenSignature > 0 && tcpHandler.decodedPayloadLen > 0)
@@ -1228,8 +1365,6 @@ bool FirebaseData::processDownload(const MB_String &filename, firebase_mem_stora
 #endif
                     }
                 }
-
-                pChunk.clear();
             }
             else
             {
@@ -1258,35 +1393,24 @@ bool FirebaseData::processDownload(const MB_String &filename, firebase_mem_stora
         int ofs = 0;
         (void)ofs;
 
-        if (session.con_mode == firebase_con_mode_rtdb)
-        {
-            payload = (char *)buf;
-
-            if (tcpHandler.isBase64File)
-            {
-                if (tcpHandler.pChunkIdx == 1)
-                    ofs = response.payloadOfs;
-
-                tcpHandler.base64PadLenTail = Core.oh.trimLastChunkBase64(payload, payload.length());
-            }
-        }
+        if (session.con_mode == firebase_con_mode_rtdb && tcpHandler.isBase64File && tcpHandler.pChunkIdx == 1)
+            ofs = response.payloadOfs;
 
+        // the firmware is written from the read buffer, the quotes and the incomplete
+        // base64 quantum of the chunk are handled by the sink
         if (isOTA)
         {
-#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST))
+            if (session.con_mode == firebase_con_mode_rtdb && tcpHandler.isBase64File && tcpHandler.pChunkIdx == 1)
+                prepareDownloadOTA(tcpHandler, response);
+
             if (tcpHandler.error.code == 0)
             {
                 bool ret = false;
                 if (session.con_mode == firebase_con_mode_rtdb && tcpHandler.isBase64File)
-                {
-                    if (tcpHandler.pChunkIdx == 1)
-                        prepareDownloadOTA(tcpHandler, response);
-
-                    ret = Core.oh.decodeBase64OTA(&Core.bh, &Core.mbfs, payload.c_str() + ofs,
-                                                  payload.length() - ofs, tcpHandler.error.code);
-                }
+                    ret = Core.oh.writeBase64((const char *)buf + ofs, tcpHandler.bufferAvailable - ofs);
                 else
-                    ret = Core.bh.updateWrite(buf, tcpHandler.bufferAvailable);
+                    ret = Core.oh.write(buf, tcpHandler.bufferAvailable);
 
                 if (!ret)
                     tcpHandler.error.code = FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED;
@@ -1295,6 +1419,13 @@ bool FirebaseData::processDownload(const MB_String &filename, firebase_mem_stora
         }
         else
         {
+            if (session.con_mode == firebase_con_mode_rtdb)
+            {
+                payload = (char *)buf;
+
+                if (tcpHandler.isBase64File)
+                    tcpHandler.base64PadLenTail = Core.oh.trimLastChunkBase64(payload, payload.length());
+            }
 
             if (tcpHandler.error.code == 0)
             {
@@ -1565,7 +1696,8 @@ void FirebaseData::getError(MB_String &payload, struct firebase_tcp_response_han
         if (payload[0] == '{')
         {
             initJson();
-            Core.jh.setData(session.jsonPtr, payload, clearPayload);
+            // only the error code and message are read from the response which can be a large document
+            Core.jh.setData(session.jsonPtr, payload, clearPayload, true);
 
             if (Core.jh.parse(session.jsonPtr, session.dataPtr, firebase_storage_ss_pgm_str_16 /* "error/code" */))
             {
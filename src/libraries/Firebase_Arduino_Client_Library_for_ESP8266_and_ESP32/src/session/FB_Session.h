@@ -37,6 +37,8 @@
 
 #include "./rtdb/stream/FB_Stream.h"
 #include "./rtdb/stream/FB_MP_Stream.h"
+#include "./rtdb/stream/FB_StreamMux.h"
+#include "./rtdb/stream/FB_SSE_Parser.h"
 #include "./rtdb/QueueInfo.h"
 #include "./rtdb/QueueManager.h"
 
@@ -142,7 +144,11 @@ public:
    */
   void setExternalClientCallbacks(FB_TCPConnectionRequestCallback tcpConnectionCB,
                                   FB_NetworkConnectionRequestCallback networkConnectionCB,
-                                  FB_NetworkStatusRequestCallback networkStatusCB) { setGenericClient(nullptr, networkConnectionCB, networkStatusCB); };
+                                  FB_NetworkStatusRequestCallback networkStatusCB)
+  {
+    (void)tcpConnectionCB;
+    setGenericClient(nullptr, networkConnectionCB, networkStatusCB);
+  };
 
   /** Assign external TinyGsm Client.
    *
@@ -181,6 +187,59 @@ public:
    */
   void setBSSLBufferSize(uint16_t rx, uint16_t tx);
 
+  /** Set the maximum fragment length to negotiate for secured mode BearSSL WiFi client.
+   *
+   * @param len The fragment length (512, 1024, 2048 or 4096) or 0 to disable.
+   *
+   * @note The server support is probed once per host, the receive buffer is reduced to this length
+   * when the server supports it.
+   */
+  void setBSSLMaxFragmentLength(uint16_t len);
+
+  /** Get the peak usage of the receive and transmit buffer memory for secured mode BearSSL WiFi client.
+   *
+   * @param rx The peak number of bytes used in receive buffer memory.
+   * @param tx The peak number of bytes used in transmit buffer memory.
+   *
+   * @note The usage can be used to tune the buffer sizes with setBSSLBufferSize.
+   */
+  void getBSSLBufferUsage(size_t &rx, size_t &tx);
+
+  /** Get the TLS records and TCP send calls of the requests.
+   *
+   * @return FB_TCPWriteStats data e.g. requests, records, socketWrites and bytes and the same of the last request.
+   *
+   * @note The request header and body are held until the response is polled and sent in full TLS records.
+   * The records of the handshake are included when the request opened a new connection.
+   */
+  FB_TCPWriteStats getTCPWriteStats();
+
+  /** Clear the TLS records and TCP send calls statistics.
+   */
+  void resetTCPWriteStats();
+
+#if defined(PERF_TRACE_ENABLED)
+  /** Get the time of the connection and request phases of this session.
+   *
+   * @return FB_PerfStats data e.g. the count, total and last time (us) of connect, handshake,
+   * request, wait and response phases, the bytes read and written and the handshakes.
+   *
+   * @note Available when ENABLE_PERF_TRACE is defined.
+   * The session id is the id of this session in the trace entries from Firebase.getPerfTrace.
+   */
+  FB_PerfStats getPerfStats();
+
+  /** Clear the phase time statistics.
+   */
+  void resetPerfStats();
+#endif
+
+  /** Enable or disable the Nagle algorithm of the internal WiFi client.
+   *
+   * @param noDelay True (default) to send the segments without waiting for the ACK of the previous one.
+   */
+  void setNoDelay(bool noDelay);
+
   /** Set the HTTP response size limit.
    *
    * @param len The server response buffer size limit.
@@ -193,6 +252,22 @@ public:
    */
   void setCert(const char *ca);
 
+#if defined(OTA_UPDATE_ENABLED)
+  /** Set the expected SHA-256 digest of the firmware for the OTA download.
+   *
+   * @param sha256 The hex string of the digest, the empty string to skip the check.
+   *
+   * @note The digest is checked before the update is finished, the update is aborted when it does not match.
+   */
+  void setOTASHA256(const char *sha256);
+
+  /** Get the SHA-256 digest of the last downloaded firmware.
+   *
+   * @return The hex string of the digest.
+   */
+  String OTASHA256();
+#endif
+
   /** Pause/Unpause WiFiClient from all Firebase operations.
    *
    * @param pause The boolean to set/unset pause operation.
@@ -768,6 +843,8 @@ private:
 #if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
   StreamEventCallback _dataAvailableCallback = NULL;
   MultiPathStreamEventCallback _multiPathDataCallback = NULL;
+  FirebaseStreamMux *_streamMux = nullptr;
+  FirebaseSSEParser _sseParser;
   StreamTimeoutCallback _timeoutCallback = NULL;
   QueueInfoCallback _queueInfoCallback = NULL;
 #endif
@@ -831,6 +908,8 @@ private:
   void waitRxReady();
   bool readPayload(MB_String *chunkOut, struct firebase_tcp_response_handler_t &tcpHandler,
                    struct server_response_data_t &response);
+  void readChunk(char *pChunk, struct firebase_tcp_response_handler_t &tcpHandler,
+                 struct server_response_data_t &response);
   bool readResponse(MB_String *payload, struct firebase_tcp_response_handler_t &tcpHandler,
                     struct server_response_data_t &response);
   bool prepareDownload(const MB_String &filename, firebase_mem_storage_type type, bool openFileInWrireMode = false);
@@ -888,6 +967,8 @@ private:
   void setSession(bool remove, bool status);
   int tcpSend(const char *s);
   int tcpWrite(const uint8_t *data, size_t size);
+  int tcpWriteFile(firebase_mem_storage_type type, uint8_t *buf, size_t size);
+  int tcpWriteData(const uint8_t *data, uint8_t *buf, size_t size);
   void addQueueSession();
   void removeQueueSession();
   void setRaw(bool trim);
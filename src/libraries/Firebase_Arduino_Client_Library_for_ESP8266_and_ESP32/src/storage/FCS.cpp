@@ -88,7 +88,8 @@ bool FB_Storage::sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *req)
 
     if (req->requestType == firebase_fcs_request_type_download ||
         req->requestType == firebase_fcs_request_type_download_ota ||
-        req->requestType == firebase_fcs_request_type_upload)
+        req->requestType == firebase_fcs_request_type_upload ||
+        req->requestType == firebase_fcs_request_type_upload_segments)
     {
         if (req->remoteFileName.length() == 0)
         {
@@ -121,7 +122,8 @@ bool FB_Storage::sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *req)
             sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
         }
         else if (req->requestType == firebase_fcs_request_type_upload ||
-                 req->requestType == firebase_fcs_request_type_upload_pgm_data)
+                 req->requestType == firebase_fcs_request_type_upload_pgm_data ||
+                 req->requestType == firebase_fcs_request_type_upload_segments)
         {
             fbdo->session.fcs.cbUploadInfo.status = firebase_fcs_upload_status_error;
             FCS_UploadStatusInfo in;
@@ -166,6 +168,21 @@ bool FB_Storage::mUpload(FirebaseData *fbdo, MB_StringPtr bucketID, const uint8_
     return sendRequest(fbdo, &req);
 }
 
+bool FB_Storage::mUpload(FirebaseData *fbdo, MB_StringPtr bucketID, const UploadSegment *segments, size_t count,
+                         MB_StringPtr remoteFileName, MB_StringPtr mime,
+                         FCS_UploadProgressCallback callback)
+{
+    struct firebase_fcs_req_t req;
+    req.remoteFileName = remoteFileName;
+    req.requestType = firebase_fcs_request_type_upload_segments;
+    req.bucketID = bucketID;
+    req.mime = mime;
+    req.segments = segments;
+    req.segmentCount = count;
+    req.uploadCallback = callback;
+    return sendRequest(fbdo, &req);
+}
+
 bool FB_Storage::mDownload(FirebaseData *fbdo, MB_StringPtr bucketID, MB_StringPtr remoteFileName,
                            MB_StringPtr localFileName, firebase_mem_storage_type storageType,
                            FCS_DownloadProgressCallback callback)
@@ -184,7 +201,11 @@ bool FB_Storage::mDownload(FirebaseData *fbdo, MB_StringPtr bucketID, MB_StringP
 bool FB_Storage::mDownloadOTA(FirebaseData *fbdo, MB_StringPtr bucketID, MB_StringPtr remoteFileName,
                               FCS_DownloadProgressCallback callback)
 {
-#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
+    (void)fbdo;
+    (void)bucketID;
+    (void)remoteFileName;
+    (void)callback;
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(MB_HOST))
     struct firebase_fcs_req_t req;
     req.remoteFileName = remoteFileName;
     req.requestType = firebase_fcs_request_type_download_ota;
@@ -349,6 +370,77 @@ void FB_Storage::reportDownloadProgress(FirebaseData *fbdo, struct firebase_fcs_
     }
 }
 
+size_t FB_Storage::getSegmentLength(const UploadSegment &segment)
+{
+    if (!segment.localFileName)
+        return segment.data ? segment.len : 0;
+
+    MB_String localFileName = segment.localFileName;
+    Core.ut.makePath(localFileName);
+
+    int size = Core.mbfs.open(localFileName, mbfs_type segment.storageType, mb_fs_open_mode_read);
+    if (size > 0)
+        Core.mbfs.close(mbfs_type segment.storageType); // fixed for ESP32 core v2.0.2, SPIFFS file
+
+    if (size <= 0 || segment.offset >= (size_t)size)
+        return 0;
+
+    if (segment.len > 0 && segment.offset + segment.len <= (size_t)size)
+        return segment.len;
+
+    return size - segment.offset;
+}
+
+bool FB_Storage::sendSegment(FirebaseData *fbdo, struct firebase_fcs_req_t *req, const UploadSegment &segment,
+                             uint8_t *buf, size_t bufLen, size_t &sent)
+{
+    size_t len = getSegmentLength(segment);
+    int written = 0;
+
+    if (segment.localFileName)
+    {
+        MB_String localFileName = segment.localFileName;
+        Core.ut.makePath(localFileName);
+
+        // Fix in ESP32 core 2.0.x
+        if (Core.mbfs.open(localFileName, mbfs_type segment.storageType, mb_fs_open_mode_read) < 0)
+            return false;
+
+        if (segment.offset > 0)
+            Core.mbfs.seek(mbfs_type segment.storageType, segment.offset);
+
+        while (len > 0)
+        {
+            written = fbdo->tcpWriteFile(segment.storageType, buf, len > bufLen ? bufLen : len);
+            if (written <= 0)
+                break;
+
+            len -= written;
+            sent += written;
+            reportUploadProgress(fbdo, req, sent);
+        }
+
+        Core.mbfs.close(mbfs_type segment.storageType);
+    }
+    else
+    {
+        size_t pos = 0;
+        while (len > 0)
+        {
+            written = fbdo->tcpWriteData(segment.data + pos, buf, len > bufLen ? bufLen : len);
+            if (written <= 0)
+                break;
+
+            pos += written;
+            len -= written;
+            sent += written;
+            reportUploadProgress(fbdo, req, sent);
+        }
+    }
+
+    return len == 0;
+}
+
 bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *req)
 {
 
@@ -368,13 +460,21 @@ bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *
 
     req->fileSize = ret;
 
+    if (req->requestType == firebase_fcs_request_type_upload_segments)
+    {
+        for (size_t i = 0; i < req->segmentCount; i++)
+            req->fileSize += getSegmentLength(req->segments[i]);
+    }
+
     MB_String header;
     size_t len = 0;
     bool hasParams = false;
     ret = -1;
     firebase_request_method method = http_undefined;
 
-    if (req->requestType == firebase_fcs_request_type_upload || req->requestType == firebase_fcs_request_type_upload_pgm_data)
+    if (req->requestType == firebase_fcs_request_type_upload ||
+        req->requestType == firebase_fcs_request_type_upload_pgm_data ||
+        req->requestType == firebase_fcs_request_type_upload_segments)
         method = http_post;
     else if (req->requestType == firebase_fcs_request_type_download ||
              req->requestType == firebase_fcs_request_type_download_ota ||
@@ -407,13 +507,15 @@ bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *
 
     Core.hh.addRequestHeaderLast(header);
 
-    if (req->requestType == firebase_fcs_request_type_upload || req->requestType == firebase_fcs_request_type_upload_pgm_data)
+    if (req->requestType == firebase_fcs_request_type_upload ||
+        req->requestType == firebase_fcs_request_type_upload_pgm_data ||
+        req->requestType == firebase_fcs_request_type_upload_segments)
     {
         Core.hh.addContentTypeHeader(header, req->mime.c_str());
 
         if (req->requestType == firebase_fcs_request_type_upload_pgm_data)
             len = req->pgmArcLen;
-        else if (req->requestType == firebase_fcs_request_type_upload)
+        else
             len = req->fileSize;
 
         Core.hh.addContentLengthHeader(header, len);
@@ -421,6 +523,8 @@ bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *
 
     Core.hh.addGAPIsHostHeader(header, firebase_storage_ss_pgm_str_1 /* "firebasestorage." */);
 
+    fbdo->tcpClient.cork();
+
     if (!Core.config->signer.test_mode)
     {
         Core.hh.addAuthHeaderFirst(header, Core.getTokenType());
@@ -451,7 +555,9 @@ bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *
 
     fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
 
-    if (req->requestType == firebase_fcs_request_type_upload || req->requestType == firebase_fcs_request_type_upload_pgm_data)
+    if (req->requestType == firebase_fcs_request_type_upload ||
+        req->requestType == firebase_fcs_request_type_upload_pgm_data ||
+        req->requestType == firebase_fcs_request_type_upload_segments)
     {
         FCS_UploadStatusInfo in;
         makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_fcs_upload_status_init, 0, req->fileSize, 0, "");
@@ -465,64 +571,48 @@ bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *
     {
         fbdo->session.fcs.storage_type = req->storageType;
         bool waitResponse = true;
-        if (req->requestType == firebase_fcs_request_type_upload)
+        if (req->requestType == firebase_fcs_request_type_upload ||
+            req->requestType == firebase_fcs_request_type_upload_pgm_data ||
+            req->requestType == firebase_fcs_request_type_upload_segments)
         {
-            int available = len;
-            // Fix in ESP32 core 2.0.x
-            Core.mbfs.open(req->localFileName, mbfs_type req->storageType, mb_fs_open_mode_read);
+            // The file and byte array are the single segment upload.
+            UploadSegment segment;
+            const UploadSegment *segments = &segment;
+            size_t count = 1;
 
-            int bufLen = Core.ut.getUploadBufSize(Core.config, firebase_con_mode_storage);
-            uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(bufLen + 1, false));
-            int read = 0;
-            int readCount = 0;
-
-            while (available)
+            if (req->requestType == firebase_fcs_request_type_upload)
             {
-                if (available > bufLen)
-                    available = bufLen;
-
-                read = Core.mbfs.read(mbfs_type req->storageType, buf, available);
-                if (read && (int)fbdo->tcpWrite(buf, read) != read)
-                    break;
-
-                readCount += read;
-                reportUploadProgress(fbdo, req, readCount);
-                available = Core.mbfs.available(mbfs_type req->storageType);
+                segment.localFileName = req->localFileName.c_str();
+                segment.storageType = req->storageType;
+                segment.len = req->fileSize;
+            }
+            else if (req->requestType == firebase_fcs_request_type_upload_pgm_data)
+            {
+                segment.data = req->pgmArc;
+                segment.len = req->pgmArcLen;
+                req->fileSize = req->pgmArcLen;
             }
-
-            Core.mbfs.delP(&buf);
-            Core.mbfs.close(mbfs_type req->storageType);
-            if (readCount == (int)req->fileSize)
-                reportUploadProgress(fbdo, req, req->fileSize);
             else
-                waitResponse = false;
-        }
-        else if (req->requestType == firebase_fcs_request_type_upload_pgm_data)
-        {
-            int len = req->pgmArcLen;
-            int available = len;
-            req->fileSize = len;
+            {
+                segments = req->segments;
+                count = req->segmentCount;
+            }
 
+            // The buffer is used only when the data can't be written to the SSL output buffer directly e.g. non-secure mode.
             int bufLen = Core.ut.getUploadBufSize(Core.config, firebase_con_mode_storage);
             uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(bufLen + 1, false));
-            size_t pos = 0;
+            size_t sent = 0;
 
-            while (available)
+            for (size_t i = 0; i < count; i++)
             {
-                if (available > bufLen)
-                    available = bufLen;
-                memcpy_P(buf, req->pgmArc + pos, available);
-                if ((int)fbdo->tcpWrite(buf, available) != available)
+                if (!sendSegment(fbdo, req, segments[i], buf, bufLen, sent))
                     break;
-
-                reportUploadProgress(fbdo, req, pos);
-                pos += available;
-                len -= available;
-                available = len;
             }
+
             Core.mbfs.delP(&buf);
-            if (req->pgmArcLen == pos)
-                reportUploadProgress(fbdo, req, pos);
+
+            if (sent == req->fileSize)
+                reportUploadProgress(fbdo, req, req->fileSize);
             else
                 waitResponse = false;
         }
@@ -547,7 +637,8 @@ bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *
                     sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
                 }
                 else if (req->requestType == firebase_fcs_request_type_upload ||
-                         req->requestType == firebase_fcs_request_type_upload_pgm_data)
+                         req->requestType == firebase_fcs_request_type_upload_pgm_data ||
+                         req->requestType == firebase_fcs_request_type_upload_segments)
                 {
                     FCS_UploadStatusInfo in;
                     makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_fcs_upload_status_complete,
@@ -96,6 +96,29 @@ public:
         return mUpload(fbdo, toStringPtr(bucketID), data, len, toStringPtr(remoteFileName), toStringPtr(mime), callback);
     }
 
+    /** Upload the list of byte array and file segments as one file to the Firebase Storage data bucket.
+     *
+     * @param fbdo The pointer to Firebase Data Object.
+     * @param bucketID The Firebase storage bucket ID in the project.
+     * @param segments The array of UploadSegment data.
+     * @param count The number of segments.
+     * @param remotetFileName The file path includes its name of uploaded file in data bucket.
+     * @param mime The file MIME type
+     * @param callback Optional. The callback function that accept FCS_UploadStatusInfo data.
+     * .
+     * @return Boolean value, indicates the success of the operation.
+     *
+     * @note The segments are written in order to the SSL output buffer without the intermediate buffer.
+     * The byte array segment can be the PROGMEM data and the segments should be valid until the upload was done.
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool upload(FirebaseData *fbdo, T1 bucketID, const UploadSegment *segments, size_t count, T2 remoteFileName,
+                T3 mime, FCS_UploadProgressCallback callback = NULL)
+    {
+        return mUpload(fbdo, toStringPtr(bucketID), segments, count, toStringPtr(remoteFileName), toStringPtr(mime), callback);
+    }
+
     /** Download file from the Firebase Storage data bucket.
      *
      * @param fbdo The pointer to Firebase Data Object.
@@ -201,6 +224,11 @@ private:
                  FCS_UploadProgressCallback callback = NULL);
     bool mUpload(FirebaseData *fbdo, MB_StringPtr bucketID, const uint8_t *data, size_t len,
                  MB_StringPtr remoteFileName, MB_StringPtr mime, FCS_UploadProgressCallback callback = NULL);
+    bool mUpload(FirebaseData *fbdo, MB_StringPtr bucketID, const UploadSegment *segments, size_t count,
+                 MB_StringPtr remoteFileName, MB_StringPtr mime, FCS_UploadProgressCallback callback = NULL);
+    size_t getSegmentLength(const UploadSegment &segment);
+    bool sendSegment(FirebaseData *fbdo, struct firebase_fcs_req_t *req, const UploadSegment &segment,
+                     uint8_t *buf, size_t bufLen, size_t &sent);
     bool mDownload(FirebaseData *fbdo, MB_StringPtr bucketID, MB_StringPtr remoteFileName,
                    MB_StringPtr localFileName, firebase_mem_storage_type storageType, FCS_DownloadProgressCallback callback = NULL);
     bool mDownloadOTA(FirebaseData *fbdo, MB_StringPtr bucketID, MB_StringPtr remoteFileName,
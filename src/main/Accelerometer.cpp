@@ -1,8 +1,8 @@
+#include "Channel.h"
 #include "Constants.h"
+#include "SensorList.h"
 #include "Accelerometer.h"
 #include <Wire.h>
-#include "Logger.h"
-#include <Firebase_ESP_Client.h>
 
 Accelerometer::Accelerometer(uint8_t address) {
   m_address = address;
@@ -34,18 +34,6 @@ void Accelerometer::update() {
   m_GyZ = Wire.read() << 8 | Wire.read();
 }
 
-void Accelerometer::display() {
-  Logger::display("AcX:", m_AcX);
-  Logger::display("AcY:", m_AcY);
-  Logger::display("AcZ:", m_AcZ);
-  // Logger::display("Temp:", m_temp / 340.00 + 36.53);
-  // Logger::display("GyX:", m_GyX);
-  // Logger::display("GyY:", m_GyY);
-  // Logger::display("GyZ:", m_GyZ);
-}
-
-void Accelerometer::logging(FirebaseJson* json) {
-  Logger::record(json, Constants::Accelerometer::ACX_ID, m_AcX);
-  Logger::record(json, Constants::Accelerometer::ACY_ID, m_AcY);
-  Logger::record(json, Constants::Accelerometer::ACZ_ID, m_AcZ);
+std::array<int32_t, std::size(Accelerometer::CHANNELS)> Accelerometer::values() const {
+  return { m_AcX, m_AcY, m_AcZ };
 }
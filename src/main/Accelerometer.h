@@ -1,15 +1,16 @@
+#include <array>
 #include <cstdint>
-#include <Firebase_ESP_Client.h>
 
 class Accelerometer {
 public:
-  Accelerometer(uint8_t address);
+  static constexpr auto &CHANNELS{ Constants::Accelerometer::CHANNELS };
 
-  void update();
+  Accelerometer(uint8_t address = Constants::Accelerometer::ADDRESS);
 
-  void display();
+  void update();
 
-  void logging(FirebaseJson* json);
+  // raw values in the CHANNELS order
+  std::array<int32_t, std::size(CHANNELS)> values() const;
 
 private:
   uint8_t m_address;
@@ -21,3 +22,8 @@ private:
   int16_t m_GyY;
   int16_t m_GyZ;
 };
+
+template<>
+struct SensorDriver<Constants::Accelerometer> {
+  using type = Accelerometer;
+};
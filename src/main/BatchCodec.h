@@ -0,0 +1,267 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Compact per-channel sample batch, uploaded as a Firestore bytesValue (base64).
+//
+// blob    := kind:u8 count:varint body
+// INTEGER := zigzag varint of the first value, then zigzag varints of the deltas to the previous value
+// FLOAT   := float32 bits of the first value (little endian), then a bit stream (MSB first) per value
+//            of the XOR with the previous bits (Gorilla):
+//              '0'                                     same value
+//              '10' bits[32 - lead - trail]            same leading/trailing zero window as before
+//              '11' lead[5] len - 1[5] bits[len]       new window
+//
+// The channels of SensorList.h are all INTEGER (fixed point raw values). FLOAT is kept for the batches
+// uploaded before them, which the decoder still reads.
+//
+// The decoder in ml/batch_decode.cpp includes this file, host/tests/test_batch_codec.cpp tests both kinds.
+class BatchCodec {
+public:
+  enum Kind : uint8_t {
+    INTEGER = 1,
+    FLOAT = 2
+  };
+
+  explicit BatchCodec(Kind kind)
+    : m_kind{ kind } {}
+
+  void add(int64_t value) {
+    if (m_kind == FLOAT) {
+      add((float)value);
+      return;
+    }
+    // the delta wraps in 64 bits as the decoder's sum does, INT64_MIN after INT64_MAX is a valid delta
+    writeVarint(m_body, zigzag(m_count == 0 ? value : (int64_t)((uint64_t)value - (uint64_t)m_prev)));
+    m_prev = value;
+    m_count++;
+  }
+  void add(float value) {
+    if (m_kind == INTEGER) {
+      add((int64_t)value);
+      return;
+    }
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (m_count == 0) {
+      for (uint8_t i = 0; i < 4; i++) {
+        m_body.push_back((uint8_t)(bits >> (8 * i)));
+      }
+    } else {
+      uint32_t delta{ bits ^ m_prevBits };
+      if (delta == 0) {
+        writeBits(0, 1);
+      } else {
+        uint8_t lead = __builtin_clz(delta);
+        uint8_t trail = __builtin_ctz(delta);
+        if (m_lead <= 31 && lead >= m_lead && trail >= m_trail) {
+          writeBits(0b10, 2);
+          writeBits(delta >> m_trail, 32 - m_lead - m_trail);
+        } else {
+          uint8_t len = 32 - lead - trail;
+          writeBits(0b11, 2);
+          writeBits(lead, 5);
+          writeBits(len - 1, 5);
+          writeBits(delta >> trail, len);
+          m_lead = lead;
+          m_trail = trail;
+        }
+      }
+    }
+    m_prevBits = bits;
+    m_count++;
+  }
+  uint32_t count() const {
+    return m_count;
+  }
+  void clear() {
+    m_body.clear();
+    m_count = 0;
+    m_prev = 0;
+    m_prevBits = 0;
+    m_lead = 0xFF;
+    m_trail = 0;
+    m_bitPos = 0;
+  }
+  std::string base64() const {
+    std::vector<uint8_t> blob;
+    blob.reserve(m_body.size() + 6);
+    blob.push_back(m_kind);
+    writeVarint(blob, m_count);
+    blob.insert(blob.end(), m_body.begin(), m_body.end());
+    return encodeBase64(blob);
+  }
+
+  // Decode the base64 blob into values, false if the blob is malformed
+  static bool decode(const std::string& text, std::vector<double>& values) {
+    std::vector<uint8_t> blob;
+    values.clear();
+    if (!decodeBase64(text, blob) || blob.empty()) {
+      return false;
+    }
+    size_t pos{ 1 };
+    uint64_t count;
+    if (!readVarint(blob, pos, count)) {
+      return false;
+    }
+    // every sample takes at least one bit of the body, a larger count is a corrupt header
+    if (count > (blob.size() - pos) * 8) {
+      return false;
+    }
+    values.reserve(count);
+    if (blob[0] == INTEGER) {
+      int64_t value{ 0 };
+      for (uint64_t i = 0; i < count; i++) {
+        uint64_t v;
+        if (!readVarint(blob, pos, v)) {
+          return false;
+        }
+        value = i == 0 ? unzigzag(v) : (int64_t)((uint64_t)value + (uint64_t)unzigzag(v));
+        values.push_back((double)value);
+      }
+      return true;
+    }
+    if (blob[0] != FLOAT) {
+      return false;
+    }
+    if (count == 0) {
+      return true;
+    }
+    if (blob.size() < pos + 4) {
+      return false;
+    }
+    uint32_t bits{ 0 };
+    for (uint8_t i = 0; i < 4; i++) {
+      bits |= (uint32_t)blob[pos++] << (8 * i);
+    }
+    size_t bit{ pos * 8 };
+    uint8_t lead{ 0 }, trail{ 0 };
+    for (uint64_t i = 0; i < count; i++) {
+      if (i > 0) {
+        uint32_t v;
+        if (!readBits(blob, bit, 1, v)) {
+          return false;
+        }
+        if (v == 1) {
+          if (!readBits(blob, bit, 1, v)) {
+            return false;
+          }
+          if (v == 1) {
+            uint32_t l, n;
+            if (!readBits(blob, bit, 5, l) || !readBits(blob, bit, 5, n)) {
+              return false;
+            }
+            if (l + n + 1 > 32) {
+              return false;
+            }
+            lead = l;
+            trail = 32 - lead - (n + 1);
+          }
+          if (!readBits(blob, bit, 32 - lead - trail, v)) {
+            return false;
+          }
+          bits ^= v << trail;
+        }
+      }
+      float value;
+      memcpy(&value, &bits, sizeof(value));
+      values.push_back(value);
+    }
+    return true;
+  }
+
+private:
+  Kind m_kind;
+  std::vector<uint8_t> m_body;
+  uint32_t m_count{ 0 };
+  int64_t m_prev{ 0 };
+  uint32_t m_prevBits{ 0 };
+  uint8_t m_lead{ 0xFF };
+  uint8_t m_trail{ 0 };
+  uint8_t m_bitPos{ 0 };
+
+  static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+  }
+  static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+  }
+  static void writeVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+      out.push_back((uint8_t)(v | 0x80));
+      v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+  }
+  static bool readVarint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& v) {
+    v = 0;
+    for (uint8_t shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+      uint8_t b{ in[pos++] };
+      v |= (uint64_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  void writeBits(uint32_t v, uint8_t n) {
+    while (n > 0) {
+      if (m_bitPos == 0) {
+        m_body.push_back(0);
+      }
+      uint8_t room = 8 - m_bitPos;
+      uint8_t take = n < room ? n : room;
+      uint8_t chunk = (v >> (n - take)) & ((1u << take) - 1);
+      m_body.back() |= chunk << (room - take);
+      m_bitPos = (m_bitPos + take) & 7;
+      n -= take;
+    }
+  }
+  static bool readBits(const std::vector<uint8_t>& in, size_t& bit, uint8_t n, uint32_t& v) {
+    v = 0;
+    if (bit + n > in.size() * 8) {
+      return false;
+    }
+    for (uint8_t i = 0; i < n; i++, bit++) {
+      v = (v << 1) | ((in[bit >> 3] >> (7 - (bit & 7))) & 1);
+    }
+    return true;
+  }
+  static std::string encodeBase64(const std::vector<uint8_t>& in) {
+    static const char table[]{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+    std::string out;
+    out.reserve((in.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < in.size(); i += 3) {
+      uint32_t n = (uint32_t)in[i] << 16;
+      if (i + 1 < in.size()) n |= (uint32_t)in[i + 1] << 8;
+      if (i + 2 < in.size()) n |= in[i + 2];
+      out += table[(n >> 18) & 63];
+      out += table[(n >> 12) & 63];
+      out += i + 1 < in.size() ? table[(n >> 6) & 63] : '=';
+      out += i + 2 < in.size() ? table[n & 63] : '=';
+    }
+    return out;
+  }
+  static bool decodeBase64(const std::string& in, std::vector<uint8_t>& out) {
+    uint32_t n{ 0 };
+    uint8_t bits{ 0 };
+    for (char c : in) {
+      int v;
+      if (c >= 'A' && c <= 'Z') v = c - 'A';
+      else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+      else if (c >= '0' && c <= '9') v = c - '0' + 52;
+      else if (c == '+' || c == '-') v = 62;
+      else if (c == '/' || c == '_') v = 63;
+      else if (c == '=' || c == '\n' || c == '\r') continue;
+      else return false;
+      n = (n << 6) | v;
+      bits += 6;
+      if (bits >= 8) {
+        bits -= 8;
+        out.push_back((uint8_t)(n >> bits));
+      }
+    }
+    return true;
+  }
+};
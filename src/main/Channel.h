@@ -0,0 +1,30 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Compile-time description of a sensor channel, the sensors declare their channels in Constants.h
+// and Sensors.h generates the update, display and logging loops from them.
+//
+// The channel value is the int32 raw value, Q is the number of fractional bits (see Fixed.h),
+// value = raw / 2^Q. The decoder in ml/batch_decode.cpp lists the channels for the feature extraction.
+struct Channel {
+  const char *name;   // display label and Firestore field name
+  const char *field;  // Firestore field path of the batch
+  const char *key;    // feature extraction record key
+  uint8_t q;
+};
+
+// The channel tables of the sensors joined in order
+template<typename... Sensor>
+constexpr auto channelTable() {
+  std::array<Channel, (std::size(Sensor::CHANNELS) + ...)> table{};
+  size_t index{ 0 };
+  (
+    [&] {
+      for (const Channel &channel : Sensor::CHANNELS) {
+        table[index++] = channel;
+      }
+    }(),
+    ...);
+  return table;
+}
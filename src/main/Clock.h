@@ -0,0 +1,75 @@
+#include <cstdint>
+#include <cstdlib>
+#include <sys/time.h>
+#include "esp_timer.h"
+#include "esp32-hal.h"
+
+// Monotonic sample clock. Samples are stamped with esp_timer microseconds and converted to UTC
+// when a batch is uploaded, the conversion is disciplined against the system clock which is set
+// by SNTP or by the Date header of the Firebase responses.
+class Clock {
+private:
+  inline static bool m_synced{ false };
+  inline static int64_t m_offset{ 0 };      // UTC - monotonic at the last sync (us)
+  inline static int64_t m_anchor{ 0 };      // monotonic time of the last sync (us)
+  inline static int64_t m_drift{ 0 };       // rate correction of esp_timer (ppb)
+  inline static int64_t m_lastSystem{ 0 };  // system - monotonic offset seen by the last update (us)
+  inline static uint32_t m_lastUpdate{ 0 };
+
+  static void discipline(int64_t utc, int64_t mono) {
+    if (m_synced) {
+      int64_t error = utc - toUtcUs(mono);
+      int64_t elapsed = mono - m_anchor;
+      // correct half of the rate error to filter the time source jitter, steps are not rate errors
+      if (llabs(error) < Constants::Clock::MAX_SLEW_US && elapsed >= Constants::Clock::MIN_DRIFT_INTERVAL_US) {
+        m_drift += error * 1000000000LL / elapsed / 2;
+        if (m_drift > Constants::Clock::MAX_DRIFT_PPB) m_drift = Constants::Clock::MAX_DRIFT_PPB;
+        if (m_drift < -Constants::Clock::MAX_DRIFT_PPB) m_drift = -Constants::Clock::MAX_DRIFT_PPB;
+      }
+    }
+    m_offset = utc - mono;
+    m_anchor = mono;
+    m_synced = true;
+  }
+public:
+  // Start SNTP without waiting, the clock is synced by update() once the time arrives
+  static void begin() {
+    configTime(0, 0, "pool.ntp.org", "time.nist.gov");
+  }
+  static void update() {
+    uint32_t time{ millis() };
+    if (m_synced && time - m_lastUpdate < Constants::Clock::UPDATE_PERIOD) {
+      return;
+    }
+    m_lastUpdate = time;
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    int64_t mono{ esp_timer_get_time() };
+    if (tv.tv_sec < Constants::Clock::VALID_TIME) {
+      return;
+    }
+
+    // the system clock only moves against esp_timer when it was set or adjusted
+    int64_t system{ (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - mono };
+    if (m_synced && llabs(system - m_lastSystem) < Constants::Clock::MIN_STEP_US) {
+      return;
+    }
+    m_lastSystem = system;
+    discipline(mono + system, mono);
+  }
+  // Monotonic microseconds since boot, cheap enough for every sample
+  static int64_t nowUs() {
+    return esp_timer_get_time();
+  }
+  // UTC microseconds of the monotonic time, boot relative until synced
+  static int64_t toUtcUs(int64_t mono) {
+    if (!m_synced) {
+      return mono;
+    }
+    return mono + m_offset + (mono - m_anchor) * m_drift / 1000000000LL;
+  }
+  static bool synced() {
+    return m_synced;
+  }
+};
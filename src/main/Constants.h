@@ -1,17 +1,48 @@
-#include <sys/_stdint.h>
 #include <cstdint>
 
+// The periods and the profiling can be set by the build flags to sweep them without editing, e.g.
+// arduino-cli compile --build-property "build.extra_flags=-DRECORDING_PERIOD_MS=50 -DLOGGING_PERIOD_MS=5000 -DPROFILING_ENABLED=true"
+// host/fil builds the sketch on the host with the same flags, see host/README.md
+#ifndef RECORDING_PERIOD_MS
+#define RECORDING_PERIOD_MS 100
+#endif
+#ifndef LOGGING_PERIOD_MS
+#define LOGGING_PERIOD_MS 2000
+#endif
+#ifndef PROFILING_ENABLED
+#define PROFILING_ENABLED false
+#endif
+#ifndef REPORT_PERIOD_MS
+#define REPORT_PERIOD_MS 10000
+#endif
+
 class Constants {
 public:
   static const uint32_t BAUD_RATE{ 115200 };
   static const bool SERIALDISPLAY{ false };
   static const bool LOGGING{ true };
-  static const uint16_t RECORDING_PERIOD{ 100 };
-  static const uint16_t LOGGING_PERIOD{ 2000 };
+  static const uint16_t RECORDING_PERIOD{ RECORDING_PERIOD_MS };
+  static const uint16_t LOGGING_PERIOD{ LOGGING_PERIOD_MS };
+  // Print the sampling rate, loop time and upload latency report (see Profiler.h)
+  static const bool PROFILING{ PROFILING_ENABLED };
+  static const uint32_t REPORT_PERIOD{ REPORT_PERIOD_MS };
 
   static const uint16_t SDA{ 21 };
   static const uint16_t SCL{ 22 };
 
+  class Clock {
+  public:
+    static const uint16_t UPDATE_PERIOD{ 1000 };
+    static const int64_t VALID_TIME{ 1618971013 };
+    static const int64_t MIN_STEP_US{ 1000 };
+    static const int64_t MAX_SLEW_US{ 1000000 };
+    static const int64_t MIN_DRIFT_INTERVAL_US{ 60000000 };
+    static const int64_t MAX_DRIFT_PPB{ 500000 };
+    static constexpr const char *T0_ID{ "fields/T0/integerValue" };
+    static constexpr const char *SYNCED_ID{ "fields/Synced/booleanValue" };
+    static constexpr const char *DT_ID{ "fields/DT/bytesValue" };
+  };
+
   class Accelerometer {
   public:
     static const uint8_t ADDRESS{ 0x68 };
@@ -24,9 +55,11 @@ public:
     static const uint8_t ACCEL_ZOUT_H{ 0x3F };
     static const uint8_t ACCEL_ZOUT_L{ 0x40 };
 
-    static constexpr const char *ACX_ID{ "fields/AcX/arrayValue/values" };
-    static constexpr const char *ACY_ID{ "fields/AcY/arrayValue/values" };
-    static constexpr const char *ACZ_ID{ "fields/AcZ/arrayValue/values" };
+    static constexpr Channel CHANNELS[]{
+      { "AcX", "fields/AcX/bytesValue", "ax", 0 },
+      { "AcY", "fields/AcY/bytesValue", "ay", 0 },
+      { "AcZ", "fields/AcZ/bytesValue", "az", 0 },
+    };
   };
 
   class TemperatureSensor {
@@ -34,15 +67,23 @@ public:
     static const uint8_t ADDRESS{ 0x48 };
     static const uint8_t TEMP_OUT{ 0x00 };
     static const uint16_t THRESHOLD{ 30 };
-    static constexpr const char *TEMP_ID{ "fields/Temp/arrayValue/values" };
+    static const uint8_t Q{ 8 };  // MAX30205 resolution is 1/256 °C
+    static constexpr Channel CHANNELS[]{
+      { "Temp", "fields/Temp/bytesValue", "temp", Q },
+    };
   };
 
   class PulseOximeter {
   public:
     static const uint16_t RATE_SIZE{ 4 };  //Increase this for more averaging. 4 is good.
-    static constexpr float WEIGHT{ 0.9 };
-    static constexpr const char *IR_ID{ "fields/IR/arrayValue/values" };
-    static constexpr const char *BPM_ID{ "fields/BPM/arrayValue/values" };
-    static constexpr const char *AVG_BPM_ID{ "fields/ABPM/arrayValue/values" };
+    static const uint8_t Q{ 8 };
+    // EMA weight of the new sample, 1 / 10
+    static const uint32_t EMA_NUM{ 1 };
+    static const uint32_t EMA_DEN{ 10 };
+    static constexpr Channel CHANNELS[]{
+      { "IR", "fields/IR/bytesValue", "ir", 0 },
+      { "BPM", "fields/BPM/bytesValue", "bpm", Q },
+      { "ABPM", "fields/ABPM/bytesValue", "abpm", 0 },
+    };
   };
 };
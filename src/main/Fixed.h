@@ -0,0 +1,127 @@
+#include <cstdint>
+
+// Q-format fixed point value with FRAC fractional bits in a 32-bit integer, the sensor math
+// stays in integer registers so the tasks and ISRs don't need the FPU context.
+// The results out of the range saturate to MIN/MAX instead of wrapping.
+template<uint8_t FRAC>
+class Fixed {
+public:
+  static_assert(FRAC < 31, "FRAC must leave the integer bits");
+  static constexpr int32_t ONE{ (int32_t)1 << FRAC };
+  static constexpr int32_t MAX_RAW{ INT32_MAX };
+  static constexpr int32_t MIN_RAW{ INT32_MIN };
+
+  static constexpr int32_t saturate(int64_t raw) {
+    return raw > MAX_RAW ? MAX_RAW : raw < MIN_RAW ? MIN_RAW : (int32_t)raw;
+  }
+
+  constexpr Fixed()
+    : m_raw{ 0 } {}
+
+  static constexpr Fixed fromRaw(int32_t raw) {
+    Fixed f;
+    f.m_raw = raw;
+    return f;
+  }
+  static constexpr Fixed fromInt(int32_t value) {
+    return fromRaw(saturate((int64_t)value * ONE));
+  }
+  // num / den without the floating point division, zero if den is zero
+  static constexpr Fixed ratio(int32_t num, int32_t den) {
+    return fromRaw(den == 0 ? 0 : saturate(((int64_t)num * ONE) / den));
+  }
+  constexpr int32_t raw() const {
+    return m_raw;
+  }
+  // rounded to the nearest integer
+  constexpr int32_t toInt() const {
+    return (int32_t)(((int64_t)m_raw + (ONE >> 1)) >> FRAC);
+  }
+  // for the serial display only
+  float toFloat() const {
+    return (float)m_raw / ONE;
+  }
+
+  constexpr Fixed operator+(Fixed rhs) const {
+    return fromRaw(saturate((int64_t)m_raw + rhs.m_raw));
+  }
+  constexpr Fixed operator-(Fixed rhs) const {
+    return fromRaw(saturate((int64_t)m_raw - rhs.m_raw));
+  }
+  constexpr Fixed operator*(Fixed rhs) const {
+    return fromRaw(saturate(((int64_t)m_raw * rhs.m_raw) >> FRAC));
+  }
+  constexpr bool operator<(Fixed rhs) const {
+    return m_raw < rhs.m_raw;
+  }
+  constexpr bool operator>(Fixed rhs) const {
+    return m_raw > rhs.m_raw;
+  }
+  constexpr bool operator==(Fixed rhs) const {
+    return m_raw == rhs.m_raw;
+  }
+
+private:
+  int32_t m_raw;
+};
+
+// Unit conversion of the raw sensor count, value = raw * NUM / DEN, the factor is folded at compile time
+template<uint8_t FRAC, int32_t NUM, int32_t DEN>
+constexpr Fixed<FRAC> convert(int32_t raw) {
+  static_assert(DEN != 0, "DEN must not be zero");
+  // raw * NUM * ONE may not fit in 64 bits, the whole and the remainder of raw * NUM / DEN are scaled apart
+  int64_t value{ (int64_t)raw * NUM };
+  int64_t whole{ value / DEN };
+  if (whole > (Fixed<FRAC>::MAX_RAW >> FRAC))
+    return Fixed<FRAC>::fromRaw(Fixed<FRAC>::MAX_RAW);
+  if (whole < (Fixed<FRAC>::MIN_RAW >> FRAC))
+    return Fixed<FRAC>::fromRaw(Fixed<FRAC>::MIN_RAW);
+  return Fixed<FRAC>::fromRaw(Fixed<FRAC>::saturate(whole * Fixed<FRAC>::ONE + value % DEN * Fixed<FRAC>::ONE / DEN));
+}
+
+// Exponential moving average y += alpha * (x - y) with alpha = NUM / DEN
+template<uint8_t FRAC, uint32_t NUM, uint32_t DEN>
+class Ema {
+public:
+  static_assert(NUM > 0 && NUM <= DEN, "alpha must be in (0, 1]");
+  // alpha in Q16, more precise than the value format
+  static constexpr int32_t ALPHA{ (int32_t)(((uint64_t)NUM << 16) / DEN) };
+
+  Fixed<FRAC> add(Fixed<FRAC> x) {
+    // rounded, the truncated step would bias the average down
+    int64_t step{ (((int64_t)x.raw() - m_value.raw()) * ALPHA + (1 << 15)) >> 16 };
+    m_value = Fixed<FRAC>::fromRaw(Fixed<FRAC>::saturate(m_value.raw() + step));
+    return m_value;
+  }
+  Fixed<FRAC> value() const {
+    return m_value;
+  }
+  void reset(Fixed<FRAC> value = Fixed<FRAC>()) {
+    m_value = value;
+  }
+
+private:
+  Fixed<FRAC> m_value;
+};
+
+// Moving average over the last N values, the running sum is updated instead of re-summing
+template<typename T, uint8_t N>
+class MovingAverage {
+public:
+  static_assert(N > 0, "N must not be zero");
+
+  void add(T value) {
+    m_sum += (int32_t)value - (int32_t)m_values[m_pos];
+    m_values[m_pos] = value;
+    m_pos = (m_pos + 1) % N;
+  }
+  // the empty slots count as zero
+  T average() const {
+    return (T)(m_sum / N);
+  }
+
+private:
+  T m_values[N]{};
+  int32_t m_sum{ 0 };
+  uint8_t m_pos{ 0 };
+};
@@ -1,5 +1,6 @@
 #include "HardwareSerial.h"
 #include <string>
+#include <vector>
 #include "esp32-hal.h"
 #include <sys/stat.h>
 #include <sys/_stdint.h>
@@ -25,9 +26,18 @@ static FirebaseJson content;
 class Logger {
 private:
   inline static uint32_t m_lastTime{ 0 };
-  inline static uint32_t m_index{ 0 };
+  inline static bool m_rowReady{ false };
+  inline static int64_t m_firstUs{ -1 };
+  inline static int64_t m_prevUs{ 0 };
+  inline static const Channel* m_channels{ nullptr };
+  inline static std::vector<BatchCodec> m_batches;
+  inline static BatchCodec m_dt{ BatchCodec::INTEGER };
 public:
-  static void begin() {
+  // The channels are the registry table (see Sensors.h), record() takes the index in it
+  static void begin(const Channel channels[], size_t count) {
+    Logger::m_channels = channels;
+    Logger::m_batches.assign(count, BatchCodec(BatchCodec::INTEGER));
+
     WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
     Serial.print("Connecting to Wi-Fi...");
     while (WiFi.status() != WL_CONNECTED) {
@@ -44,6 +54,9 @@ public:
 
     Firebase.begin(&firebaseConfig, &firebaseAuth);
     Firebase.reconnectWiFi(true);
+#if defined(ESP32)
+    Firebase.refreshTokenInBackground(true);
+#endif
     Logger::m_lastTime = millis();
 
     Serial.println("Firebase Client Initialized.");
@@ -51,21 +64,51 @@ public:
   static FirebaseJson* getJson() {
     return &content;
   }
-  static void record(FirebaseJson* content, const char id[], auto data) {
-    if (Firebase.ready()) {
-      content->set((std::string(id) + "/[" + std::to_string(Logger::m_index) + "]/stringValue").c_str(), std::to_string(data).c_str());
-    } else {
+  // Add the raw value to the channel batch of the current sample row, see BatchCodec.h for the format
+  static void record(size_t index, int32_t data) {
+    if (Logger::m_rowReady) {
+      Logger::m_batches[index].add((int64_t)data);
+    }
+  }
+  // Start the sample row, its timestamp is stored as the microseconds since the previous row
+  static void stamp(FirebaseJson* content) {
+    Logger::m_rowReady = Firebase.ready();
+    if (!Logger::m_rowReady) {
+      Profiler::lost(1);
       Serial.println("Firebase is not ready.");
+      return;
+    }
+    Profiler::sample();
+    int64_t now{ Clock::nowUs() };
+    if (Logger::m_firstUs < 0) {
+      Logger::m_firstUs = now;
+      Logger::m_prevUs = now;
     }
+    Logger::m_dt.add(now - Logger::m_prevUs);
+    Logger::m_prevUs = now;
   }
   static void send(FirebaseJson* content) {
     uint32_t time{ millis() };
-    Logger::m_index++;
     if (time - Logger::m_lastTime >= Constants::LOGGING_PERIOD) {
-      if (Firebase.Firestore.createDocument(&fbdo, PROJECT_ID, "", PATH, std::to_string(~time).c_str(), content->raw(), "")) {
+      if (Logger::m_firstUs >= 0) {
+        // the batch start time is converted with the latest clock discipline
+        content->set(Constants::Clock::T0_ID, std::to_string(Clock::toUtcUs(Logger::m_firstUs)).c_str());
+        content->set(Constants::Clock::SYNCED_ID, Clock::synced());
+      }
+      content->set(Constants::Clock::DT_ID, Logger::m_dt.base64().c_str());
+      for (size_t i = 0; i < Logger::m_batches.size(); i++) {
+        content->set(Logger::m_channels[i].field, Logger::m_batches[i].base64().c_str());
+      }
+      bool sent{ Firebase.Firestore.createDocument(&fbdo, PROJECT_ID, "", PATH, std::to_string(~time).c_str(), content->raw(), "") };
+      Profiler::upload(millis() - time, sent);
+      if (sent) {
         Logger::m_lastTime = time;
         content->clear();
-        Logger::m_index = 0;
+        Logger::m_dt.clear();
+        for (BatchCodec& batch : Logger::m_batches) {
+          batch.clear();
+        }
+        Logger::m_firstUs = -1;
         Serial.println("Data Sent Successfully");
       } else {
         Serial.println(fbdo.errorReason());
@@ -79,4 +122,14 @@ public:
     Serial.print(str);
     Serial.println(data);
   }
+  // The fixed point channels are shown as float
+  static void display(const Channel& channel, int32_t data) {
+    Serial.print(channel.name);
+    Serial.print(":");
+    if (channel.q > 0) {
+      Serial.println((float)data / (1 << channel.q));
+    } else {
+      Serial.println(data);
+    }
+  }
 };
@@ -0,0 +1,146 @@
+#include <cstdint>
+#include <Esp.h>
+#include "esp32-hal.h"
+
+// Power of two histogram, bucket i counts the values in [2^(i-1), 2^i), bucket 0 counts zeros
+class Histogram {
+private:
+  static const size_t BUCKETS{ 24 };
+  uint32_t m_counts[BUCKETS]{};
+  uint32_t m_total{ 0 };
+  uint32_t m_max{ 0 };
+public:
+  void add(uint32_t value) {
+    size_t i{ value ? (size_t)(32 - __builtin_clz(value)) : 0 };
+    if (i >= BUCKETS) {
+      i = BUCKETS - 1;
+    }
+    m_counts[i]++;
+    m_total++;
+    if (value > m_max) {
+      m_max = value;
+    }
+  }
+  // The upper bound of the bucket that holds the percentile, at most the max seen
+  uint32_t percentile(uint8_t p) const {
+    if (m_total == 0) {
+      return 0;
+    }
+    uint32_t rank{ (uint32_t)(((uint64_t)m_total * p + 99) / 100) };
+    uint32_t seen{ 0 };
+    for (size_t i = 0; i < BUCKETS; i++) {
+      seen += m_counts[i];
+      if (seen >= rank) {
+        uint32_t bound{ i ? (uint32_t)((1ULL << i) - 1) : 0 };
+        return bound < m_max ? bound : m_max;
+      }
+    }
+    return m_max;
+  }
+  uint32_t count() const {
+    return m_total;
+  }
+  uint32_t max() const {
+    return m_max;
+  }
+  // name:count p50 p90 p99 max, then the non empty buckets as <upper bound>=count
+  void print(const char name[]) const {
+    Serial.printf("%s:n=%u p50=%u p90=%u p99=%u max=%u", name, m_total, percentile(50), percentile(90), percentile(99), m_max);
+    for (size_t i = 0; i < BUCKETS; i++) {
+      if (m_counts[i]) {
+        Serial.printf(" <%u=%u", i ? (uint32_t)(1ULL << i) : 1, m_counts[i]);
+      }
+    }
+    Serial.println();
+  }
+  void clear() {
+    *this = Histogram();
+  }
+};
+
+// Field measurement of what the wearable sustains while uploading: the achieved sampling rate,
+// the loop time, the upload latency, the heap low-water mark and the sample rows lost.
+// A report is printed every REPORT_PERIOD with the periods it ran at, so the runs built with
+// different RECORDING_PERIOD_MS/LOGGING_PERIOD_MS (see Constants.h) can be compared from the logs.
+// All calls are no-op when PROFILING is off.
+class Profiler {
+public:
+  // The counts since boot, not cleared by the reports (read by the host harness, host/fil)
+  struct Totals {
+    uint32_t samples;
+    uint32_t lost;
+    uint32_t uploads;
+    uint32_t failed;
+  };
+private:
+  inline static Totals m_totals{};
+  inline static Histogram m_loop;    // loop time (us)
+  inline static Histogram m_upload;  // createDocument time (ms)
+  inline static int64_t m_lastLoopUs{ -1 };
+  inline static uint32_t m_lastReport{ 0 };
+  inline static uint32_t m_samples{ 0 };
+  inline static uint32_t m_lost{ 0 };
+  inline static uint32_t m_failed{ 0 };
+public:
+  // Call at the top of loop(), the time since the previous call is the loop time
+  static void loop() {
+    if (!Constants::PROFILING) {
+      return;
+    }
+    int64_t now{ Clock::nowUs() };
+    if (m_lastLoopUs >= 0) {
+      m_loop.add((uint32_t)(now - m_lastLoopUs));
+    }
+    m_lastLoopUs = now;
+
+    uint32_t time{ millis() };
+    if (time - m_lastReport >= Constants::REPORT_PERIOD) {
+      report(time - m_lastReport);
+      m_lastReport = time;
+      // the report itself is not a loop time
+      m_lastLoopUs = Clock::nowUs();
+    }
+  }
+  // A sample row was stamped
+  static void sample() {
+    if (Constants::PROFILING) {
+      m_samples++;
+      m_totals.samples++;
+    }
+  }
+  // Sample rows that were due but not recorded
+  static void lost(uint32_t rows) {
+    if (Constants::PROFILING) {
+      m_lost += rows;
+      m_totals.lost += rows;
+    }
+  }
+  static void upload(uint32_t ms, bool ok) {
+    if (!Constants::PROFILING) {
+      return;
+    }
+    m_upload.add(ms);
+    m_totals.uploads++;
+    if (!ok) {
+      m_failed++;
+      m_totals.failed++;
+    }
+  }
+  static const Totals &totals() {
+    return m_totals;
+  }
+private:
+  static void report(uint32_t elapsed) {
+    Serial.printf("PROFILE rec=%u log=%u elapsed=%u samples=%u rate=%.2f lost=%u uploads=%u failed=%u heap=%u heap_min=%u\n",
+                  Constants::RECORDING_PERIOD, Constants::LOGGING_PERIOD, elapsed, m_samples,
+                  elapsed ? m_samples * 1000.0f / elapsed : 0.0f, m_lost, m_upload.count(), m_failed,
+                  ESP.getFreeHeap(), ESP.getMinFreeHeap());
+    m_loop.print("PROFILE loop_us");
+    m_upload.print("PROFILE upload_ms");
+    m_loop.clear();
+    m_upload.clear();
+    m_samples = 0;
+    m_lost = 0;
+    m_failed = 0;
+  }
+};
@@ -1,15 +1,14 @@
+#include "Channel.h"
 #include "Constants.h"
+#include "SensorList.h"
+#include "Fixed.h"
 #include "PulseOximeter.h"
 #include "heartRate.h"
 #include "spo2_algorithm.h"
 #include <Wire.h>
-#include "Logger.h"
-#include <Firebase_ESP_Client.h>
 
 PulseOximeter::PulseOximeter() {
-  m_rateSpot = 0;
   m_lastBeat = 0;  //Time at which the last beat occurred
-  m_beatsPerMinute = 0.0;
   m_beatAvg = 0;
   m_irValue = 0;
 
@@ -27,39 +26,24 @@ PulseOximeter::PulseOximeter() {
 
 void PulseOximeter::update() {
   uint32_t irValue = m_particleSensor.getIR();
-  m_irValue = m_irValue * Constants::PulseOximeter::WEIGHT + irValue * (1 - Constants::PulseOximeter::WEIGHT);
+  // the filter keeps the fraction, only the beat detector gets the integer
+  m_irValue = m_irFilter.add(Value::fromInt(irValue)).toInt();
 
   if (checkForBeat(m_irValue) == true) {
     //We sensed a beat!
-    long delta = millis() - m_lastBeat;
-    m_lastBeat = millis();
+    uint32_t time{ millis() };
+    uint32_t delta{ time - m_lastBeat };
+    m_lastBeat = time;
 
-    float beatsPerMinute = 60 / (delta / 1000.0);
-    m_beatsPerMinute = m_beatsPerMinute * Constants::PulseOximeter::WEIGHT + beatsPerMinute * (1 - Constants::PulseOximeter::WEIGHT);
+    m_beatsPerMinute = m_bpmFilter.add(Value::ratio(60000, delta));
 
-    if (m_beatsPerMinute < 255 && m_beatsPerMinute > 20) {
-      m_rates[m_rateSpot++] = (uint8_t)m_beatsPerMinute;  //Store this reading in the array
-      m_rateSpot %= Constants::PulseOximeter::RATE_SIZE;  //Wrap variable
-
-      //Take average of readings
-      m_beatAvg = 0;
-      for (uint8_t x = 0; x < Constants::PulseOximeter::RATE_SIZE; x++)
-        m_beatAvg += m_rates[x];
-      m_beatAvg /= Constants::PulseOximeter::RATE_SIZE;
+    if (m_beatsPerMinute < Value::fromInt(255) && m_beatsPerMinute > Value::fromInt(20)) {
+      m_rates.add(m_beatsPerMinute.toInt());  //Store this reading
+      m_beatAvg = m_rates.average();
     }
   }
 }
 
-void PulseOximeter::display() {
-  Logger::display("IR:", m_irValue);
-  Logger::display("BPM:", m_beatsPerMinute);
-  Logger::display("ABPM:", m_beatAvg);
-}
-
-void PulseOximeter::logging(FirebaseJson* json) {
-  // if (m_irValue >= 50000) {
-  Logger::record(json, Constants::PulseOximeter::IR_ID, m_irValue);
-  Logger::record(json, Constants::PulseOximeter::BPM_ID, m_beatsPerMinute);
-  Logger::record(json, Constants::PulseOximeter::AVG_BPM_ID, m_beatAvg);
-  // }
+std::array<int32_t, std::size(PulseOximeter::CHANNELS)> PulseOximeter::values() const {
+  return { (int32_t)m_irValue, m_beatsPerMinute.raw(), m_beatAvg };
 }
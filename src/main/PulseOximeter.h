@@ -1,24 +1,33 @@
-#include <sys/_stdint.h>
 #include "MAX30105.h"
+#include <array>
 #include <cstdint>
-#include <Firebase_ESP_Client.h>
 
 class PulseOximeter {
 public:
+  static constexpr auto &CHANNELS{ Constants::PulseOximeter::CHANNELS };
+
   PulseOximeter();
 
   void update();
 
-  void display();
-
-  void logging(FirebaseJson* json);
+  // raw values in the CHANNELS order
+  std::array<int32_t, std::size(CHANNELS)> values() const;
 
 private:
+  using Value = Fixed<Constants::PulseOximeter::Q>;
+  using Filter = Ema<Constants::PulseOximeter::Q, Constants::PulseOximeter::EMA_NUM, Constants::PulseOximeter::EMA_DEN>;
+
   MAX30105 m_particleSensor;
-  uint8_t m_rates[Constants::PulseOximeter::RATE_SIZE]{};  //Array of heart rates
-  uint8_t m_rateSpot;
+  Filter m_irFilter;
+  Filter m_bpmFilter;
+  MovingAverage<uint8_t, Constants::PulseOximeter::RATE_SIZE> m_rates;  //Heart rates
   uint32_t m_lastBeat;  //Time at which the last beat occurred
-  float m_beatsPerMinute;
+  Value m_beatsPerMinute;
   uint8_t m_beatAvg;
   uint32_t m_irValue;
 };
+
+template<>
+struct SensorDriver<Constants::PulseOximeter> {
+  using type = PulseOximeter;
+};
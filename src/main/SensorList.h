@@ -0,0 +1,24 @@
+#include <array>
+#include <cstddef>
+
+// The sensors in logging order, the only place they are listed. The firmware registry (Sensors.h)
+// and the decoder (ml/batch_decode.cpp) are both instantiated from this list, the channel order of
+// an uploaded batch and of its decoder can't drift apart.
+//
+// The entries are the sensor configurations in Constants.h, a driver declares itself for its
+// configuration with a SensorDriver specialization (see Accelerometer.h).
+template<template<typename...> class T>
+using SensorList = T<Constants::Accelerometer, Constants::TemperatureSensor, Constants::PulseOximeter>;
+
+// The driver of a sensor configuration
+template<typename Config>
+struct SensorDriver;
+
+// The joined channel tables of the sensor configurations
+template<typename... Config>
+struct SensorChannels {
+  static constexpr size_t CHANNEL_COUNT{ (std::size(Config::CHANNELS) + ...) };
+  static constexpr std::array<Channel, CHANNEL_COUNT> CHANNELS{ channelTable<Config...>() };
+};
+
+using Channels = SensorList<SensorChannels>;
@@ -0,0 +1,58 @@
+#include <array>
+#include <cstdint>
+#include <tuple>
+
+// Compile-time registry of the sensors, the update, display and logging loops are expanded over the
+// sensor tuple, no virtual call and no channel lookup by name.
+//
+// A sensor is default constructible and provides
+//   CHANNELS  its Channel table (Constants.h)
+//   update()  read the sensor
+//   values()  the raw values in the CHANNELS order
+// Logger keeps one batch per channel, indexed in the order of CHANNELS below.
+//
+// The registry is instantiated with the sensor configurations of SensorList.h, each is read by its
+// SensorDriver.
+template<typename... Config>
+class SensorRegistry {
+public:
+  static constexpr size_t CHANNEL_COUNT{ SensorChannels<Config...>::CHANNEL_COUNT };
+  static constexpr std::array<Channel, CHANNEL_COUNT> CHANNELS{ SensorChannels<Config...>::CHANNELS };
+
+  void update() {
+    std::apply([](auto &...sensor) {
+      (sensor.update(), ...);
+    },
+               m_sensors);
+  }
+  void display() const {
+    forEach([](size_t index, int32_t value) {
+      Logger::display(CHANNELS[index], value);
+    });
+  }
+  void logging() const {
+    forEach([](size_t index, int32_t value) {
+      Logger::record(index, value);
+    });
+  }
+
+private:
+  std::tuple<typename SensorDriver<Config>::type...> m_sensors;
+
+  template<typename F>
+  void forEach(F f) const {
+    size_t index{ 0 };
+    std::apply([&](const auto &...sensor) {
+      (
+        [&] {
+          for (int32_t value : sensor.values()) {
+            f(index++, value);
+          }
+        }(),
+        ...);
+    },
+               m_sensors);
+  }
+};
+
+using Sensors = SensorList<SensorRegistry>;
@@ -1,32 +1,25 @@
+#include "Channel.h"
 #include "Constants.h"
+#include "SensorList.h"
+#include "Fixed.h"
 #include "TemperatureSensor.h"
 #include <Wire.h>
-#include "Logger.h"
-#include <Firebase_ESP_Client.h>
 
 TemperatureSensor::TemperatureSensor(uint8_t address) {
   m_address = address;
-  m_temp = 0;
 }
 
 void TemperatureSensor::update() {
   Wire.beginTransmission(m_address);
   Wire.write(Constants::TemperatureSensor::TEMP_OUT);
   Wire.requestFrom(m_address, (uint8_t)2);
-  // m_temp = ~(Wire.read() << 8 | Wire.read()) * 0.00390625;
-  m_temp = ~Wire.read();
-  Wire.read();
+  // both bytes are kept, the low byte is the fraction
+  uint16_t raw = Wire.read() << 8;
+  raw |= Wire.read();
+  m_temp = convert<Constants::TemperatureSensor::Q, 1, 256>((uint16_t)~raw);
   Wire.endTransmission();
 }
 
-void TemperatureSensor::display() {
-  // if (m_temp > Constants::TemperatureSensor::THRESHOLD) {
-  Logger::display("Temp:", m_temp);
-  // }
-}
-
-void TemperatureSensor::logging(FirebaseJson* json) {
-  // if (m_temp > Constants::TemperatureSensor::THRESHOLD) {
-  Logger::record(json, Constants::TemperatureSensor::TEMP_ID, m_temp);
-  // }
+std::array<int32_t, std::size(TemperatureSensor::CHANNELS)> TemperatureSensor::values() const {
+  return { m_temp.raw() };
 }
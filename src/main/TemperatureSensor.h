@@ -1,17 +1,23 @@
+#include <array>
 #include <cstdint>
-#include <Firebase_ESP_Client.h>
 
 class TemperatureSensor {
 public:
-  TemperatureSensor(uint8_t address);
+  static constexpr auto &CHANNELS{ Constants::TemperatureSensor::CHANNELS };
 
-  void update();
+  TemperatureSensor(uint8_t address = Constants::TemperatureSensor::ADDRESS);
 
-  void display();
+  void update();
 
-  void logging(FirebaseJson* json);
+  // raw values in the CHANNELS order
+  std::array<int32_t, std::size(CHANNELS)> values() const;
 
 private:
   uint8_t m_address;
-  uint8_t m_temp;
+  Fixed<Constants::TemperatureSensor::Q> m_temp;
+};
+
+template<>
+struct SensorDriver<Constants::TemperatureSensor> {
+  using type = TemperatureSensor;
 };
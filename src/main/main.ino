@@ -1,14 +1,20 @@
+#include "Channel.h"
 #include "Constants.h"
+#include "SensorList.h"
+#include "Fixed.h"
 #include "Accelerometer.h"
 #include "TemperatureSensor.h"
 #include "PulseOximeter.h"
 #include <Wire.h>
+#include "Clock.h"
+#include "Profiler.h"
+#include "BatchCodec.h"
 #include "Logger.h"
+#include "Sensors.h"
 #include <Firebase_ESP_Client.h>
 
-Accelerometer *accelerometer;
-TemperatureSensor *temperatureSensor;
-PulseOximeter *pulseOximeter;
+// A new sensor only needs its Channel table in Constants.h, its driver and an entry in SensorList.h
+Sensors *sensors;
 FirebaseJson *json;
 
 uint32_t lastTime{ 0 };
@@ -16,35 +22,33 @@ uint32_t lastTime{ 0 };
 void setup() {
   Serial.begin(Constants::BAUD_RATE);
   Wire.begin(Constants::SDA, Constants::SCL);
+  Clock::begin();
 
-  accelerometer = new Accelerometer(Constants::Accelerometer::ADDRESS);
-  temperatureSensor = new TemperatureSensor(Constants::TemperatureSensor::ADDRESS);
-  pulseOximeter = new PulseOximeter();
+  sensors = new Sensors();
 
   if (Constants::LOGGING) {
-    Logger::begin();
+    Logger::begin(Sensors::CHANNELS.data(), Sensors::CHANNEL_COUNT);
     json = Logger::getJson();
     lastTime = millis();
   }
 }
 
 void loop() {
-  accelerometer->update();
-  temperatureSensor->update();
-  pulseOximeter->update();
+  Profiler::loop();
+  Clock::update();
+  sensors->update();
 
   if (Constants::SERIALDISPLAY) {
-    accelerometer->display();
-    temperatureSensor->display();
-    pulseOximeter->display();
+    sensors->display();
   }
 
   if (Constants::LOGGING) {
     uint32_t time{ millis() };
     if (time - lastTime > Constants::RECORDING_PERIOD) {
-      accelerometer->logging(json);
-      temperatureSensor->logging(json);
-      pulseOximeter->logging(json);
+      // the periods passed since the last row without a row of their own
+      Profiler::lost((time - lastTime - 1) / Constants::RECORDING_PERIOD - 1);
+      Logger::stamp(json);
+      sensors->logging();
       lastTime = time;
     }
     Logger::send(json);
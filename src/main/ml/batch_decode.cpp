@@ -0,0 +1,64 @@
+/**
+ * batch_decode.cpp
+ *
+ * Decode the sensor channel batches (Firestore bytesValue, base64) uploaded by Logger.
+ * The wire format is defined by ../BatchCodec.h, which is shared with the firmware.
+ *
+ * Build:
+ *   g++ -O2 -std=c++17 -o batch_decode batch_decode.cpp
+ *
+ * Usage:
+ *   One base64 blob per input line, one comma separated line of values per output line.
+ *   A malformed blob gives an empty line and exit code 1.
+ *
+ *   echo "ARSA+gECAgMCAgMCAgMCAgMCAgMCAgMC" | ./batch_decode
+ *
+ *   ./batch_decode --channels
+ *   The firmware channel table (../SensorList.h), one "name,key,q" line per channel.
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../BatchCodec.h"
+#include "../Channel.h"
+#include "../Constants.h"
+#include "../SensorList.h"
+
+int main(int argc, char *argv[]) {
+  std::ios::sync_with_stdio(false);
+
+  if (argc > 1 && std::string(argv[1]) == "--channels") {
+    for (const Channel &channel : Channels::CHANNELS) {
+      std::cout << channel.name << "," << channel.key << "," << (int)channel.q << "\n";
+    }
+    return 0;
+  }
+
+  int status{ 0 };
+  std::string line;
+  std::vector<double> values;
+  char buf[32];
+
+  while (std::getline(std::cin, line)) {
+    std::string out;
+    if (!BatchCodec::decode(line, values)) {
+      std::cerr << "batch_decode: malformed blob: " << line.substr(0, 40) << "\n";
+      status = 1;
+    } else {
+      for (size_t i = 0; i < values.size(); i++) {
+        // integer channels are exact, floats need 9 digits to round trip
+        if (values[i] == (double)(long long)values[i]) {
+          snprintf(buf, sizeof(buf), i == 0 ? "%lld" : ",%lld", (long long)values[i]);
+        } else {
+          snprintf(buf, sizeof(buf), i == 0 ? "%.9g" : ",%.9g", values[i]);
+        }
+        out += buf;
+      }
+    }
+    std::cout << out << "\n";
+  }
+
+  return status;
+}
@@ -25,6 +25,15 @@ const COLLECTION_NAME = 'SensorData';
 const KEY_FILE = './firebase-admin-key.json';
 const OUTPUT_FILE = process.argv.find(a => a.startsWith('--output='))?.split('=')[1] || 'firestore_export.json';
 
+// Channel batches are bytes fields, keep them as base64 text (see ../BatchCodec.h)
+function bytesToBase64(data) {
+  const out = {};
+  for (const [key, value] of Object.entries(data)) {
+    out[key] = Buffer.isBuffer(value) ? value.toString('base64') : value;
+  }
+  return out;
+}
+
 async function exportFirestore() {
   try {
     // Load service account key
@@ -58,7 +67,7 @@ async function exportFirestore() {
     const documents = [];
     
     snapshot.forEach(doc => {
-      const data = doc.data();
+      const data = bytesToBase64(doc.data());
       documents.push({
         docId: doc.id,
         ...data
@@ -21,6 +21,9 @@ Assumptions:
 - Heart: 'hr'/'bpm' (bpm) or 'rr'/'rr_ms' (milliseconds)
 - Accel: 'ax','ay','az' or variants
 - Temp: 'temp'/'temperature'
+- Firestore batches (T0 + DT and one bytesValue per channel, see ../BatchCodec.h) are decoded
+  with the batch_decode CLI into one record per sample row, the batches with Synced false are
+  dropped (--keep-unsynced keeps them)
 
 Outputs:
 - features.npy : (n_windows, 10 features) float32
@@ -31,10 +34,12 @@ Outputs:
 """
 
 import argparse
+import base64
 import csv
 import json
 import math
 import os
+import subprocess
 
 import numpy as np
 import pandas as pd
@@ -42,6 +47,10 @@ import pandas as pd
 WINDOW_SECONDS = 5 * 60  # 5 minutes
 MIN_SAMPLES_PER_WINDOW = 10
 
+# Decoder of the Logger channel batches, build with: g++ -O2 -std=c++17 -o batch_decode batch_decode.cpp
+BATCH_DECODE = os.environ.get('BATCH_DECODE', os.path.join(os.path.dirname(os.path.abspath(__file__)), 'batch_decode'))
+
+
 FEATURE_NAMES = [
     "hr_mean_bpm",
     "hrv_sdnn_ms",
@@ -81,6 +90,100 @@ def load_csv(path):
     return df.to_dict('records')
 
 
+def blob_text(value):
+    """Base64 text of an exported bytes field (base64 string, bytes or Node Buffer JSON)."""
+    if isinstance(value, str):
+        return value
+    if isinstance(value, (bytes, bytearray)):
+        return base64.b64encode(value).decode('ascii')
+    if isinstance(value, dict) and isinstance(value.get('data'), list):
+        return base64.b64encode(bytes(value['data'])).decode('ascii')
+    return None
+
+
+def batch_channels():
+    """Firestore channel field -> (record key, scale), from the firmware channel table.
+
+    The values are uploaded as raw integers, the fixed point channels are scaled by 2^-q.
+    """
+    if not os.path.exists(BATCH_DECODE):
+        raise FileNotFoundError(f"{BATCH_DECODE} not found, build it from batch_decode.cpp")
+    out = subprocess.run([BATCH_DECODE, '--channels'], capture_output=True, text=True, check=True).stdout
+    channels = {}
+    for line in out.splitlines():
+        name, key, q = line.split(',')
+        channels[name] = (key, 1.0 / (1 << int(q)))
+    return channels
+
+
+def decode_blobs(blobs):
+    """Decode base64 channel blobs with one batch_decode run, returns a list of float arrays."""
+    if not blobs:
+        return []
+    if not os.path.exists(BATCH_DECODE):
+        raise FileNotFoundError(f"{BATCH_DECODE} not found, build it from batch_decode.cpp")
+    proc = subprocess.run([BATCH_DECODE], input='\n'.join(blobs) + '\n', capture_output=True, text=True)
+    # a malformed blob would shift the channels of the batch, none is decoded
+    if proc.returncode != 0:
+        raise ValueError(f"batch_decode failed ({proc.returncode}): {proc.stderr.strip()}")
+    out = proc.stdout.split('\n')
+    if len(out) < len(blobs):
+        raise ValueError(f"batch_decode returned {len(out)} lines for {len(blobs)} blobs")
+    return [np.array([float(v) for v in line.split(',')] if line else [], dtype=float)
+            for line in out[:len(blobs)]]
+
+
+def is_synced(rec):
+    """False for the batch whose T0 was taken before the clock was synced (Synced field)."""
+    synced = rec.get('Synced', True)
+    if isinstance(synced, str):
+        return synced.strip().lower() != 'false'
+    return bool(synced)
+
+
+def expand_batches(records, keep_unsynced=False):
+    """Expand the Logger batch documents (T0, DT and channel blobs) into one record per sample row.
+
+    The T0 of an unsynced batch counts from the boot, not from the epoch, these batches are dropped
+    unless keep_unsynced.
+    """
+    batches = [r for r in records if 'T0' in r and blob_text(r.get('DT')) is not None]
+    if not batches:
+        return records
+
+    synced = [rec for rec in batches if is_synced(rec)]
+    if len(synced) < len(batches):
+        print(f"{'Kept' if keep_unsynced else 'Dropped'} {len(batches) - len(synced)} of {len(batches)} "
+              f"batches taken before the clock was synced")
+    if not keep_unsynced:
+        batches = synced
+
+    channels_table = batch_channels()
+    blobs = []
+    for rec in batches:
+        blobs.append(blob_text(rec['DT']))
+        for name in channels_table:
+            if blob_text(rec.get(name)) is not None:
+                blobs.append(blob_text(rec[name]))
+    decoded = iter(decode_blobs(blobs))
+
+    rows = [r for r in records if not ('T0' in r and blob_text(r.get('DT')) is not None)]
+    for rec in batches:
+        # sample time = T0 + cumulative DT, in microseconds
+        ts = (float(rec['T0']) + np.cumsum(next(decoded))) / 1e6
+        channels = {}
+        for name, (key, scale) in channels_table.items():
+            if blob_text(rec.get(name)) is not None:
+                channels[key] = next(decoded) * scale
+        for i, t in enumerate(ts):
+            row = {'ts': float(t)}
+            for key, values in channels.items():
+                if i < values.size:
+                    row[key] = float(values[i])
+            rows.append(row)
+    return rows
+
+
 def load_data(path):
     """Auto-detect file type and load data."""
     if path.endswith('.json'):
@@ -287,11 +390,15 @@ def main():
     parser.add_argument('input', help='Input file (JSON or CSV)')
     parser.add_argument('--out', help='Output .npy file', default='features.npy')
     parser.add_argument('--save-csv', help='Also save raw extracted data to CSV', default=None)
+    parser.add_argument('--keep-unsynced', action='store_true',
+                        help='Keep the batches taken before the clock was synced (T0 from the boot)')
     args = parser.parse_args()
 
     print(f"Loading data from {args.input}...")
     records = load_data(args.input)
     print(f"Loaded {len(records)} records")
+
+    records = expand_batches(records, args.keep_unsynced)
     
     fields = extract_fields(records)
     print(f"Extracted {len(fields['ts'])} timestamped samples")